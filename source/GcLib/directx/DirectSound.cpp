@@ -888,7 +888,7 @@ void SoundPlayer::SetFrequency(DWORD freq) {
 	}
 }
 
-void SoundPlayer::_LoadSamples(byte* pWaveData, size_t nSamples, double* pRes) {
+void SoundPlayer::_LoadSamples(byte* pWaveData, size_t nSamples, float* pRes) {
 	DWORD sampleRate = soundSource_->formatWave_.nSamplesPerSec;
 	DWORD bytePerSample = soundSource_->formatWave_.wBitsPerSample / 8U;
 	DWORD nBlockAlign = soundSource_->formatWave_.nBlockAlign;
@@ -911,7 +911,7 @@ void SoundPlayer::_LoadSamples(byte* pWaveData, size_t nSamples, double* pRes) {
 				val -= STHRESHOLD * 2;
 			}
 
-			pRes[i] = val / (double)STHRESHOLD;
+			pRes[i] = val / (float)STHRESHOLD;
 		}
 	}
 	else if (nChannels == 2) {
@@ -928,7 +928,7 @@ void SoundPlayer::_LoadSamples(byte* pWaveData, size_t nSamples, double* pRes) {
 				val -= STHRESHOLD * 2;
 			}
 
-			pRes[i] = val / (double)STHRESHOLD;
+			pRes[i] = val / (float)STHRESHOLD;
 		}
 	}
 	else {
@@ -937,94 +937,167 @@ void SoundPlayer::_LoadSamples(byte* pWaveData, size_t nSamples, double* pRes) {
 		}
 	}
 }
-void SoundPlayer::_DoFFT(const std::vector<double>& bufIn, std::vector<double>& bufOut, double multiplier, bool bAutoLog) {
-	size_t cSamples = bufIn.size();
-	size_t nResolution = bufOut.size();
+bool SoundPlayer::GetSamplesFFT(DWORD durationMs, size_t resolution, bool bAutoLog, std::vector<double>& res) {
+	res.resize(resolution, 0);
 
-	size_t cSamplesP2 = 0;
-	{
-		size_t nextPow2 = pow(2, ceil(log2(cSamples)));
-		size_t prevPow2 = nextPow2 >> 1;
+	if (durationMs > 0 && pDirectSoundBuffer_ && IsPlaying()) {
+		DWORD sampleRate = soundSource_->formatWave_.nSamplesPerSec;
+		DWORD nBlockAlign = soundSource_->formatWave_.nBlockAlign;
 
-		//Round to the nearest power of two
-		cSamplesP2 = ((nextPow2 - cSamples) < (cSamples - prevPow2)) ? nextPow2 : prevPow2;
-	}
-	size_t fillSize = std::min(cSamples, cSamplesP2);
+		DWORD samplesNeeded = durationMs * sampleRate / 1000U;
+		samplesNeeded = std::clamp<DWORD>(samplesNeeded, 32, sampleRate / 4);
 
-	kissfft<double> fft(fillSize, true);
+		DWORD cAudioPos = GetCurrentPosition();
+		DWORD cAudioPosMax = soundSource_->audioSizeTotal_;
 
-	std::vector<std::complex<double>> ffin(cSamplesP2, std::complex<double>(0, 0));
-	std::vector<std::complex<double>> ffout(cSamplesP2);
-	
-	for (size_t i = 0; i < fillSize; ++i) {
-		//Apply the Hann window function
-		double window = 0.54 * (1 - cos(2 * GM_PI * i / (fillSize - 1)));
-		//window *= multiplier;
-		ffin[i] = std::complex<double>(bufIn[i] * window, 0);
-	}
+		//The wave buffer is static, so the part overlapping the previous window can be kept
+		size_t iLoadFrom = analyzer_.PrepareWindow(cAudioPos, samplesNeeded, nBlockAlign, true);
+		if (iLoadFrom < samplesNeeded) {
+			float* pSamples = analyzer_.GetSampleBuffer();
+
+			DWORD posLock = cAudioPos + iLoadFrom * nBlockAlign;
+			DWORD sizeLock = (posLock < cAudioPosMax) 
+				? std::min<DWORD>(cAudioPosMax - posLock, (samplesNeeded - iLoadFrom) * nBlockAlign) : 0;
+
+			size_t cLoaded = 0;
+			if (sizeLock > 0) {
+				void* pMem;
+				DWORD dwSize;
+				HRESULT hr = pDirectSoundBuffer_->Lock(posLock, sizeLock, &pMem, &dwSize, nullptr, nullptr, 0);
+				if (FAILED(hr)) {
+					analyzer_.Reset();
+					return false;
+				}
+
+				cLoaded = dwSize / nBlockAlign;
+				_LoadSamples((byte*)pMem, cLoaded, pSamples + iLoadFrom);
 
-	fft.transform(ffin.data(), ffout.data());
+				pDirectSoundBuffer_->Unlock(pMem, dwSize, nullptr, 0);
+			}
+			std::fill(pSamples + iLoadFrom + cLoaded, pSamples + samplesNeeded, 0.0f);
+		}
 
-	double avgPower = ffout[0].real();
+		analyzer_.GetBands(res, resolution, bAutoLog);
 
-	size_t halfSamp = std::min(cSamplesP2, cSamples) / 2;
-	for (size_t i = 1; i < halfSamp; ++i) {
-		double norm = std::norm(ffout[i]);
-		ffout[i - 1] = { log(norm + 1), 0 };
+		return true;
 	}
 
-	size_t len = halfSamp - 1;
-	for (size_t i = 0; i < nResolution; ++i) {
-		double pos = i / (double)nResolution;
-		if (bAutoLog) {
-			//inverse function of [log10(1 + 99 * pos) / 2]
-			constexpr double LOG_F = 1.69460519893;
-			pos = 2 * (pow(10, LOG_F * pos) - 1) / 99;
-		}
-		pos *= len;
+	return false;
+}
 
-		size_t from = floor(pos);
-		size_t to = std::min<size_t>(from + 1, len);
+//*******************************************************************
+//SoundSpectrumAnalyzer
+//*******************************************************************
+SoundSpectrumAnalyzer::SoundSpectrumAnalyzer() {
+	Reset();
+}
+SoundSpectrumAnalyzer::~SoundSpectrumAnalyzer() {
+}
+void SoundSpectrumAnalyzer::Reset() {
+	posSample_ = 0;
+	strideSample_ = 0;
+	bSampleValid_ = false;
+	bPowerValid_ = false;
+}
+SoundSpectrumAnalyzer::Plan* SoundSpectrumAnalyzer::_GetPlan(size_t size) {
+	auto itrFind = mapPlan_.find(size);
+	if (itrFind != mapPlan_.end())
+		return &itrFind->second;
 
-		double val = Math::Lerp::Smooth(ffout[from].real(), ffout[to].real(), pos - from);
-		bufOut[i] = val;
+	Plan& plan = mapPlan_[size];
+	plan.size = size;
+	plan.fft.reset(new kissfft<float>(size, true));
+	plan.window.resize(size);
+	for (size_t i = 0; i < size; ++i) {
+		//Hann window function
+		plan.window[i] = 0.54 * (1 - cos(2 * GM_PI * i / (size - 1)));
 	}
+	return &plan;
 }
-bool SoundPlayer::GetSamplesFFT(DWORD durationMs, size_t resolution, bool bAutoLog, std::vector<double>& res) {
-	res.resize(resolution, 0);
+void SoundSpectrumAnalyzer::_Transform() {
+	size_t cSamples = bufSample_.size();
 
-	if (durationMs > 0 && pDirectSoundBuffer_ && IsPlaying()) {
-		DWORD sampleRate = soundSource_->formatWave_.nSamplesPerSec;
-		DWORD bytePerSample = soundSource_->formatWave_.wBitsPerSample / 8U;
-		DWORD nChannels = soundSource_->formatWave_.nChannels;
+	size_t sizeTransform = 0;
+	{
+		size_t nextPow2 = pow(2, ceil(log2(cSamples)));
+		size_t prevPow2 = nextPow2 >> 1;
 
-		DWORD samplesNeeded = durationMs * sampleRate / 1000U;
-		samplesNeeded = std::clamp<DWORD>(samplesNeeded, 32, sampleRate / 4);
+		//Round to the nearest power of two, never exceeding the sample count
+		size_t cSamplesP2 = ((nextPow2 - cSamples) < (cSamples - prevPow2)) ? nextPow2 : prevPow2;
+		sizeTransform = std::min(cSamples, cSamplesP2);
+	}
 
-		DWORD cAudioPos = GetCurrentPosition();
-		DWORD cAudioPosMax = soundSource_->audioSizeTotal_;
-		DWORD sizeLock = std::min(cAudioPosMax - cAudioPos, samplesNeeded * bytePerSample);
+	Plan* plan = _GetPlan(sizeTransform);
 
-		std::vector<double> samples;
+	bufIn_.resize(sizeTransform);
+	bufOut_.resize(sizeTransform);
 
-		void* pMem;
-		DWORD dwSize;
-		HRESULT hr = pDirectSoundBuffer_->Lock(cAudioPos, sizeLock, &pMem, &dwSize, nullptr, nullptr, 0);
-		if (SUCCEEDED(hr)) {
-			samples.resize(samplesNeeded);
+	{
+		const float* pSample = bufSample_.data();
+		const float* pWindow = plan->window.data();
+		std::complex<float>* pIn = bufIn_.data();
+		for (size_t i = 0; i < sizeTransform; ++i)
+			pIn[i] = std::complex<float>(pSample[i] * pWindow[i], 0);
+	}
+
+	plan->fft->transform(bufIn_.data(), bufOut_.data());
+
+	//Skip the DC component
+	size_t halfSamp = sizeTransform / 2;
+	bufPower_.resize(halfSamp);
+	for (size_t i = 0; i < halfSamp; ++i)
+		bufPower_[i] = logf(std::norm(bufOut_[i + 1]) + 1);
+
+	bPowerValid_ = true;
+}
+size_t SoundSpectrumAnalyzer::PrepareWindow(DWORD pos, size_t count, DWORD stride, bool bReuseOverlap) {
+	size_t iLoadFrom = 0;
+	if (bSampleValid_ && bufSample_.size() == count && strideSample_ == stride) {
+		//Same window as the last call, the cached spectrum is still valid
+		if (pos == posSample_)
+			return count;
+
+		if (bReuseOverlap && pos > posSample_ && stride > 0) {
+			DWORD diff = pos - posSample_;
+			size_t shift = diff / stride;
+			if ((diff % stride) == 0 && shift < count) {
+				memmove(bufSample_.data(), bufSample_.data() + shift, (count - shift) * sizeof(float));
+				iLoadFrom = count - shift;
+			}
+		}
+	}
 
-			_LoadSamples((byte*)pMem, samplesNeeded, samples.data());
+	bufSample_.resize(count);
+	posSample_ = pos;
+	strideSample_ = stride;
+	bSampleValid_ = true;
+	bPowerValid_ = false;
 
-			pDirectSoundBuffer_->Unlock(pMem, dwSize, nullptr, 0);
+	return iLoadFrom;
+}
+void SoundSpectrumAnalyzer::GetBands(std::vector<double>& res, size_t resolution, bool bAutoLog) {
+	res.resize(resolution, 0);
+	if (!bSampleValid_ || bufSample_.size() < 2) return;
+
+	if (!bPowerValid_)
+		_Transform();
+	if (bufPower_.size() < 2) return;
+
+	size_t len = bufPower_.size() - 1;
+	for (size_t i = 0; i < resolution; ++i) {
+		double pos = i / (double)resolution;
+		if (bAutoLog) {
+			//inverse function of [log10(1 + 99 * pos) / 2]
+			constexpr double LOG_F = 1.69460519893;
+			pos = 2 * (pow(10, LOG_F * pos) - 1) / 99;
 		}
-		else return false;
-		
-		_DoFFT(samples, res, GetVolumeRate() / 100, bAutoLog);
+		pos *= len;
 
-		return true;
-	}
+		size_t from = std::min<size_t>(floor(pos), len);
+		size_t to = std::min<size_t>(from + 1, len);
 
-	return false;
+		res[i] = Math::Lerp::Smooth<double, double>(bufPower_[from], bufPower_[to], pos - from);
+	}
 }
 
 //*******************************************************************
@@ -1210,38 +1283,45 @@ bool SoundStreamingPlayer::GetSamplesFFT(DWORD durationMs, size_t resolution, bo
 
 	if (durationMs > 0 && pDirectSoundBuffer_ && IsPlaying()) {
 		DWORD sampleRate = soundSource_->formatWave_.nSamplesPerSec;
-		DWORD bytePerSample = soundSource_->formatWave_.wBitsPerSample / 8U;
-		DWORD nChannels = soundSource_->formatWave_.nChannels;
+		DWORD nBlockAlign = soundSource_->formatWave_.nBlockAlign;
 
 		DWORD samplesNeeded = durationMs * sampleRate / 1000U;
 		samplesNeeded = std::clamp<DWORD>(samplesNeeded, 32, sampleRate / 4);
 
-		DWORD sizeLock = samplesNeeded * bytePerSample;
+		DWORD sizeLock = samplesNeeded * nBlockAlign;
 
 		DWORD currentPos = 0;
-		if (pDirectSoundBuffer_) {
+		{
 			HRESULT hr = pDirectSoundBuffer_->GetCurrentPosition(&currentPos, nullptr);
 			if (FAILED(hr)) currentPos = 0;
 		}
 
-		std::vector<double> samples;
+		//The ring buffer gets refilled by the streaming thread, so only an exact window match is reused
+		size_t iLoadFrom = analyzer_.PrepareWindow(currentPos, samplesNeeded, nBlockAlign, false);
+		if (iLoadFrom < samplesNeeded) {
+			float* pSamples = analyzer_.GetSampleBuffer();
 
-		void* pMem1, *pMem2;
-		DWORD dwSize1, dwSize2;
-		HRESULT hr = pDirectSoundBuffer_->Lock(currentPos, sizeLock, &pMem1, &dwSize1, &pMem2, &dwSize2, 0);
-		if (SUCCEEDED(hr)) {
-			samples.resize(samplesNeeded);
+			void* pMem1, *pMem2;
+			DWORD dwSize1, dwSize2;
+			HRESULT hr = pDirectSoundBuffer_->Lock(currentPos, sizeLock, &pMem1, &dwSize1, &pMem2, &dwSize2, 0);
+			if (FAILED(hr)) {
+				analyzer_.Reset();
+				return false;
+			}
 
-			DWORD sampSize1 = dwSize1 / bytePerSample;
-			_LoadSamples((byte*)pMem1, sampSize1, samples.data());
-			if (dwSize2 > 0)
-				_LoadSamples((byte*)pMem2, dwSize2 / bytePerSample, samples.data() + sampSize1);
+			size_t cLoaded = dwSize1 / nBlockAlign;
+			_LoadSamples((byte*)pMem1, cLoaded, pSamples);
+			if (dwSize2 > 0) {
+				size_t cLoaded2 = std::min<size_t>(dwSize2 / nBlockAlign, samplesNeeded - cLoaded);
+				_LoadSamples((byte*)pMem2, cLoaded2, pSamples + cLoaded);
+				cLoaded += cLoaded2;
+			}
+			std::fill(pSamples + cLoaded, pSamples + samplesNeeded, 0.0f);
 
 			pDirectSoundBuffer_->Unlock(pMem1, dwSize1, pMem2, dwSize2);
 		}
-		else return false;
 
-		_DoFFT(samples, res, GetVolumeRate() / 100, bAutoLog);
+		analyzer_.GetBands(res, resolution, bAutoLog);
 
 		return true;
 	}
@@ -3,6 +3,8 @@
 #include "../pch.h"
 #include "DxConstant.hpp"
 
+template<typename scalar_t> class kissfft;
+
 namespace directx {
 	class DirectSoundManager;
 	class SoundDivision;
@@ -11,6 +13,7 @@ namespace directx {
 
 	class SoundSourceData;
 
+	class SoundSpectrumAnalyzer;
 	class SoundPlayer;
 	class SoundStreamingPlayer;
 
@@ -192,6 +195,45 @@ namespace directx {
 		virtual bool Load(shared_ptr<gstd::FileReader> reader);
 	};
 
+	//*******************************************************************
+	//SoundSpectrumAnalyzer
+	//*******************************************************************
+	class SoundSpectrumAnalyzer {
+	public:
+		struct Plan {
+			size_t size;
+			unique_ptr<kissfft<float>> fft;
+			std::vector<float> window;		//Precomputed Hann window
+		};
+	protected:
+		std::unordered_map<size_t, Plan> mapPlan_;	//Keyed by transform size
+
+		std::vector<float> bufSample_;
+		std::vector<std::complex<float>> bufIn_;
+		std::vector<std::complex<float>> bufOut_;
+		std::vector<float> bufPower_;
+
+		DWORD posSample_;			//Buffer position of bufSample_[0], in bytes
+		DWORD strideSample_;
+		bool bSampleValid_;
+		bool bPowerValid_;
+
+		Plan* _GetPlan(size_t size);
+		void _Transform();
+	public:
+		SoundSpectrumAnalyzer();
+		~SoundSpectrumAnalyzer();
+
+		void Reset();
+
+		//Prepares the sample window for [pos, pos + count * stride), reusing the overlap with the previous window.
+		//Returns the index of the first sample that must be loaded; returns count if nothing needs to be loaded.
+		size_t PrepareWindow(DWORD pos, size_t count, DWORD stride, bool bReuseOverlap);
+		float* GetSampleBuffer() { return bufSample_.data(); }
+
+		void GetBands(std::vector<double>& res, size_t resolution, bool bAutoLog);
+	};
+
 	//*******************************************************************
 	//SoundPlayer
 	//*******************************************************************
@@ -245,11 +287,12 @@ namespace directx {
 		
 		bool flgUpdateStreamOffset_;
 
+		SoundSpectrumAnalyzer analyzer_;
+
 		virtual bool _CreateBuffer(shared_ptr<SoundSourceData> source) = 0;
 		static LONG _GetVolumeAsDirectSoundDecibel(float rate);
 
-		void _LoadSamples(byte* pWaveData, size_t pSize, double* pRes);
-		void _DoFFT(const std::vector<double>& bufIn, std::vector<double>& bufOut, double multiplier, bool bAutoLog);
+		void _LoadSamples(byte* pWaveData, size_t pSize, float* pRes);
 	public:
 		SoundPlayer();
 		virtual ~SoundPlayer();
@@ -24,6 +24,10 @@ DxScriptObjectBase::DxScriptObjectBase() {
 	bActive_ = false;
 	bVisible_ = true;
 	priRender_ = 50;
+
+	renderSeq_ = 0;
+	renderBucket_ = -1;
+	renderStamp_ = 0;
 	
 	frameExist_ = 0;
 }
@@ -33,19 +37,33 @@ DxScriptObjectBase::~DxScriptObjectBase() {
 }
 
 void DxScriptObjectBase::Clone(DxScriptObjectBase* src) {
-	idScript_ = src->idScript_;
+	SetScriptID(src->idScript_);
 
 	bActive_ = src->bActive_;
-	bVisible_ = src->bVisible_;
-	priRender_ = src->priRender_;
+	SetVisible(src->bVisible_);
+	SetRenderPriorityI(src->priRender_);
 	frameExist_ = src->frameExist_;
 
 	mapObjectValue_ = src->mapObjectValue_;
 	mapObjectValueI_ = src->mapObjectValueI_;
 }
 
+void DxScriptObjectBase::SetScriptID(int64_t idScript) {
+	if (manager_) manager_->_SetObjectOwner(this, idScript);
+	else idScript_ = idScript;
+}
+void DxScriptObjectBase::SetVisible(bool bVisible) {
+	if (bVisible_ == bVisible) return;
+	bVisible_ = bVisible;
+	if (manager_) manager_->_UpdateRenderBucket(this);
+}
 void DxScriptObjectBase::SetRenderPriority(double pri) {
-	priRender_ = pri * (manager_->GetRenderBucketCapacity() - 1U);
+	SetRenderPriorityI(pri * (manager_->GetRenderBucketCapacity() - 1U));
+}
+void DxScriptObjectBase::SetRenderPriorityI(int pri) {
+	if (priRender_ == pri) return;
+	priRender_ = pri;
+	if (manager_) manager_->_UpdateRenderBucket(this);
 }
 double DxScriptObjectBase::GetRenderPriority() {
 	return (double)priRender_ / (manager_->GetRenderBucketCapacity() - 1U);
@@ -186,6 +204,34 @@ void DxScriptPrimitiveObject2D::Render() {
 			graphics->SetFogEnable(true);
 	}
 }
+bool DxScriptPrimitiveObject2D::RenderBatched(RenderBatcher2D* batch) {
+	RenderObjectTLX* obj = GetRenderObject();
+	if (obj == nullptr) return false;
+
+	//Same as SetRenderState, IsBatchable and CreateRenderMatrix depend on these
+	obj->SetVertexShaderRendering(bVertexShaderMode_);
+	obj->SetDisableMatrixTransformation(!bEnableMatrix_);
+	if (!obj->IsBatchable()) return false;
+
+	obj->SetPosition(position_);
+	obj->SetAngle(angle_);
+	obj->SetScale(scale_);
+
+	RenderBatchKey2D key;
+	{
+		shared_ptr<Texture> texture = obj->GetTexture();
+		key.texture = texture ? texture->GetD3DTexture() : nullptr;
+	}
+	key.renderTarget = obj->GetRenderTarget();
+	key.shader = obj->GetShader();
+	key.blend = typeBlend_;
+	key.culling = modeCulling_;
+	key.filterMin = filterMin_;
+	key.filterMag = filterMag_;
+	key.filterMip = filterMip_;
+
+	return batch->Add(key, obj, obj->CreateRenderMatrix(angX_, angY_, angZ_));
+}
 void DxScriptPrimitiveObject2D::SetRenderState() {
 	DirectGraphics* graphics = DirectGraphics::GetBase();
 	RenderObjectTLX* obj = GetRenderObject();
@@ -866,6 +912,7 @@ void DxSoundObject::Clone(DxScriptObjectBase* _src) {
 	auto src = (DxSoundObject*)_src;
 
 	mapCachedPlayers_.clear();
+	mapSpectrum_.clear();
 	Load(src->player_->GetSoundSource());
 
 	style_ = src->style_;
@@ -885,6 +932,7 @@ bool DxSoundObject::Load(shared_ptr<SoundSourceData> source) {
 
 	//A very ugly hack
 	player_ = nullptr;
+	mapSpectrum_.clear();
 	if (source) {
 		for (auto itr = mapCachedPlayers_.begin(); itr != mapCachedPlayers_.end();) {
 			SoundSourceData* pSource = itr->first;
@@ -914,6 +962,31 @@ void DxSoundObject::Play() {
 	if (player_)
 		player_->Play();
 }
+const DxSoundObject::SpectrumBands& DxSoundObject::GetSpectrumBands(DWORD durationMs, size_t resolution, bool bAutoLog) {
+	uint64_t frame = manager_ ? manager_->GetWorkFrameCount() : 0;
+
+	auto key = std::make_tuple(durationMs, resolution, bAutoLog);
+	auto itrFind = mapSpectrum_.find(key);
+	if (itrFind != mapSpectrum_.end()) {
+		if (itrFind->second.frame == frame)
+			return itrFind->second;
+	}
+	else {
+		//Subscribers that stopped polling leave their entries behind, keep the table small
+		for (auto itr = mapSpectrum_.begin(); itr != mapSpectrum_.end();) {
+			if (itr->second.frame != frame) itr = mapSpectrum_.erase(itr);
+			else ++itr;
+		}
+		itrFind = mapSpectrum_.insert(std::make_pair(key, SpectrumBands())).first;
+	}
+
+	SpectrumBands& res = itrFind->second;
+	res.frame = frame;
+	res.bValid = player_ ? player_->GetSamplesFFT(durationMs, resolution, bAutoLog, res.bands) : false;
+	if (!res.bValid)
+		res.bands.assign(resolution, 0);
+	return res;
+}
 
 //****************************************************************************
 //DxFileObject
@@ -1425,72 +1498,96 @@ DWORD DxBinaryFileObject::Write(LPVOID data, size_t size) {
 //DxScriptObjectManager
 //****************************************************************************
 DxScriptObjectManager::FogData DxScriptObjectManager::fogData_ = { false, 0xffffffff, 0, 0 };
-DxScriptObjectManager::DxScriptObjectManager() {
+DxScriptObjectManager::DxScriptObjectManager() : batcher_(&batchSink_) {
+	countSlot_ = 0U;
+	indexFreeHead_ = -1;
+	indexFreeTail_ = -1;
+
+	renderSeqCounter_ = 0U;
+	renderStampCounter_ = 0U;
+
 	SetMaxObject(DEFAULT_CONTAINER_CAPACITY);
 	SetRenderBucketCapacity(101);
 
 	totalObjectCreateCount_ = 0U;
+	countWorkFrame_ = 0U;
 
+	listActiveObject_.reserve(DEFAULT_CONTAINER_CAPACITY);
 	listDeleteObject_.reserve(512U);
 }
 DxScriptObjectManager::~DxScriptObjectManager() {
 }
 
 bool DxScriptObjectManager::SetMaxObject(size_t size) {
-	/*
-	listUnusedIndex_.clear();
-	for (size_t iObj = 0U; iObj < obj_.size(); ++iObj) {
-		shared_ptr<DxScriptObjectBase> obj = obj_[iObj];
-		if (obj == nullptr) listUnusedIndex_.push_back(iObj);
+	if (countSlot_ >= MAX_OBJECT) return false;
+	size = std::min<size_t>(size, MAX_OBJECT);
+
+	while (countSlot_ < size) {
+		ObjectSlot* page = new ObjectSlot[SLOT_PAGE_SIZE];
+		listSlotPage_.emplace_back(page);
+
+		size_t indexBase = countSlot_;
+		countSlot_ += SLOT_PAGE_SIZE;
+		for (size_t iSlot = 0; iSlot < SLOT_PAGE_SIZE; ++iSlot) {
+			page[iSlot].generation = 0;
+			page[iSlot].prevOwned = -1;
+			page[iSlot].nextOwned = -1;
+			_PushFreeSlot(indexBase + iSlot);
+		}
 	}
-	*/
-	if (obj_.size() == 131072U) return false;
-	size = std::min(size, 131072U);
-
-	for (size_t iObj = obj_.size(); iObj < size; ++iObj)
-		listUnusedIndex_.push_back(iObj);
-	obj_.resize(size, nullptr);
 	return true;
 }
+void DxScriptObjectManager::_PushFreeSlot(int index) {
+	_GetSlot(index).nextFree = -1;
+	if (indexFreeTail_ >= 0)
+		_GetSlot(indexFreeTail_).nextFree = index;
+	else
+		indexFreeHead_ = index;
+	indexFreeTail_ = index;
+}
 void DxScriptObjectManager::SetRenderBucketCapacity(size_t capacity) {
 	listObjRender_.resize(capacity);
 	listShader_.resize(capacity);
+
+	//Priorities are clamped to the bucket count, so every member has to be placed again
+	for (RenderList& renderList : listObjRender_) {
+		renderList.Clear();
+		renderList.manager = this;
+	}
+	for (auto& obj : listActiveObject_) {
+		if (obj == nullptr) continue;
+		obj->renderBucket_ = -1;
+		obj->renderStamp_ = 0;
+	}
+	for (auto& obj : listActiveObject_) {
+		if (obj) _UpdateRenderBucket(obj.get());
+	}
 }
 
 int DxScriptObjectManager::AddObject(ref_unsync_ptr<DxScriptObjectBase> obj, bool bActivate) {
-	int res = DxScript::ID_INVALID;
-
-	auto ExpandContainerCapacity = [&]() -> bool {
-		size_t oldSize = obj_.size();
-		bool res = SetMaxObject(oldSize * 2U);
-		if (res) Logger::WriteTop(StringUtility::Format("DxScriptObjectManager: Object pool expansion. [%d->%d]",
-			oldSize, obj_.size()));
-		return res;
-	};
-
-	{
-		do {
-			if (listUnusedIndex_.size() == 0U) {
-				if (!ExpandContainerCapacity()) break;
-			}
-			res = listUnusedIndex_.front();
-			listUnusedIndex_.pop_front();
-		} while (obj_[res]);
+	//Freed slots are reused in FIFO order, so a slot's generation wraps around as late as possible
+	if (indexFreeHead_ < 0) {
+		if (!SetMaxObject(countSlot_ + SLOT_PAGE_SIZE))
+			return DxScript::ID_INVALID;
+	}
 
-		if (res != DxScript::ID_INVALID) {
-			obj_[res] = obj;
+	int index = indexFreeHead_;
+	ObjectSlot& slot = _GetSlot(index);
+	indexFreeHead_ = slot.nextFree;
+	if (indexFreeHead_ < 0) indexFreeTail_ = -1;
 
-			if (bActivate) {
-				obj->bActive_ = true;
-				listActiveObject_.push_back(obj);
-			}
-			obj->idObject_ = res;
-			obj->manager_ = this;
+	int res = (int)(slot.generation << ID_INDEX_BITS) | index;
+	slot.obj = obj;
+	_LinkOwner(index, obj->idScript_);
 
-			++totalObjectCreateCount_;
-		}
+	obj->idObject_ = res;
+	obj->manager_ = this;
+	if (bActivate) {
+		obj->bActive_ = true;
+		_PushActiveObject(obj);
 	}
 
+	++totalObjectCreateCount_;
 	return res;
 }
 
@@ -1502,7 +1599,7 @@ void DxScriptObjectManager::ActivateObject(ref_unsync_ptr<DxScriptObjectBase> ob
 
 	if (bActivate && !obj->IsActive()) {
 		obj->bActive_ = true;
-		listActiveObject_.push_back(obj);
+		_PushActiveObject(obj);
 	}
 	else if (!bActivate) {
 		obj->bActive_ = false;
@@ -1511,35 +1608,83 @@ void DxScriptObjectManager::ActivateObject(ref_unsync_ptr<DxScriptObjectBase> ob
 
 std::vector<int> DxScriptObjectManager::GetValidObjectIdentifier() {
 	std::vector<int> res;
-	for (size_t iObj = 0; iObj < obj_.size(); ++iObj) {
-		if (obj_[iObj] == nullptr) continue;
-		res.push_back(obj_[iObj]->idObject_);
+	for (size_t iSlot = 0; iSlot < countSlot_; ++iSlot) {
+		ObjectSlot& slot = _GetSlot(iSlot);
+		if (slot.obj == nullptr) continue;
+		res.push_back(slot.obj->idObject_);
 	}
 	return res;
 }
-DxScriptObjectBase* DxScriptObjectManager::GetObjectPointer(int id) {
-	if (id < 0 || id >= obj_.size()) return nullptr;
-	return obj_[id].get();
+
+void DxScriptObjectManager::_LinkOwner(int index, int64_t idScript) {
+	if (idScript == ScriptClientBase::ID_SCRIPT_FREE) return;
+
+	ObjectSlot& slot = _GetSlot(index);
+	auto itrOwner = mapOwnedObject_.find(idScript);
+	if (itrOwner == mapOwnedObject_.end()) {
+		slot.prevOwned = -1;
+		slot.nextOwned = -1;
+		mapOwnedObject_[idScript] = { index, index, 1U };
+		return;
+	}
+
+	OwnerList& owner = itrOwner->second;
+	slot.prevOwned = owner.tail;
+	slot.nextOwned = -1;
+	_GetSlot(owner.tail).nextOwned = index;
+	owner.tail = index;
+	++owner.count;
+}
+void DxScriptObjectManager::_UnlinkOwner(int index, int64_t idScript) {
+	if (idScript == ScriptClientBase::ID_SCRIPT_FREE) return;
+
+	auto itrOwner = mapOwnedObject_.find(idScript);
+	if (itrOwner == mapOwnedObject_.end()) return;
+
+	OwnerList& owner = itrOwner->second;
+	ObjectSlot& slot = _GetSlot(index);
+	if (slot.prevOwned >= 0) _GetSlot(slot.prevOwned).nextOwned = slot.nextOwned;
+	else owner.head = slot.nextOwned;
+	if (slot.nextOwned >= 0) _GetSlot(slot.nextOwned).prevOwned = slot.prevOwned;
+	else owner.tail = slot.prevOwned;
+	slot.prevOwned = -1;
+	slot.nextOwned = -1;
+
+	if (--owner.count == 0)
+		mapOwnedObject_.erase(itrOwner);
+}
+void DxScriptObjectManager::_SetObjectOwner(DxScriptObjectBase* obj, int64_t idScript) {
+	ObjectSlot* slot = _GetSlotFromID(obj->idObject_);
+	if (slot && slot->obj.get() == obj) {
+		int index = obj->idObject_ & ID_INDEX_MASK;
+		_UnlinkOwner(index, obj->idScript_);
+		_LinkOwner(index, idScript);
+	}
+	obj->idScript_ = idScript;
 }
 
 void DxScriptObjectManager::_DeleteObject(int id) {
-	if (id < 0 || id >= obj_.size()) return;
+	ObjectSlot* slot = _GetSlotFromID(id);
+	if (slot == nullptr || slot->obj == nullptr) return;
 
-	ref_unsync_ptr<DxScriptObjectBase> pObj = obj_[id];
-	if (pObj == nullptr) return;
+	ref_unsync_ptr<DxScriptObjectBase> pObj = slot->obj;
 
 	pObj->bDelete_ = true;
-	if (pObj->manager_)
-		pObj->manager_->listUnusedIndex_.push_back(id);
+	_UpdateRenderBucket(pObj.get());
+
+	int index = id & ID_INDEX_MASK;
+	_UnlinkOwner(index, pObj->idScript_);
+
+	slot->obj = nullptr;
+	slot->generation = (slot->generation + 1) & ID_GENERATION_MASK;
+	_PushFreeSlot(index);
 
-	obj_[id] = nullptr;
 	pObj->idObject_ = DxScript::ID_INVALID;
 }
 
 //DeleteObject marks object for actual deletion at the start of the next frame
 void DxScriptObjectManager::DeleteObject(int id) {
-	if (id < 0 || id >= obj_.size()) return;
-	DeleteObject(obj_[id].get());
+	DeleteObject(GetObjectPointer(id));
 }
 void DxScriptObjectManager::DeleteObject(ref_unsync_ptr<DxScriptObjectBase> obj) {
 	DeleteObject(obj.get());
@@ -1548,47 +1693,73 @@ void DxScriptObjectManager::DeleteObject(DxScriptObjectBase* obj) {
 	if (obj == nullptr) return;
 	obj->bDelete_ = true;
 	obj->bActive_ = false;
+	_UpdateRenderBucket(obj);
 	listDeleteObject_.push_back(obj->idObject_);
 }
 
 void DxScriptObjectManager::ClearObject() {
-	std::fill(obj_.begin(), obj_.end(), nullptr);
-	listActiveObject_.clear();
+	for (auto& obj : listActiveObject_) {
+		if (obj == nullptr) continue;
+		obj->renderSeq_ = 0;
+		obj->renderBucket_ = -1;
+		obj->renderStamp_ = 0;
+	}
+	for (RenderList& renderList : listObjRender_)
+		renderList.Clear();
 
-	listUnusedIndex_.clear();
-	for (size_t iObj = 0; iObj < obj_.size(); ++iObj) {
-		listUnusedIndex_.push_back(iObj);
+	listActiveObject_.clear();
+	mapOwnedObject_.clear();
+
+	indexFreeHead_ = -1;
+	indexFreeTail_ = -1;
+	for (size_t iSlot = 0; iSlot < countSlot_; ++iSlot) {
+		ObjectSlot& slot = _GetSlot(iSlot);
+		if (slot.obj) {
+			slot.obj = nullptr;
+			slot.generation = (slot.generation + 1) & ID_GENERATION_MASK;
+		}
+		slot.prevOwned = -1;
+		slot.nextOwned = -1;
+		_PushFreeSlot(iSlot);
 	}
 }
+//The by-script operations only walk the objects owned by that script
 void DxScriptObjectManager::DeleteObjectByScriptID(int64_t idScript) {
 	if (idScript == ScriptClientBase::ID_SCRIPT_FREE) return;
 
-	for (size_t iObj = 0; iObj < obj_.size(); ++iObj) {
-		auto& pObj = obj_[iObj];
-		if (pObj == nullptr) continue;
-		if (pObj->GetScriptID() != idScript) continue;
-		DeleteObject(pObj);
-	}
+	auto itrOwner = mapOwnedObject_.find(idScript);
+	if (itrOwner == mapOwnedObject_.end()) return;
+
+	//DeleteObject only marks the objects, they stay linked until CleanupObject frees them
+	for (int index = itrOwner->second.head; index >= 0; index = _GetSlot(index).nextOwned)
+		DeleteObject(_GetSlot(index).obj.get());
 }
 void DxScriptObjectManager::OrphanObjectByScriptID(int64_t idScript) {
 	if (idScript == ScriptClientBase::ID_SCRIPT_FREE) return;
 
-	for (size_t iObj = 0; iObj < obj_.size(); ++iObj) {
-		auto& pObj = obj_[iObj];
-		if (pObj == nullptr) continue;
-		if (pObj->GetScriptID() != idScript) continue;
-		pObj->idScript_ = ScriptClientBase::ID_SCRIPT_FREE;
+	auto itrOwner = mapOwnedObject_.find(idScript);
+	if (itrOwner == mapOwnedObject_.end()) return;
+
+	for (int index = itrOwner->second.head; index >= 0;) {
+		ObjectSlot& slot = _GetSlot(index);
+		index = slot.nextOwned;
+
+		slot.obj->idScript_ = ScriptClientBase::ID_SCRIPT_FREE;
+		slot.prevOwned = -1;
+		slot.nextOwned = -1;
 	}
+	mapOwnedObject_.erase(itrOwner);
 }
 std::vector<int> DxScriptObjectManager::GetObjectByScriptID(int64_t idScript) {
 	std::vector<int> res;
 
 	if (idScript != ScriptClientBase::ID_SCRIPT_FREE) {
-		for (size_t iObj = 0; iObj < obj_.size(); ++iObj) {
-			auto& pObj = obj_[iObj];
-			if (pObj == nullptr) continue;
-			if (pObj->GetScriptID() != idScript) continue;
-			res.push_back(pObj->idObject_);
+		auto itrOwner = mapOwnedObject_.find(idScript);
+		if (itrOwner != mapOwnedObject_.end()) {
+			const OwnerList& owner = itrOwner->second;
+			res.reserve(owner.count);
+			for (int index = owner.head; index >= 0; index = _GetSlot(index).nextOwned)
+				res.push_back(_GetSlot(index).obj->idObject_);
 		}
 	}
 	return res;
@@ -1609,16 +1780,24 @@ void DxScriptObjectManager::WorkObject() {
 	}
 	mapReservedSound_.clear();
 
-	for (auto itr = listActiveObject_.begin(); itr != listActiveObject_.end();) {
-		DxScriptObjectBase* obj = itr->get();
-		if (obj == nullptr || obj->IsDeleted()) {
-			itr = listActiveObject_.erase(itr);
-			continue;
+	++countWorkFrame_;
+
+	//Compacts the active array in place, objects activated during Work() are appended and run this frame too
+	size_t iWrite = 0;
+	for (size_t iRead = 0; iRead < listActiveObject_.size(); ++iRead) {
+		DxScriptObjectBase* obj = listActiveObject_[iRead].get();
+		if (obj == nullptr || obj->IsDeleted()) continue;
+
+		if (iWrite != iRead) {
+			listActiveObject_[iWrite] = listActiveObject_[iRead];
+			listActiveObject_[iRead] = nullptr;
 		}
+		++iWrite;
+
 		obj->Work();
 		++(obj->frameExist_);
-		++itr;
 	}
+	listActiveObject_.resize(iWrite);
 }
 void DxScriptObjectManager::RenderObject() {
 	PrepareRenderObject();
@@ -1642,19 +1821,25 @@ void DxScriptObjectManager::RenderObject() {
 
 		for (UINT iPass = 0; iPass < cPass; ++iPass) {
 			if (effect) effect->BeginPass(iPass);
-			for (auto itr = renderList.begin(); itr != renderList.end(); ++itr) {
-				(*itr)->Render();
+			for (DxScriptObjectBase* obj : renderList) {
+				RenderObjectBatched(obj);
 			}
+			FlushRenderBatch();
 			if (effect) effect->EndPass();
 		}
-		renderList.Clear();
 
 		if (effect) effect->End();
 	}
 }
+void DxScriptObjectManager::RenderObjectBatched(DxScriptObjectBase* obj) {
+	if (obj->RenderBatched(&batcher_)) return;
+	batcher_.Flush();
+	obj->Render();
+}
 void DxScriptObjectManager::CleanupObject() {
-	for (auto& obj : listActiveObject_) {
-		if (obj) obj->CleanUp();
+	for (size_t iObj = 0; iObj < listActiveObject_.size(); ++iObj) {
+		if (DxScriptObjectBase* obj = listActiveObject_[iObj].get())
+			obj->CleanUp();
 	}
 
 	for (int id : listDeleteObject_) {
@@ -1663,37 +1848,64 @@ void DxScriptObjectManager::CleanupObject() {
 	listDeleteObject_.clear();
 }
 
-void DxScriptObjectManager::RenderList::Add(ref_unsync_ptr<DxScriptObjectBase>& ptr) {
-	if (size >= list.size())
-		list.push_back(ptr);
-	else
-		list[size++] = ptr;
-}
-void DxScriptObjectManager::RenderList::Clear() {
-	size = 0U;
-	std::fill(list.begin(), list.end(), nullptr);
+void DxScriptObjectManager::_PushActiveObject(ref_unsync_ptr<DxScriptObjectBase>& obj) {
+	listActiveObject_.push_back(obj);
+	if (obj->renderSeq_ == 0)
+		obj->renderSeq_ = ++renderSeqCounter_;
+	_UpdateRenderBucket(obj.get());
 }
-void DxScriptObjectManager::PrepareRenderObject() {
-	for (auto& obj : listActiveObject_) {
-		if (obj == nullptr || obj->IsDeleted()) continue;
-		//Some render objects don't use normal rendering, thus sorting isn't required for them
-		if (!obj->HasNormalRendering()) continue;
-		if (!obj->IsVisible()) continue;
+void DxScriptObjectManager::_UpdateRenderBucket(DxScriptObjectBase* obj) {
+	int bucket = -1;
+	//Some render objects don't use normal rendering, thus sorting isn't required for them
+	if (obj->renderSeq_ > 0 && !obj->bDelete_ && obj->bVisible_ && obj->HasNormalRendering())
+		bucket = std::clamp(obj->priRender_, 0, (int)listObjRender_.size() - 1);
+	if (bucket == obj->renderBucket_) return;
 
-		AddRenderObject(obj);
+	if (obj->renderBucket_ >= 0) {
+		listObjRender_[obj->renderBucket_].Remove();
+		obj->renderStamp_ = 0;
+	}
+	obj->renderBucket_ = bucket;
+	if (bucket >= 0) {
+		if (++renderStampCounter_ == 0) ++renderStampCounter_;
+		obj->renderStamp_ = renderStampCounter_;
+		listObjRender_[bucket].Insert(obj);
 	}
 }
-void DxScriptObjectManager::AddRenderObject(ref_unsync_ptr<DxScriptObjectBase> obj) {
-	size_t renderSize = listObjRender_.size();
 
-	int tPri = obj->priRender_;
-	if (tPri < 0) tPri = 0;
-	else if (tPri > renderSize - 1) tPri = renderSize - 1;
-	listObjRender_[tPri].Add(obj);
+DxScriptObjectBase* DxScriptObjectManager::RenderList::_GetObject(const Entry& entry) const {
+	DxScriptObjectBase* obj = manager->GetObjectPointer(entry.idObject);
+	return (obj && obj->renderStamp_ == entry.stamp) ? obj : nullptr;
 }
-void DxScriptObjectManager::ClearRenderObject() {
-	for (size_t iPri = 0; iPri < listObjRender_.size(); ++iPri) {
-		listObjRender_[iPri].Clear();
+void DxScriptObjectManager::RenderList::Insert(DxScriptObjectBase* obj) {
+	Entry entry = { obj->idObject_, obj->renderStamp_, obj->renderSeq_ };
+	//Newly created objects always go to the back, only re-joining objects need a search
+	if (list.empty() || list.back().seq < entry.seq) {
+		list.push_back(entry);
+		return;
+	}
+	auto itrPos = std::upper_bound(list.begin(), list.end(), entry.seq,
+		[](uint64_t seq, const Entry& e) { return seq < e.seq; });
+	list.insert(itrPos, entry);
+}
+void DxScriptObjectManager::RenderList::Compact() {
+	if (countStale == 0) return;
+	if (countStale < list.size()) {
+		auto itrEnd = std::remove_if(list.begin(), list.end(),
+			[&](const Entry& e) { return _GetObject(e) == nullptr; });
+		list.erase(itrEnd, list.end());
+	}
+	else list.clear();
+	countStale = 0;
+}
+void DxScriptObjectManager::RenderList::Clear() {
+	list.clear();
+	countStale = 0;
+}
+void DxScriptObjectManager::PrepareRenderObject() {
+	for (RenderList& renderList : listObjRender_) {
+		if (renderList.countStale > 32U && renderList.countStale * 2U > renderList.list.size())
+			renderList.Compact();
 	}
 }
 
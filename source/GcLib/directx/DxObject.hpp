@@ -33,6 +33,11 @@ namespace directx {
 		bool bVisible_;
 		int priRender_;
 
+		//Render bucket membership, maintained by DxScriptObjectManager
+		uint64_t renderSeq_;
+		int renderBucket_;
+		uint32_t renderStamp_;
+
 		uint32_t frameExist_;
 
 		std::unordered_map<std::wstring, gstd::value> mapObjectValue_;
@@ -51,21 +56,26 @@ namespace directx {
 		virtual void SetRenderState() {}
 		virtual void CleanUp() {}
 
+		//Returns false if the object has to go through Render() instead
+		virtual bool RenderBatched(RenderBatcher2D* batch) { return false; }
+
 		virtual bool HasNormalRendering() { return false; }
 
 		int GetObjectID() { return idObject_; }
 		TypeObject GetObjectType() { return typeObject_; }
 		int64_t GetScriptID() { return idScript_; }
+		void SetScriptID(int64_t idScript);
 
 		bool IsDeleted() { return bDelete_; }
 		bool IsActive() { return bActive_; }
 		void SetActive(bool bActive) { bActive_ = bActive; }
 		bool IsVisible() { return bVisible_; }
+		void SetVisible(bool bVisible);
 
 		double GetRenderPriority();
 		int GetRenderPriorityI() { return priRender_; }
 		void SetRenderPriority(double pri);
-		void SetRenderPriorityI(int pri) { priRender_ = pri; }
+		void SetRenderPriorityI(int pri);
 
 		uint32_t GetExistFrame() { return frameExist_; }
 
@@ -226,6 +236,7 @@ namespace directx {
 
 		virtual void Render();
 		virtual void SetRenderState();
+		virtual bool RenderBatched(RenderBatcher2D* batch);
 
 		RenderObjectTLX* GetRenderObject() { return dynamic_cast<RenderObjectTLX*>(objRender_.get()); }
 
@@ -532,10 +543,19 @@ namespace directx {
 	//****************************************************************************
 	class DxSoundObject : public DxScriptObjectBase {
 		friend DxScript;
+	public:
+		struct SpectrumBands {
+			uint64_t frame;
+			bool bValid;
+			std::vector<double> bands;
+		};
 	protected:
 		std::unordered_map<SoundSourceData*, weak_ptr<SoundPlayer>> mapCachedPlayers_;
 		shared_ptr<SoundPlayer> player_;
 		SoundPlayer::PlayStyle style_;
+
+		//Spectrum bands shared by every caller within the same frame, keyed by [duration, resolution, autolog]
+		std::map<std::tuple<DWORD, size_t, bool>, SpectrumBands> mapSpectrum_;
 	public:
 		DxSoundObject();
 		~DxSoundObject();
@@ -551,6 +571,8 @@ namespace directx {
 
 		shared_ptr<SoundPlayer> GetPlayer() { return player_; }
 		SoundPlayer::PlayStyle& GetStyle() { return style_; }
+
+		const SpectrumBands& GetSpectrumBands(DWORD durationMs, size_t resolution, bool bAutoLog);
 	};
 
 	//****************************************************************************
@@ -661,15 +683,51 @@ namespace directx {
 	class DxScriptObjectManager {
 		friend DxScriptObjectBase;
 	public:
+		//Objects join and leave a bucket only when they are created, deleted, hidden, or reprioritized.
+		//	Leaving only invalidates the entry, stale entries are skipped and compacted away later.
 		struct RenderList {
-			std::vector<ref_unsync_ptr<DxScriptObjectBase>> list;
-			size_t size = 0;
-
-			void Add(ref_unsync_ptr<DxScriptObjectBase>& ptr);
+			struct Entry {
+				int idObject;
+				uint32_t stamp;
+				uint64_t seq;
+			};
+			class const_iterator {
+				const RenderList* parent_;
+				const Entry* ptr_;
+				const Entry* end_;
+
+				void _Skip() {
+					while (ptr_ != end_ && parent_->_GetObject(*ptr_) == nullptr) ++ptr_;
+				}
+			public:
+				const_iterator(const RenderList* parent, const Entry* ptr, const Entry* end)
+					: parent_(parent), ptr_(ptr), end_(end) { _Skip(); }
+
+				DxScriptObjectBase* operator*() const { return parent_->_GetObject(*ptr_); }
+				const_iterator& operator++() { ++ptr_; _Skip(); return *this; }
+				bool operator==(const const_iterator& other) const { return ptr_ == other.ptr_; }
+				bool operator!=(const const_iterator& other) const { return ptr_ != other.ptr_; }
+			};
+
+			//Sorted by seq, which is the order the objects were activated in
+			std::vector<Entry> list;
+			size_t countStale = 0;
+			DxScriptObjectManager* manager = nullptr;
+
+			DxScriptObjectBase* _GetObject(const Entry& entry) const;
+
+			void Insert(DxScriptObjectBase* obj);
+			void Remove() { ++countStale; }
+			void Compact();
 			void Clear();
 
-			std::vector<ref_unsync_ptr<DxScriptObjectBase>>::const_iterator begin() { return list.cbegin(); }
-			std::vector<ref_unsync_ptr<DxScriptObjectBase>>::const_iterator end() { return begin() + size; }
+			size_t GetSize() const { return list.size() - countStale; }
+
+			const_iterator begin() const { return const_iterator(this, list.data(), list.data() + list.size()); }
+			const_iterator end() const {
+				const Entry* pEnd = list.data() + list.size();
+				return const_iterator(this, pEnd, pEnd);
+			}
 		};
 		struct FogData {
 			bool enable;
@@ -680,30 +738,79 @@ namespace directx {
 
 		enum : size_t {
 			DEFAULT_CONTAINER_CAPACITY = 16384U,
+			SLOT_PAGE_SIZE = 4096U,
+		};
+		//Object IDs are [generation:14][slot index:17], a slot's generation advances every time it's freed
+		enum : int {
+			ID_INDEX_BITS = 17,
+			ID_INDEX_MASK = (1 << ID_INDEX_BITS) - 1,
+			ID_GENERATION_MASK = 0x3fff,
+			MAX_OBJECT = 1 << ID_INDEX_BITS,
+		};
+	protected:
+		struct ObjectSlot {
+			ref_unsync_ptr<DxScriptObjectBase> obj;
+			uint32_t generation;
+			int nextFree;
+			int prevOwned;
+			int nextOwned;
+		};
+		struct OwnerList {
+			int head;
+			int tail;
+			size_t count;
 		};
 	protected:
 		static FogData fogData_;
 	protected:
 		size_t totalObjectCreateCount_;
-		std::list<int> listUnusedIndex_;
+		uint64_t countWorkFrame_;
+
+		//Slots live in fixed-size pages, growing the table never moves existing slots
+		std::vector<std::unique_ptr<ObjectSlot[]>> listSlotPage_;
+		size_t countSlot_;
+		int indexFreeHead_;
+		int indexFreeTail_;
+		std::unordered_map<int64_t, OwnerList> mapOwnedObject_;
 
-		std::vector<ref_unsync_ptr<DxScriptObjectBase>> obj_;
-		std::list<ref_unsync_ptr<DxScriptObjectBase>> listActiveObject_;
+		std::vector<ref_unsync_ptr<DxScriptObjectBase>> listActiveObject_;
 		std::vector<int> listDeleteObject_;
 
 		std::unordered_map<std::wstring, shared_ptr<SoundPlayer>> mapReservedSound_;
 
 		std::vector<RenderList> listObjRender_;
 		std::vector<shared_ptr<Shader>> listShader_;
+		uint64_t renderSeqCounter_;
+		uint32_t renderStampCounter_;
+
+		RenderBatchDeviceSink2D batchSink_;
+		RenderBatcher2D batcher_;
+
+		ObjectSlot& _GetSlot(int index) { return listSlotPage_[index / SLOT_PAGE_SIZE][index % SLOT_PAGE_SIZE]; }
+		ObjectSlot* _GetSlotFromID(int id) {
+			if (id < 0) return nullptr;
+			int index = id & ID_INDEX_MASK;
+			if (index >= countSlot_) return nullptr;
+			ObjectSlot* slot = &_GetSlot(index);
+			if (slot->generation != ((uint32_t)id >> ID_INDEX_BITS)) return nullptr;
+			return slot;
+		}
+		void _PushFreeSlot(int index);
 
-		void _SetObjectID(DxScriptObjectBase* obj, int index) { obj->idObject_ = index; obj->manager_ = this; }
+		void _LinkOwner(int index, int64_t idScript);
+		void _UnlinkOwner(int index, int64_t idScript);
+		void _SetObjectOwner(DxScriptObjectBase* obj, int64_t idScript);
 
 		void _DeleteObject(int id);
+
+		void _PushActiveObject(ref_unsync_ptr<DxScriptObjectBase>& obj);
+		//Moves the object to the bucket its current state belongs in, or out of all buckets
+		void _UpdateRenderBucket(DxScriptObjectBase* obj);
 	public:
 		DxScriptObjectManager();
 		virtual ~DxScriptObjectManager();
 
-		size_t GetMaxObject() { return obj_.size(); }
+		size_t GetMaxObject() { return countSlot_; }
 		bool SetMaxObject(size_t size);
 		size_t GetAliveObjectCount() { return listActiveObject_.size(); }
 		size_t GetRenderBucketCapacity() { return listObjRender_.size(); }
@@ -714,13 +821,18 @@ namespace directx {
 		void ActivateObject(int id, bool bActivate);
 		void ActivateObject(ref_unsync_ptr<DxScriptObjectBase> obj, bool bActivate);
 
+		//Returns null for IDs of objects that have already been freed, even if their slot was reused
 		ref_unsync_ptr<DxScriptObjectBase> GetObject(int id) {
-			return ((id < 0 || id >= obj_.size()) ? nullptr : obj_[id]); 
+			ObjectSlot* slot = _GetSlotFromID(id);
+			return slot ? slot->obj : nullptr;
 		}
 
 		std::vector<int> GetValidObjectIdentifier();
 
-		DxScriptObjectBase* GetObjectPointer(int id);
+		DxScriptObjectBase* GetObjectPointer(int id) {
+			ObjectSlot* slot = _GetSlotFromID(id);
+			return slot ? slot->obj.get() : nullptr;
+		}
 		virtual void DeleteObject(int id);
 		virtual void DeleteObject(ref_unsync_ptr<DxScriptObjectBase> obj);
 		virtual void DeleteObject(DxScriptObjectBase* obj);
@@ -730,15 +842,19 @@ namespace directx {
 		void OrphanObjectByScriptID(int64_t idScript);
 		std::vector<int> GetObjectByScriptID(int64_t idScript);
 
-		void AddRenderObject(ref_unsync_ptr<DxScriptObjectBase> obj);
 		void WorkObject();
 		virtual void RenderObject();
 		void CleanupObject();
 
+		//Render buckets are kept up to date incrementally, this only compacts them
 		virtual void PrepareRenderObject();
-		void ClearRenderObject();
 		std::vector<DxScriptObjectManager::RenderList>* GetRenderObjectListPointer() { return &listObjRender_; }
 
+		//Consecutive batchable objects are merged until FlushRenderBatch or a non-batchable object
+		void RenderObjectBatched(DxScriptObjectBase* obj);
+		void FlushRenderBatch() { batcher_.Flush(); }
+		RenderBatcher2D* GetRenderBatcher() { return &batcher_; }
+
 		void SetShader(shared_ptr<Shader> shader, int min, int max);
 		void ResetShader();
 		void ResetShader(int min, int max);
@@ -749,6 +865,7 @@ namespace directx {
 		shared_ptr<SoundPlayer> GetReservedSound(shared_ptr<SoundPlayer> player);
 
 		size_t GetTotalObjectCreateCount() { return totalObjectCreateCount_; }
+		uint64_t GetWorkFrameCount() { return countWorkFrame_; }
 
 		static void SetFogParam(bool bEnable, D3DCOLOR fogColor, float start, float end);
 		static FogData* GetFogData() { return &fogData_; }
@@ -822,6 +822,10 @@ DxScript::DxScript() {
 }
 DxScript::~DxScript() {
 }
+void DxScript::AppendScriptTables(std::vector<function>* listFunc, std::vector<constant>* listConst) {
+	listFunc->insert(listFunc->end(), dxFunction.cbegin(), dxFunction.cend());
+	listConst->insert(listConst->end(), dxConstant.cbegin(), dxConstant.cend());
+}
 int DxScript::AddObject(ref_unsync_ptr<DxScriptObjectBase> obj, bool bActivate) {
 	obj->idScript_ = idScript_;
 	return objManager_->AddObject(obj, bActivate);
@@ -859,8 +863,14 @@ D3DXMATRIX _script_unpack_matrix(script_machine* machine, const value& v) {
 		if (v.length_as_array() != 16U)
 			goto lab_size_invalid;
 
-		for (size_t i = 0; i < 16; ++i)
-			ptrMat[i] = v[i].as_float();
+		if (const std::vector<double>* arr = v.as_float_array_ptr()) {
+			for (size_t i = 0; i < 16; ++i)
+				ptrMat[i] = (*arr)[i];
+		}
+		else {
+			for (size_t i = 0; i < 16; ++i)
+				ptrMat[i] = v[i].as_float();
+		}
 	}
 	
 	goto lab_return;
@@ -888,6 +898,11 @@ D3DXVECTOR3 _script_unpack_vector3(script_machine* machine, const value& v) {
 	if (v.length_as_array() != 3)
 		goto lab_size_invalid;
 
+	if (const std::vector<double>* arr = v.as_float_array_ptr()) {
+		res = D3DXVECTOR3((FLOAT)(*arr)[0], (FLOAT)(*arr)[1], (FLOAT)(*arr)[2]);
+		goto lab_return;
+	}
+
 	res = D3DXVECTOR3(
 		(FLOAT)v[0].as_float(), 
 		(FLOAT)v[1].as_float(), 
@@ -2484,7 +2499,7 @@ value DxScript::Func_Obj_SetVisible(script_machine* machine, int argc, const val
 	int id = argv[0].as_int();
 	DxScriptObjectBase* obj = script->GetObjectPointer(id);
 	if (obj)
-		obj->bVisible_ = argv[1].as_boolean();
+		obj->SetVisible(argv[1].as_boolean());
 	return value();
 }
 value DxScript::Func_Obj_IsVisible(script_machine* machine, int argc, const value* argv) {
@@ -2506,7 +2521,7 @@ value DxScript::Func_Obj_SetRenderPriority(script_machine* machine, int argc, co
 		if (pri < 0) pri = 0;
 		else if (pri > 1) pri = 1;
 
-		obj->priRender_ = pri * maxPri;
+		obj->SetRenderPriorityI(pri * maxPri);
 	}
 	return value();
 }
@@ -2521,7 +2536,7 @@ value DxScript::Func_Obj_SetRenderPriorityI(script_machine* machine, int argc, c
 		if (pri < 0) pri = 0;
 		else if (pri > maxPri) pri = maxPri;
 
-		obj->priRender_ = pri;
+		obj->SetRenderPriorityI(pri);
 	}
 	return value();
 }
@@ -2762,7 +2777,7 @@ value DxScript::Func_Obj_SetParentScriptID(script_machine* machine, int argc, co
 	int64_t idScript = argc == 2 ? argv[1].as_int() : script->GetScriptID();
 
 	DxScriptObjectBase* obj = script->GetObjectPointerAs<DxScriptObjectBase>(id);
-	if (obj) obj->idScript_ = idScript;
+	if (obj) obj->SetScriptID(idScript);
 
 	return value();
 }
@@ -4005,8 +4020,14 @@ value DxScript::Func_ObjPrimitive_SetVertexIndex(script_machine* machine, int ar
 		const value& valArr = argv[1];
 		std::vector<uint16_t> vecIndex;
 		vecIndex.resize(valArr.length_as_array());
-		for (size_t i = 0; i < valArr.length_as_array(); ++i) {
-			vecIndex[i] = (uint16_t)valArr[i].as_int();
+		if (const std::vector<int64_t>* arr = valArr.as_int_array_ptr()) {
+			for (size_t i = 0; i < arr->size(); ++i)
+				vecIndex[i] = (uint16_t)(*arr)[i];
+		}
+		else {
+			for (size_t i = 0; i < valArr.length_as_array(); ++i) {
+				vecIndex[i] = (uint16_t)valArr[i].as_int();
+			}
 		}
 		obj->GetRenderObject()->SetVertexIndices(vecIndex);
 	}
@@ -5183,20 +5204,16 @@ gstd::value DxScript::Func_ObjSound_GetSamplesFFT(gstd::script_machine* machine,
 	size_t resolution = argv[2].as_int();
 	bool bAutoLog = argv[3].as_boolean();
 
-	value res;
-	std::vector<double> fftResult;
-	fftResult.resize(resolution, 0);
-	
 	if (resolution > 0) {
 		DxSoundObject* obj = script->GetObjectPointerAs<DxSoundObject>(id);
 		if (obj) {
-			shared_ptr<SoundPlayer> player = obj->GetPlayer();
-			if (player) {
-				player->GetSamplesFFT(durationMs, resolution, bAutoLog, fftResult);
-			}
+			//Bands are computed once per frame and shared by every script polling the same object
+			const DxSoundObject::SpectrumBands& spectrum = obj->GetSpectrumBands(durationMs, resolution, bAutoLog);
+			return script->CreateFloatArrayValue(spectrum.bands);
 		}
 	}
 
+	std::vector<double> fftResult(resolution, 0);
 	return script->CreateFloatArrayValue(fftResult);
 }
 gstd::value DxScript::Func_ObjSound_AddJumpPoint(gstd::script_machine* machine, int argc, const gstd::value* argv) {
@@ -55,6 +55,9 @@ namespace directx {
 		DxScript();
 		virtual ~DxScript();
 
+		//Tables this class adds to the engine, without the screen size constants
+		static void AppendScriptTables(std::vector<gstd::function>* listFunc, std::vector<gstd::constant>* listConst);
+
 		void SetObjectManager(std::shared_ptr<DxScriptObjectManager> manager) { objManager_ = manager; }
 		std::shared_ptr<DxScriptObjectManager> GetObjectManager() { return objManager_; }
 
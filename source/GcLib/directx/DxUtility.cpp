@@ -328,5 +328,38 @@ void DxMath::TransformVertex2D(VERTEX_TLX(&vert)[4], D3DXVECTOR2* scale, D3DXVEC
 	}
 #endif
 }
+void DxMath::TransformVertexPositions(byte* dst, const byte* src, size_t stride, size_t count,
+	const D3DXMATRIX& mat)
+{
+#ifdef __L_MATH_VECTORIZE
+	__m128 r0 = Vectorize::Load((float*)mat.m[0]);
+	__m128 r1 = Vectorize::Load((float*)mat.m[1]);
+	__m128 r2 = Vectorize::Load((float*)mat.m[2]);
+	__m128 r3 = Vectorize::Load((float*)mat.m[3]);
+	__m128 maskW = _mm_castsi128_ps(Vectorize::SetI(0, 0, 0, -1));
+
+	for (size_t i = 0; i < count; ++i, src += stride, dst += stride) {
+		__m128 v = Vectorize::Load(*(const D3DXVECTOR4*)src);
+
+		//(x, y, z, 1) * mat
+		__m128 res = Vectorize::MulAdd(Vectorize::Shuffle<_MM_SHUFFLE_R(0, 0, 0, 0)>(v, v), r0, r3);
+		res = Vectorize::MulAdd(Vectorize::Shuffle<_MM_SHUFFLE_R(1, 1, 1, 1)>(v, v), r1, res);
+		res = Vectorize::MulAdd(Vectorize::Shuffle<_MM_SHUFFLE_R(2, 2, 2, 2)>(v, v), r2, res);
+
+		//Homogeneous divide, then restore the source w
+		res = Vectorize::Div(res, Vectorize::Shuffle<_MM_SHUFFLE_R(3, 3, 3, 3)>(res, res));
+		res = Vectorize::Select(maskW, v, res);
+
+		Vectorize::Store((float*)dst, res);
+	}
+#else
+	for (size_t i = 0; i < count; ++i, src += stride, dst += stride) {
+		D3DXVECTOR3 pos = *(const D3DXVECTOR3*)src;
+		D3DXVec3TransformCoord((D3DXVECTOR3*)dst, &pos, &mat);
+		if (dst != src)
+			((D3DXVECTOR4*)dst)->w = ((const D3DXVECTOR4*)src)->w;
+	}
+#endif
+}
 
 #endif
\ No newline at end of file
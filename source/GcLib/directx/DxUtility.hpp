@@ -133,6 +133,52 @@ namespace directx {
 		static D3DXVECTOR4 RotatePosFromXYZFactor(D3DXVECTOR4& vec, D3DXVECTOR2* angX, D3DXVECTOR2* angY, D3DXVECTOR2* angZ);
 		static void TransformVertex2D(VERTEX_TLX(&vert)[4], D3DXVECTOR2* scale, D3DXVECTOR2* angle, 
 			D3DXVECTOR2* position, D3DXVECTOR2* textureSize);
+		//Batched D3DXVec3TransformCoord over the D3DXVECTOR4 positions at the start of each vertex,
+		//	dst and src may be the same buffer; w is copied from src unchanged
+		static void TransformVertexPositions(byte* dst, const byte* src, size_t stride, size_t count,
+			const D3DXMATRIX& mat);
+	};
+
+	//Shape lists in SoA layout, for the batched intersection tests
+	struct DxCircleBatch {
+		std::vector<float> x;
+		std::vector<float> y;
+		std::vector<float> r;
+
+		size_t GetSize() const { return x.size(); }
+		void Clear() {
+			x.clear();
+			y.clear();
+			r.clear();
+		}
+		void Add(const DxCircle& circle) {
+			x.push_back(circle.GetX());
+			y.push_back(circle.GetY());
+			r.push_back(circle.GetR());
+		}
+	};
+	struct DxWidthLineBatch {
+		std::vector<float> x1;
+		std::vector<float> y1;
+		std::vector<float> x2;
+		std::vector<float> y2;
+		std::vector<float> w;
+
+		size_t GetSize() const { return x1.size(); }
+		void Clear() {
+			x1.clear();
+			y1.clear();
+			x2.clear();
+			y2.clear();
+			w.clear();
+		}
+		void Add(const DxWidthLine& line) {
+			x1.push_back(line.GetX1());
+			y1.push_back(line.GetY1());
+			x2.push_back(line.GetX2());
+			y2.push_back(line.GetY2());
+			w.push_back(line.GetWidth());
+		}
 	};
 
 	class DxIntersect {
@@ -160,6 +206,11 @@ namespace directx {
 		static bool Circle_LineW(const DxCircle* circle, const DxWidthLine* line);
 		static bool Circle_RegularPolygon(const DxCircle* circle, const DxRegularPolygon* polygon);
 
+		//Batched Circle_Circle and Circle_LineW, res[i] is set to the result of the pair i (0 or 1).
+		//	Performs the same operations as the scalar tests, so the results are identical.
+		static void Circle_Circle(const DxCircleBatch* circle1, const DxCircleBatch* circle2, uint8_t* res);
+		static void Circle_LineW(const DxCircleBatch* circle, const DxWidthLineBatch* line, uint8_t* res);
+
 		static bool Line_Polygon(const DxLine* line, const std::vector<DxPoint>* verts);
 		static bool Line_Circle(const DxLine* line, const  DxCircle* circle);
 		static bool Line_Ellipse(const DxLine* line, const DxEllipse* ellipse);
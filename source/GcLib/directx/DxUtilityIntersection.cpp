@@ -441,6 +441,125 @@ bool DxIntersect::Circle_LineW(const DxCircle* circle, const DxWidthLine* line)
 
 	return false;
 }
+
+#ifdef __L_MATH_VECTORIZE
+//Writes the lanes of a comparison mask to res as 0 or 1
+static __forceinline void _StoreBatchResult(uint8_t* res, const __m128& mask) {
+	int bits = _mm_movemask_ps(mask);
+	res[0] = bits & 1;
+	res[1] = (bits >> 1) & 1;
+	res[2] = (bits >> 2) & 1;
+	res[3] = (bits >> 3) & 1;
+}
+#endif
+void DxIntersect::Circle_Circle(const DxCircleBatch* circle1, const DxCircleBatch* circle2, uint8_t* res) {
+	size_t count = circle1->GetSize();
+	size_t i = 0;
+#ifdef __L_MATH_VECTORIZE
+	float* ax = (float*)circle1->x.data();
+	float* ay = (float*)circle1->y.data();
+	float* ar = (float*)circle1->r.data();
+	float* bx = (float*)circle2->x.data();
+	float* by = (float*)circle2->y.data();
+	float* br = (float*)circle2->r.data();
+
+	for (; i + 4 <= count; i += 4) {
+		__m128 dx = Vectorize::Sub(Vectorize::Load(ax + i), Vectorize::Load(bx + i));
+		__m128 dy = Vectorize::Sub(Vectorize::Load(ay + i), Vectorize::Load(by + i));
+		__m128 rr = Vectorize::Add(Vectorize::Load(ar + i), Vectorize::Load(br + i));
+
+		__m128 dd = Vectorize::Add(Vectorize::Mul(dx, dx), Vectorize::Mul(dy, dy));
+		_StoreBatchResult(res + i, _mm_cmple_ps(dd, Vectorize::Mul(rr, rr)));
+	}
+#endif
+	for (; i < count; ++i) {
+		DxCircle c1(circle1->x[i], circle1->y[i], circle1->r[i]);
+		DxCircle c2(circle2->x[i], circle2->y[i], circle2->r[i]);
+		res[i] = Circle_Circle(&c1, &c2);
+	}
+}
+void DxIntersect::Circle_LineW(const DxCircleBatch* circle, const DxWidthLineBatch* line, uint8_t* res) {
+	size_t count = circle->GetSize();
+	size_t i = 0;
+#ifdef __L_MATH_VECTORIZE
+	float* pcx = (float*)circle->x.data();
+	float* pcy = (float*)circle->y.data();
+	float* pcr = (float*)circle->r.data();
+	float* px1 = (float*)line->x1.data();
+	float* py1 = (float*)line->y1.data();
+	float* px2 = (float*)line->x2.data();
+	float* py2 = (float*)line->y2.data();
+	float* plw = (float*)line->w.data();
+
+	__m128 maskSign = Vectorize::Replicate(-0.0f);
+	__m128 two = Vectorize::Replicate(2.0f);
+	__m128 half = Vectorize::Replicate(0.5f);
+
+	//Lane-wise Circle_LineW, both branches are evaluated then selected
+	for (; i + 4 <= count; i += 4) {
+		__m128 cx = Vectorize::Load(pcx + i);
+		__m128 cy = Vectorize::Load(pcy + i);
+		__m128 cr = Vectorize::Load(pcr + i);
+		__m128 x1 = Vectorize::Load(px1 + i);
+		__m128 y1 = Vectorize::Load(py1 + i);
+		__m128 x2 = Vectorize::Load(px2 + i);
+		__m128 y2 = Vectorize::Load(py2 + i);
+		__m128 lw = Vectorize::Load(plw + i);
+
+		__m128 rr = Vectorize::Mul(cr, cr);
+		__m128 cen_x = Vectorize::Div(Vectorize::Add(x1, x2), two);
+		__m128 cen_y = Vectorize::Div(Vectorize::Add(y1, y2), two);
+		__m128 dx = Vectorize::Sub(x2, x1);
+		__m128 dy = Vectorize::Sub(y2, y1);
+		__m128 line_h = _mm_sqrt_ps(Vectorize::Add(Vectorize::Mul(dx, dx), Vectorize::Mul(dy, dy)));
+
+		__m128 rcos = Vectorize::Div(dx, line_h);
+		__m128 rsin = Vectorize::Div(dy, line_h);
+
+		__m128 ucx = Vectorize::Sub(cen_x, cx);
+		__m128 ucy = Vectorize::Sub(cen_y, cy);
+		__m128 cross_x = Vectorize::Mul(_mm_andnot_ps(maskSign,
+			Vectorize::Sub(Vectorize::Mul(rcos, ucy), Vectorize::Mul(rsin, ucx))), two);
+		__m128 cross_y = Vectorize::Mul(_mm_andnot_ps(maskSign,
+			Vectorize::Add(Vectorize::Mul(rsin, ucy), Vectorize::Mul(rcos, ucx))), two);
+
+		__m128 intersect_w = _mm_cmple_ps(cross_x, lw);
+		__m128 intersect_h = _mm_cmple_ps(cross_y, line_h);
+
+		//Inside the rectangle, or within the side regions
+		__m128 r2 = Vectorize::Mul(cr, two);
+		__m128 hitSide = _mm_or_ps(_mm_and_ps(intersect_w, intersect_h), _mm_or_ps(
+			_mm_and_ps(intersect_w, _mm_cmple_ps(cross_y, Vectorize::Add(line_h, r2))),
+			_mm_and_ps(intersect_h, _mm_cmple_ps(cross_x, Vectorize::Add(lw, r2)))));
+
+		//Within the corner regions
+		__m128 l_uw = Vectorize::Mul(Vectorize::Div(lw, line_h), half);
+		__m128 nx = Vectorize::Mul(dx, l_uw);
+		__m128 ny = Vectorize::Mul(dy, l_uw);
+
+		auto _CheckDist = [&](const __m128& tx, const __m128& ty) {
+			__m128 ex = Vectorize::Sub(tx, cx);
+			__m128 ey = Vectorize::Sub(ty, cy);
+			return _mm_cmple_ps(Vectorize::Add(Vectorize::Mul(ex, ex), Vectorize::Mul(ey, ey)), rr);
+		};
+		__m128 hitCorner = _mm_or_ps(
+			_mm_or_ps(
+				_CheckDist(Vectorize::Sub(x1, ny), Vectorize::Add(y1, nx)),
+				_CheckDist(Vectorize::Add(x1, ny), Vectorize::Sub(y1, nx))),
+			_mm_or_ps(
+				_CheckDist(Vectorize::Add(x2, ny), Vectorize::Sub(y2, nx)),
+				_CheckDist(Vectorize::Sub(x2, ny), Vectorize::Add(y2, nx))));
+
+		__m128 bSideRegion = _mm_or_ps(intersect_w, intersect_h);
+		_StoreBatchResult(res + i, Vectorize::Select(bSideRegion, hitSide, hitCorner));
+	}
+#endif
+	for (; i < count; ++i) {
+		DxCircle c(circle->x[i], circle->y[i], circle->r[i]);
+		DxWidthLine l(line->x1[i], line->y1[i], line->x2[i], line->y2[i], line->w[i]);
+		res[i] = Circle_LineW(&c, &l);
+	}
+}
 bool DxIntersect::Circle_RegularPolygon(const DxCircle* circle, const DxRegularPolygon* polygon) {
 	float cx = circle->GetX();
 	float cy = circle->GetY();
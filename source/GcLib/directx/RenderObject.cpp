@@ -397,6 +397,9 @@ size_t RenderObjectPrimitive::GetPrimitiveCount(D3DPRIMITIVETYPE typePrim, size_
 RenderObjectTLX::RenderObjectTLX() {
 	strideVertexStreamZero_ = sizeof(VERTEX_TLX);
 	bPermitCamera_ = true;
+
+	D3DXMatrixIdentity(&matVertCopy_);
+	bVertCopyDirty_ = true;
 }
 RenderObjectTLX::~RenderObjectTLX() {
 
@@ -406,20 +409,42 @@ void RenderObjectTLX::Render() {
 	RenderObjectTLX::Render(D3DXVECTOR2(1, 0), D3DXVECTOR2(1, 0), D3DXVECTOR2(1, 0));
 }
 void RenderObjectTLX::Render(const D3DXVECTOR2& angX, const D3DXVECTOR2& angY, const D3DXVECTOR2& angZ) {
+	RenderObjectTLX::Render(CreateRenderMatrix(angX, angY, angZ));
+}
+D3DXMATRIX RenderObjectTLX::CreateRenderMatrix(const D3DXVECTOR2& angX, const D3DXVECTOR2& angY, const D3DXVECTOR2& angZ) {
 	DirectGraphics* graphics = DirectGraphics::GetBase();
 	ref_count_ptr<DxCamera2D> camera = graphics->GetCamera2D();
 	bool bCamera = camera->IsEnable() && bPermitCamera_;
 
-	D3DXMATRIX matWorld;
-	if (!disableMatrixTransform_) {
-		matWorld = RenderObject::CreateWorldMatrix2D(position_, scale_,
-			angX, angY, angZ, bCamera ? &camera->GetMatrix() : nullptr);
+	if (disableMatrixTransform_)
+		return camera->GetMatrix();
+	return RenderObject::CreateWorldMatrix2D(position_, scale_,
+		angX, angY, angZ, bCamera ? &camera->GetMatrix() : nullptr);
+}
+bool RenderObjectTLX::IsBatchable() {
+	if (bVertexShaderMode_) return false;
+	switch (typePrimitive_) {
+	case D3DPT_TRIANGLELIST:
+	case D3DPT_TRIANGLESTRIP:
+	case D3DPT_TRIANGLEFAN:
+		return true;
 	}
-	else {
-		matWorld = camera->GetMatrix();
+	return false;
+}
+void RenderObjectTLX::_UpdateVertexCopy(const D3DXMATRIX& matTransform, size_t countVertex) {
+	bool bSameMatrix = memcmp(&matVertCopy_, &matTransform, sizeof(D3DXMATRIX)) == 0;
+	if (bVertCopyDirty_ || vertCopy_.size() != vertex_.size()) {
+		vertCopy_ = vertex_;
+		DxMath::TransformVertexPositions(vertCopy_.data(), vertCopy_.data(),
+			strideVertexStreamZero_, countVertex, matTransform);
 	}
-
-	RenderObjectTLX::Render(matWorld);
+	else if (!bSameMatrix) {
+		//Only the positions are affected, the rest of the copy is still valid
+		DxMath::TransformVertexPositions(vertCopy_.data(), vertex_.data(),
+			strideVertexStreamZero_, countVertex, matTransform);
+	}
+	matVertCopy_ = matTransform;
+	bVertCopyDirty_ = false;
 }
 void RenderObjectTLX::Render(const D3DXMATRIX& matTransform) {
 	DirectGraphics* graphics = DirectGraphics::GetBase();
@@ -442,15 +467,8 @@ void RenderObjectTLX::Render(const D3DXMATRIX& matTransform) {
 		size_t countIndex = std::min(vertexIndices_.size(), 65536U);
 		size_t countPrim = std::min(GetPrimitiveCount(bUseIndex ? countIndex : countVertex), 65536U);
 
-		if (!bVertexShaderMode_) {
-			vertCopy_ = vertex_;
-			for (size_t iVert = 0; iVert < countVertex; ++iVert) {
-				size_t pos = iVert * strideVertexStreamZero_;
-				VERTEX_TLX* vertex = (VERTEX_TLX*)&vertCopy_[pos];
-				D3DXVECTOR4* vPos = &vertex->position;
-				D3DXVec3TransformCoord((D3DXVECTOR3*)vPos, (D3DXVECTOR3*)vPos, &matTransform);
-			}
-		}
+		if (!bVertexShaderMode_)
+			_UpdateVertexCopy(matTransform, countVertex);
 
 		RenderShaderLibrary* shaderLib = ShaderManager::GetBase()->GetRenderLib();
 
@@ -527,21 +545,30 @@ void RenderObjectTLX::Copy(RenderObject* _src) {
 	auto src = (RenderObjectTLX*)_src;
 
 	bPermitCamera_ = src->bPermitCamera_;
+	_SetVertexDirty();
 }
 
 void RenderObjectTLX::SetVertexCount(size_t count) {
 	RenderObjectPrimitive::SetVertexCount(count);
+	_SetVertexDirty();
 	SetColorRGB(D3DCOLOR_ARGB(255, 255, 255, 255));
 	SetAlpha(255);
 }
 VERTEX_TLX* RenderObjectTLX::GetVertex(size_t index) {
 	size_t pos = index * strideVertexStreamZero_;
 	if (pos >= vertex_.size()) return nullptr;
+	_SetVertexDirty();
 	return (VERTEX_TLX*)&vertex_[pos];
 }
+const VERTEX_TLX* RenderObjectTLX::GetVertex(size_t index) const {
+	size_t pos = index * strideVertexStreamZero_;
+	if (pos >= vertex_.size()) return nullptr;
+	return (const VERTEX_TLX*)&vertex_[pos];
+}
 void RenderObjectTLX::SetVertex(size_t index, const VERTEX_TLX& vertex) {
 	size_t pos = index * strideVertexStreamZero_;
 	if (pos >= vertex_.size()) return;
+	_SetVertexDirty();
 	memcpy(&vertex_[pos], &vertex, strideVertexStreamZero_);
 }
 void RenderObjectTLX::SetVertexPosition(size_t index, float x, float y, float z, float w) {
@@ -587,7 +614,7 @@ void RenderObjectTLX::SetVertexColorRGB(size_t index, D3DCOLOR rgb) {
 	vertex->diffuse_color = (vertex->diffuse_color & 0xff000000) | (rgb & 0x00ffffff);
 }
 D3DCOLOR RenderObjectTLX::GetVertexColor(size_t index) {
-	VERTEX_TLX* vertex = GetVertex(index);
+	const VERTEX_TLX* vertex = ((const RenderObjectTLX*)this)->GetVertex(index);
 	if (vertex == nullptr) return 0xffffffff;
 	return vertex->diffuse_color;
 }
@@ -608,6 +635,178 @@ void RenderObjectTLX::SetAlpha(int alpha) {
 	}
 }
 
+//****************************************************************************
+//RenderBatcher2D
+//****************************************************************************
+bool RenderBatchKey2D::operator==(const RenderBatchKey2D& other) const {
+	return texture == other.texture && renderTarget == other.renderTarget && shader == other.shader
+		&& blend == other.blend && culling == other.culling
+		&& filterMin == other.filterMin && filterMag == other.filterMag && filterMip == other.filterMip;
+}
+
+void RenderBatchDeviceSink2D::DrawBatch(const RenderBatchKey2D& key, const VERTEX_TLX* vertex, size_t countVertex,
+	const uint16_t* index, size_t countIndex)
+{
+	DirectGraphics* graphics = DirectGraphics::GetBase();
+	IDirect3DDevice9* device = graphics->GetDevice();
+
+	//Same states as DxScriptPrimitiveObject2D::Render
+	DWORD bEnableFog = FALSE;
+	device->GetRenderState(D3DRS_FOGENABLE, &bEnableFog);
+	if (bEnableFog)
+		graphics->SetFogEnable(false);
+
+	graphics->SetLightingEnable(false);
+	graphics->SetZWriteEnable(false);
+	graphics->SetZBufferEnable(false);
+	graphics->SetBlendMode(key.blend);
+	graphics->SetCullingMode(key.culling);
+	graphics->SetTextureFilter(key.filterMin, key.filterMag, key.filterMip);
+	if (graphics->IsAllowRenderTargetChange())
+		graphics->SetRenderTarget(key.renderTarget);
+
+	device->SetTexture(0, key.texture);
+	device->SetFVF(VERTEX_TLX::fvf);
+
+	UINT countPrim = countIndex / 3U;
+
+	TransientBufferArena* arena = VertexBufferManager::GetBase()->GetArenaTLX();
+	UINT baseVertex = 0;
+	UINT startIndex = 0;
+	bool bUseArena = arena->Append(vertex, countVertex, index, countIndex, &baseVertex, &startIndex);
+	if (bUseArena) {
+		device->SetStreamSource(0, arena->GetVertexBuffer()->GetBuffer(), 0, sizeof(VERTEX_TLX));
+		device->SetIndices(arena->GetIndexBuffer()->GetBuffer());
+	}
+
+	{
+		UINT countPass = 1;
+		ID3DXEffect* effect = nullptr;
+		if (key.shader) {
+			effect = key.shader->GetEffect();
+			if (key.shader->LoadTechnique())
+				key.shader->LoadParameter();
+			effect->Begin(&countPass, 0);
+		}
+		for (UINT iPass = 0; iPass < countPass; ++iPass) {
+			if (effect) effect->BeginPass(iPass);
+
+			if (bUseArena)
+				device->DrawIndexedPrimitive(D3DPT_TRIANGLELIST, baseVertex, 0, countVertex, startIndex, countPrim);
+			else
+				device->DrawIndexedPrimitiveUP(D3DPT_TRIANGLELIST, 0, countVertex, countPrim,
+					index, D3DFMT_INDEX16, vertex, sizeof(VERTEX_TLX));
+
+			if (effect) effect->EndPass();
+		}
+		if (effect) effect->End();
+	}
+
+	device->SetIndices(nullptr);
+
+	if (bEnableFog)
+		graphics->SetFogEnable(true);
+}
+
+void RenderBatchRecordSink2D::DrawBatch(const RenderBatchKey2D& key, const VERTEX_TLX* vertex, size_t countVertex,
+	const uint16_t* index, size_t countIndex)
+{
+	Draw draw;
+	draw.key = key;
+	draw.vertex.assign(vertex, vertex + countVertex);
+	draw.index.assign(index, index + countIndex);
+	listDraw_.push_back(std::move(draw));
+}
+
+RenderBatcher2D::RenderBatcher2D(RenderBatchSink2D* sink) {
+	sink_ = sink;
+
+	bPending_ = false;
+
+	countObject_ = 0;
+	countDraw_ = 0;
+}
+
+bool RenderBatcher2D::Add(const RenderBatchKey2D& key, RenderObjectTLX* obj, const D3DXMATRIX& matTransform) {
+	if (!obj->IsBatchable()) return false;
+
+	D3DPRIMITIVETYPE typePrimitive = obj->typePrimitive_;
+	const std::vector<uint16_t>& srcIndex = obj->vertexIndices_;
+
+	bool bUseIndex = srcIndex.size() > 0;
+	size_t countVertex = std::min(obj->GetVertexCount(), 65536U);
+	size_t countSource = bUseIndex ? std::min(srcIndex.size(), 65536U) : countVertex;
+	size_t countPrim = obj->GetPrimitiveCount(countSource);
+	size_t countIndex = countPrim * 3U;
+	if (countVertex == 0 || countPrim == 0) return true;
+	if (countVertex > MAX_BATCH_VERTEX || countIndex > MAX_BATCH_INDEX) return false;
+
+	if (bPending_ && (key != key_ || vertex_.size() + countVertex > MAX_BATCH_VERTEX
+		|| index_.size() + countIndex > MAX_BATCH_INDEX))
+		Flush();
+
+	//Convert to a triangle list, indices are validated before anything is committed to the batch
+	size_t posIndex = index_.size();
+	size_t baseVertex = vertex_.size();
+	index_.resize(posIndex + countIndex);
+	{
+		uint16_t* pIndex = &index_[posIndex];
+		for (size_t iPrim = 0; iPrim < countPrim; ++iPrim) {
+			size_t tri[3];
+			switch (typePrimitive) {
+			case D3DPT_TRIANGLELIST:
+				tri[0] = iPrim * 3U;
+				tri[1] = iPrim * 3U + 1U;
+				tri[2] = iPrim * 3U + 2U;
+				break;
+			case D3DPT_TRIANGLESTRIP:
+				//Odd triangles in a strip have reversed winding
+				tri[0] = (iPrim & 1) ? iPrim + 1U : iPrim;
+				tri[1] = (iPrim & 1) ? iPrim : iPrim + 1U;
+				tri[2] = iPrim + 2U;
+				break;
+			case D3DPT_TRIANGLEFAN:
+				tri[0] = 0U;
+				tri[1] = iPrim + 1U;
+				tri[2] = iPrim + 2U;
+				break;
+			}
+			for (size_t i = 0; i < 3; ++i) {
+				size_t iVert = bUseIndex ? srcIndex[tri[i]] : tri[i];
+				if (iVert >= countVertex) {
+					index_.resize(posIndex);
+					return false;
+				}
+				*(pIndex++) = (uint16_t)(baseVertex + iVert);
+			}
+		}
+	}
+
+	obj->_UpdateVertexCopy(matTransform, countVertex);
+	{
+		const VERTEX_TLX* src = (const VERTEX_TLX*)obj->vertCopy_.data();
+		vertex_.insert(vertex_.end(), src, src + countVertex);
+	}
+
+	key_ = key;
+	bPending_ = true;
+	++countObject_;
+
+	return true;
+}
+void RenderBatcher2D::Flush() {
+	if (bPending_ && index_.size() > 0) {
+		if (sink_)
+			sink_->DrawBatch(key_, vertex_.data(), vertex_.size(), index_.data(), index_.size());
+		++countDraw_;
+	}
+
+	bPending_ = false;
+	vertex_.clear();
+	index_.clear();
+	key_ = RenderBatchKey2D();
+}
+
 //****************************************************************************
 //RenderObjectLX
 //****************************************************************************
@@ -1109,6 +1308,7 @@ void SpriteList2D::Render(const D3DXVECTOR2& angX, const D3DXVECTOR2& angY, cons
 				angX, angY, angZ, bCamera ? &camera->GetMatrix() : nullptr);
 
 		vertCopy_ = vertex_;
+		_SetVertexDirty();
 		{
 			byte mulAlpha = color_ >> 24;
 			float rMulAlpha = 1.0f;
@@ -1220,6 +1420,7 @@ void SpriteList2D::_AddVertex(VERTEX_TLX(&verts)[4]) {
 	};
 	memcpy(&vertexIndices_[countRenderIndex_], indices, 6U * sizeof(uint16_t));
 	memcpy(&vertex_[countRenderVertex_ * strideVertexStreamZero_], verts, 4U * strideVertexStreamZero_);
+	_SetVertexDirty();
 	countRenderIndex_ += 6U;
 	countRenderVertex_ += 4U;
 }
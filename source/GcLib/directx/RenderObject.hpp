@@ -72,6 +72,7 @@ namespace directx {
 		void SetTexture(shared_ptr<Texture> texture) { texture_ = texture; }
 		shared_ptr<Texture> GetTexture() { return texture_; }
 		void SetRenderTarget(shared_ptr<Texture> texture) { renderTarget_ = texture; }
+		shared_ptr<Texture> GetRenderTarget() { return renderTarget_.lock(); }
 
 		void SetRelativeMatrix(shared_ptr<D3DXMATRIX>& mat) { matRelative_ = mat; }
 
@@ -107,7 +108,9 @@ namespace directx {
 		bool IsCoordinate2D() { return bCoordinate2D_; }
 		void SetCoordinate2D(bool b) { bCoordinate2D_ = b; }
 
+		bool IsDisableMatrixTransformation() { return disableMatrixTransform_; }
 		void SetDisableMatrixTransformation(bool b) { disableMatrixTransform_ = b; }
+		bool IsVertexShaderRendering() { return bVertexShaderMode_; }
 		void SetVertexShaderRendering(bool b) { bVertexShaderMode_ = b; }
 
 		DirectionalLightingState* GetLighting() { return &lightParameter_; }
@@ -154,23 +157,38 @@ namespace directx {
 	//RenderObjectTLX
 	//	2D render object
 	//****************************************************************************
+	class RenderBatcher2D;
 	class RenderObjectTLX : public RenderObjectPrimitive {
+		friend RenderBatcher2D;
 	protected:
 		bool bPermitCamera_;
+
+		//Transformed copy of vertex_, reused while neither the vertices nor the matrix change
 		std::vector<byte> vertCopy_;
+		D3DXMATRIX matVertCopy_;
+		bool bVertCopyDirty_;
+
+		void _SetVertexDirty() { bVertCopyDirty_ = true; }
+		void _UpdateVertexCopy(const D3DXMATRIX& matTransform, size_t countVertex);
 	public:
 		RenderObjectTLX();
 		virtual ~RenderObjectTLX();
 
 		virtual void Copy(RenderObject* src);
 
+		//Whether RenderBatcher2D can draw this object in place of Render(matrix)
+		virtual bool IsBatchable();
+		D3DXMATRIX CreateRenderMatrix(const D3DXVECTOR2& angX, const D3DXVECTOR2& angY, const D3DXVECTOR2& angZ);
+
 		virtual void Render();
 		virtual void Render(const D3DXVECTOR2& angX, const D3DXVECTOR2& angY, const D3DXVECTOR2& angZ);
 		virtual void Render(const D3DXMATRIX& matTransform);
 
 		virtual void SetVertexCount(size_t count);
 
+		//Assumes the vertex will be written to
 		VERTEX_TLX* GetVertex(size_t index);
+		const VERTEX_TLX* GetVertex(size_t index) const;
 		void SetVertex(size_t index, const VERTEX_TLX& vertex);
 		void SetVertexPosition(size_t index, float x, float y, float z = 1.0f, float w = 1.0f);
 		void SetVertexUV(size_t index, float u, float v);
@@ -187,6 +205,87 @@ namespace directx {
 		void SetPermitCamera(bool bPermit) { bPermitCamera_ = bPermit; }
 	};
 
+	//****************************************************************************
+	//RenderBatcher2D
+	//	Merges consecutive RenderObjectTLX draws that share device states into
+	//	single indexed triangle list draws
+	//****************************************************************************
+	struct RenderBatchKey2D {
+		IDirect3DTexture9* texture = nullptr;
+		shared_ptr<Texture> renderTarget;
+		shared_ptr<Shader> shader;
+		BlendMode blend = MODE_BLEND_ALPHA;
+		D3DCULL culling = D3DCULL_NONE;
+		D3DTEXTUREFILTERTYPE filterMin = D3DTEXF_LINEAR;
+		D3DTEXTUREFILTERTYPE filterMag = D3DTEXF_LINEAR;
+		D3DTEXTUREFILTERTYPE filterMip = D3DTEXF_NONE;
+
+		bool operator==(const RenderBatchKey2D& other) const;
+		bool operator!=(const RenderBatchKey2D& other) const { return !(*this == other); }
+	};
+
+	//Receives the merged draws, can be replaced with a stand-in that records them instead
+	class RenderBatchSink2D {
+	public:
+		virtual ~RenderBatchSink2D() {}
+
+		virtual void DrawBatch(const RenderBatchKey2D& key, const VERTEX_TLX* vertex, size_t countVertex,
+			const uint16_t* index, size_t countIndex) = 0;
+	};
+	//Draws through the TLX arena of VertexBufferManager
+	class RenderBatchDeviceSink2D : public RenderBatchSink2D {
+	public:
+		virtual void DrawBatch(const RenderBatchKey2D& key, const VERTEX_TLX* vertex, size_t countVertex,
+			const uint16_t* index, size_t countIndex);
+	};
+	//Keeps a copy of every draw instead of drawing, stands in for the device sink where there is no device
+	class RenderBatchRecordSink2D : public RenderBatchSink2D {
+	public:
+		struct Draw {
+			RenderBatchKey2D key;
+			std::vector<VERTEX_TLX> vertex;
+			std::vector<uint16_t> index;
+		};
+	protected:
+		std::vector<Draw> listDraw_;
+	public:
+		virtual void DrawBatch(const RenderBatchKey2D& key, const VERTEX_TLX* vertex, size_t countVertex,
+			const uint16_t* index, size_t countIndex);
+
+		const std::vector<Draw>& GetDrawList() { return listDraw_; }
+		void Clear() { listDraw_.clear(); }
+	};
+
+	class RenderBatcher2D {
+	public:
+		enum : size_t {
+			MAX_BATCH_VERTEX = 65536U,
+			MAX_BATCH_INDEX = 65536U * 3U,
+		};
+	private:
+		RenderBatchSink2D* sink_;
+
+		bool bPending_;
+		RenderBatchKey2D key_;
+		std::vector<VERTEX_TLX> vertex_;
+		std::vector<uint16_t> index_;
+
+		size_t countObject_;
+		size_t countDraw_;
+	public:
+		RenderBatcher2D(RenderBatchSink2D* sink);
+
+		void SetSink(RenderBatchSink2D* sink) { sink_ = sink; }
+
+		//Returns false if the object has to be rendered by itself, the caller must then Flush() before rendering it
+		bool Add(const RenderBatchKey2D& key, RenderObjectTLX* obj, const D3DXMATRIX& matTransform);
+		void Flush();
+
+		size_t GetObjectCount() { return countObject_; }
+		size_t GetDrawCount() { return countDraw_; }
+		void ResetCount() { countObject_ = 0; countDraw_ = 0; }
+	};
+
 	//****************************************************************************
 	//RenderObjectLX
 	//	3D render object
@@ -292,6 +391,8 @@ namespace directx {
 			return std::min(count, vertexIndices_.size());
 		}
 
+		virtual bool IsBatchable() { return false; }
+
 		virtual void Render();
 		virtual void Render(const D3DXVECTOR2& angX, const D3DXVECTOR2& angY, const D3DXVECTOR2& angZ);
 
@@ -434,6 +535,8 @@ namespace directx {
 	public:
 		ParticleRenderer2D();
 
+		virtual bool IsBatchable() { return false; }
+
 		virtual void Render();
 
 		virtual void Copy(RenderObject* src);
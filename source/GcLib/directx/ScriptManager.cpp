@@ -416,6 +416,10 @@ ManagedScript::ManagedScript() {
 	listValueEvent_ = nullptr;
 	listValueEventSize_ = 0;
 }
+void ManagedScript::AppendScriptTables(std::vector<function>* listFunc, std::vector<constant>* listConst) {
+	listFunc->insert(listFunc->end(), managedScriptFunction.cbegin(), managedScriptFunction.cend());
+	listConst->insert(listConst->end(), managedScriptConstant.cbegin(), managedScriptConstant.cend());
+}
 ManagedScript::~ManagedScript() {
 	//listValueEvent_ shouldn't be delete'd, that's the job of whatever was calling RequestEvent,
 	//	doing so will cause a memory corruption + crash if there was a script error in Run().
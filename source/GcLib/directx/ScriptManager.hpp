@@ -136,6 +136,8 @@ namespace directx {
 		ManagedScript();
 		virtual ~ManagedScript();
 
+		static void AppendScriptTables(std::vector<gstd::function>* listFunc, std::vector<gstd::constant>* listConst);
+
 		virtual void Reset();
 
 		virtual void SetScriptManager(ScriptManager* manager);
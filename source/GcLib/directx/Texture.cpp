@@ -246,6 +246,342 @@ size_t Texture::GetFormatBPP(D3DFORMAT format) {
 	}
 }
 
+//****************************************************************************
+//TextureDecodeCache
+//****************************************************************************
+TextureDecodeCache::TextureDecodeCache() {
+	//Kept with the engine rather than next to the scripts or inside their archives: the entries depend on
+	//	the engine's decoder and load flags instead of the package, archives are read-only once built,
+	//	and script folders can be shared by several installs or be on read-only media
+	pathDirectory_ = PathProperty::GetModuleDirectory() + L"cache/texture/";
+	bDiskCache_ = true;
+
+	sizeMemory_ = 0U;
+
+	bDiskIndexed_ = false;
+	sizeDisk_ = 0U;
+
+	countHit_ = 0U;
+	countMiss_ = 0U;
+}
+TextureDecodeCache::~TextureDecodeCache() {
+}
+
+uint64_t TextureDecodeCache::ComputeKey(const std::string& source, bool genMipmap, bool flgNonPowerOfTwo) {
+	byte flags = ((byte)genMipmap << 1) | (byte)flgNonPowerOfTwo;
+	uint64_t hash = HashUtility::Fnv1a64(source);
+	return HashUtility::Fnv1a64(&flags, sizeof(byte), hash);
+}
+std::wstring TextureDecodeCache::GetEntryPath(uint64_t key) {
+	return pathDirectory_ + StringUtility::Format(L"%016llx.dtc", key);
+}
+
+static uint64_t _GetDecodeCacheFileSize(const TextureDecodeCache::Entry* entry) {
+	return TextureDecodeCache::HEADER_SIZE + sizeof(uint32_t) + sizeof(uint64_t)
+		+ sizeof(D3DXIMAGE_INFO) + sizeof(uint32_t) + entry->data.size();
+}
+
+void TextureDecodeCache::Clear() {
+	Lock lock(lock_);
+
+	mapEntry_.clear();
+	listEntryOrder_.clear();
+	sizeMemory_ = 0U;
+}
+void TextureDecodeCache::_AddEntry(uint64_t key, shared_ptr<Entry> entry) {
+	if (mapEntry_.find(key) != mapEntry_.end()) return;
+
+	mapEntry_[key] = entry;
+	listEntryOrder_.push_back(key);
+	sizeMemory_ += entry->data.size();
+
+	while (sizeMemory_ > MEMORY_CACHE_LIMIT && listEntryOrder_.size() > 1U) {
+		auto itrFind = mapEntry_.find(listEntryOrder_.front());
+		if (itrFind != mapEntry_.end()) {
+			sizeMemory_ -= itrFind->second->data.size();
+			mapEntry_.erase(itrFind);
+		}
+		listEntryOrder_.pop_front();
+	}
+}
+
+void TextureDecodeCache::_IndexDisk() {
+	{
+		Lock lock(lock_);
+		if (bDiskIndexed_) return;
+	}
+
+	//Hits refresh the write time of their file, so ordering by it gives the use order of earlier runs
+	std::vector<std::tuple<stdfs::file_time_type, uint64_t, uint64_t>> listFile;
+	std::error_code err;
+	for (auto& itr : stdfs::directory_iterator(pathDirectory_, err)) {
+		const stdfs::path& path = itr.path();
+		if (path.extension() != L".dtc") continue;
+
+		std::wstring name = path.stem().wstring();
+		wchar_t* pEnd = nullptr;
+		uint64_t key = wcstoull(name.c_str(), &pEnd, 16);
+		if (name.size() != 16U || pEnd != name.c_str() + name.size()) continue;
+
+		std::error_code errFile;
+		uint64_t size = itr.file_size(errFile);
+		stdfs::file_time_type time = itr.last_write_time(errFile);
+		if (errFile) continue;
+
+		listFile.push_back(std::make_tuple(time, key, size));
+	}
+	std::sort(listFile.begin(), listFile.end());
+
+	std::vector<uint64_t> listEvict;
+	{
+		Lock lock(lock_);
+		if (bDiskIndexed_) return;
+		bDiskIndexed_ = true;
+
+		for (auto& [time, key, size] : listFile)
+			_TouchDiskEntry(key, size, &listEvict);
+	}
+	_RemoveDiskEntries(listEvict);
+}
+void TextureDecodeCache::_TouchDiskEntry(uint64_t key, uint64_t size, std::vector<uint64_t>* listEvict) {
+	auto itrFind = mapDiskEntry_.find(key);
+	if (itrFind != mapDiskEntry_.end()) {
+		sizeDisk_ -= itrFind->second->size;
+		listDiskEntry_.erase(itrFind->second);
+	}
+	listDiskEntry_.push_back({ key, size });
+	mapDiskEntry_[key] = std::prev(listDiskEntry_.end());
+	sizeDisk_ += size;
+
+	while (sizeDisk_ > DISK_CACHE_LIMIT && listDiskEntry_.size() > 1U) {
+		const DiskEntry& entry = listDiskEntry_.front();
+		sizeDisk_ -= entry.size;
+		mapDiskEntry_.erase(entry.key);
+		listEvict->push_back(entry.key);
+		listDiskEntry_.pop_front();
+	}
+}
+void TextureDecodeCache::_RemoveDiskEntries(const std::vector<uint64_t>& listKey) {
+	for (uint64_t key : listKey) {
+		std::error_code err;
+		stdfs::remove(GetEntryPath(key), err);
+	}
+}
+
+shared_ptr<TextureDecodeCache::Entry> TextureDecodeCache::_LoadEntryFromDisk(uint64_t key) {
+	File file(GetEntryPath(key));
+	if (!file.Open())
+		return nullptr;
+
+	size_t sizeFile = file.GetSize();
+	if (sizeFile < HEADER_SIZE + sizeof(uint32_t) + sizeof(uint64_t) + sizeof(D3DXIMAGE_INFO) + sizeof(uint32_t))
+		return nullptr;
+
+	char header[HEADER_SIZE];
+	file.Read(header, HEADER_SIZE);
+	if (memcmp(header, HEADER, HEADER_SIZE) != 0)
+		return nullptr;
+	if (file.ReadValue<uint32_t>() != VERSION)
+		return nullptr;
+	if (file.ReadValue<uint64_t>() != key)
+		return nullptr;
+
+	shared_ptr<Entry> res(new Entry());
+	file.Read(&res->infoImage, sizeof(D3DXIMAGE_INFO));
+
+	uint32_t sizeData = file.ReadValue<uint32_t>();
+	if (sizeData == 0 || file.GetFilePointer() + sizeData > sizeFile)
+		return nullptr;
+
+	res->data.resize(sizeData);
+	file.Read(res->data.data(), sizeData);
+
+	return res;
+}
+bool TextureDecodeCache::_SaveEntryToDisk(uint64_t key, Entry* entry) {
+	std::wstring path = GetEntryPath(key);
+	std::wstring pathTemp = path + L".tmp";
+	File::CreateFileDirectory(path);
+
+	//Written under a temporary name first, so that a reader never sees a partial entry
+	{
+		File file(pathTemp);
+		if (!file.Open(File::AccessType::WRITEONLY))
+			return false;
+
+		file.Write((LPVOID)HEADER, HEADER_SIZE);
+		file.WriteValue<uint32_t>(VERSION);
+		file.WriteValue<uint64_t>(key);
+		file.Write(&entry->infoImage, sizeof(D3DXIMAGE_INFO));
+		file.WriteValue<uint32_t>(entry->data.size());
+		file.Write(entry->data.data(), entry->data.size());
+		file.Close();
+	}
+
+	std::error_code err;
+	stdfs::rename(pathTemp, path, err);
+	if (err) {
+		stdfs::remove(pathTemp, err);
+		return false;
+	}
+	return true;
+}
+
+shared_ptr<TextureDecodeCache::Entry> TextureDecodeCache::Find(uint64_t key) {
+	{
+		Lock lock(lock_);
+
+		auto itrFind = mapEntry_.find(key);
+		if (itrFind != mapEntry_.end()) {
+			++countHit_;
+			return itrFind->second;
+		}
+		if (!bDiskCache_) {
+			++countMiss_;
+			return nullptr;
+		}
+	}
+
+	_IndexDisk();
+	shared_ptr<Entry> entry = _LoadEntryFromDisk(key);
+
+	std::vector<uint64_t> listEvict;
+	{
+		Lock lock(lock_);
+
+		if (entry == nullptr) {
+			++countMiss_;
+
+			//Missing or unreadable, it will be rewritten by Store
+			auto itrDisk = mapDiskEntry_.find(key);
+			if (itrDisk != mapDiskEntry_.end()) {
+				sizeDisk_ -= itrDisk->second->size;
+				listDiskEntry_.erase(itrDisk->second);
+				mapDiskEntry_.erase(itrDisk);
+			}
+			return nullptr;
+		}
+
+		++countHit_;
+		_AddEntry(key, entry);
+		_TouchDiskEntry(key, _GetDecodeCacheFileSize(entry.get()), &listEvict);
+	}
+
+	std::error_code err;
+	stdfs::last_write_time(GetEntryPath(key), stdfs::file_time_type::clock::now(), err);
+	_RemoveDiskEntries(listEvict);
+
+	return entry;
+}
+shared_ptr<TextureDecodeCache::Entry> TextureDecodeCache::Store(uint64_t key, shared_ptr<Entry> entry) {
+	if (entry == nullptr) return nullptr;
+
+	{
+		Lock lock(lock_);
+
+		_AddEntry(key, entry);
+		//Another thread may be writing the same image
+		if (!bDiskCache_ || !setDiskWriting_.insert(key).second)
+			return entry;
+	}
+
+	_IndexDisk();
+	bool bSaved = _SaveEntryToDisk(key, entry.get());
+
+	std::vector<uint64_t> listEvict;
+	{
+		Lock lock(lock_);
+
+		setDiskWriting_.erase(key);
+		if (bSaved)
+			_TouchDiskEntry(key, _GetDecodeCacheFileSize(entry.get()), &listEvict);
+	}
+	_RemoveDiskEntries(listEvict);
+
+	return entry;
+}
+shared_ptr<TextureDecodeCache::Entry> TextureDecodeCache::Store(uint64_t key, 
+	IDirect3DTexture9* texture, const D3DXIMAGE_INFO& infoImage) 
+{
+	if (texture == nullptr) return nullptr;
+
+	ID3DXBuffer* buffer = nullptr;
+	HRESULT hr = D3DXSaveTextureToFileInMemory(&buffer, D3DXIFF_DDS, texture, nullptr);
+	if (FAILED(hr)) return nullptr;
+
+	shared_ptr<Entry> entry(new Entry());
+	entry->infoImage = infoImage;
+	entry->data.assign((const char*)buffer->GetBufferPointer(), buffer->GetBufferSize());
+	ptr_release(buffer);
+
+	return Store(key, entry);
+}
+
+shared_ptr<TextureDecodeCache::Entry> TextureDecodeCache::Convert(IDirect3DDevice9* device, const std::string& source,
+	bool genMipmap, bool flgNonPowerOfTwo) 
+{
+	shared_ptr<Entry> res;
+
+	D3DXIMAGE_INFO infoImage;
+	HRESULT hr = D3DXGetImageInfoFromFileInMemory(source.c_str(), source.size(), &infoImage);
+	if (FAILED(hr)) return nullptr;
+
+	//Same parameters as TextureManager::__CreateFromFile, so the entries are interchangeable
+	//System memory textures need no device resources, so conversion does not require a visible window
+	IDirect3DTexture9* texture = nullptr;
+	hr = D3DXCreateTextureFromFileInMemoryEx(device, source.c_str(), source.size(),
+		flgNonPowerOfTwo ? D3DX_DEFAULT_NONPOW2 : D3DX_DEFAULT,
+		flgNonPowerOfTwo ? D3DX_DEFAULT_NONPOW2 : D3DX_DEFAULT,
+		genMipmap ? D3DX_DEFAULT : 1, 0,
+		D3DFMT_UNKNOWN, D3DPOOL_SYSTEMMEM, D3DX_FILTER_BOX, D3DX_DEFAULT, 0x00000000,
+		nullptr, nullptr, &texture);
+	if (FAILED(hr)) return nullptr;
+
+	ID3DXBuffer* buffer = nullptr;
+	hr = D3DXSaveTextureToFileInMemory(&buffer, D3DXIFF_DDS, texture, nullptr);
+	if (SUCCEEDED(hr)) {
+		res.reset(new Entry());
+		res->infoImage = infoImage;
+		res->data.assign((const char*)buffer->GetBufferPointer(), buffer->GetBufferSize());
+	}
+
+	ptr_release(buffer);
+	ptr_release(texture);
+	return res;
+}
+size_t TextureDecodeCache::ConvertFiles(IDirect3DDevice9* device, const std::vector<std::wstring>& listPath,
+	bool genMipmap, bool flgNonPowerOfTwo)
+{
+	size_t res = 0;
+	for (const std::wstring& path : listPath) {
+		File file(path);
+		if (!file.Open()) continue;
+
+		std::string source;
+		source.resize(file.GetSize());
+		file.Read(source.data(), source.size());
+		file.Close();
+
+		uint64_t key = ComputeKey(source, genMipmap, flgNonPowerOfTwo);
+		if (Find(key) != nullptr) continue;
+
+		shared_ptr<Entry> entry = Convert(device, source, genMipmap, flgNonPowerOfTwo);
+		if (entry == nullptr || entry->infoImage.ImageFileFormat == D3DXIFF_DDS) continue;
+
+		Store(key, entry);
+		++res;
+	}
+	return res;
+}
+
+HRESULT TextureDecodeCache::CreateTexture(IDirect3DDevice9* device, Entry* entry, IDirect3DTexture9** pTexture) {
+	//The DDS already holds the final size, format, and mip chain; this is a straight copy into the texture
+	return D3DXCreateTextureFromFileInMemoryEx(device, entry->data.c_str(), entry->data.size(),
+		D3DX_DEFAULT_NONPOW2, D3DX_DEFAULT_NONPOW2, D3DX_FROM_FILE, 0,
+		D3DFMT_FROM_FILE, D3DPOOL_MANAGED, D3DX_FILTER_NONE, D3DX_FILTER_NONE, 0x00000000,
+		nullptr, nullptr, pTexture);
+}
+
 //****************************************************************************
 //TextureManager
 //****************************************************************************
@@ -437,19 +773,36 @@ void TextureManager::__CreateFromFile(shared_ptr<TextureData>& dst, const std::w
 	dst->useMipMap_ = genMipmap;
 	dst->useNonPowerOfTwo_ = flgNonPowerOfTwo;
 
-	HRESULT hr = D3DXCreateTextureFromFileInMemoryEx(DirectGraphics::GetBase()->GetDevice(),
-		source.c_str(), source.size(),
-		dst->useNonPowerOfTwo_ ? D3DX_DEFAULT_NONPOW2 : D3DX_DEFAULT,
-		dst->useNonPowerOfTwo_ ? D3DX_DEFAULT_NONPOW2 : D3DX_DEFAULT,
-		dst->useMipMap_ ? D3DX_DEFAULT : 1, 0,
-		D3DFMT_UNKNOWN, D3DPOOL_MANAGED, D3DX_FILTER_BOX, D3DX_DEFAULT, 0x00000000,
-		nullptr, nullptr, &(dst->pTexture_));
-	if (FAILED(hr))
-		throw wexception("D3DXCreateTextureFromFileInMemoryEx failure.");
-
-	hr = D3DXGetImageInfoFromFileInMemory(source.c_str(), source.size(), &dst->infoImage_);
-	if (FAILED(hr))
-		throw wexception("D3DXGetImageInfoFromFileInMemory failure.");
+	uint64_t keyCache = TextureDecodeCache::ComputeKey(source, genMipmap, flgNonPowerOfTwo);
+
+	bool bFromCache = false;
+	if (shared_ptr<TextureDecodeCache::Entry> entry = cacheDecode_.Find(keyCache)) {
+		HRESULT hr = TextureDecodeCache::CreateTexture(graphics->GetDevice(), entry.get(), &(dst->pTexture_));
+		if (SUCCEEDED(hr)) {
+			dst->infoImage_ = entry->infoImage;
+			bFromCache = true;
+		}
+	}
+
+	if (!bFromCache) {
+		HRESULT hr = D3DXCreateTextureFromFileInMemoryEx(graphics->GetDevice(),
+			source.c_str(), source.size(),
+			dst->useNonPowerOfTwo_ ? D3DX_DEFAULT_NONPOW2 : D3DX_DEFAULT,
+			dst->useNonPowerOfTwo_ ? D3DX_DEFAULT_NONPOW2 : D3DX_DEFAULT,
+			dst->useMipMap_ ? D3DX_DEFAULT : 1, 0,
+			D3DFMT_UNKNOWN, D3DPOOL_MANAGED, D3DX_FILTER_BOX, D3DX_DEFAULT, 0x00000000,
+			nullptr, nullptr, &(dst->pTexture_));
+		if (FAILED(hr))
+			throw wexception("D3DXCreateTextureFromFileInMemoryEx failure.");
+
+		hr = D3DXGetImageInfoFromFileInMemory(source.c_str(), source.size(), &dst->infoImage_);
+		if (FAILED(hr))
+			throw wexception("D3DXGetImageInfoFromFileInMemory failure.");
+
+		//DDS sources are already upload-ready, caching them would only duplicate the file
+		if (dst->infoImage_.ImageFileFormat != D3DXIFF_DDS)
+			cacheDecode_.Store(keyCache, dst->pTexture_, dst->infoImage_);
+	}
 	dst->CalculateResourceSize();
 
 	dst->manager_ = this;
@@ -9,6 +9,7 @@ namespace directx {
 	class TextureData;
 	class Texture;
 	class TextureManager;
+	class TextureDecodeCache;
 	class TextureInfoPanel;
 
 	//****************************************************************************
@@ -88,6 +89,86 @@ namespace directx {
 		static size_t GetFormatBPP(D3DFORMAT format);
 	};
 
+	//****************************************************************************
+	//TextureDecodeCache
+	//****************************************************************************
+	class TextureDecodeCache {
+	public:
+		struct Entry {
+			D3DXIMAGE_INFO infoImage;	//Info of the original image, not of the cached surface
+			std::string data;			//DDS image with the full mip chain, uploaded without decoding
+		};
+
+		enum : size_t {
+			MEMORY_CACHE_LIMIT = 128U * 1024U * 1024U,
+		};
+		enum : uint64_t {
+			DISK_CACHE_LIMIT = 1024ULL * 1024ULL * 1024ULL,
+		};
+		static constexpr const char* HEADER = "DNHTXCH\0";
+		static constexpr size_t HEADER_SIZE = 8U;
+		static constexpr uint32_t VERSION = 1U;
+	protected:
+		//Guards the tables only, files are read and written without holding it
+		gstd::CriticalSection lock_;
+
+		std::wstring pathDirectory_;
+		bool bDiskCache_;
+
+		std::unordered_map<uint64_t, shared_ptr<Entry>> mapEntry_;
+		std::list<uint64_t> listEntryOrder_;	//Oldest first, for eviction
+		size_t sizeMemory_;
+
+		//Files in the directory, least recently used first. Built from the file times on first use
+		//	and kept under DISK_CACHE_LIMIT by deleting from the front
+		struct DiskEntry {
+			uint64_t key;
+			uint64_t size;
+		};
+		bool bDiskIndexed_;
+		std::list<DiskEntry> listDiskEntry_;
+		std::unordered_map<uint64_t, std::list<DiskEntry>::iterator> mapDiskEntry_;
+		uint64_t sizeDisk_;
+		std::set<uint64_t> setDiskWriting_;
+
+		size_t countHit_;
+		size_t countMiss_;
+
+		void _AddEntry(uint64_t key, shared_ptr<Entry> entry);
+		void _IndexDisk();
+		void _TouchDiskEntry(uint64_t key, uint64_t size, std::vector<uint64_t>* listEvict);
+		void _RemoveDiskEntries(const std::vector<uint64_t>& listKey);
+		shared_ptr<Entry> _LoadEntryFromDisk(uint64_t key);
+		bool _SaveEntryToDisk(uint64_t key, Entry* entry);
+	public:
+		TextureDecodeCache();
+		~TextureDecodeCache();
+
+		static uint64_t ComputeKey(const std::string& source, bool genMipmap, bool flgNonPowerOfTwo);
+
+		void SetDirectory(const std::wstring& path) { pathDirectory_ = path; }
+		const std::wstring& GetDirectory() { return pathDirectory_; }
+		void SetDiskCacheEnable(bool b) { bDiskCache_ = b; }
+		std::wstring GetEntryPath(uint64_t key);
+
+		void Clear();
+
+		shared_ptr<Entry> Find(uint64_t key);
+		shared_ptr<Entry> Store(uint64_t key, shared_ptr<Entry> entry);
+		shared_ptr<Entry> Store(uint64_t key, IDirect3DTexture9* texture, const D3DXIMAGE_INFO& infoImage);
+
+		//Decodes an image into an entry without creating any device resources
+		static shared_ptr<Entry> Convert(IDirect3DDevice9* device, const std::string& source, bool genMipmap, bool flgNonPowerOfTwo);
+		//Converts and stores every file that isn't cached yet, returns the number of files converted
+		size_t ConvertFiles(IDirect3DDevice9* device, const std::vector<std::wstring>& listPath, bool genMipmap, bool flgNonPowerOfTwo);
+
+		static HRESULT CreateTexture(IDirect3DDevice9* device, Entry* entry, IDirect3DTexture9** pTexture);
+
+		size_t GetHitCount() { return countHit_; }
+		size_t GetMissCount() { return countMiss_; }
+		uint64_t GetDiskSize() { return sizeDisk_; }
+	};
+
 	//****************************************************************************
 	//TextureManager
 	//****************************************************************************
@@ -106,6 +187,8 @@ namespace directx {
 		std::list<std::pair<std::map<std::wstring, shared_ptr<TextureData>>::iterator, IDirect3DSurface9*>> listRefreshSurface_;
 		shared_ptr<TextureInfoPanel> panelInfo_;
 
+		TextureDecodeCache cacheDecode_;
+
 		void _ReleaseTextureData(const std::wstring& name);
 		void _ReleaseTextureData(std::map<std::wstring, shared_ptr<TextureData>>::iterator itr);
 
@@ -159,6 +159,78 @@ namespace directx {
 
 	//-----------------------------------------------------------------------------------------
 
+	TransientBufferArena::TransientBufferArena(IDirect3DDevice9* device) {
+		vertexBuffer_.reset(new FixedVertexBuffer(device));
+		indexBuffer_.reset(new FixedIndexBuffer(device));
+
+		posVertex_ = 0U;
+		posIndex_ = 0U;
+		bDiscard_ = true;
+	}
+	TransientBufferArena::~TransientBufferArena() {
+		Release();
+	}
+
+	void TransientBufferArena::Setup(size_t countVertex, size_t strideVertex, DWORD fvf, size_t countIndex) {
+		vertexBuffer_->Setup(countVertex, strideVertex, fvf);
+		indexBuffer_->Setup(countIndex, sizeof(uint16_t), D3DFMT_INDEX16);
+	}
+	HRESULT TransientBufferArena::Create(DWORD usage, D3DPOOL pool) {
+		posVertex_ = 0U;
+		posIndex_ = 0U;
+		bDiscard_ = true;
+
+		HRESULT hr = vertexBuffer_->Create(usage, pool);
+		if (FAILED(hr)) return hr;
+		return indexBuffer_->Create(usage, pool);
+	}
+	void TransientBufferArena::Release() {
+		vertexBuffer_->Release();
+		indexBuffer_->Release();
+	}
+
+	bool TransientBufferArena::Append(const void* vertex, size_t countVertex, const uint16_t* index, size_t countIndex,
+		UINT* pBaseVertex, UINT* pStartIndex)
+	{
+		if (countVertex > vertexBuffer_->GetSize() || countIndex > indexBuffer_->GetSize())
+			return false;
+		if (vertexBuffer_->GetBuffer() == nullptr || indexBuffer_->GetBuffer() == nullptr)
+			return false;
+
+		if (posVertex_ + countVertex > vertexBuffer_->GetSize()
+			|| posIndex_ + countIndex > indexBuffer_->GetSize())
+		{
+			posVertex_ = 0U;
+			posIndex_ = 0U;
+			bDiscard_ = true;
+		}
+
+		BufferLockParameter lockParam(bDiscard_ ? D3DLOCK_DISCARD : D3DLOCK_NOOVERWRITE);
+
+		lockParam.lockOffset = posVertex_;
+		lockParam.data = (void*)vertex;
+		lockParam.dataCount = countVertex;
+		lockParam.dataStride = vertexBuffer_->GetStride();
+		if (FAILED(vertexBuffer_->UpdateBuffer(&lockParam))) return false;
+
+		lockParam.lockOffset = posIndex_;
+		lockParam.data = (void*)index;
+		lockParam.dataCount = countIndex;
+		lockParam.dataStride = sizeof(uint16_t);
+		if (FAILED(indexBuffer_->UpdateBuffer(&lockParam))) return false;
+
+		*pBaseVertex = posVertex_;
+		*pStartIndex = posIndex_;
+
+		posVertex_ += countVertex;
+		posIndex_ += countIndex;
+		bDiscard_ = false;
+
+		return true;
+	}
+
+	//-----------------------------------------------------------------------------------------
+
 	VertexBufferManager* VertexBufferManager::thisBase_ = nullptr;
 	VertexBufferManager::VertexBufferManager() {
 		indexBuffer_ = nullptr;
@@ -179,6 +251,8 @@ namespace directx {
 		indexBufferGrowable_.reset();
 		vertexBuffer_HWInstancing_.reset();
 
+		arenaTLX_.reset();
+
 		for (auto& [addr, pBuffer] : mapExtraBuffer_Vertex_)
 			pBuffer.reset();
 	}
@@ -217,6 +291,9 @@ namespace directx {
 		vertexBuffer_HWInstancing_.reset(new GrowableVertexBuffer(device));
 		vertexBuffer_HWInstancing_->Setup(512U, sizeof(VERTEX_INSTANCE), 0);
 
+		arenaTLX_.reset(new TransientBufferArena(device));
+		arenaTLX_->Setup(ARENA_VERTEX_SIZE, sizeof(VERTEX_TLX), VERTEX_TLX::fvf, ARENA_INDEX_SIZE);
+
 		CreateBuffers(device);
 
 		return true;
@@ -244,6 +321,8 @@ namespace directx {
 		AssertBuffer(vertexBufferGrowable_->Create(usage, pool), L"VB_Growable");
 		AssertBuffer(indexBufferGrowable_->Create(usage, pool), L"IB_Growable");
 		AssertBuffer(vertexBuffer_HWInstancing_->Create(usage, pool), L"VB_InstanceHW");
+
+		AssertBuffer(arenaTLX_->Create(usage, pool), L"Arena_TLX");
 	}
 	void VertexBufferManager::Release() {
 		for (auto& iVB : vertexBuffers_)
@@ -253,6 +332,8 @@ namespace directx {
 		vertexBufferGrowable_->Release();
 		indexBufferGrowable_->Release();
 		vertexBuffer_HWInstancing_->Release();
+
+		arenaTLX_->Release();
 	}
 
 	BufferBase<IDirect3DVertexBuffer9>* VertexBufferManager::CreateExtraVertexBuffer() {
@@ -63,6 +63,7 @@ namespace directx {
 
 		T* GetBuffer() { return buffer_; }
 		size_t GetSize() { return size_; }
+		size_t GetStride() { return stride_; }
 		size_t GetSizeInBytes() { return size_ * stride_; }
 	protected:
 		virtual HRESULT _Create() = 0;
@@ -133,12 +134,41 @@ namespace directx {
 		D3DFORMAT format_;
 	};
 
+	//Vertex+index ring buffer for data that is only used by one draw call.
+	//	Appends lock behind the previous draws with D3DLOCK_NOOVERWRITE, both buffers
+	//	are discarded together only when either one wraps around.
+	class TransientBufferArena {
+	public:
+		TransientBufferArena(IDirect3DDevice9* device);
+		~TransientBufferArena();
+
+		void Setup(size_t countVertex, size_t strideVertex, DWORD fvf, size_t countIndex);
+		HRESULT Create(DWORD usage, D3DPOOL pool);
+		void Release();
+
+		//Returns false if the data cannot fit even in an empty arena
+		bool Append(const void* vertex, size_t countVertex, const uint16_t* index, size_t countIndex,
+			UINT* pBaseVertex, UINT* pStartIndex);
+
+		FixedVertexBuffer* GetVertexBuffer() { return vertexBuffer_.get(); }
+		FixedIndexBuffer* GetIndexBuffer() { return indexBuffer_.get(); }
+	private:
+		unique_ptr<FixedVertexBuffer> vertexBuffer_;
+		unique_ptr<FixedIndexBuffer> indexBuffer_;
+
+		size_t posVertex_;
+		size_t posIndex_;
+		bool bDiscard_;
+	};
+
 	class DirectGraphics;
 	class VertexBufferManager : public DirectGraphicsListener {
 		static VertexBufferManager* thisBase_;
 	public:
 		enum : size_t {
 			MAX_STRIDE_STATIC = 65536U,
+			ARENA_VERTEX_SIZE = 65536U * 2U,
+			ARENA_INDEX_SIZE = 65536U * 6U,
 		};
 
 		VertexBufferManager();
@@ -163,6 +193,8 @@ namespace directx {
 
 		GrowableVertexBuffer* GetInstancingVertexBuffer() { return vertexBuffer_HWInstancing_.get(); }
 
+		TransientBufferArena* GetArenaTLX() { return arenaTLX_.get(); }
+
 		static void AssertBuffer(HRESULT hr, const std::wstring& bufferID);
 		
 		BufferBase<IDirect3DVertexBuffer9>* CreateExtraVertexBuffer();
@@ -184,6 +216,8 @@ namespace directx {
 
 		unique_ptr<GrowableVertexBuffer> vertexBuffer_HWInstancing_;
 
+		unique_ptr<TransientBufferArena> arenaTLX_;
+
 		std::unordered_map<size_t, unique_ptr<BufferBase<IDirect3DVertexBuffer9>>> mapExtraBuffer_Vertex_;
 
 		virtual void CreateBuffers(IDirect3DDevice9* device);
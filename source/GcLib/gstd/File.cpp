@@ -146,8 +146,9 @@ ByteBuffer& ByteBuffer::operator=(const ByteBuffer& other) noexcept {
 //*******************************************************************
 //File
 //*******************************************************************
-std::wstring File::lastError_ = L"";
+thread_local std::wstring File::lastError_ = L"";
 std::map<std::wstring, size_t> File::mapFileUseCount_ = {};
+CriticalSection File::csFileUseCount_;
 
 bool File::CreateFileDirectory(const std::wstring& path) {
 #ifdef __L_STD_FILESYSTEM
@@ -404,6 +405,7 @@ bool File::Open(DWORD typeAccess) {
 
 	if (hFile_.is_open()) {
 #if _DEBUG
+		Lock lock(csFileUseCount_);
 		auto itr = mapFileUseCount_.find(path_);
 		if (itr != mapFileUseCount_.end())
 			++(itr->second);
@@ -417,6 +419,7 @@ bool File::Open(DWORD typeAccess) {
 void File::Close() {
 #if _DEBUG
 	if (IsOpen()) {
+		Lock lock(csFileUseCount_);
 		auto itr = mapFileUseCount_.find(path_);
 		if (itr != mapFileUseCount_.end())
 			--(itr->second);
@@ -105,8 +105,9 @@ namespace gstd {
 	//File
 	//*******************************************************************
 	class File : public Writer, public Reader {
-		static std::wstring lastError_;
+		static thread_local std::wstring lastError_;	//Per thread, so that the error read back is from this thread's Open
 		static std::map<std::wstring, size_t> mapFileUseCount_;
+		static CriticalSection csFileUseCount_;	//Files are opened from multiple threads
 	public:
 		enum AccessType : DWORD {
 			READ = 0x1,
@@ -814,6 +814,18 @@ void ByteOrder::Reverse(LPVOID buf, DWORD size) {
 	}
 }
 
+//*******************************************************************
+//HashUtility
+//*******************************************************************
+uint64_t HashUtility::Fnv1a64(const void* buf, size_t size, uint64_t hash) {
+	const byte* pData = reinterpret_cast<const byte*>(buf);
+	for (size_t i = 0; i < size; ++i) {
+		hash ^= pData[i];
+		hash *= FNV_PRIME;
+	}
+	return hash;
+}
+
 //*******************************************************************
 //PathProperty
 //*******************************************************************
@@ -506,6 +506,20 @@ namespace gstd {
 		static void Reverse(LPVOID buf, DWORD size);
 	};
 
+	//================================================================
+	//HashUtility
+	class HashUtility {
+	public:
+		static constexpr uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+		static constexpr uint64_t FNV_PRIME = 0x100000001b3ULL;
+	public:
+		//FNV-1a, for content keys of cached data; not for anything security-related
+		static uint64_t Fnv1a64(const void* buf, size_t size, uint64_t hash = FNV_OFFSET_BASIS);
+		static uint64_t Fnv1a64(const std::string& str, uint64_t hash = FNV_OFFSET_BASIS) {
+			return Fnv1a64(str.data(), str.size(), hash);
+		}
+	};
+
 	//================================================================
 	//PathProperty
 	class PathProperty {
@@ -296,6 +296,20 @@ void parser::begin_parse() {
 		engine->main_block->codes[0].arg0 = count_base_constants + stateParser.var_count_main + stateParser.var_count_sub;
 
 		_parser_assert_end(&stateParser);
+
+		for (script_block& iBlock : engine->blocks)
+			resolve_variable_access(&iBlock);
+
+		if (script_engine::option_keep_unoptimized)
+			engine->listing_unoptimized = engine->disassemble();
+		if (script_engine::option_optimize) {
+			std::map<uint32_t, value> mapConstant;
+			collect_constant_variables(mapConstant);
+			for (script_block& iBlock : engine->blocks) {
+				if (iBlock.func == nullptr)
+					optimize_block(&iBlock, mapConstant);
+			}
+		}
 	}
 	catch (parser_error& e) {
 		error = true;
@@ -1020,8 +1034,6 @@ size_t parser::_parse_array_suffix_lvalue(script_block* block, parser_state_t* s
 		parser_assert(state, state->next() != token_kind::tk_range,
 			"Array slice operation is not allowed here.\r\n");
 
-		state->AddCode(block, code(command_kind::pc_inline_index_array));
-
 		parser_assert(state, state->next() == token_kind::tk_close_bra, "\"]\" is required.\r\n");
 		state->advance();
 	}
@@ -1336,6 +1348,7 @@ void parser::parse_single_statement(script_block* block, parser_state_t* state,
 		bool isArrayElement = false;
 		size_t arrayIndexCount = 0;
 		if (s->bVariable) {
+			//Only the indices are evaluated here, the element is resolved right before the store
 			if (state->next() == token_kind::tk_open_bra) {
 				isArrayElement = true;
 				state->AddCode(block, code(command_kind::pc_push_variable2, s->level, s->var, name));
@@ -1360,8 +1373,10 @@ void parser::parse_single_statement(script_block* block, parser_state_t* state,
 					state->AddCode(block, code(command_kind::pc_inline_cast_var, (uint32_t)cvtType, true));
 			}
 
-			if (isArrayElement)
+			if (isArrayElement) {
+				state->AddCode(block, code(command_kind::pc_inline_index_array, arrayIndexCount, 1));
 				state->AddCode(block, code(command_kind::pc_ref_assign));
+			}
 			else 
 				state->AddCode(block, code(command_kind::pc_copy_assign, s->level, s->var, name));
 			break;
@@ -1390,8 +1405,10 @@ void parser::parse_single_statement(script_block* block, parser_state_t* state,
 #undef DEF_CASE
 			state->advance();
 			parse_expression(block, state);
-			if (isArrayElement)
+			if (isArrayElement) {
+				state->AddCode(block, code(command_kind::pc_inline_index_array, arrayIndexCount, 1));
 				state->AddCode(block, code(f, false, name));
+			}
 			else
 				state->AddCode(block, code(f, true, MAKE_ARG1_LEVEL_VAR(s->level, s->var), name));
 			break;
@@ -1403,8 +1420,10 @@ void parser::parse_single_statement(script_block* block, parser_state_t* state,
 			command_kind f = (state->next() == token_kind::tk_inc) ? command_kind::pc_inline_inc
 				: command_kind::pc_inline_dec;
 			state->advance();
-			if (isArrayElement)
+			if (isArrayElement) {
+				state->AddCode(block, code(command_kind::pc_inline_index_array, arrayIndexCount, 0));
 				state->AddCode(block, code(f, false, true, name));
+			}
 			else
 				state->AddCode(block, code(f, true, MAKE_ARG1_LEVEL_VAR(s->level, s->var), name));
 			break;
@@ -1691,9 +1710,10 @@ void parser::parse_single_statement(script_block* block, parser_state_t* state,
 				"\"in\" or a colon is required.\r\n");
 			state->advance();
 
-			bool bMakeArrayUnique = true;
+			//Without "ref", the loop iterates over the array as it was when the loop started
+			bool bRefArray = false;
 			if (state->next() == token_kind::tk_decl_mod_ref) {
-				bMakeArrayUnique = false;
+				bRefArray = true;
 				state->advance();
 			}
 
@@ -1701,9 +1721,25 @@ void parser::parse_single_statement(script_block* block, parser_state_t* state,
 			state->AddCode(block, code(command_kind::pc_var_format, 0U, 0));
 
 			//The array
-			parse_expression(block, state);
-			if (bMakeArrayUnique)
-				state->AddCode(block, code(command_kind::pc_make_unique, 0));
+			{
+				//With "ref", a variable is iterated through a pointer to it, so writes made in the body are seen
+				symbol* sRef = nullptr;
+				if (bRefArray && state->next() == token_kind::tk_word) {
+					script_scanner lex_tmp(*state->lex);
+					lex_tmp.advance();
+					if (lex_tmp.next == token_kind::tk_close_par) {
+						sRef = search(state->lex->word);
+						if (sRef && !sRef->bVariable)
+							sRef = nullptr;
+					}
+				}
+
+				if (sRef) {
+					state->AddCode(block, code(command_kind::pc_push_variable2, sRef->level, sRef->var, state->lex->word));
+					state->advance();
+				}
+				else parse_expression(block, state);
+			}
 
 			parser_assert(state, state->next() == token_kind::tk_close_par, "\")\" is required.\r\n");
 			state->advance();
@@ -2294,19 +2330,16 @@ void parser::parse_single_statement(script_block* block, parser_state_t* state,
 					totalVar = 1;
 				}
 
+				//Arguments take the variable slots right after the return value, 
+				//	pc_call moves them there directly from the caller's stack
+				uint32_t argBase = totalVar;
+
 				totalVar += scan_current_scope(&newState, s->sub->level, totalVar, &s->argData);
-				newState.AddCode(s->sub, code(command_kind::pc_var_alloc, 0));
+				newState.AddCode(s->sub, code(command_kind::pc_var_alloc, 0, argBase));
 
 				newState.var_count_main = totalVar;
 			}
 
-			//Function arguments
-			for (const auto& iArg : s->argData) {
-				symbol* sVar = search(iArg.name);
-				//No need to type-convert arguments here
-				newState.AddCode(s->sub, code(command_kind::pc_copy_assign,
-					sVar->level, sVar->var, iArg.name));
-			}
 			parse_statements(s->sub, &newState, token_kind::tk_close_cur, token_kind::tk_semicolon);
 			scan_final(s->sub, &newState);
 
@@ -2626,6 +2659,47 @@ lab_opt_construct_array_cancel:
 
 	block->codes = newCodes;
 }
+//Replaces variable levels with VAR_LEVEL_LOCAL or VAR_LEVEL_GLOBAL where possible,
+//	so that the machine can skip walking up the environment chain
+void parser::resolve_variable_access(script_block* block) {
+	auto _Resolve = [&](uint32_t level) -> uint32_t {
+		//Inner blocks are inlined, so the block's own level is always the executing environment
+		if (level == block->level) return VAR_LEVEL_LOCAL;
+		//Only the main block has level 1, its environment is the root of every chain
+		if (level == 1) return VAR_LEVEL_GLOBAL;
+		//Enclosing levels stay a search: a call's environment is parented to the caller's, not the owner's,
+		//	so the depth to the owning block depends on the call site (recursion, calls from sibling functions).
+		//	A static (depth, slot) would need a lexical parent link in environment::init, which changes which
+		//	environment a level resolves to and is left for later. script/variable_access measured
+		//	Local, Global and Enclosing within 1% of each other (~1.72ms per 10000 increments), the walk is short.
+		return level;
+	};
+
+	for (code& iCode : block->codes) {
+		switch (iCode.GetOp()) {
+		case command_kind::pc_push_variable:
+		case command_kind::pc_push_variable2:
+		case command_kind::pc_copy_assign:
+			iCode.arg0 = _Resolve(iCode.arg0);
+			break;
+		case command_kind::pc_inline_inc:
+		case command_kind::pc_inline_dec:
+		case command_kind::pc_inline_add_asi:
+		case command_kind::pc_inline_sub_asi:
+		case command_kind::pc_inline_mul_asi:
+		case command_kind::pc_inline_div_asi:
+		case command_kind::pc_inline_fdiv_asi:
+		case command_kind::pc_inline_mod_asi:
+		case command_kind::pc_inline_pow_asi:
+		case command_kind::pc_inline_cat_asi:
+			if (iCode.arg0) {
+				uint32_t level = _Resolve((iCode.arg1 & 0xfff00000) >> 20);
+				iCode.arg1 = (level << 20) | (iCode.arg1 & 0x000fffff);
+			}
+			break;
+		}
+	}
+}
 //Links jump commands with their matching jump targets
 void parser::link_jump(script_block* block, parser_state_t* state, size_t ip_off) {
 	std::vector<code> newCodes;
@@ -2697,4 +2771,470 @@ void parser::scan_final(script_block* block, parser_state_t* state) {
 		parser_assert(itr->GetLine(), itr->GetOp() != command_kind::pc_loop_continue,
 			"\"continue\" may only be used inside a loop.");
 	}
-}
\ No newline at end of file
+}
+bool parser::_parser_is_jump(command_kind c) {
+	switch (c) {
+	case command_kind::pc_jump:
+	case command_kind::pc_jump_if:
+	case command_kind::pc_jump_if_not:
+	case command_kind::pc_jump_if_nopop:
+	case command_kind::pc_jump_if_not_nopop:
+		return true;
+	}
+	return false;
+}
+bool parser::_parser_is_foldable_value(const value& v) {
+	type_data* type = v.get_type();
+	if (type == nullptr) return false;
+	if (type == script_type_manager::get_string_type()) return true;
+	switch (type->get_kind()) {
+	case type_data::tk_int:
+	case type_data::tk_float:
+	case type_data::tk_char:
+	case type_data::tk_boolean:
+		return true;
+	}
+	return false;
+}
+std::vector<bool> parser::_parser_get_jump_targets(const std::vector<code>& codes) {
+	std::vector<bool> res(codes.size() + 1, false);
+	for (const code& iCode : codes) {
+		if (_parser_is_jump(iCode.GetOp()) && iCode.arg0 <= codes.size())
+			res[iCode.arg0] = true;
+	}
+	return res;
+}
+
+//Finds the writes in the straight-line start of the main block that no read of the same variable can come before
+//	The scan stops at the first branch, jump target, yield or call into script code, as anything after that
+//	may run in a different order. Builtin calls can't read script variables, so they don't stop it.
+std::set<const code*> parser::get_dominating_writes(script_block* block) {
+	std::set<const code*> res;
+	std::set<uint32_t> setRead;
+
+	std::vector<code>& codes = block->codes;
+	std::vector<bool> listTarget = _parser_get_jump_targets(codes);
+
+	for (size_t ip = 0; ip < codes.size(); ++ip) {
+		const code& c = codes[ip];
+		if (listTarget[ip]) break;
+
+		command_kind op = c.GetOp();
+		if (_parser_is_jump(op)) break;
+		switch (op) {
+		case command_kind::pc_yield:
+		case command_kind::pc_wait:
+		case command_kind::pc_sub_return:
+			return res;
+		case command_kind::pc_call:
+		case command_kind::pc_call_and_push_result:
+			if (c.block == block_const_reg) {
+				//Only literal writes, see load_constants
+				for (const code& iCode : block_const_reg->codes) {
+					if (iCode.GetOp() == command_kind::pc_copy_assign)
+						res.insert(&iCode);
+				}
+				break;
+			}
+			if (c.block->func == nullptr || c.block->func == BaseFunction::invoke)
+				return res;
+			break;
+		case command_kind::pc_push_variable:
+		case command_kind::pc_push_variable2:
+			setRead.insert(c.arg1);
+			break;
+		case command_kind::pc_copy_assign:
+			if (setRead.find(c.arg1) == setRead.end())
+				res.insert(&c);
+			break;
+		}
+	}
+	return res;
+}
+
+//Finds the global variables that are written exactly once, with a literal value, and never have their address taken
+//	Reads of those can be replaced by the literal itself, this includes every engine constant
+//	The write must also come before every read, see get_dominating_writes
+void parser::collect_constant_variables(std::map<uint32_t, value>& res) {
+	std::map<uint32_t, size_t> mapWriteCount;
+	std::map<uint32_t, const code*> mapWriteSource;
+
+	std::set<const code*> setDominating = get_dominating_writes(engine->main_block);
+
+	for (script_block& iBlock : engine->blocks) {
+		if (iBlock.func) continue;
+
+		bool bMain = &iBlock == engine->main_block;
+		auto _IsGlobal = [&](uint32_t level) -> bool {
+			return level == VAR_LEVEL_GLOBAL || (bMain && level == VAR_LEVEL_LOCAL);
+		};
+		auto _Disqualify = [&](uint32_t var) {
+			mapWriteCount[var] += 2;
+		};
+
+		std::vector<code>& codes = iBlock.codes;
+		std::vector<bool> listTarget = _parser_get_jump_targets(codes);
+
+		for (size_t ip = 0; ip < codes.size(); ++ip) {
+			const code& c = codes[ip];
+			switch (c.GetOp()) {
+			case command_kind::pc_copy_assign:
+			{
+				if (!_IsGlobal(c.arg0)) break;
+				++mapWriteCount[c.arg1];
+
+				//The pushed value must be the only one that can reach the assignment,
+				//	a declaration's cast in between is skipped if the literal already has that type
+				const code* pSource = nullptr;
+				if (setDominating.find(&c) != setDominating.end()) {
+					size_t ipSource = ip;
+					if (ipSource > 1 && !listTarget[ipSource]
+						&& codes[ipSource - 1].GetOp() == command_kind::pc_inline_cast_var
+						&& codes[ipSource - 2].GetOp() == command_kind::pc_push_value
+						&& (type_data*)codes[ipSource - 1].arg0 == codes[ipSource - 2].data.get_type())
+						--ipSource;
+					if (ipSource > 0 && !listTarget[ipSource] && codes[ipSource - 1].GetOp() == command_kind::pc_push_value)
+						pSource = &codes[ipSource - 1];
+				}
+				mapWriteSource[c.arg1] = pSource;
+				break;
+			}
+			case command_kind::pc_push_variable2:
+				if (_IsGlobal(c.arg0))
+					_Disqualify(c.arg1);
+				break;
+			case command_kind::pc_inline_inc:
+			case command_kind::pc_inline_dec:
+			case command_kind::pc_inline_add_asi:
+			case command_kind::pc_inline_sub_asi:
+			case command_kind::pc_inline_mul_asi:
+			case command_kind::pc_inline_div_asi:
+			case command_kind::pc_inline_fdiv_asi:
+			case command_kind::pc_inline_mod_asi:
+			case command_kind::pc_inline_pow_asi:
+			case command_kind::pc_inline_cat_asi:
+				if (c.arg0 && _IsGlobal((c.arg1 & 0xfff00000) >> 20))
+					_Disqualify(c.arg1 & 0x000fffff);
+				break;
+			case command_kind::pc_var_format:
+				//Variables of blocks inlined into the main block are globals that get reset on every entry
+				if (bMain) {
+					for (size_t i = c.arg0; i < c.arg0 + c.arg1; ++i)
+						_Disqualify(i);
+				}
+				break;
+			}
+		}
+	}
+
+	for (auto& [var, count] : mapWriteCount) {
+		if (count != 1) continue;
+		const code* pSource = mapWriteSource[var];
+		if (pSource && _parser_is_foldable_value(pSource->data))
+			res[var] = pSource->data;
+	}
+}
+
+//Whole-block optimization over the linked bytecode:
+//	- Propagates constant globals
+//	- Folds operations and pure builtin calls on literal operands, and branches on literal conditions
+//	- Threads jumps to unconditional jumps
+//	- Removes unreachable code and jumps to the next reachable instruction
+void parser::optimize_block(script_block* block, const std::map<uint32_t, value>& mapConstant) {
+	bool bMain = block == engine->main_block;
+
+	if (mapConstant.size() > 0) {
+		for (code& iCode : block->codes) {
+			if (iCode.GetOp() != command_kind::pc_push_variable) continue;
+			if (iCode.arg0 != VAR_LEVEL_GLOBAL && !(bMain && iCode.arg0 == VAR_LEVEL_LOCAL)) continue;
+
+			auto itrFind = mapConstant.find(iCode.arg1);
+			if (itrFind != mapConstant.end())
+				iCode = code(iCode.GetLine(), command_kind::pc_push_value, itrFind->second);
+		}
+	}
+
+	//----------------------------------------------------------------------
+	//Folding
+
+	{
+		const std::vector<code>& codes = block->codes;
+		std::vector<bool> listTarget = _parser_get_jump_targets(codes);
+
+		std::vector<code> newCodes;
+		std::vector<bool> listNewTarget;
+		std::vector<size_t> mapIp(codes.size() + 1);
+		newCodes.reserve(codes.size());
+		listNewTarget.reserve(codes.size());
+
+		bool bPendingTarget = false;
+		auto _Emit = [&](const code& c, bool bTarget) {
+			newCodes.push_back(c);
+			listNewTarget.push_back(bTarget || bPendingTarget);
+			bPendingTarget = false;
+		};
+		//Checks that the last [count] emitted codes are literals that can only be reached in sequence,
+		//	the first of them may still be a jump target as the folded result takes its place
+		auto _HasLiteralOperands = [&](size_t count) -> bool {
+			if (bPendingTarget || newCodes.size() < count) return false;
+			for (size_t i = 0; i < count; ++i) {
+				size_t pos = newCodes.size() - count + i;
+				if (newCodes[pos].GetOp() != command_kind::pc_push_value) return false;
+				if (i > 0 && listNewTarget[pos]) return false;
+				if (!_parser_is_foldable_value(newCodes[pos].data)) return false;
+			}
+			return true;
+		};
+		auto _PopOperands = [&](size_t count) {
+			if (count > 0)
+				bPendingTarget = listNewTarget[newCodes.size() - count];
+			for (size_t i = 0; i < count; ++i) {
+				newCodes.pop_back();
+				listNewTarget.pop_back();
+			}
+		};
+
+		for (size_t ip = 0; ip < codes.size(); ++ip) {
+			const code& c = codes[ip];
+			command_kind op = c.GetOp();
+			mapIp[ip] = newCodes.size();
+
+			if (listTarget[ip]) {
+				_Emit(c, true);
+				continue;
+			}
+
+			bool bFolded = false;
+			try {
+				switch (op) {
+				case command_kind::pc_inline_neg:
+				case command_kind::pc_inline_not:
+				case command_kind::pc_inline_abs:
+				{
+					if (!_HasLiteralOperands(1)) break;
+					const value* argv = &newCodes.back().data;
+					value res;
+					switch (op) {
+					case command_kind::pc_inline_neg:
+						res = BaseFunction::_script_negative(1, argv);
+						break;
+					case command_kind::pc_inline_not:
+						res = BaseFunction::_script_not_(1, argv);
+						break;
+					case command_kind::pc_inline_abs:
+						res = BaseFunction::_script_absolute(1, argv);
+						break;
+					}
+					_PopOperands(1);
+					_Emit(code(c.GetLine(), command_kind::pc_push_value, res), false);
+					bFolded = true;
+					break;
+				}
+				case command_kind::pc_inline_add:
+				case command_kind::pc_inline_sub:
+				case command_kind::pc_inline_mul:
+				case command_kind::pc_inline_div:
+				case command_kind::pc_inline_fdiv:
+				case command_kind::pc_inline_mod:
+				case command_kind::pc_inline_pow:
+				case command_kind::pc_inline_cmp_e:
+				case command_kind::pc_inline_cmp_g:
+				case command_kind::pc_inline_cmp_ge:
+				case command_kind::pc_inline_cmp_l:
+				case command_kind::pc_inline_cmp_le:
+				case command_kind::pc_inline_cmp_ne:
+				case command_kind::pc_inline_logic_and:
+				case command_kind::pc_inline_logic_or:
+				{
+					if (!_HasLiteralOperands(2)) break;
+					value argv[] = { newCodes[newCodes.size() - 2].data, newCodes.back().data };
+					value res;
+					switch (op) {
+					case command_kind::pc_inline_add:
+						res = BaseFunction::_script_add(2, argv);
+						break;
+					case command_kind::pc_inline_sub:
+						res = BaseFunction::_script_subtract(2, argv);
+						break;
+					case command_kind::pc_inline_mul:
+						res = BaseFunction::_script_multiply(2, argv);
+						break;
+					case command_kind::pc_inline_div:
+						res = BaseFunction::_script_divide(2, argv);
+						break;
+					case command_kind::pc_inline_fdiv:
+						res = BaseFunction::_script_fdivide(2, argv);
+						break;
+					case command_kind::pc_inline_mod:
+						res = BaseFunction::_script_remainder_(2, argv);
+						break;
+					case command_kind::pc_inline_pow:
+						res = BaseFunction::_script_power(2, argv);
+						break;
+					case command_kind::pc_inline_logic_and:
+						res = value(script_type_manager::get_boolean_type(), argv[0].as_boolean() && argv[1].as_boolean());
+						break;
+					case command_kind::pc_inline_logic_or:
+						res = value(script_type_manager::get_boolean_type(), argv[0].as_boolean() || argv[1].as_boolean());
+						break;
+					default:
+					{
+						int64_t r = BaseFunction::_script_compare(2, argv).as_int();
+						bool b = false;
+						switch (op) {
+						case command_kind::pc_inline_cmp_e: b = r == 0; break;
+						case command_kind::pc_inline_cmp_g: b = r > 0; break;
+						case command_kind::pc_inline_cmp_ge: b = r >= 0; break;
+						case command_kind::pc_inline_cmp_l: b = r < 0; break;
+						case command_kind::pc_inline_cmp_le: b = r <= 0; break;
+						case command_kind::pc_inline_cmp_ne: b = r != 0; break;
+						}
+						res = value(script_type_manager::get_boolean_type(), b);
+						break;
+					}
+					}
+					_PopOperands(2);
+					_Emit(code(c.GetLine(), command_kind::pc_push_value, res), false);
+					bFolded = true;
+					break;
+				}
+				case command_kind::pc_call_and_push_result:
+				{
+					script_block* sub = c.block;
+					if (sub->func == nullptr || !script_pure_functions::contains(sub->func)) break;
+					if (!_HasLiteralOperands(c.arg1)) break;
+
+					std::vector<value> argv;
+					for (size_t i = newCodes.size() - c.arg1; i < newCodes.size(); ++i)
+						argv.push_back(newCodes[i].data);
+
+					value res = sub->func(nullptr, c.arg1, argv.data());
+					if (!_parser_is_foldable_value(res)) break;
+
+					_PopOperands(c.arg1);
+					_Emit(code(c.GetLine(), command_kind::pc_push_value, res), false);
+					bFolded = true;
+					break;
+				}
+				case command_kind::pc_jump_if:
+				case command_kind::pc_jump_if_not:
+				{
+					if (!_HasLiteralOperands(1)) break;
+					bool bTaken = newCodes.back().data.as_boolean() == (op == command_kind::pc_jump_if);
+					_PopOperands(1);
+					if (bTaken)
+						_Emit(code(c.GetLine(), command_kind::pc_jump, c.arg0), false);
+					bFolded = true;
+					break;
+				}
+				case command_kind::pc_jump_if_nopop:
+				case command_kind::pc_jump_if_not_nopop:
+				{
+					if (!_HasLiteralOperands(1)) break;
+					bool bTaken = newCodes.back().data.as_boolean() == (op == command_kind::pc_jump_if_nopop);
+					if (bTaken)
+						_Emit(code(c.GetLine(), command_kind::pc_jump, c.arg0), false);
+					bFolded = true;
+					break;
+				}
+				}
+			}
+			catch (...) {
+				//Leave the error to be raised at runtime, if the code is ever reached
+				bFolded = false;
+			}
+
+			if (!bFolded)
+				_Emit(c, false);
+		}
+		mapIp[codes.size()] = newCodes.size();
+
+		for (code& iCode : newCodes) {
+			if (_parser_is_jump(iCode.GetOp()))
+				iCode.arg0 = mapIp[iCode.arg0];
+		}
+		block->codes = newCodes;
+	}
+
+	//----------------------------------------------------------------------
+	//Jump threading, reachability, compaction
+
+	{
+		std::vector<code>& codes = block->codes;
+		size_t countCode = codes.size();
+
+		for (code& iCode : codes) {
+			if (!_parser_is_jump(iCode.GetOp())) continue;
+			for (size_t iHop = 0; iHop < 16; ++iHop) {
+				size_t dest = iCode.arg0;
+				if (dest >= countCode || codes[dest].GetOp() != command_kind::pc_jump || codes[dest].arg0 == dest)
+					break;
+				iCode.arg0 = codes[dest].arg0;
+			}
+		}
+
+		std::vector<bool> listReachable(countCode, false);
+		{
+			std::vector<size_t> listWork;
+			listWork.push_back(0);
+			while (listWork.size() > 0) {
+				size_t ip = listWork.back();
+				listWork.pop_back();
+				if (ip >= countCode || listReachable[ip]) continue;
+				listReachable[ip] = true;
+
+				const code& c = codes[ip];
+				switch (c.GetOp()) {
+				case command_kind::pc_sub_return:
+					break;
+				case command_kind::pc_jump:
+					listWork.push_back(c.arg0);
+					break;
+				case command_kind::pc_jump_if:
+				case command_kind::pc_jump_if_not:
+				case command_kind::pc_jump_if_nopop:
+				case command_kind::pc_jump_if_not_nopop:
+					listWork.push_back(c.arg0);
+					listWork.push_back(ip + 1);
+					break;
+				default:
+					listWork.push_back(ip + 1);
+					break;
+				}
+			}
+		}
+
+		//A jump over nothing but dead code is a no-op
+		for (size_t ip = 0; ip < countCode; ++ip) {
+			const code& c = codes[ip];
+			if (!listReachable[ip] || c.GetOp() != command_kind::pc_jump || c.arg0 <= ip) continue;
+			bool bRemovable = true;
+			for (size_t i = ip + 1; i < c.arg0 && i < countCode; ++i) {
+				if (listReachable[i]) {
+					bRemovable = false;
+					break;
+				}
+			}
+			if (bRemovable)
+				listReachable[ip] = false;
+		}
+
+		std::vector<size_t> mapIp(countCode + 1);
+		std::vector<code> newCodes;
+		newCodes.reserve(countCode);
+		for (size_t ip = 0; ip < countCode; ++ip) {
+			mapIp[ip] = newCodes.size();
+			if (listReachable[ip])
+				newCodes.push_back(codes[ip]);
+		}
+		mapIp[countCode] = newCodes.size();
+
+		if (newCodes.size() != countCode) {
+			for (code& iCode : newCodes) {
+				if (_parser_is_jump(iCode.GetOp()))
+					iCode.arg0 = mapIp[iCode.arg0];
+			}
+			codes = newCodes;
+		}
+	}
+}
@@ -11,7 +11,7 @@ namespace gstd {
 		pc_yield,				//Transfer control to next thread
 		pc_wait,				//Set nWait to ({esp-0} - 1), and cause thread to do pc_yield until (nWait-- == 0)
 
-		pc_var_alloc,			//Resize variable array to [arg0]
+		pc_var_alloc,			//Resize variable array to [arg0], arguments from pc_call are placed starting at [arg1]
 		pc_var_format,			//Set variable array (from=[arg0], length=[arg1]) to empty
 
 		pc_pop,					//Pop [arg0] values from stack
@@ -100,7 +100,7 @@ namespace gstd {
 		pc_inline_logic_or,		//Push ({esp-1} || {esp-0}) to stack
 
 		pc_inline_cast_var,			//Cast {esp-0} to (type_data*)[arg0], check type conversion if [arg1]
-		pc_inline_index_array,		//Push &((*{esp-1})[{esp-0}]) to stack
+		pc_inline_index_array,		//Replace [ptr] [i0]...[i(arg0-1)] below the top [arg1] values with &((*ptr)[i0]...), detaching each level
 		pc_inline_index_array2,		//Push ({esp-1}[{esp-0}]) to stack
 		pc_inline_length_array,		//Push length({esp-0}) to stack
 
@@ -110,6 +110,11 @@ namespace gstd {
 		bk_normal, bk_sub, bk_function, bk_microthread
 	};
 
+	//Variable levels that parser::resolve_variable_access substitutes when the owning environment is known statically
+	//	Must fit in the 12-bit level field of the packed inline operations
+	constexpr uint32_t VAR_LEVEL_LOCAL = 0xfff;		//Variable of the executing block itself
+	constexpr uint32_t VAR_LEVEL_GLOBAL = 0xffe;	//Variable of the main block
+
 	struct code;
 	struct script_block {
 		uint32_t level;
@@ -325,11 +330,16 @@ namespace gstd {
 		void write_operation(script_block* block, parser_state_t* state, const symbol* s, int clauses);
 
 		void optimize_expression(script_block* block, parser_state_t* state);
+		void resolve_variable_access(script_block* block);
 		void link_jump(script_block* block, parser_state_t* state, size_t ip_off);
 		void link_break_continue(script_block* block, parser_state_t* state, 
 			size_t ip_begin, size_t ip_end, size_t ip_break, size_t ip_continue);
 		void scan_final(script_block* block, parser_state_t* state);
 
+		std::set<const code*> get_dominating_writes(script_block* block);
+		void collect_constant_variables(std::map<uint32_t, value>& res);
+		void optimize_block(script_block* block, const std::map<uint32_t, value>& mapConstant);
+
 		inline static void parser_assert(bool expr, const std::wstring& error);
 		inline static void parser_assert(bool expr, const std::string& error);
 		inline static void parser_assert(parser_state_t* state, bool expr, const std::wstring& error);
@@ -341,6 +351,10 @@ namespace gstd {
 		static void _parser_assert_end(parser_state_t* state);
 		static void _parser_assert_nend(parser_state_t* state);
 
+		static bool _parser_is_jump(command_kind c);
+		static bool _parser_is_foldable_value(const value& v);
+		static std::vector<bool> _parser_get_jump_targets(const std::vector<code>& codes);
+
 		inline static bool test_variadic(int require, int argc);
 		inline static bool IsDeclToken(token_kind tk);
 
@@ -1,5 +1,7 @@
 #include "source/GcLib/pch.h"
 
+#include <intrin.h>
+
 #include "../GstdUtility.hpp"
 #include "Script.hpp"
 #include "ScriptLexer.hpp"
@@ -56,6 +58,10 @@ type_data* script_type_manager::get_array_type(type_data* element) {
 //****************************************************************************
 //script_engine
 //****************************************************************************
+bool script_engine::option_optimize = true;
+bool script_engine::option_keep_unoptimized = false;
+bool script_engine::option_fast_path = true;
+
 script_engine::script_engine(const std::wstring& source, std::vector<function>* list_func, std::vector<constant>* list_const) {
 	init(source.data(), source.data() + source.size(), list_func, list_const);
 }
@@ -95,6 +101,387 @@ script_block* script_engine::new_block(int level, block_kind kind) {
 	return &*blocks.insert(blocks.end(), x);
 }
 
+const char* script_engine::get_command_name(command_kind op) {
+	switch (op) {
+#define DEF_CASE(cmd) case command_kind::cmd: return #cmd;
+		DEF_CASE(pc_yield);
+		DEF_CASE(pc_wait);
+		DEF_CASE(pc_var_alloc);
+		DEF_CASE(pc_var_format);
+		DEF_CASE(pc_pop);
+		DEF_CASE(pc_push_value);
+		DEF_CASE(pc_push_variable);
+		DEF_CASE(pc_push_variable2);
+		DEF_CASE(pc_dup_n);
+		DEF_CASE(pc_swap);
+		DEF_CASE(pc_load_ptr);
+		DEF_CASE(pc_unload_ptr);
+		DEF_CASE(pc_make_unique);
+		DEF_CASE(pc_copy_assign);
+		DEF_CASE(pc_ref_assign);
+		DEF_CASE(pc_sub_return);
+		DEF_CASE(pc_call);
+		DEF_CASE(pc_call_and_push_result);
+		DEF_CASE(pc_jump);
+		DEF_CASE(pc_jump_if);
+		DEF_CASE(pc_jump_if_not);
+		DEF_CASE(pc_jump_if_nopop);
+		DEF_CASE(pc_jump_if_not_nopop);
+		DEF_CASE(pc_jump_target);
+		DEF_CASE(_pc_jump);
+		DEF_CASE(_pc_jump_if);
+		DEF_CASE(_pc_jump_if_not);
+		DEF_CASE(_pc_jump_if_nopop);
+		DEF_CASE(_pc_jump_if_not_nopop);
+		DEF_CASE(pc_compare_e);
+		DEF_CASE(pc_compare_g);
+		DEF_CASE(pc_compare_ge);
+		DEF_CASE(pc_compare_l);
+		DEF_CASE(pc_compare_le);
+		DEF_CASE(pc_compare_ne);
+		DEF_CASE(pc_loop_ascent);
+		DEF_CASE(pc_loop_descent);
+		DEF_CASE(pc_loop_count);
+		DEF_CASE(pc_loop_foreach);
+		DEF_CASE(pc_loop_continue);
+		DEF_CASE(pc_loop_break);
+		DEF_CASE(pc_construct_array);
+		DEF_CASE(pc_inline_inc);
+		DEF_CASE(pc_inline_dec);
+		DEF_CASE(pc_inline_add_asi);
+		DEF_CASE(pc_inline_sub_asi);
+		DEF_CASE(pc_inline_mul_asi);
+		DEF_CASE(pc_inline_div_asi);
+		DEF_CASE(pc_inline_fdiv_asi);
+		DEF_CASE(pc_inline_mod_asi);
+		DEF_CASE(pc_inline_pow_asi);
+		DEF_CASE(pc_inline_cat_asi);
+		DEF_CASE(pc_inline_neg);
+		DEF_CASE(pc_inline_not);
+		DEF_CASE(pc_inline_abs);
+		DEF_CASE(pc_inline_add);
+		DEF_CASE(pc_inline_sub);
+		DEF_CASE(pc_inline_mul);
+		DEF_CASE(pc_inline_div);
+		DEF_CASE(pc_inline_fdiv);
+		DEF_CASE(pc_inline_mod);
+		DEF_CASE(pc_inline_pow);
+		DEF_CASE(pc_inline_app);
+		DEF_CASE(pc_inline_cat);
+		DEF_CASE(pc_inline_cmp_e);
+		DEF_CASE(pc_inline_cmp_g);
+		DEF_CASE(pc_inline_cmp_ge);
+		DEF_CASE(pc_inline_cmp_l);
+		DEF_CASE(pc_inline_cmp_le);
+		DEF_CASE(pc_inline_cmp_ne);
+		DEF_CASE(pc_inline_logic_and);
+		DEF_CASE(pc_inline_logic_or);
+		DEF_CASE(pc_inline_cast_var);
+		DEF_CASE(pc_inline_index_array);
+		DEF_CASE(pc_inline_index_array2);
+		DEF_CASE(pc_inline_length_array);
+		DEF_CASE(pc_nop);
+#undef DEF_CASE
+	}
+	return "(unknown)";
+}
+std::string script_engine::disassemble_block(script_block* block) {
+	auto _FormatVariable = [](uint32_t level, uint32_t var) -> std::string {
+		if (level == VAR_LEVEL_LOCAL)
+			return StringUtility::Format("local[%u]", var);
+		else if (level == VAR_LEVEL_GLOBAL)
+			return StringUtility::Format("global[%u]", var);
+		return StringUtility::Format("level%u[%u]", level, var);
+	};
+
+	std::string res = StringUtility::Format("%s \"%s\" (level=%u, args=%u, codes=%u)\n",
+		block->kind == block_kind::bk_function ? "function" :
+		block->kind == block_kind::bk_microthread ? "task" :
+		block->kind == block_kind::bk_sub ? "sub" : "block",
+		block->name.c_str(), block->level, block->arguments, block->codes.size());
+
+	for (size_t ip = 0; ip < block->codes.size(); ++ip) {
+		const code& c = block->codes[ip];
+		command_kind op = c.GetOp();
+
+		std::string operand;
+		switch (op) {
+		case command_kind::pc_var_alloc:
+			operand = StringUtility::Format("%u, args at %u", (uint32_t)c.arg0, c.arg1);
+			break;
+		case command_kind::pc_var_format:
+			operand = StringUtility::Format("%u, %u", (uint32_t)c.arg0, c.arg1);
+			break;
+		case command_kind::pc_inline_index_array:
+			operand = StringUtility::Format("indices=%u, above=%u", (uint32_t)c.arg0, c.arg1);
+			break;
+		case command_kind::pc_pop:
+		case command_kind::pc_dup_n:
+		case command_kind::pc_load_ptr:
+		case command_kind::pc_unload_ptr:
+		case command_kind::pc_make_unique:
+		case command_kind::pc_construct_array:
+			operand = StringUtility::Format("%u", (uint32_t)c.arg0);
+			break;
+		case command_kind::pc_push_value:
+		{
+			type_data* type = c.data.get_type();
+			operand = type_data::string_representation(type) + " ";
+			if (type == script_type_manager::get_string_type())
+				operand += "\"" + StringUtility::ConvertWideToMulti(c.data.as_string()) + "\"";
+			else
+				operand += StringUtility::ConvertWideToMulti(c.data.as_string());
+			break;
+		}
+		case command_kind::pc_push_variable:
+		case command_kind::pc_push_variable2:
+		case command_kind::pc_copy_assign:
+			operand = _FormatVariable(c.arg0, c.arg1);
+			break;
+		case command_kind::pc_call:
+		case command_kind::pc_call_and_push_result:
+			operand = StringUtility::Format("%s%s, argc=%u", c.block->func ? "builtin " : "",
+				c.block->name.c_str(), c.arg1);
+			break;
+		case command_kind::pc_jump:
+		case command_kind::pc_jump_if:
+		case command_kind::pc_jump_if_not:
+		case command_kind::pc_jump_if_nopop:
+		case command_kind::pc_jump_if_not_nopop:
+			operand = StringUtility::Format("-> %u", (uint32_t)c.arg0);
+			break;
+		case command_kind::pc_inline_inc:
+		case command_kind::pc_inline_dec:
+		case command_kind::pc_inline_add_asi:
+		case command_kind::pc_inline_sub_asi:
+		case command_kind::pc_inline_mul_asi:
+		case command_kind::pc_inline_div_asi:
+		case command_kind::pc_inline_fdiv_asi:
+		case command_kind::pc_inline_mod_asi:
+		case command_kind::pc_inline_pow_asi:
+		case command_kind::pc_inline_cat_asi:
+			if (c.arg0)
+				operand = _FormatVariable((c.arg1 & 0xfff00000) >> 20, c.arg1 & 0x000fffff);
+			else
+				operand = StringUtility::Format("stack, %u", c.arg1);
+			break;
+		case command_kind::pc_inline_cast_var:
+			operand = type_data::string_representation((type_data*)c.arg0) + (c.arg1 ? ", checked" : "");
+			break;
+		}
+
+		res += StringUtility::Format("%6u  line %5u  %-24s %s\n", ip, c.GetLine(), get_command_name(op), operand.c_str());
+	}
+	return res;
+}
+std::string script_engine::disassemble() {
+	std::string res;
+	for (script_block& iBlock : blocks) {
+		if (iBlock.func) continue;
+		res += disassemble_block(&iBlock);
+		res += "\n";
+	}
+	return res;
+}
+
+//Change in stack size after the command runs, upper bound where it depends on the operands
+int script_engine::get_stack_effect(const code& c) {
+	switch (c.GetOp()) {
+	case command_kind::pc_wait:
+	case command_kind::pc_copy_assign:
+	case command_kind::pc_jump_if:
+	case command_kind::pc_jump_if_not:
+	case command_kind::pc_inline_add:
+	case command_kind::pc_inline_sub:
+	case command_kind::pc_inline_mul:
+	case command_kind::pc_inline_div:
+	case command_kind::pc_inline_fdiv:
+	case command_kind::pc_inline_mod:
+	case command_kind::pc_inline_pow:
+	case command_kind::pc_inline_app:
+	case command_kind::pc_inline_cat:
+	case command_kind::pc_inline_cmp_e:
+	case command_kind::pc_inline_cmp_g:
+	case command_kind::pc_inline_cmp_ge:
+	case command_kind::pc_inline_cmp_l:
+	case command_kind::pc_inline_cmp_le:
+	case command_kind::pc_inline_cmp_ne:
+	case command_kind::pc_inline_logic_and:
+	case command_kind::pc_inline_logic_or:
+	case command_kind::pc_inline_index_array2:
+		return -1;
+	case command_kind::pc_inline_index_array:
+		return -(int)c.arg0;
+	case command_kind::pc_ref_assign:
+		return -2;
+	case command_kind::pc_pop:
+		return -(int)c.arg0;
+	case command_kind::pc_push_value:
+	case command_kind::pc_push_variable:
+	case command_kind::pc_push_variable2:
+	case command_kind::pc_dup_n:
+	case command_kind::pc_load_ptr:
+	case command_kind::pc_loop_ascent:
+	case command_kind::pc_loop_descent:
+	case command_kind::pc_loop_count:
+		return 1;
+	case command_kind::pc_loop_foreach:
+		return 2;
+	case command_kind::pc_construct_array:
+		return 1 - (int)c.arg0;
+	case command_kind::pc_call:
+		return -(int)c.arg1;
+	case command_kind::pc_call_and_push_result:
+		return 1 - (int)c.arg1;
+	case command_kind::pc_inline_inc:
+	case command_kind::pc_inline_dec:
+		return (c.arg0 == 0 && c.arg1) ? -1 : 0;
+	case command_kind::pc_inline_add_asi:
+	case command_kind::pc_inline_sub_asi:
+	case command_kind::pc_inline_mul_asi:
+	case command_kind::pc_inline_div_asi:
+	case command_kind::pc_inline_fdiv_asi:
+	case command_kind::pc_inline_mod_asi:
+	case command_kind::pc_inline_pow_asi:
+	case command_kind::pc_inline_cat_asi:
+		return c.arg0 ? -1 : -2;
+	}
+	return 0;
+}
+std::string script_engine::analyze_block(script_block* block, std::map<command_kind, size_t>* pOpCount) {
+	const std::vector<code>& codes = block->codes;
+	size_t countCode = codes.size();
+
+	//Estimated maximum stack depth, from the deepest path through the control flow
+	size_t maxDepth = 0;
+	{
+		std::vector<int> listDepth(countCode, -1);
+		std::vector<std::pair<size_t, int>> listWork;
+		listWork.push_back(std::make_pair(0U, 0));
+		while (listWork.size() > 0) {
+			auto [ip, depth] = listWork.back();
+			listWork.pop_back();
+			if (ip >= countCode || depth <= listDepth[ip]) continue;
+			//Unbalanced loops would grow forever, stop at a sane bound
+			if (depth > 0xffff) continue;
+			listDepth[ip] = depth;
+
+			const code& c = codes[ip];
+			int next = std::max(depth + get_stack_effect(c), 0);
+			maxDepth = std::max(maxDepth, (size_t)std::max(depth, next));
+
+			switch (c.GetOp()) {
+			case command_kind::pc_sub_return:
+				break;
+			case command_kind::pc_jump:
+				listWork.push_back(std::make_pair((size_t)c.arg0, next));
+				break;
+			case command_kind::pc_jump_if:
+			case command_kind::pc_jump_if_not:
+			case command_kind::pc_jump_if_nopop:
+			case command_kind::pc_jump_if_not_nopop:
+				listWork.push_back(std::make_pair((size_t)c.arg0, next));
+				listWork.push_back(std::make_pair(ip + 1, next));
+				break;
+			default:
+				listWork.push_back(std::make_pair(ip + 1, next));
+				break;
+			}
+		}
+	}
+
+	//Loops are the ranges closed by backward jumps, code inside them is where the time goes
+	struct LoopRange {
+		size_t begin;
+		size_t end;
+		size_t depth;
+		std::map<std::string, size_t> mapCall;
+	};
+	std::vector<LoopRange> listLoop;
+	std::vector<size_t> listLoopDepth(countCode, 0);
+	for (size_t ip = 0; ip < countCode; ++ip) {
+		const code& c = codes[ip];
+		if (pOpCount) ++(*pOpCount)[c.GetOp()];
+
+		switch (c.GetOp()) {
+		case command_kind::pc_jump:
+		case command_kind::pc_jump_if:
+		case command_kind::pc_jump_if_not:
+		case command_kind::pc_jump_if_nopop:
+		case command_kind::pc_jump_if_not_nopop:
+			if (c.arg0 <= ip) {
+				LoopRange loop;
+				loop.begin = c.arg0;
+				loop.end = ip;
+				loop.depth = 0;
+				listLoop.push_back(loop);
+				for (size_t i = loop.begin; i <= loop.end; ++i)
+					++listLoopDepth[i];
+			}
+			break;
+		}
+	}
+
+	size_t countInLoop = 0;
+	for (size_t ip = 0; ip < countCode; ++ip) {
+		if (listLoopDepth[ip] > 0) ++countInLoop;
+	}
+	for (LoopRange& loop : listLoop) {
+		loop.depth = listLoopDepth[loop.begin];
+		for (size_t ip = loop.begin; ip <= loop.end; ++ip) {
+			const code& c = codes[ip];
+			if (c.GetOp() == command_kind::pc_call || c.GetOp() == command_kind::pc_call_and_push_result)
+				++loop.mapCall[c.block->name];
+		}
+	}
+
+	std::string res = StringUtility::Format("%s \"%s\": codes=%u, max stack=%u, in loops=%u, loops=%u\n",
+		block->kind == block_kind::bk_function ? "function" :
+		block->kind == block_kind::bk_microthread ? "task" :
+		block->kind == block_kind::bk_sub ? "sub" : "block",
+		block->name.c_str(), countCode, maxDepth, countInLoop, listLoop.size());
+
+	//Hot path candidates, deepest nesting first, then the largest body
+	std::sort(listLoop.begin(), listLoop.end(), [](const LoopRange& a, const LoopRange& b) {
+		if (a.depth != b.depth) return a.depth > b.depth;
+		return (a.end - a.begin) > (b.end - b.begin);
+	});
+	for (const LoopRange& loop : listLoop) {
+		res += StringUtility::Format("    loop [%u-%u] lines %u-%u, depth=%u, codes=%u",
+			loop.begin, loop.end, codes[loop.begin].GetLine(), codes[loop.end].GetLine(),
+			loop.depth, loop.end - loop.begin + 1);
+		if (loop.mapCall.size() > 0) {
+			res += ", calls:";
+			for (auto& [name, count] : loop.mapCall)
+				res += StringUtility::Format(" %s(x%u)", name.c_str(), count);
+		}
+		res += "\n";
+	}
+	return res;
+}
+std::string script_engine::analyze() {
+	std::string res;
+	std::map<command_kind, size_t> mapOpCount;
+
+	size_t countBlock = 0;
+	size_t countCode = 0;
+	for (script_block& iBlock : blocks) {
+		if (iBlock.func) continue;
+		res += analyze_block(&iBlock, &mapOpCount);
+		++countBlock;
+		countCode += iBlock.codes.size();
+	}
+
+	std::string summary = StringUtility::Format("blocks=%u, codes=%u\n", countBlock, countCode);
+	{
+		std::vector<std::pair<command_kind, size_t>> listOp(mapOpCount.begin(), mapOpCount.end());
+		std::sort(listOp.begin(), listOp.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+		for (auto& [op, count] : listOp)
+			summary += StringUtility::Format("    %-24s %u\n", get_command_name(op), count);
+	}
+	return summary + "\n" + res;
+}
+
 //****************************************************************************
 //script_machine::environment
 //****************************************************************************
@@ -141,11 +528,173 @@ void script_machine::environment::dec_ref() {
 	}
 }
 
+//****************************************************************************
+//script_machine::thread_wheel
+//****************************************************************************
+void script_machine::thread_wheel::clear() {
+	for (size_t i = 0; i < WHEEL_SIZE; ++i) {
+		slot_near[i].clear();
+		slot_far[i].clear();
+	}
+	overflow.clear();
+	count = 0;
+}
+void script_machine::thread_wheel::add(const entry& e, uint64_t cycle) {
+	uint64_t delta = e.cycle_wake - cycle;
+	if (delta < WHEEL_SIZE)
+		slot_near[e.cycle_wake & WHEEL_MASK].push_back(e);
+	else if (delta < WHEEL_SPAN)
+		slot_far[(e.cycle_wake >> WHEEL_BITS) & WHEEL_MASK].push_back(e);
+	else
+		overflow.insert(std::make_pair(e.cycle_wake, e));
+	++count;
+}
+void script_machine::thread_wheel::advance(uint64_t cycle, thread_map& wake_target) {
+	if (count == 0) return;
+
+	if ((cycle & WHEEL_MASK) == 0) {
+		if (((cycle >> WHEEL_BITS) & WHEEL_MASK) == 0) {
+			//Pull in everything that fits in the wheel again
+			auto itrEnd = overflow.lower_bound(cycle + WHEEL_SPAN);
+			for (auto itr = overflow.begin(); itr != itrEnd; ++itr) {
+				--count;
+				add(itr->second, cycle);
+			}
+			overflow.erase(overflow.begin(), itrEnd);
+		}
+
+		//Cascade the far slot of this span down into the near slots
+		std::vector<entry>& listFar = slot_far[(cycle >> WHEEL_BITS) & WHEEL_MASK];
+		for (entry& e : listFar)
+			slot_near[e.cycle_wake & WHEEL_MASK].push_back(e);
+		listFar.clear();
+	}
+
+	std::vector<entry>& listNear = slot_near[cycle & WHEEL_MASK];
+	for (entry& e : listNear)
+		wake_target.insert(std::make_pair(e.label, e.env));
+	count -= listNear.size();
+	listNear.clear();
+}
+void script_machine::thread_wheel::relabel(const std::vector<uint64_t>& list_old, uint64_t step) {
+	auto _Remap = [&](entry& e) {
+		size_t index = std::lower_bound(list_old.begin(), list_old.end(), e.label) - list_old.begin();
+		e.label = index * step;
+	};
+	for (size_t i = 0; i < WHEEL_SIZE; ++i) {
+		for (entry& e : slot_near[i]) _Remap(e);
+		for (entry& e : slot_far[i]) _Remap(e);
+	}
+	for (auto& [cycle, e] : overflow) _Remap(e);
+}
+
+//****************************************************************************
+//script_profiler
+//****************************************************************************
+script_profiler::script_profiler() {
+	clear();
+}
+void script_profiler::clear() {
+	map_block.clear();
+	map_builtin.clear();
+	map_stack.clear();
+
+	state_current = timing_state();
+	list_suspended.clear();
+	time_prev = 0;
+	time_since_sample = 0;
+
+	cache_block = nullptr;
+	cache_data = nullptr;
+}
+void script_profiler::merge(const script_profiler& other) {
+	for (auto& [block, src] : other.map_block) {
+		block_data& dst = map_block[block];
+		if (dst.count.size() < src.count.size()) {
+			dst.engine = src.engine;
+			dst.count.resize(src.count.size());
+			dst.time.resize(src.time.size());
+		}
+		for (size_t i = 0; i < src.count.size(); ++i) {
+			dst.count[i] += src.count[i];
+			dst.time[i] += src.time[i];
+		}
+	}
+	for (auto& [block, src] : other.map_builtin) {
+		builtin_data& dst = map_builtin[block];
+		dst.count += src.count;
+		dst.time += src.time;
+	}
+	for (auto& [key, time] : other.map_stack)
+		map_stack[key] += time;
+}
+void script_profiler::accumulate(uint64_t time) {
+	if (state_current.data == nullptr) return;
+
+	uint64_t delta = time - time_prev;
+	state_current.data->time[state_current.ip] += delta;
+	if (builtin_data* builtin = state_current.builtin)
+		builtin->time += delta;
+	time_since_sample += delta;
+	time_prev = time;
+}
+void script_profiler::enter() {
+	//Another machine may be starting from inside a builtin call, pause the caller's timing until it returns
+	accumulate(__rdtsc());
+	list_suspended.push_back(state_current);
+	state_current = timing_state();
+}
+void script_profiler::leave() {
+	accumulate(__rdtsc());
+	state_current = list_suspended.back();
+	list_suspended.pop_back();
+	time_prev = __rdtsc();
+}
+bool script_profiler::record(script_engine* engine, const script_block* block, size_t ip) {
+	uint64_t time = __rdtsc();
+	accumulate(time);
+
+	if (block != cache_block) {
+		block_data& data = map_block[block];
+		if (data.count.size() != block->codes.size()) {
+			data.engine = engine;
+			data.count.resize(block->codes.size());
+			data.time.resize(block->codes.size());
+		}
+		cache_block = block;
+		cache_data = &data;
+	}
+	++(cache_data->count[ip]);
+
+	state_current.data = cache_data;
+	state_current.ip = ip;
+	state_current.builtin = nullptr;
+
+	const code& c = block->codes[ip];
+	command_kind op = c.GetOp();
+	if (op == command_kind::pc_call || op == command_kind::pc_call_and_push_result) {
+		const script_block* sub = c.block;
+		if (sub->func) {
+			builtin_data* builtin = &map_builtin[sub];
+			++(builtin->count);
+			state_current.builtin = builtin;
+		}
+	}
+
+	time_prev = time;
+	return time_since_sample >= STACK_SAMPLE_PERIOD;
+}
+void script_profiler::add_stack_sample(stack_key&& key) {
+	map_stack[key] += time_since_sample;
+	time_since_sample = 0;
+}
+
 //****************************************************************************
 //script_machine
 //****************************************************************************
 script_machine::script_machine(script_engine* the_engine) {
 	engine = the_engine;
+	profiler = nullptr;
 
 	reset();
 }
@@ -168,8 +717,8 @@ script_machine::environment* script_machine::get_new_environment() {
 		alloc_env_chunk(ENV_CHUNK);
 	}
 
-	res = _list_free_environments.front();
-	_list_free_environments.pop_front();
+	res = _list_free_environments.back();
+	_list_free_environments.pop_back();
 
 	return res;
 }
@@ -202,8 +751,59 @@ void script_machine::reset() {
 	_list_free_environments.clear();
 
 	list_parent_environment.clear();
+	env_global = nullptr;
 	threads.clear();
-	current_thread_index = std::list<environment*>::iterator();
+	current_thread_index = thread_map::iterator();
+
+	thread_labels.clear();
+	list_interrupt_label.clear();
+	threads_sleeping.clear();
+	count_cycle = 0;
+}
+
+uint64_t script_machine::new_thread_label(uint64_t label_prev) {
+	//Halfway between the previous thread and whichever thread currently follows it
+	auto itrNext = thread_labels.upper_bound(label_prev);
+	uint64_t labelNext = itrNext != thread_labels.end() ? *itrNext : UINT64_MAX;
+	return label_prev + (labelNext - label_prev) / 2U;
+}
+void script_machine::relabel_threads() {
+	//Spread all labels out evenly again, keeping their order
+	std::vector<uint64_t> listOld(thread_labels.begin(), thread_labels.end());
+	uint64_t step = UINT64_MAX / (listOld.size() + 1U);
+	auto _Remap = [&](uint64_t label) -> uint64_t {
+		auto itr = std::lower_bound(listOld.begin(), listOld.end(), label);
+		uint64_t res = (itr - listOld.begin()) * step;
+		//Labels of finished threads go just before their successor
+		return (itr != listOld.end() && *itr == label) ? res : res - 1U;
+	};
+
+	uint64_t labelCurrent = _Remap(current_thread_index->first);
+
+	thread_map threadsNew;
+	for (auto& [label, env] : threads)
+		threadsNew.emplace_hint(threadsNew.end(), _Remap(label), env);
+	threads.swap(threadsNew);
+	current_thread_index = threads.find(labelCurrent);
+
+	for (uint64_t& label : list_interrupt_label)
+		label = _Remap(label);
+	threads_sleeping.relabel(listOld, step);
+
+	thread_labels.clear();
+	for (size_t i = 0; i < listOld.size(); ++i)
+		thread_labels.insert(thread_labels.end(), i * step);
+}
+void script_machine::sleep_thread(int count_wait) {
+	thread_wheel::entry entry = { current_thread_index->first, current_thread_index->second,
+		count_cycle + count_wait };
+
+	//Never the main thread, so this does not wrap around
+	auto itrSleep = current_thread_index;
+	yield();
+	threads.erase(itrSleep);
+
+	threads_sleeping.add(entry, count_cycle);
 }
 void script_machine::run() {
 	if (bTerminate) return;
@@ -213,9 +813,9 @@ void script_machine::run() {
 
 		environment* mainEnv = get_new_environment();
 		mainEnv->init(nullptr, engine->main_block);
-		threads.push_back(mainEnv);
-
-		current_thread_index = threads.begin();
+		env_global = mainEnv;
+		current_thread_index = threads.insert(std::make_pair(0ui64, mainEnv)).first;
+		thread_labels.insert(0ui64);
 
 		finished = false;
 		stopped = false;
@@ -247,15 +847,15 @@ void script_machine::call(std::map<std::string, script_block*>::iterator event_i
 }
 
 void script_machine::interrupt(script_block* sub) {
-	//Save current thread
-	auto prev_thread = current_thread_index;
+	//Save current thread, by label as the thread may go to sleep in the meantime
+	list_interrupt_label.push_back(current_thread_index->first);
 	current_thread_index = threads.begin();
 
-	environment* env_first = *current_thread_index;
+	environment* env_first = current_thread_index->second;
 
 	environment* new_env = get_new_environment();
 	new_env->init(env_first, sub);
-	*current_thread_index = new_env;
+	current_thread_index->second = new_env;
 
 	finished = false;
 
@@ -265,36 +865,130 @@ void script_machine::interrupt(script_block* sub) {
 
 	finished = false;
 
-	//Resume previous thread
-	current_thread_index = prev_thread;
+	//Resume previous thread, or the next runnable one if it has since finished or gone to sleep
+	uint64_t labelPrev = list_interrupt_label.back();
+	list_interrupt_label.pop_back();
+
+	current_thread_index = threads.upper_bound(labelPrev);
+	--current_thread_index;
 }
 script_machine::environment* script_machine::add_thread(script_block* sub) {
 	environment* e = get_new_environment();
-	e->init(*current_thread_index, sub);
+	e->init(current_thread_index->second, sub);
 
-	threads.insert(++current_thread_index, e);
-	--current_thread_index;
+	//The new thread goes right after the current one and runs immediately
+	uint64_t labelNew = new_thread_label(current_thread_index->first);
+	if (labelNew == current_thread_index->first) {
+		relabel_threads();
+		labelNew = new_thread_label(current_thread_index->first);
+	}
+
+	thread_labels.insert(labelNew);
+	current_thread_index = threads.insert(std::make_pair(labelNew, e)).first;
 
 	return e;
 }
 script_machine::environment* script_machine::add_child_block(script_block* sub) {
 	environment* e = get_new_environment();
-	e->init(*current_thread_index, sub);
+	e->init(current_thread_index->second, sub);
 
-	*current_thread_index = e;
+	current_thread_index->second = e;
 
 	return e;
 }
 
+//Fast paths for operations on scalar int/float operands, these skip the generic BaseFunction dispatch.
+//	Any other operand types return false, and the caller falls back to the generic path.
+//	Everything returns false while script_engine::option_fast_path is off.
+static inline bool _script_is_scalar(type_data* type) {
+	return script_engine::option_fast_path
+		&& (type == script_type_manager::get_int_type() || type == script_type_manager::get_float_type());
+}
+static bool _script_arith_scalar(command_kind op, const value* args, value* res) {
+	type_data* typeInt = script_type_manager::get_int_type();
+	type_data* typeFloat = script_type_manager::get_float_type();
+	type_data* typeL = args[0].get_type();
+	type_data* typeR = args[1].get_type();
+	if (!_script_is_scalar(typeL) || !_script_is_scalar(typeR))
+		return false;
+
+	if (typeL == typeInt && typeR == typeInt) {
+		int64_t l = args[0].as_int();
+		int64_t r = args[1].as_int();
+		switch (op) {
+		case command_kind::pc_inline_add:
+			res->reset(typeInt, l + r);
+			return true;
+		case command_kind::pc_inline_sub:
+			res->reset(typeInt, l - r);
+			return true;
+		case command_kind::pc_inline_mul:
+			res->reset(typeInt, l * r);
+			return true;
+		}
+	}
+
+	//Division always results in a float
+	double l = args[0].as_float();
+	double r = args[1].as_float();
+	switch (op) {
+	case command_kind::pc_inline_add:
+		res->reset(typeFloat, l + r);
+		return true;
+	case command_kind::pc_inline_sub:
+		res->reset(typeFloat, l - r);
+		return true;
+	case command_kind::pc_inline_mul:
+		res->reset(typeFloat, l * r);
+		return true;
+	case command_kind::pc_inline_div:
+		res->reset(typeFloat, l / r);
+		return true;
+	}
+	return false;
+}
+static bool _script_compare_scalar(const value* args, int* res) {
+	type_data* typeInt = script_type_manager::get_int_type();
+	type_data* typeL = args[0].get_type();
+	type_data* typeR = args[1].get_type();
+	if (!_script_is_scalar(typeL) || !_script_is_scalar(typeR))
+		return false;
+
+	if (typeL == typeInt && typeR == typeInt) {
+		int64_t l = args[0].as_int();
+		int64_t r = args[1].as_int();
+		*res = (l == r) ? 0 : (l < r) ? -1 : 1;
+	}
+	else {
+		double l = args[0].as_float();
+		double r = args[1].as_float();
+		*res = (l == r) ? 0 : (l < r) ? -1 : 1;
+	}
+	return true;
+}
+
+void script_machine::profile_stack(environment* env, code* c) {
+	script_profiler::stack_key key;
+	for (environment* i = env; i != nullptr; i = i->parent)
+		key.first.push_back(i->sub);
+	std::reverse(key.first.begin(), key.first.end());
+	key.second = c->GetLine();
+
+	profiler->add_stack_sample(std::move(key));
+}
+
 void script_machine::run_code() {
 	if (threads.size() == 0) {
-		current_thread_index = std::list<environment*>::iterator();
+		current_thread_index = thread_map::iterator();
 		return;
 	}
+
+	script_profiler::scope scopeProfile(profiler);
 	try {
 		while (!finished && !bTerminate) {
-			environment* current = *current_thread_index;
+			environment* current = current_thread_index->second;
 
+			//Only the main thread counts down its waits here, other threads sleep in threads_sleeping
 			if (current->waitCount > 0) {
 				--(current->waitCount);
 				yield();
@@ -317,13 +1011,14 @@ void script_machine::run_code() {
 				}
 				else {
 					if (current->sub->kind == block_kind::bk_microthread) {
+						thread_labels.erase(current_thread_index->first);
 						current_thread_index = threads.erase(current_thread_index);
 						yield();
 					}
 					else {
 						if (current->has_result && parent != nullptr)
-							parent->stack.push_back(current->variables[0]);
-						*current_thread_index = parent;
+							parent->stack.push_back(std::move(current->variables[0]));
+						current_thread_index->second = parent;
 					}
 
 					for (environment* pEnv = current; pEnv != nullptr;) {
@@ -340,6 +1035,10 @@ void script_machine::run_code() {
 
 				code* c = &(current->sub->codes[current->ip]);
 				error_line = c->GetLine();
+				if (profiler) {
+					if (profiler->record(engine, current->sub, current->ip))
+						profile_stack(current, c);
+				}
 				++(current->ip);
 
 				command_kind opc = c->GetOp();
@@ -348,9 +1047,15 @@ void script_machine::run_code() {
 				case command_kind::pc_wait:
 				{
 					value* t = &stack.back();
-					current->waitCount = (int)t->as_int() - 1;
+					int countWait = (int)t->as_int();
 					stack.pop_back();
-					if (current->waitCount < 0) break;
+					if (countWait <= 0) break;
+
+					if (countWait > 1 && current_thread_index != threads.begin()) {
+						sleep_thread(countWait);
+						break;
+					}
+					current->waitCount = countWait - 1;
 				}
 				//Fallthrough
 				case command_kind::pc_yield:
@@ -358,6 +1063,7 @@ void script_machine::run_code() {
 					break;
 
 				case command_kind::pc_var_alloc:
+					//resize() never shrinks or clears, arguments already placed by pc_call are kept
 					variables.resize(c->arg0);
 					variables.length = c->arg0;
 					break;
@@ -464,7 +1170,6 @@ void script_machine::run_code() {
 								type_data* prev_type = dest->get_type();
 
 								*dest = *src;
-								dest->make_unique();
 
 								if (prev_type && prev_type != src->get_type())
 									BaseFunction::_value_cast(dest, prev_type);
@@ -521,10 +1226,27 @@ void script_machine::run_code() {
 						if (bPushResult)
 							stack.push_back(ret);
 					};
-					auto _PassArgsFromStack = [](size_t argc, script_value_vector& srcStk, script_value_vector& dstStk) {
-						value* pBack = &srcStk.back();
-						for (int i = 0; i < argc; ++i)
-							dstStk.push_back(pBack[-i]);
+					//Moves the arguments from the top of the caller's stack straight into the callee's variable slots.
+					//	The callee still starts at its pc_var_alloc (so the profiler counts the call there),
+					//	which keeps the preloaded slots since the variables are already sized.
+					//	Blocks without a leading pc_var_alloc get the arguments pushed onto their stack instead.
+					auto _PassArgsFromStack = [](size_t argc, script_value_vector& srcStk, environment* dst) {
+						const std::vector<code>& codes = dst->sub->codes;
+						if (codes.size() > 0 && codes[0].GetOp() == command_kind::pc_var_alloc) {
+							const code& cAlloc = codes[0];
+							dst->variables.resize(cAlloc.arg0);
+							dst->variables.length = cAlloc.arg0;
+
+							value* pSrc = srcStk.at + (srcStk.size() - argc);
+							value* pDst = dst->variables.at + cAlloc.arg1;
+							for (size_t i = 0; i < argc; ++i)
+								pDst[i] = std::move(pSrc[i]);
+						}
+						else if (argc > 0) {
+							value* pBack = &srcStk.back();
+							for (size_t i = 0; i < argc; ++i)
+								dst->stack.push_back(pBack[-(ptrdiff_t)i]);
+						}
 						srcStk.pop_back(argc);
 					};
 
@@ -559,7 +1281,7 @@ void script_machine::run_code() {
 								else if (subIvk->kind == block_kind::bk_microthread) {
 									environment* e = add_thread(subIvk);
 
-									_PassArgsFromStack(subIvk->arguments, stack, e->stack);
+									_PassArgsFromStack(subIvk->arguments, stack, e);
 									stack.pop_back();
 
 									if (bPushResult)
@@ -569,7 +1291,7 @@ void script_machine::run_code() {
 									environment* e = add_child_block(subIvk);
 									e->has_result = bPushResult;
 
-									_PassArgsFromStack(subIvk->arguments, stack, e->stack);
+									_PassArgsFromStack(subIvk->arguments, stack, e);
 									stack.pop_back();
 								}
 							}
@@ -579,14 +1301,14 @@ void script_machine::run_code() {
 						//Tasks
 						environment* e = add_thread(sub);
 
-						_PassArgsFromStack(c->arg1, stack, e->stack);
+						_PassArgsFromStack(c->arg1, stack, e);
 					}
 					else {
 						//User-defined functions or internal blocks
 						environment* e = add_child_block(sub);
 						e->has_result = bPushResult;
 
-						_PassArgsFromStack(c->arg1, stack, e->stack);
+						_PassArgsFromStack(c->arg1, stack, e);
 					}
 
 					break;
@@ -655,15 +1377,20 @@ void script_machine::run_code() {
 					value* i = &stack.back();
 					value* src_array = i - 1;
 
-					std::vector<value>::iterator itrCur = src_array->array_get_begin() + i->as_int();
-					std::vector<value>::iterator itrEnd = src_array->array_get_end();
+					//"for each (x in ref arr)" pushes a pointer to the variable instead of the array
+					if (src_array->has_data() && src_array->get_type()->get_kind() == type_data::tk_pointer)
+						src_array = src_array->as_ptr();
+
+					size_t index = (size_t)i->as_int();
 
 					bool bSkip = false;
-					if (src_array->get_type()->get_kind() != type_data::tk_array || itrCur >= itrEnd) {
+					if (src_array->get_type()->get_kind() != type_data::tk_array || index >= src_array->length_as_array()) {
 						bSkip = true;
 					}
 					else {
-						stack.push_back(*itrCur);
+						//Read through the const accessor, so that a packed array stays packed
+						const value* src_read = src_array;
+						stack.push_back(src_read->index_as_array(index));
 						//stack.back().make_unique();
 						i->set(i->get_type(), i->as_int() + 1i64);
 					}
@@ -717,6 +1444,20 @@ void script_machine::run_code() {
 						value* var = find_variable_symbol<false>(current, c,
 							ARG1_GET_LEVEL(c->arg1), ARG1_GET_VAR(c->arg1));
 						if (var == nullptr) break;
+
+						type_data* typeVar = var->get_type();
+						int64_t step = (opc == command_kind::pc_inline_inc) ? 1 : -1;
+						if (script_engine::option_fast_path) {
+							if (typeVar == script_type_manager::get_int_type()) {
+								var->reset(typeVar, var->as_int() + step);
+								break;
+							}
+							else if (typeVar == script_type_manager::get_float_type()) {
+								var->reset(typeVar, var->as_float() + step);
+								break;
+							}
+						}
+
 						value res = (opc == command_kind::pc_inline_inc) ?
 							BaseFunction::successor(this, 1, var) : BaseFunction::predecessor(this, 1, var);
 						*var = res;
@@ -763,7 +1504,16 @@ void script_machine::run_code() {
 						if (dest == nullptr) break;
 
 						value arg[2] = { *dest, stack.back() };
-						PerformFunction(&res, opc, arg);
+
+						command_kind opcScalar = command_kind::pc_nop;
+						switch (opc) {
+						case command_kind::pc_inline_add_asi: opcScalar = command_kind::pc_inline_add; break;
+						case command_kind::pc_inline_sub_asi: opcScalar = command_kind::pc_inline_sub; break;
+						case command_kind::pc_inline_mul_asi: opcScalar = command_kind::pc_inline_mul; break;
+						case command_kind::pc_inline_div_asi: opcScalar = command_kind::pc_inline_div; break;
+						}
+						if (!_script_arith_scalar(opcScalar, arg, &res))
+							PerformFunction(&res, opc, arg);
 
 						BaseFunction::_value_cast(&res, dest->get_type());
 						*dest = res;
@@ -791,16 +1541,24 @@ void script_machine::run_code() {
 							ARG1_GET_LEVEL(c->arg1), ARG1_GET_VAR(c->arg1));
 						if (dest == nullptr) break;
 
+						dest->make_unique();
 						value arg[2] = { *dest, stack.back() };
-						BaseFunction::concatenate_direct(this, 2, arg);
+						//concatenate may replace the storage (empty/non-array left side, unpacking), so store the result back
+						value res = BaseFunction::concatenate_direct(this, 2, arg);
+						if (!error)
+							*dest = res;
 
 						stack.pop_back();
 					}
 					else {
 						value* pArg = &stack.back() - 1;
 
-						value arg[2] = { *(pArg->as_ptr()), pArg[1] };
-						BaseFunction::concatenate_direct(this, 2, arg);
+						value& pDest = *(pArg->as_ptr());
+						pDest.make_unique();
+						value arg[2] = { pDest, pArg[1] };
+						value res = BaseFunction::concatenate_direct(this, 2, arg);
+						if (!error)
+							pDest = res;
 
 						stack.pop_back(2U);
 					}
@@ -838,6 +1596,12 @@ void script_machine::run_code() {
 					value res;
 					value* args = &stack.back() - 1;
 
+					if (_script_arith_scalar(opc, args, &res)) {
+						stack.pop_back();
+						stack.back() = res;
+						break;
+					}
+
 #define DEF_CASE(cmd, fn) case cmd: res = BaseFunction::fn(this, 2, args); break;
 					switch (opc) {
 						DEF_CASE(command_kind::pc_inline_add, add);
@@ -866,8 +1630,12 @@ void script_machine::run_code() {
 				case command_kind::pc_inline_cmp_ne:
 				{
 					value* args = &stack.back() - 1;
-					value cmp_res = BaseFunction::compare(this, 2, args);
-					int cmp_r = cmp_res.as_int();
+					value cmp_res;
+					int cmp_r = 0;
+					if (!_script_compare_scalar(args, &cmp_r)) {
+						cmp_res = BaseFunction::compare(this, 2, args);
+						cmp_r = cmp_res.as_int();
+					}
 
 #define DEF_CASE(cmd, expr) case cmd: cmp_res.reset(script_type_manager::get_boolean_type(), expr); break;
 					switch (opc) {
@@ -922,14 +1690,24 @@ void script_machine::run_code() {
 				}
 				case command_kind::pc_inline_index_array:
 				{
-					value* arr = &stack.back() - 1;
-					value* idx = arr + 1;
-
-					value* pRes = (value*)BaseFunction::index(this, 2, arr->as_ptr(), idx);
+					//Stack: .... [ptr to array] [index 0] ... [index arg0-1] [arg1 values]
+					//	Runs right before the store, after the right-hand side, so nothing can share
+					//	the arrays between their detachment and the write
+					size_t countIndex = c->arg0;
+					size_t countAbove = c->arg1;
+					value* pBase = &stack.back() - countAbove - countIndex;
+
+					value* pRes = pBase->as_ptr();
+					for (size_t i = 0; i < countIndex && pRes != nullptr; ++i) {
+						pRes->make_unique();
+						pRes = (value*)BaseFunction::index(this, 2, pRes, pBase + 1 + i);
+					}
 					if (pRes == nullptr) break;
 
-					*arr = value(script_type_manager::get_ptr_type(), pRes);
-					stack.pop_back(1U);	//pop idx
+					*pBase = value(script_type_manager::get_ptr_type(), pRes);
+					for (size_t i = 0; i < countAbove; ++i)
+						pBase[1 + i] = std::move(pBase[1 + countIndex + i]);
+					stack.pop_back(countIndex);
 					break;
 				}
 				case command_kind::pc_inline_index_array2:
@@ -937,6 +1715,20 @@ void script_machine::run_code() {
 					value* arr = &stack.back() - 1;
 					value* idx = arr + 1;
 
+					//Reading from a packed array, no need to unpack it
+					if (arr->is_packed()) {
+						int index = idx->as_int();
+						size_t length = arr->length_as_array();
+						if (index < 0) index += length;
+						if (!BaseFunction::_index_check(this, arr->get_type(), length, index)) break;
+
+						value res;
+						arr->index_packed(index, &res);
+						stack.pop_back();
+						stack.back() = res;
+						break;
+					}
+
 					value* pRes = (value*)BaseFunction::index(this, 2, arr, idx);
 					if (pRes == nullptr) break;
 					value res = *pRes;
@@ -971,24 +1763,36 @@ void script_machine::run_code() {
 template<bool ALLOW_NULL>
 value* script_machine::find_variable_symbol(environment* current_env, code* c,
 	uint32_t level, uint32_t variable) {
-	for (environment* i = current_env; i != nullptr; i = i->parent) {
-		if (i->sub->level == level) {
-			value* res = &(i->variables[variable]);
+	environment* env = nullptr;
+	if (level == VAR_LEVEL_LOCAL)
+		env = current_env;
+	else if (level == VAR_LEVEL_GLOBAL)
+		env = env_global;
+	else {
+		for (environment* i = current_env; i != nullptr; i = i->parent) {
+			if (i->sub->level == level) {
+				env = i;
+				break;
+			}
+		}
+	}
+
+	if (env) {
+		value* res = &(env->variables[variable]);
 
-			if constexpr (ALLOW_NULL)
+		if constexpr (ALLOW_NULL)
+			return res;
+		else {
+			if (res->has_data())
 				return res;
 			else {
-				if (res->has_data())
-					return res;
-				else {
 #ifdef _DEBUG
-					raise_error(StringUtility::Format("Variable hasn't been initialized: %s\r\n",
-						c->var_name.c_str()));
+				raise_error(StringUtility::Format("Variable hasn't been initialized: %s\r\n",
+					c->var_name.c_str()));
 #else
-					raise_error("Variable hasn't been initialized.\r\n");
+				raise_error("Variable hasn't been initialized.\r\n");
 #endif
-					return nullptr;
-				}
+				return nullptr;
 			}
 		}
 	}
@@ -68,7 +68,22 @@ namespace gstd {
 		int get_error_line() { return error_line; }
 
 		script_block* new_block(int level, block_kind kind);
+
+		//Human-readable listing of the bytecode of every script-defined block
+		std::string disassemble();
+		static std::string disassemble_block(script_block* block);
+		static const char* get_command_name(command_kind op);
+
+		//Static report of code size, estimated stack depth and loop-heavy paths of every script-defined block
+		std::string analyze();
+		static std::string analyze_block(script_block* block, std::map<command_kind, size_t>* pOpCount);
+		static int get_stack_effect(const code& c);
 	public:
+		//Compilation options, read when an engine is created
+		static bool option_optimize;			//Run parser::optimize_block over the parsed code
+		static bool option_keep_unoptimized;	//Keep a listing of the code from before the optimization pass
+		static bool option_fast_path;			//Use the scalar int/float fast paths in script_machine, read on every operation
+
 		void* data;		//Client script pointer
 
 		bool error;
@@ -78,6 +93,75 @@ namespace gstd {
 		std::list<script_block> blocks;
 		script_block* main_block;
 		std::map<std::string, script_block*> events;
+
+		std::string listing_unoptimized;
+	};
+
+	//Execution counts and timestamp counter ticks per instruction of the machines it is attached to,
+	//	plus call stacks sampled by time for flamegraphs
+	class script_profiler {
+	public:
+		struct block_data {
+			script_engine* engine = nullptr;
+			std::vector<uint64_t> count;
+			std::vector<uint64_t> time;
+		};
+		struct builtin_data {
+			uint64_t count = 0;
+			uint64_t time = 0;
+		};
+
+		//Blocks of the call stack starting from the outermost one, and the line being run
+		typedef std::pair<std::vector<const script_block*>, int> stack_key;
+
+		//About a third of a millisecond at 3GHz
+		static constexpr uint64_t STACK_SAMPLE_PERIOD = 1ui64 << 20;
+
+		//Brackets a run of a machine, time spent outside of it isn't attributed to any instruction
+		class scope {
+			script_profiler* profiler;
+		public:
+			scope(script_profiler* p) : profiler(p) { if (profiler) profiler->enter(); }
+			~scope() { if (profiler) profiler->leave(); }
+		};
+	private:
+		struct timing_state {
+			block_data* data = nullptr;
+			size_t ip = 0;
+			builtin_data* builtin = nullptr;
+		};
+
+		std::unordered_map<const script_block*, block_data> map_block;
+		std::unordered_map<const script_block*, builtin_data> map_builtin;
+		std::map<stack_key, uint64_t> map_stack;
+
+		timing_state state_current;
+		std::vector<timing_state> list_suspended;	//Of machines that are running another machine
+		uint64_t time_prev;
+		uint64_t time_since_sample;
+
+		const script_block* cache_block;
+		block_data* cache_data;
+
+		void accumulate(uint64_t time);
+	public:
+		script_profiler();
+
+		void clear();
+		bool empty() { return map_block.empty() && map_builtin.empty(); }
+		//Adds the counts and times of another profiler, used to publish the data collected by a thread
+		void merge(const script_profiler& other);
+
+		void enter();
+		void leave();
+
+		//Returns true when the caller should follow up with a stack sample
+		bool record(script_engine* engine, const script_block* block, size_t ip);
+		void add_stack_sample(stack_key&& key);
+
+		const std::unordered_map<const script_block*, block_data>& get_block_map() { return map_block; }
+		const std::unordered_map<const script_block*, builtin_data>& get_builtin_map() { return map_builtin; }
+		const std::map<stack_key, uint64_t>& get_stack_map() { return map_stack; }
 	};
 
 	class script_machine {
@@ -104,6 +188,39 @@ namespace gstd {
 			void add_ref();
 			void dec_ref();
 		};
+
+		//Threads are ordered by a label, the main thread always has label 0
+		typedef std::map<uint64_t, environment*> thread_map;
+
+		//Hierarchical timer wheel of threads sleeping in a wait, keyed by the scheduling cycle they wake up in
+		class thread_wheel {
+		public:
+			struct entry {
+				uint64_t label;
+				environment* env;
+				uint64_t cycle_wake;
+			};
+
+			static constexpr size_t WHEEL_BITS = 8;
+			static constexpr size_t WHEEL_SIZE = 1U << WHEEL_BITS;
+			static constexpr uint64_t WHEEL_MASK = WHEEL_SIZE - 1U;
+			static constexpr uint64_t WHEEL_SPAN = WHEEL_SIZE * WHEEL_SIZE;
+		private:
+			std::vector<entry> slot_near[WHEEL_SIZE];	//One cycle per slot
+			std::vector<entry> slot_far[WHEEL_SIZE];	//WHEEL_SIZE cycles per slot
+			std::multimap<uint64_t, entry> overflow;
+
+			size_t count;
+		public:
+			thread_wheel() { count = 0; }
+
+			void clear();
+			void add(const entry& e, uint64_t cycle);
+			void advance(uint64_t cycle, thread_map& wake_target);
+			void relabel(const std::vector<uint64_t>& list_old, uint64_t step);
+
+			size_t size() { return count; }
+		};
 	public:
 		void* data;		//Pointer to client script class
 
@@ -119,17 +236,30 @@ namespace gstd {
 		bool resuming;
 
 		std::list<environment> _list_environments;
-		std::list<environment*> _list_free_environments;
+		std::vector<environment*> _list_free_environments;	//Reused last-in first-out, while their memory is still warm
 
 		std::list<environment*> list_parent_environment;
+		environment* env_global;		//Environment of the main block
 
-		std::list<environment*> threads;
-		std::list<environment*>::iterator current_thread_index;
+		//Runnable threads only, the cursor moves towards lower labels
+		thread_map threads;
+		thread_map::iterator current_thread_index;
+
+		std::set<uint64_t> thread_labels;		//Labels of all threads, including sleeping ones
+		std::vector<uint64_t> list_interrupt_label;
+		thread_wheel threads_sleeping;
+		uint64_t count_cycle;
+
+		script_profiler* profiler;
 	private:
 		void alloc_env_chunk(size_t chunk);
 
 		environment* get_new_environment();
 		void dispose_environment(environment* env);
+
+		uint64_t new_thread_label(uint64_t label_prev);
+		void relabel_threads();
+		void sleep_thread(int count_wait);
 	public:
 		script_machine(script_engine* the_engine);
 		virtual ~script_machine();
@@ -174,20 +304,27 @@ namespace gstd {
 
 		script_engine* get_engine() { return engine; }
 
+		void set_profiler(script_profiler* p) { profiler = p; }
+		script_profiler* get_profiler() { return profiler; }
+
 		bool has_event(const std::string& event_name, std::map<std::string, script_block*>::iterator& res);
 		int get_current_line();
-		int get_current_thread_addr() { return (int)current_thread_index._Ptr; }
+		int get_current_thread_addr() { return (int)&*current_thread_index; }
 
-		size_t get_thread_count() { return threads.size(); }
+		size_t get_thread_count() { return threads.size() + threads_sleeping.size(); }
 	private:
 		void yield() {
-			if (current_thread_index == threads.begin())
+			if (current_thread_index == threads.begin()) {
+				//Wrapping around starts a new cycle, wake the threads due in it before resuming from the back
+				threads_sleeping.advance(++count_cycle, threads);
 				current_thread_index = std::prev(threads.end());
+			}
 			else
 				--current_thread_index;
 		}
 
 		void run_code();
+		void profile_stack(environment* env, code* c);
 
 		template<bool ALLOW_NULL>
 		value* find_variable_symbol(environment* current_env, code* c,
@@ -58,6 +58,30 @@ namespace gstd {
 
 	//-------------------------------------------------------------------------------------------
 
+	std::set<dnh_func_callback_t>& script_pure_functions::get_set() {
+		//Function-local so that registrations during static initialization of other files are safe
+		static std::set<dnh_func_callback_t> setFunc;
+		return setFunc;
+	}
+	bool script_pure_functions::add(std::initializer_list<dnh_func_callback_t> list) {
+		get_set().insert(list);
+		return true;
+	}
+	bool script_pure_functions::contains(dnh_func_callback_t func) {
+		return get_set().find(func) != get_set().end();
+	}
+
+	static const bool _bRegisteredPure = script_pure_functions::add({
+		BaseFunction::round, BaseFunction::truncate, BaseFunction::ceil, BaseFunction::floor,
+		BaseFunction::absolute, BaseFunction::negative, BaseFunction::not_,
+		BaseFunction::add, BaseFunction::subtract, BaseFunction::multiply, BaseFunction::divide,
+		BaseFunction::remainder_, BaseFunction::power, BaseFunction::compare,
+		BaseFunction::bitwiseNot, BaseFunction::bitwiseAnd, BaseFunction::bitwiseOr, BaseFunction::bitwiseXor,
+		BaseFunction::bitwiseLeft, BaseFunction::bitwiseRight,
+	});
+
+	//-------------------------------------------------------------------------------------------
+
 	static inline const bool _is_force_convert_float(type_data* type) {
 		return type->get_kind() & (type_data::tk_float | type_data::tk_array);
 	}
@@ -247,6 +271,8 @@ namespace gstd {
 			return val->reset(cast, val->as_boolean());
 		case type_data::tk_array:
 			if (type_data* castElem = cast->get_element()) {
+				if (val->is_packed() && val->get_packed_element_kind() == castElem->get_kind())
+					return val->set(cast);
 				if (val->length_as_array() > 0) {
 					std::vector<value> arrVal = *(val->as_array_ptr());
 					for (value& iVal : arrVal)
@@ -603,7 +629,8 @@ namespace gstd {
 			std::vector<value> resArr;
 			resArr.resize(argv->length_as_array());
 			for (size_t i = 0; i < argv->length_as_array(); ++i) {
-				resArr[i] = _script_negative(1, &(*argv)[i]);
+				value v = (*argv)[i];
+				resArr[i] = _script_negative(1, &v);
 			}
 			result.reset(argv->get_type(), resArr);
 			return result;
@@ -677,6 +704,10 @@ namespace gstd {
 						r = sl < sr ? -1 : 1;
 						break;
 					}
+					else if (argv[0].as_string_ptr() && argv[1].as_string_ptr()) {
+						int cmp = argv[0].as_string_ptr()->compare(*argv[1].as_string_ptr());
+						r = (cmp == 0) ? 0 : (cmp < 0) ? -1 : 1;
+					}
 					else {
 						value v[2];
 						for (size_t i = 0; i < sr; ++i) {
@@ -737,7 +768,8 @@ namespace gstd {
 			std::vector<value> resArr;
 			resArr.resize(argv->length_as_array());
 			for (size_t i = 0; i < argv->length_as_array(); ++i) {
-				resArr[i] = predecessor(machine, 1, &(*argv)[i]);
+				value v = (*argv)[i];
+				resArr[i] = predecessor(machine, 1, &v);
 			}
 			result.reset(argv->get_type(), resArr);
 			return result;
@@ -767,7 +799,8 @@ namespace gstd {
 			std::vector<value> resArr;
 			resArr.resize(argv->length_as_array());
 			for (size_t i = 0; i < argv->length_as_array(); ++i) {
-				resArr[i] = successor(machine, 1, &(*argv)[i]);
+				value v = (*argv)[i];
+				resArr[i] = successor(machine, 1, &v);
 			}
 			result.reset(argv->get_type(), resArr);
 			return result;
@@ -948,7 +981,7 @@ namespace gstd {
 		if (!_index_check(machine, arr->get_type(), length, index))
 			return nullptr;
 
-		return &(*arr)[index];
+		return &arr->index_as_array(index);
 	}
 
 	value BaseFunction::slice(script_machine* machine, int argc, const value* argv) {
@@ -38,6 +38,16 @@ namespace gstd {
 		constant(const char* name_, bool d_bool);
 	};
 
+	//Builtins without side effects whose result only depends on their arguments, and that don't use the machine
+	//	for valid arguments. The parser evaluates calls to them when every argument is a constant.
+	class script_pure_functions {
+	public:
+		static bool add(std::initializer_list<dnh_func_callback_t> list);
+		static bool contains(dnh_func_callback_t func);
+	private:
+		static std::set<dnh_func_callback_t>& get_set();
+	};
+
 	class BaseFunction {
 	public:
 		static const void BaseFunction::_raise_error_unsupported(script_machine* machine, type_data* type, const std::string& op_name);
@@ -60,6 +60,11 @@ value::value(type_data* t, value* v) {
 	this->set(t, v);
 }
 value::value(type_data* t, const std::wstring& v) {
+	if (_get_packed_kind(t) == type_data::tk_string) {
+		this->set(t, ref_unsync_ptr<std::wstring>(new std::wstring(v)));
+		return;
+	}
+
 	std::vector<value> vec(v.size());
 	for (size_t i = 0; i < v.size(); ++i)
 		vec[i] = value(t->get_element(), v[i]);
@@ -69,10 +74,70 @@ value::~value() {
 	this->release();
 }
 
+//Storage kind for arrays of type t, tk_null if they can't be packed
+type_data::type_kind value::_get_packed_kind(type_data* t) {
+	if (t == nullptr || t->get_kind() != type_data::tk_array) 
+		return type_data::tk_null;
+	if (type_data* elem = t->get_element()) {
+		switch (elem->get_kind()) {
+		case type_data::tk_char:
+			return type_data::tk_string;
+		case type_data::tk_int:
+			return type_data::tk_packed_int;
+		case type_data::tk_float:
+			return type_data::tk_packed_float;
+		case type_data::tk_boolean:
+			return type_data::tk_packed_boolean;
+		}
+	}
+	return type_data::tk_null;
+}
+template<class F> void value::_visit_packed(F&& fn) const {
+	value* self = const_cast<value*>(this);
+	switch (kind) {
+	case type_data::tk_string:
+		fn(self->p_string_value);
+		break;
+	case type_data::tk_packed_int:
+		fn(self->p_int_array);
+		break;
+	case type_data::tk_packed_float:
+		fn(self->p_float_array);
+		break;
+	case type_data::tk_packed_boolean:
+		fn(self->p_boolean_array);
+		break;
+	}
+}
+
+template<typename T> static T _packed_get(const value& v) {
+	if constexpr (std::is_same_v<T, wchar_t>)
+		return v.as_char();
+	else if constexpr (std::is_same_v<T, int64_t>)
+		return v.as_int();
+	else if constexpr (std::is_same_v<T, double>)
+		return v.as_float();
+	else
+		return v.as_boolean();
+}
+template<class C> static ref_unsync_ptr<C> _packed_create(const std::vector<value>& v) {
+	ref_unsync_ptr<C> res = new C();
+	res->reserve(v.size());
+	for (const value& iVal : v)
+		res->push_back(_packed_get<typename C::value_type>(iVal));
+	return res;
+}
+
 void value::release() {
 	if (!has_data()) return;
 	if (kind == type_data::tk_array)
 		p_array_value.~ref_count_ptr();
+	else {
+		_visit_packed([](auto& p) {
+			using P = std::decay_t<decltype(p)>;
+			p.~P();
+		});
+	}
 }
 
 value* value::reset(type_data* t, int64_t v) {
@@ -133,6 +198,32 @@ value* value::set(type_data* t, value* v) {
 	return this;
 }
 value* value::set(type_data* t, std::vector<value>& v) {
+	type_data::type_kind packedKind = _get_packed_kind(t);
+	if (packedKind != type_data::tk_null) {
+		//Only pack if every element already has the element type
+		type_data::type_kind elemKind = t->get_element()->get_kind();
+		bool bHomogeneous = true;
+		for (const value& iVal : v) {
+			if (!iVal.has_data() || iVal.kind != elemKind) {
+				bHomogeneous = false;
+				break;
+			}
+		}
+
+		if (bHomogeneous) {
+			switch (packedKind) {
+			case type_data::tk_string:
+				return this->set(t, _packed_create<std::wstring>(v));
+			case type_data::tk_packed_int:
+				return this->set(t, _packed_create<std::vector<int64_t>>(v));
+			case type_data::tk_packed_float:
+				return this->set(t, _packed_create<std::vector<double>>(v));
+			case type_data::tk_packed_boolean:
+				return this->set(t, _packed_create<std::vector<bool>>(v));
+			}
+		}
+	}
+
 	kind = type_data::tk_array;
 	type = t;
 	ref_unsync_ptr<std::vector<value>> nv = new std::vector<value>(v);
@@ -145,7 +236,40 @@ value* value::set(type_data* t, ref_unsync_ptr<std::vector<value>> v) {
 	new (&p_array_value) auto(v);
 	return this;
 }
+value* value::set(type_data* t, ref_unsync_ptr<std::wstring> v) {
+	kind = type_data::tk_string;
+	type = t;
+	new (&p_string_value) auto(v);
+	return this;
+}
+value* value::set(type_data* t, ref_unsync_ptr<std::vector<int64_t>> v) {
+	kind = type_data::tk_packed_int;
+	type = t;
+	new (&p_int_array) auto(v);
+	return this;
+}
+value* value::set(type_data* t, ref_unsync_ptr<std::vector<double>> v) {
+	kind = type_data::tk_packed_float;
+	type = t;
+	new (&p_float_array) auto(v);
+	return this;
+}
+value* value::set(type_data* t, ref_unsync_ptr<std::vector<bool>> v) {
+	kind = type_data::tk_packed_boolean;
+	type = t;
+	new (&p_boolean_array) auto(v);
+	return this;
+}
 value* value::set(type_data* t) {
+	if (has_data() && is_packed()) {
+		//Packed arrays can only be retyped into a type with the same element kind
+		if (_get_packed_kind(t) == kind) {
+			type = t;
+			return this;
+		}
+		_unpack();
+	}
+
 	kind = t ? t->get_kind() : type_data::tk_null;
 	type = t;
 	return this;
@@ -171,62 +295,173 @@ value& value::operator=(const value& source) {
 			this->set(source.type, source.ptr_value);
 		else if (kind == type_data::tk_array)
 			this->set(source.type, source.p_array_value);
+		else
+			source._visit_packed([&](auto& p) { this->set(source.type, p); });
 	}
 
 	return *this;
 }
 
+value& value::operator=(value&& source) noexcept {
+	if (this == std::addressof(source)) return *this;
+	this->~value();
+
+	//The refcounted pointers don't point back into the value, so they can be relocated as-is
+	memcpy((void*)this, (const void*)std::addressof(source), sizeof(value));
+	source.kind = type_data::tk_null;
+	source.type = nullptr;
+
+	return *this;
+}
+
+std::atomic<size_t> value::count_array_copy = 0;
 void value::make_unique() {
-	if (has_data() && kind == type_data::tk_array) {
+	if (!has_data()) return;
+	if (kind == type_data::tk_array) {
 		if (p_array_value.use_count() == 1) return;
-		std::vector<value> vec = *p_array_value.get();
-		for (value& v : vec)
-			v.make_unique();
-		this->reset(type, vec);
+
+		//Shallow copy, nested arrays stay shared until they themselves are written to
+		ref_unsync_ptr<std::vector<value>> copy = new std::vector<value>(*p_array_value);
+		count_array_copy.fetch_add(1, std::memory_order_relaxed);
+		type_data* t = type;
+		release();
+		this->set(t, copy);
+	}
+	else if (is_packed()) {
+		type_data* t = type;
+		_visit_packed([&](auto& p) {
+			if (p.use_count() == 1) return;
+
+			using P = std::decay_t<decltype(p)>;
+			using C = std::decay_t<decltype(*p)>;
+			P copy = new C(*p);
+			count_array_copy.fetch_add(1, std::memory_order_relaxed);
+			release();
+			this->set(t, copy);
+		});
 	}
 }
 
+ref_unsync_ptr<std::vector<value>> value::_make_array() const {
+	type_data* elem = type->get_element();
+	ref_unsync_ptr<std::vector<value>> res = new std::vector<value>();
+	_visit_packed([&](auto& p) {
+		using T = typename std::decay_t<decltype(*p)>::value_type;
+		res->reserve(p->size());
+		for (size_t i = 0; i < p->size(); ++i)
+			res->push_back(value(elem, (T)(*p)[i]));
+	});
+	return res;
+}
+//Converts a packed array into an array of values, the value itself stays the same to the script
+void value::_unpack() {
+	if (!has_data() || !is_packed()) return;
+
+	ref_unsync_ptr<std::vector<value>> arr = _make_array();
+	type_data* t = type;
+	release();
+	set(t, arr);
+}
+
 void value::append(type_data* t, const value& x) {
-	if (!has_data() || kind != type_data::tk_array)
+	if (!has_data() || (kind != type_data::tk_array && !is_packed()))
 		this->reset(t, std::vector<value>());
+	else if (kind == type_data::tk_array && p_array_value->empty())
+		this->reset(t, std::vector<value>());		//Start over as packed if possible
+	if (is_packed()) {
+		if (_get_packed_kind(t) == kind && x.has_data() && x.kind == get_packed_element_kind()) {
+			type = t;
+			_visit_packed([&](auto& p) {
+				using T = typename std::decay_t<decltype(*p)>::value_type;
+				p->push_back(_packed_get<T>(x));
+			});
+			return;
+		}
+		_unpack();
+	}
 	//make_unique();
 	type = t;
 	p_array_value->push_back(x);
 }
 void value::concatenate(const value& x) {
-	if (!has_data() || kind != type_data::tk_array)
+	if (!has_data() || (kind != type_data::tk_array && !is_packed()))
 		this->reset(x.type, std::vector<value>());
+	else if (kind == type_data::tk_array && p_array_value->empty() && x.is_packed())
+		this->reset(type->get_element() ? type : x.type, std::vector<value>());
+	if (is_packed()) {
+		if (x.kind == kind) {
+			_visit_packed([&](auto& p) {
+				x._visit_packed([&](auto& px) {
+					if constexpr (std::is_same_v<decltype(p), decltype(px)>)
+						p->insert(p->end(), px->begin(), px->end());
+				});
+			});
+			return;
+		}
+		else if (x.length_as_array() == 0)
+			return;
+		_unpack();
+	}
 	//make_unique();
 	if (type->get_element() == nullptr)
 		type = x.type;
-	p_array_value->insert(array_get_end(),
-		x.array_get_begin(), x.array_get_end());
+	if (ref_unsync_ptr<std::vector<value>> arrX = x.as_array_ptr())
+		p_array_value->insert(p_array_value->end(), arrX->begin(), arrX->end());
 }
 
 size_t value::length_as_array() const {
-	if (has_data() && kind == type_data::tk_array)
+	if (!has_data()) return 0U;
+	if (kind == type_data::tk_array)
 		return p_array_value->size();
-	return 0U;
-}
-const value& value::index_as_array(size_t i) const {
-	if (has_data() && kind == type_data::tk_array)
-		return p_array_value->at(i);
+
+	size_t res = 0U;
+	_visit_packed([&](auto& p) { res = p->size(); });
+	return res;
+}
+value value::index_as_array(size_t i) const {
+	if (has_data()) {
+		if (kind == type_data::tk_array)
+			return p_array_value->at(i);
+		if (is_packed()) {
+			value res;
+			type_data* elem = type->get_element();
+			_visit_packed([&](auto& p) {
+				using T = typename std::decay_t<decltype(*p)>::value_type;
+				res = value(elem, (T)p->at(i));
+			});
+			return res;
+		}
+	}
 	throw wexception("index_as_array: not an array");
 }
 value& value::index_as_array(size_t i) {
+	_unpack();
 	if (has_data() && kind == type_data::tk_array)
 		return p_array_value->at(i);
 	throw wexception("index_as_array: not an array");
 }
-std::vector<value>::iterator value::array_get_begin() const {
-	if (has_data() && kind == type_data::tk_array)
-		return p_array_value->begin();
-	return std::vector<value>::iterator();
-}
-std::vector<value>::iterator value::array_get_end() const {
-	if (has_data() && kind == type_data::tk_array)
-		return p_array_value->end();
-	return std::vector<value>::iterator();
+bool value::index_packed(size_t i, value* res) const {
+	if (!has_data() || !is_packed()) return false;
+
+	type_data* elem = type->get_element();
+	_visit_packed([&](auto& p) {
+		using T = typename std::decay_t<decltype(*p)>::value_type;
+		*res = value(elem, (T)(*p)[i]);
+	});
+	return true;
+}
+type_data::type_kind value::get_packed_element_kind() const {
+	switch (kind) {
+	case type_data::tk_string:
+		return type_data::tk_char;
+	case type_data::tk_packed_int:
+		return type_data::tk_int;
+	case type_data::tk_packed_float:
+		return type_data::tk_float;
+	case type_data::tk_packed_boolean:
+		return type_data::tk_boolean;
+	}
+	return type_data::tk_null;
 }
 
 int64_t value::as_int() const {
@@ -243,6 +478,16 @@ int64_t value::as_int() const {
 		return (int64_t)boolean_value;
 	if (kind == type_data::tk_pointer)
 		return (uint32_t)ptr_value;
+	if (kind == type_data::tk_string) {
+		try {
+			return std::stoll(*p_string_value);
+		}
+		catch (...) {
+			return 0i64;
+		}
+	}
+	if (is_packed())
+		return length_as_array();
 	if (kind == type_data::tk_array) {
 		if (type->get_element()->get_kind() == type_data::tk_char) {
 			try {
@@ -268,6 +513,16 @@ double value::as_float() const {
 		return (double)boolean_value;
 	if (kind == type_data::tk_pointer)
 		return (uint32_t)ptr_value;
+	if (kind == type_data::tk_string) {
+		try {
+			return std::stod(*p_string_value);
+		}
+		catch (...) {
+			return 0.0;
+		}
+	}
+	if (is_packed())
+		return length_as_array();
 	if (kind == type_data::tk_array) {
 		if (type->get_element()->get_kind() == type_data::tk_char) {
 			try {
@@ -293,7 +548,7 @@ wchar_t value::as_char() const {
 		return boolean_value ? L'1' : L'0';
 	if (kind == type_data::tk_pointer)
 		return (wchar_t)(ptr_value != nullptr);
-	if (kind == type_data::tk_array)
+	if (kind == type_data::tk_array || is_packed())
 		return L'\0';
 	return L'\0';
 }
@@ -311,6 +566,8 @@ bool value::as_boolean() const {
 		return (ptr_value != nullptr);
 	if (kind == type_data::tk_array)
 		return (p_array_value->size() != 0U);
+	if (is_packed())
+		return (length_as_array() != 0U);
 	return false;
 }
 std::wstring value::as_string() const {
@@ -325,6 +582,21 @@ std::wstring value::as_string() const {
 		return std::wstring(&char_value, 1);
 	if (kind == type_data::tk_pointer)
 		return StringUtility::Format(L"%08x", (uint32_t)ptr_value);
+	if (kind == type_data::tk_string)
+		return *p_string_value;
+	if (is_packed()) {
+		std::wstring result = L"[";
+		type_data* elem = type->get_element();
+		_visit_packed([&](auto& p) {
+			using T = typename std::decay_t<decltype(*p)>::value_type;
+			for (size_t i = 0; i < p->size(); ++i) {
+				if (i > 0) result += L",";
+				result += value(elem, (T)(*p)[i]).as_string();
+			}
+		});
+		result += L"]";
+		return result;
+	}
 	if (kind == type_data::tk_array) {
 		std::wstring result = L"";
 		if (type_data* elem = type->get_element()) {
@@ -352,5 +624,7 @@ ref_unsync_ptr<std::vector<value>> value::as_array_ptr() const {
 	if (!has_data()) return nullptr;
 	if (kind == type_data::tk_array)
 		return p_array_value;
+	if (is_packed())
+		return _make_array();
 	return nullptr;
 }
\ No newline at end of file
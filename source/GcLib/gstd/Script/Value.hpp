@@ -14,7 +14,12 @@ namespace gstd {
 			tk_boolean	= 0x08,
 			tk_array	= 0x10,
 			tk_pointer	= 0x20,
-			tk_string	= 0x40,	//Dummy for the parser
+			tk_string	= 0x40,	//Dummy for the parser, also the storage kind of packed strings
+
+			//Storage kinds of packed numeric arrays, internal to value and never used as a type
+			tk_packed_int		= 0x81,
+			tk_packed_float		= 0x82,
+			tk_packed_boolean	= 0x88,
 		} type_kind;
 
 		type_data(type_kind k, type_data* t = nullptr) : kind(k), element(t) {}
@@ -33,6 +38,10 @@ namespace gstd {
 		type_data* element = nullptr;
 	};
 
+	//Homogeneous char/int/float/bool arrays keep their array type, but are stored packed in a refcounted
+	//	std::wstring or std::vector (kinds tk_string and tk_packed_*), and are only unpacked into an array of values
+	//	once an element is accessed by reference or a write would make them heterogeneous;
+	//	const accessors read the packed storage directly and never unpack
 	class value {
 	private:
 		type_data::type_kind kind = type_data::tk_null;
@@ -47,8 +56,20 @@ namespace gstd {
 				value* ptr_value;
 			};
 			ref_unsync_ptr<std::vector<value>> p_array_value;
+			ref_unsync_ptr<std::wstring> p_string_value;
+			ref_unsync_ptr<std::vector<int64_t>> p_int_array;
+			ref_unsync_ptr<std::vector<double>> p_float_array;
+			ref_unsync_ptr<std::vector<bool>> p_boolean_array;
 		};
+
+		static type_data::type_kind _get_packed_kind(type_data* t);
+		template<class F> void _visit_packed(F&& fn) const;
+		ref_unsync_ptr<std::vector<value>> _make_array() const;
+		void _unpack();
 	public:
+		//Arrays copied by make_unique to detach them from other owners, over the whole process
+		static std::atomic<size_t> count_array_copy;
+
 		value() {}
 		value(type_data* t, int64_t v);
 		value(type_data* t, double v);
@@ -59,11 +80,16 @@ namespace gstd {
 		value(const value& source) {
 			*this = source;
 		}
+		value(value&& source) noexcept {
+			*this = std::move(source);
+		}
 
 		~value();
 		void release();
 
 		value& operator=(const value& source);
+		//Takes over the source's data without touching refcounts, leaving the source empty
+		value& operator=(value&& source) noexcept;
 
 		//--------------------------------------------------------------------------
 
@@ -80,8 +106,13 @@ namespace gstd {
 		value* set(type_data* t, value* v);
 		value* set(type_data* t, std::vector<value>& v);
 		value* set(type_data* t, ref_unsync_ptr<std::vector<value>> v);
+		value* set(type_data* t, ref_unsync_ptr<std::wstring> v);
+		value* set(type_data* t, ref_unsync_ptr<std::vector<int64_t>> v);
+		value* set(type_data* t, ref_unsync_ptr<std::vector<double>> v);
+		value* set(type_data* t, ref_unsync_ptr<std::vector<bool>> v);
 		value* set(type_data* t);
 
+		//Detaches the array from other values sharing it, call before writing to its elements
 		void make_unique();
 
 		void append(type_data* t, const value& x);
@@ -93,13 +124,14 @@ namespace gstd {
 		type_data* get_type() const { return type; }
 
 		size_t length_as_array() const;
-		const value& index_as_array(size_t i) const;
+		value index_as_array(size_t i) const;
 		value& index_as_array(size_t i);
 
-		std::vector<value>::iterator array_get_begin() const;
-		std::vector<value>::iterator array_get_end() const;
+		bool is_packed() const { return kind == type_data::tk_string || ((uint8_t)kind & 0x80) != 0; }
+		type_data::type_kind get_packed_element_kind() const;
+		bool index_packed(size_t i, value* res) const;
 
-		const value& operator[](size_t i) const { return index_as_array(i); }
+		value operator[](size_t i) const { return index_as_array(i); }
 
 		//--------------------------------------------------------------------------
 
@@ -109,7 +141,11 @@ namespace gstd {
 		bool as_boolean() const;
 		value* as_ptr() const { return ptr_value; }
 		std::wstring as_string() const;
+		const std::wstring* as_string_ptr() const { return kind == type_data::tk_string ? p_string_value.get() : nullptr; }
+		const std::vector<int64_t>* as_int_array_ptr() const { return kind == type_data::tk_packed_int ? p_int_array.get() : nullptr; }
+		const std::vector<double>* as_float_array_ptr() const { return kind == type_data::tk_packed_float ? p_float_array.get() : nullptr; }
 
+		//Packed arrays return a new array of their elements
 		ref_unsync_ptr<std::vector<value>> as_array_ptr() const;
 	};
 #pragma pack(pop)
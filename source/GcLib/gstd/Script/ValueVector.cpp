@@ -89,6 +89,10 @@ void script_value_vector::push_back(const value& value) {
 	at[length++] = value;
 	if (length + 1 >= capacity) expand();
 }
+void script_value_vector::push_back(value&& value) {
+	at[length++] = std::move(value);
+	if (length + 1 >= capacity) expand();
+}
 void script_value_vector::pop_back(size_t count) {
 	if (length < count) count = length;
 	length -= count;
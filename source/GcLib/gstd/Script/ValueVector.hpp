@@ -27,6 +27,7 @@ namespace gstd {
 		void expand();
 
 		void push_back(const value& value);
+		void push_back(value&& value);
 		void pop_back(size_t count = 1U);
 
 		void clear();
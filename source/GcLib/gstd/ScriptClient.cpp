@@ -1,5 +1,7 @@
 #include "source/GcLib/pch.h"
 
+#include <intrin.h>
+
 #include "ScriptClient.hpp"
 #include "File.hpp"
 #include "Logger.hpp"
@@ -44,6 +46,279 @@ bool ScriptEngineCache::IsExists(const std::wstring& name) {
 	return cache_.find(name) != cache_.end();
 }
 
+//****************************************************************************
+//ScriptIncludeCache
+//****************************************************************************
+gstd::CriticalSection ScriptIncludeCache::lock_;
+std::map<std::pair<std::wstring, Encoding::Type>, ScriptIncludeCache::Entry> ScriptIncludeCache::mapEntry_;
+size_t ScriptIncludeCache::countHit_ = 0U;
+size_t ScriptIncludeCache::countMiss_ = 0U;
+
+Encoding::Type ScriptIncludeCache::_GetKeyEncoding(Encoding::Type encoding) {
+	//The BOM is stripped, so both UTF-8 variants produce the same result
+	return encoding == Encoding::UTF8BOM ? Encoding::UTF8 : encoding;
+}
+bool ScriptIncludeCache::GetFileStamp(const std::wstring& path, Stamp* pStamp) {
+	std::error_code err;
+	uint64_t size = stdfs::file_size(path, err);
+	if (err) return false;
+	auto time = stdfs::last_write_time(path, err);
+	if (err) return false;
+
+	pStamp->size = size;
+	pStamp->time = time.time_since_epoch().count();
+	pStamp->hash = 0U;
+	return true;
+}
+ScriptIncludeCache::Stamp ScriptIncludeCache::GetDataStamp(const char* data, size_t size) {
+	return Stamp{ size, 0, HashUtility::Fnv1a64(data, size) };
+}
+bool ScriptIncludeCache::Find(const std::wstring& path, Encoding::Type encoding, const Stamp& stamp, std::vector<char>& res) {
+	Lock lock(lock_);
+
+	auto itrFind = mapEntry_.find(std::make_pair(path, _GetKeyEncoding(encoding)));
+	if (itrFind == mapEntry_.end() || itrFind->second.stamp != stamp) {
+		++countMiss_;
+		return false;
+	}
+
+	res = itrFind->second.source;
+	++countHit_;
+	return true;
+}
+void ScriptIncludeCache::Store(const std::wstring& path, Encoding::Type encoding, const Stamp& stamp, const std::vector<char>& source) {
+	Lock lock(lock_);
+
+	Entry& entry = mapEntry_[std::make_pair(path, _GetKeyEncoding(encoding))];
+	entry.stamp = stamp;
+	entry.source = source;
+}
+size_t ScriptIncludeCache::GetCacheCount() {
+	Lock lock(lock_);
+	return mapEntry_.size();
+}
+
+//****************************************************************************
+//ScriptProfiler
+//****************************************************************************
+thread_local ScriptProfiler::ThreadData ScriptProfiler::threadData_;
+gstd::CriticalSection ScriptProfiler::lock_;
+std::atomic<bool> ScriptProfiler::bEnable_ = false;
+std::atomic<uint64_t> ScriptProfiler::epoch_ = 0;
+script_profiler ScriptProfiler::profiler_;
+std::map<script_engine*, shared_ptr<ScriptEngineData>> ScriptProfiler::mapEngine_;
+uint64_t ScriptProfiler::tickCalibrate_ = 0;
+stdch::steady_clock::time_point ScriptProfiler::timeCalibrate_;
+
+ScriptProfiler::Scope::Scope(shared_ptr<ScriptEngineData>& engine, script_machine* machine) {
+	machine_ = machine;
+	bActive_ = false;
+
+	ThreadData& data = threadData_;
+	if (data.depth == 0) {
+		uint64_t epoch = epoch_;
+		if (data.epoch != epoch) {
+			data.profiler.clear();
+			data.mapEngine.clear();
+			data.epoch = epoch;
+		}
+		if (!bEnable_) {
+			//Hand over what was collected since the last publish before profiling was stopped
+			if (!data.profiler.empty())
+				_Publish(data);
+			machine_->set_profiler(nullptr);
+			return;
+		}
+	}
+
+	data.mapEngine.insert(std::make_pair(engine->GetEngine().get(), engine));
+	machine_->set_profiler(&data.profiler);
+	++data.depth;
+	bActive_ = true;
+}
+ScriptProfiler::Scope::~Scope() {
+	machine_->set_profiler(nullptr);
+	if (!bActive_) return;
+
+	ThreadData& data = threadData_;
+	if (--data.depth == 0 && SystemUtility::GetCpuTime2() - data.timePublish >= PUBLISH_PERIOD)
+		_Publish(data);
+}
+
+void ScriptProfiler::_Publish(ThreadData& data) {
+	data.timePublish = SystemUtility::GetCpuTime2();
+	{
+		Lock lock(lock_);
+		if (data.epoch == epoch_) {
+			profiler_.merge(data.profiler);
+			mapEngine_.insert(data.mapEngine.begin(), data.mapEngine.end());
+		}
+	}
+	data.profiler.clear();
+	data.mapEngine.clear();
+}
+
+std::wstring ScriptProfiler::_GetFunctionName(const script_block* block) {
+	if (block->name.size() == 0) return L"(main)";
+	return StringUtility::ConvertMultiToWide(block->name);
+}
+void ScriptProfiler::_GetOriginalLine(script_engine* engine, int line, std::wstring& path, int& lineOriginal) {
+	path = L"";
+	lineOriginal = line;
+
+	auto itrEngine = mapEngine_.find(engine);
+	if (itrEngine == mapEngine_.end()) return;
+
+	ScriptEngineData* data = itrEngine->second.get();
+	path = data->GetPath();
+	if (ScriptFileLineMap::Entry* entry = data->GetScriptFileLineMap()->GetEntry(line)) {
+		lineOriginal = entry->lineEndOriginal_ - (entry->lineEnd_ - line);
+		path = entry->path_;
+	}
+}
+
+void ScriptProfiler::SetEnable(bool bEnable) {
+	Lock lock(lock_);
+	if (bEnable && tickCalibrate_ == 0) {
+		tickCalibrate_ = __rdtsc();
+		timeCalibrate_ = SystemUtility::GetCpuTime();
+	}
+	bEnable_ = bEnable;
+}
+void ScriptProfiler::Clear() {
+	Lock lock(lock_);
+	++epoch_;
+	profiler_.clear();
+	mapEngine_.clear();
+}
+
+double ScriptProfiler::GetTickFrequency() {
+	Lock lock(lock_);
+	if (tickCalibrate_ == 0) return 0;
+
+	uint64_t tick = __rdtsc();
+	double seconds = stdch::duration<double>(SystemUtility::GetCpuTime() - timeCalibrate_).count();
+	if (seconds <= 0) return 0;
+	return (tick - tickCalibrate_) / seconds;
+}
+
+uint64_t ScriptProfiler::GetTotalTime() {
+	Lock lock(lock_);
+
+	uint64_t res = 0;
+	for (auto& [block, data] : profiler_.get_block_map()) {
+		for (uint64_t time : data.time)
+			res += time;
+	}
+	return res;
+}
+void ScriptProfiler::GetLineData(std::vector<LineData>& res) {
+	res.clear();
+
+	//Inlined blocks and multiple instructions share a line, merge them by file position
+	std::map<std::tuple<std::wstring, int, std::wstring>, std::pair<uint64_t, uint64_t>> mapLine;
+	{
+		Lock lock(lock_);
+		for (auto& [block, data] : profiler_.get_block_map()) {
+			std::wstring function = _GetFunctionName(block);
+			int linePrev = -1;
+			for (size_t ip = 0; ip < data.count.size(); ++ip) {
+				if (data.count[ip] == 0) continue;
+
+				int line = block->codes[ip].GetLine();
+				std::wstring path;
+				int lineOriginal;
+				_GetOriginalLine(data.engine, line, path, lineOriginal);
+
+				auto& total = mapLine[std::make_tuple(path, lineOriginal, function)];
+				//Count the line once per run of consecutive instructions on it
+				if (line != linePrev)
+					total.first += data.count[ip];
+				total.second += data.time[ip];
+				linePrev = line;
+			}
+		}
+	}
+
+	res.reserve(mapLine.size());
+	for (auto& [key, total] : mapLine) {
+		LineData data;
+		data.path = std::get<0>(key);
+		data.line = std::get<1>(key);
+		data.function = std::get<2>(key);
+		data.count = total.first;
+		data.time = total.second;
+		res.push_back(data);
+	}
+	std::sort(res.begin(), res.end(),
+		[](const LineData& a, const LineData& b) { return a.time > b.time; });
+}
+void ScriptProfiler::GetFunctionData(std::vector<FunctionData>& res) {
+	res.clear();
+
+	Lock lock(lock_);
+	for (auto& [block, data] : profiler_.get_block_map()) {
+		FunctionData fData;
+		fData.name = _GetFunctionName(block);
+		fData.bBuiltin = false;
+		fData.count = data.count.size() > 0 ? data.count[0] : 0;
+		fData.time = 0;
+		for (uint64_t time : data.time)
+			fData.time += time;
+		res.push_back(fData);
+	}
+	for (auto& [block, data] : profiler_.get_builtin_map()) {
+		FunctionData fData;
+		fData.name = _GetFunctionName(block);
+		fData.bBuiltin = true;
+		fData.count = data.count;
+		fData.time = data.time;
+		res.push_back(fData);
+	}
+	std::sort(res.begin(), res.end(),
+		[](const FunctionData& a, const FunctionData& b) { return a.time > b.time; });
+}
+
+bool ScriptProfiler::ExportFlamegraph(const std::wstring& path) {
+	//Weights are written in microseconds
+	double frequency = GetTickFrequency();
+	double usPerTick = frequency > 0 ? 1000000.0 / frequency : 1.0;
+
+	std::string text;
+	{
+		Lock lock(lock_);
+
+		auto& mapBlock = profiler_.get_block_map();
+		for (auto& [key, tick] : profiler_.get_stack_map()) {
+			const std::vector<const script_block*>& listBlock = key.first;
+			uint64_t time = (uint64_t)(tick * usPerTick);
+			if (listBlock.size() == 0 || time == 0) continue;
+
+			std::wstring frames;
+			for (const script_block* block : listBlock) {
+				frames += _GetFunctionName(block);
+				frames += L";";
+			}
+
+			std::wstring pathLine;
+			int lineOriginal = key.second;
+			auto itrBlock = mapBlock.find(listBlock.back());
+			if (itrBlock != mapBlock.end())
+				_GetOriginalLine(itrBlock->second.engine, key.second, pathLine, lineOriginal);
+			frames += StringUtility::Format(L"%s:%d", PathProperty::GetFileName(pathLine).c_str(), lineOriginal);
+
+			text += StringUtility::ConvertWideToMulti(frames);
+			text += StringUtility::Format(" %llu\n", time);
+		}
+	}
+
+	File file(path);
+	File::CreateFileDirectory(path);
+	if (!file.Open(File::WRITEONLY)) return false;
+	file.Write(text.data(), text.size());
+	return true;
+}
+
 //****************************************************************************
 //ScriptClientBase
 //****************************************************************************
@@ -271,6 +546,18 @@ static const std::vector<constant> commonConstant = {
 	constant("M_PHI", GM_PHI),
 	constant("M_1_PHI", GM_1_PHI),
 };
+static const bool _bRegisteredPure = script_pure_functions::add({
+	ScriptClientBase::Func_Min, ScriptClientBase::Func_Max, ScriptClientBase::Func_Clamp,
+	ScriptClientBase::Func_Log, ScriptClientBase::Func_Log2, ScriptClientBase::Func_Log10, ScriptClientBase::Func_LogN,
+	ScriptClientBase::Func_Cos, ScriptClientBase::Func_Sin, ScriptClientBase::Func_Tan,
+	ScriptClientBase::Func_RCos, ScriptClientBase::Func_RSin, ScriptClientBase::Func_RTan,
+	ScriptClientBase::Func_Acos, ScriptClientBase::Func_Asin, ScriptClientBase::Func_Atan, ScriptClientBase::Func_Atan2,
+	ScriptClientBase::Func_RAcos, ScriptClientBase::Func_RAsin, ScriptClientBase::Func_RAtan, ScriptClientBase::Func_RAtan2,
+	ScriptClientBase::Func_ToDegrees, ScriptClientBase::Func_ToRadians,
+	ScriptClientBase::Func_Exp, ScriptClientBase::Func_Sqrt, ScriptClientBase::Func_Cbrt, ScriptClientBase::Func_NRoot,
+	ScriptClientBase::Func_Hypot, ScriptClientBase::Func_Distance, ScriptClientBase::Func_DistanceSq,
+	ScriptClientBase::Func_ToString, ScriptClientBase::Func_ItoA, ScriptClientBase::Func_RtoA,
+});
 
 unique_ptr<script_type_manager> ScriptClientBase::pTypeManager_ = unique_ptr<script_type_manager>(new script_type_manager());
 uint64_t ScriptClientBase::randCalls_ = 0;
@@ -431,6 +718,8 @@ void ScriptClientBase::Compile() {
 			bError_ = true;
 			_RaiseErrorFromEngine();
 		}
+		if (script_engine::option_keep_unoptimized)
+			_DumpBytecode();
 		if (cache_ != nullptr && engine_->GetPath().size() > 0) {
 			cache_->AddCache(engine_->GetPath(), engine_);
 		}
@@ -444,6 +733,23 @@ void ScriptClientBase::Compile() {
 	machine_->data = this;
 }
 
+//Writes the bytecode listings of the compiled script to temp/bytecode, before and after optimization
+void ScriptClientBase::_DumpBytecode() {
+	script_engine* engine = engine_->GetEngine().get();
+	if (engine == nullptr) return;
+
+	std::wstring pathBase = PathProperty::GetModuleDirectory() + L"temp/bytecode/"
+		+ PathProperty::GetFileName(engine_->GetPath());
+	auto _Write = [](const std::wstring& path, const std::string& text) {
+		File file(path);
+		File::CreateFileDirectory(path);
+		if (file.Open(File::WRITEONLY))
+			file.Write((void*)text.data(), text.size());
+	};
+	_Write(pathBase + L".unoptimized.txt", engine->listing_unoptimized);
+	_Write(pathBase + L".txt", engine->disassemble());
+}
+
 void ScriptClientBase::Reset() {
 	if (machine_)
 		machine_->reset();
@@ -451,7 +757,10 @@ void ScriptClientBase::Reset() {
 }
 bool ScriptClientBase::Run() {
 	if (bError_) return false;
-	machine_->run();
+	{
+		ScriptProfiler::Scope scopeProfiler(engine_, machine_.get());
+		machine_->run();
+	}
 	if (machine_->get_error()) {
 		bError_ = true;
 		_RaiseErrorFromMachine();
@@ -472,7 +781,10 @@ bool ScriptClientBase::Run(std::map<std::string, script_block*>::iterator target
 	if (bError_) return false;
 
 	//Run();
-	machine_->call(target);
+	{
+		ScriptProfiler::Scope scopeProfiler(engine_, machine_.get());
+		machine_->call(target);
+	}
 
 	if (machine_->get_error()) {
 		bError_ = true;
@@ -859,9 +1171,9 @@ static value _ScriptValueLerp(script_machine* machine, const value* v1, const va
 			std::vector<value> resArr;
 			resArr.resize(v1->length_as_array());
 			for (size_t i = 0; i < v1->length_as_array(); ++i) {
-				const value* a1 = &(*v1)[i];
-				const value* a2 = &(*v2)[i];
-				resArr[i] = _ScriptValueLerp(machine, a1, a2, vx, lerpFunc);
+				value a1 = (*v1)[i];
+				value a2 = (*v2)[i];
+				resArr[i] = _ScriptValueLerp(machine, &a1, &a2, vx, lerpFunc);
 			}
 
 			res.reset(v1->get_type(), resArr);
@@ -1863,8 +2175,8 @@ void ScriptLoader::_DumpRes() {
 			file.Write(&strNewLine[0], strNewLine.size());
 		}
 
-		std::list<ScriptFileLineMap::Entry>& listEntry = mapLine_->GetEntryList();
-		std::list<ScriptFileLineMap::Entry>::iterator itr = listEntry.begin();
+		std::vector<ScriptFileLineMap::Entry>& listEntry = mapLine_->GetEntryList();
+		std::vector<ScriptFileLineMap::Entry>::iterator itr = listEntry.begin();
 
 		for (; itr != listEntry.end(); itr++) {
 			if (encoding_ == Encoding::UTF16LE) {
@@ -2016,88 +2328,7 @@ void ScriptLoader::_ParseInclude() {
 						setIncludedPath_.insert(wPath);
 
 						std::vector<char> bufIncluding;
-						{
-							shared_ptr<FileReader> reader = FileManager::GetBase()->GetFileReader(wPath);
-							if (reader == nullptr || !reader->Open()) {
-								std::wstring error = StringUtility::Format(
-									L"Include file is not found. [%s]\r\n", wPath.c_str());
-								_RaiseError(directiveLine, error);
-							}
-
-							//Detect target encoding
-							size_t targetBomSize = 0;
-							Encoding::Type includeEncoding = Encoding::UTF8;
-							if (reader->GetFileSize() >= 2) {
-								byte data[3];
-								reader->Read(data, 3);
-
-								includeEncoding = Encoding::Detect((char*)data, reader->GetFileSize());
-								targetBomSize = Encoding::GetBomSize(includeEncoding);
-
-								reader->SetFilePointerBegin();
-							}
-
-							if (reader->GetFileSize() >= targetBomSize) {
-								reader->Seek(targetBomSize);
-								bufIncluding.resize(reader->GetFileSize() - targetBomSize); //- BOM size
-								reader->Read(&bufIncluding[0], bufIncluding.size());
-							}
-
-							if (bufIncluding.size() > 0U) {
-								if (includeEncoding == Encoding::UTF16LE || includeEncoding == Encoding::UTF16BE) {
-									//Including UTF-16
-
-									//Convert the including file to UTF-8
-									if (encoding_ == Encoding::UTF8 || encoding_ == Encoding::UTF8BOM) {
-										if (includeEncoding == Encoding::UTF16BE) {
-											for (auto wItr = bufIncluding.begin(); wItr != bufIncluding.end(); wItr += 2) {
-												std::swap(*wItr, *(wItr + 1));
-											}
-										}
-
-										std::vector<char> mbres;
-										size_t countMbRes = StringUtility::ConvertWideToMulti(
-											(wchar_t*)bufIncluding.data(), bufIncluding.size() / 2U, mbres, CP_UTF8);
-										if (countMbRes == 0) {
-											std::wstring error = StringUtility::Format(L"Error reading include file. "
-												"(%s -> UTF-8) [%s]\r\n",
-												Encoding::WStringRepresentation(includeEncoding), wPath.c_str());
-											_RaiseError(scanner_->GetCurrentLine(), error);
-										}
-
-										includeEncoding = encoding_;
-										bufIncluding = mbres;
-									}
-								}
-								else {
-									//Including UTF-8
-
-									//Convert the include file to UTF-16 if it's in UTF-8
-									if (encoding_ == Encoding::UTF16LE || encoding_ == Encoding::UTF16BE) {
-										size_t includeSize = bufIncluding.size();
-
-										std::vector<char> wplacement;
-										size_t countWRes = StringUtility::ConvertMultiToWide(bufIncluding.data(),
-											includeSize, wplacement, CP_UTF8);
-										if (countWRes == 0) {
-											std::wstring error = StringUtility::Format(L"Error reading include file. "
-												"(UTF-8 -> %s) [%s]\r\n",
-												Encoding::WStringRepresentation(encoding_), wPath.c_str());
-											_RaiseError(scanner_->GetCurrentLine(), error);
-										}
-
-										bufIncluding = wplacement;
-
-										//Swap bytes for UTF-16 BE
-										if (encoding_ == Encoding::UTF16BE) {
-											for (auto wItr = bufIncluding.begin(); wItr != bufIncluding.end(); wItr += 2) {
-												std::swap(*wItr, *(wItr + 1));
-											}
-										}
-									}
-								}
-							}
-						}
+						_ReadIncludeFile(wPath, directiveLine, bufIncluding);
 
 						{
 							ScriptLoader includeLoader(script_, pathSource_, bufIncluding, mapLine_);
@@ -2130,6 +2361,102 @@ void ScriptLoader::_ParseInclude() {
 		if (!_SkipToNextValidLine()) break;
 	}
 }
+void ScriptLoader::_ReadIncludeFile(const std::wstring& path, int line, std::vector<char>& res) {
+	shared_ptr<FileReader> reader = FileManager::GetBase()->GetFileReader(path);
+	if (reader == nullptr || !reader->Open()) {
+		std::wstring error = StringUtility::Format(
+			L"Include file is not found. [%s]\r\n", path.c_str());
+		_RaiseError(line, error);
+	}
+
+	//A file on disk is looked up before it is read, an edit changes its size or write time
+	ScriptIncludeCache::Stamp stamp;
+	bool bFileStamp = !reader->IsArchived() && ScriptIncludeCache::GetFileStamp(path, &stamp);
+	if (bFileStamp && ScriptIncludeCache::Find(path, encoding_, stamp, res))
+		return;
+
+	std::vector<char> bufFile;
+	bufFile.resize(reader->GetFileSize());
+	if (bufFile.size() > 0U)
+		reader->Read(bufFile.data(), bufFile.size());
+	reader->Close();
+
+	if (!bFileStamp) {
+		stamp = ScriptIncludeCache::GetDataStamp(bufFile.data(), bufFile.size());
+		if (ScriptIncludeCache::Find(path, encoding_, stamp, res))
+			return;
+	}
+
+	//Detect target encoding
+	size_t targetBomSize = 0;
+	Encoding::Type includeEncoding = Encoding::UTF8;
+	if (bufFile.size() >= 2) {
+		includeEncoding = Encoding::Detect(bufFile.data(), bufFile.size());
+		targetBomSize = Encoding::GetBomSize(includeEncoding);
+	}
+
+	std::vector<char>& bufIncluding = res;
+	bufIncluding.clear();
+	if (bufFile.size() >= targetBomSize)
+		bufIncluding.assign(bufFile.begin() + targetBomSize, bufFile.end()); //- BOM size
+
+	if (bufIncluding.size() > 0U) {
+		if (includeEncoding == Encoding::UTF16LE || includeEncoding == Encoding::UTF16BE) {
+			//Including UTF-16
+
+			//Convert the including file to UTF-8
+			if (encoding_ == Encoding::UTF8 || encoding_ == Encoding::UTF8BOM) {
+				if (includeEncoding == Encoding::UTF16BE) {
+					for (auto wItr = bufIncluding.begin(); wItr != bufIncluding.end(); wItr += 2) {
+						std::swap(*wItr, *(wItr + 1));
+					}
+				}
+
+				std::vector<char> mbres;
+				size_t countMbRes = StringUtility::ConvertWideToMulti(
+					(wchar_t*)bufIncluding.data(), bufIncluding.size() / 2U, mbres, CP_UTF8);
+				if (countMbRes == 0) {
+					std::wstring error = StringUtility::Format(L"Error reading include file. "
+						"(%s -> UTF-8) [%s]\r\n",
+						Encoding::WStringRepresentation(includeEncoding), path.c_str());
+					_RaiseError(scanner_->GetCurrentLine(), error);
+				}
+
+				includeEncoding = encoding_;
+				bufIncluding = mbres;
+			}
+		}
+		else {
+			//Including UTF-8
+
+			//Convert the include file to UTF-16 if it's in UTF-8
+			if (encoding_ == Encoding::UTF16LE || encoding_ == Encoding::UTF16BE) {
+				size_t includeSize = bufIncluding.size();
+
+				std::vector<char> wplacement;
+				size_t countWRes = StringUtility::ConvertMultiToWide(bufIncluding.data(),
+					includeSize, wplacement, CP_UTF8);
+				if (countWRes == 0) {
+					std::wstring error = StringUtility::Format(L"Error reading include file. "
+						"(UTF-8 -> %s) [%s]\r\n",
+						Encoding::WStringRepresentation(encoding_), path.c_str());
+					_RaiseError(scanner_->GetCurrentLine(), error);
+				}
+
+				bufIncluding = wplacement;
+
+				//Swap bytes for UTF-16 BE
+				if (encoding_ == Encoding::UTF16BE) {
+					for (auto wItr = bufIncluding.begin(); wItr != bufIncluding.end(); wItr += 2) {
+						std::swap(*wItr, *(wItr + 1));
+					}
+				}
+			}
+		}
+	}
+
+	ScriptIncludeCache::Store(path, encoding_, stamp, bufIncluding);
+}
 void ScriptLoader::_ParseIfElse() {
 	struct _DirectivePos {
 		size_t posBefore;
@@ -2344,6 +2671,17 @@ ScriptFileLineMap::ScriptFileLineMap() {
 }
 ScriptFileLineMap::~ScriptFileLineMap() {
 
+}
+size_t ScriptFileLineMap::_GetEntryIndex(int line) {
+	//Entries are sorted and disjoint, find the last one that starts at or before the line
+	auto itr = std::upper_bound(listEntry_.begin(), listEntry_.end(), line,
+		[](int l, const Entry& entry) { return l < entry.lineStart_; });
+	if (itr != listEntry_.begin()) {
+		size_t index = std::distance(listEntry_.begin(), itr) - 1U;
+		if (line <= listEntry_[index].lineEnd_)
+			return index;
+	}
+	return listEntry_.size() - 1U;
 }
 void ScriptFileLineMap::AddEntry(const std::wstring& path, int lineAdd, int lineCount) {
 	Entry entryNew;
@@ -2357,53 +2695,49 @@ void ScriptFileLineMap::AddEntry(const std::wstring& path, int lineAdd, int line
 		return;
 	}
 
-	Entry* pEntryDivide = nullptr;
-	std::list<Entry>::iterator itrInsert;
-	for (itrInsert = listEntry_.begin(); itrInsert != listEntry_.end(); itrInsert++) {
-		pEntryDivide = (Entry*)&*itrInsert;
-		if (lineAdd >= pEntryDivide->lineStart_ && lineAdd <= pEntryDivide->lineEnd_) break;
-	}
-
-	Entry& entryDivide = *pEntryDivide;
+	//The directive line at lineAdd is replaced by lineCount lines
+	size_t indexDivide = _GetEntryIndex(lineAdd);
+	size_t indexShift = 0;
+	Entry& entryDivide = listEntry_[indexDivide];
 	if (entryDivide.lineStart_ == lineAdd) {
+		entryDivide.lineStart_++;
 		entryDivide.lineStartOriginal_++;
-		listEntry_.insert(itrInsert, entryNew);
+		if (entryDivide.lineStart_ > entryDivide.lineEnd_)
+			listEntry_[indexDivide] = entryNew;	//Nothing left of the divided entry
+		else
+			listEntry_.insert(listEntry_.begin() + indexDivide, entryNew);
+		indexShift = indexDivide + 1;
 	}
 	else if (entryDivide.lineEnd_ == lineAdd) {
 		entryDivide.lineEnd_--;
 		entryDivide.lineEndOriginal_--;
 
-		listEntry_.insert(itrInsert, entryNew);
-		itrInsert++;
+		listEntry_.insert(listEntry_.begin() + indexDivide + 1, entryNew);
+		indexShift = indexDivide + 2;
 	}
 	else {
 		Entry entryNew2 = entryDivide;
 		entryDivide.lineEnd_ = lineAdd - 1;
-		entryDivide.lineEndOriginal_ = lineAdd - entryDivide.lineStart_;
+		entryDivide.lineEndOriginal_ = entryDivide.lineStartOriginal_ + (lineAdd - entryDivide.lineStart_) - 1;
 
 		entryNew2.lineStartOriginal_ = entryDivide.lineEndOriginal_ + 2;
 		entryNew2.lineStart_ = entryNew.lineEnd_ + 1;
 		entryNew2.lineEnd_ += lineCount - 1;
 
-		if (itrInsert != listEntry_.end())
-			itrInsert++;
-		listEntry_.insert(itrInsert, entryNew);
-		listEntry_.insert(itrInsert, entryNew2);
+		Entry listNew[2] = { entryNew, entryNew2 };
+		listEntry_.insert(listEntry_.begin() + indexDivide + 1, listNew, listNew + 2);
+		indexShift = indexDivide + 3;
 	}
 
-	for (; itrInsert != listEntry_.end(); itrInsert++) {
-		Entry& entry = *itrInsert;
+	for (size_t i = indexShift; i < listEntry_.size(); ++i) {
+		Entry& entry = listEntry_[i];
 		entry.lineStart_ += lineCount - 1;
 		entry.lineEnd_ += lineCount - 1;
 	}
 }
 ScriptFileLineMap::Entry* ScriptFileLineMap::GetEntry(int line) {
-	Entry* res = nullptr;
-	for (auto itrInsert = listEntry_.begin(); itrInsert != listEntry_.end(); itrInsert++) {
-		res = &*itrInsert;
-		if (line >= res->lineStart_ && line <= res->lineEnd_) break;
-	}
-	return res;
+	if (listEntry_.size() == 0) return nullptr;
+	return &listEntry_[_GetEntryIndex(line)];
 }
 std::wstring& ScriptFileLineMap::GetPath(int line) {
 	Entry* entry = GetEntry(line);
@@ -2751,3 +3085,161 @@ void ScriptCommonDataInfoPanel::_UpdateValueView() {
 	for (; iRow < countRow; ++iRow)
 		wndListViewValue_.DeleteRow(iRow);
 }
+
+//****************************************************************************
+//ScriptProfilerInfoPanel
+//****************************************************************************
+ScriptProfilerInfoPanel::ScriptProfilerInfoPanel() {
+}
+bool ScriptProfilerInfoPanel::_AddedLogger(HWND hTab) {
+	Create(hTab);
+
+	gstd::WButton::Style buttonStyle;
+	buttonStyle.SetStyle(WS_CHILD | WS_VISIBLE | BS_FLAT |
+		BS_PUSHBUTTON | BS_TEXT);
+	buttonEnable_.Create(hWnd_, buttonStyle);
+	buttonReset_.Create(hWnd_, buttonStyle);
+	buttonReset_.SetText(L"Reset");
+	buttonExport_.Create(hWnd_, buttonStyle);
+	buttonExport_.SetText(L"Export Flamegraph");
+	_UpdateButtonText();
+
+	gstd::WListView::Style styleListView;
+	styleListView.SetStyle(WS_CHILD | WS_VISIBLE |
+		LVS_REPORT | LVS_SHOWSELALWAYS | LVS_SINGLESEL | LVS_NOSORTHEADER);
+	styleListView.SetStyleEx(WS_EX_CLIENTEDGE);
+	styleListView.SetListViewStyleEx(LVS_EX_FULLROWSELECT | LVS_EX_GRIDLINES);
+
+	wndListViewLine_.Create(hWnd_, styleListView);
+	wndListViewLine_.AddColumn(56, COL_LINE_PERCENT, L"Time %");
+	wndListViewLine_.AddColumn(96, COL_LINE_TIME, L"Time (ms)");
+	wndListViewLine_.AddColumn(80, COL_LINE_COUNT, L"Count");
+	wndListViewLine_.AddColumn(128, COL_LINE_FUNCTION, L"Function");
+	wndListViewLine_.AddColumn(48, COL_LINE_LINE, L"Line");
+	wndListViewLine_.AddColumn(256, COL_LINE_FILE, L"File");
+
+	wndListViewFunction_.Create(hWnd_, styleListView);
+	wndListViewFunction_.AddColumn(56, COL_FUNC_PERCENT, L"Time %");
+	wndListViewFunction_.AddColumn(96, COL_FUNC_TIME, L"Time (ms)");
+	wndListViewFunction_.AddColumn(80, COL_FUNC_COUNT, L"Calls");
+	wndListViewFunction_.AddColumn(256, COL_FUNC_NAME, L"Function");
+
+	wndSplitter_.Create(hWnd_, WSplitter::TYPE_HORIZONTAL);
+	wndSplitter_.SetRatioY(0.6f);
+
+	SetWindowVisible(false);
+	PanelInitialize();
+
+	return true;
+}
+void ScriptProfilerInfoPanel::LocateParts() {
+	int wx = GetClientX();
+	int wy = GetClientY();
+	int wWidth = GetClientWidth();
+	int wHeight = GetClientHeight();
+
+	int xButton = wx + 16;
+	int yButton = wy + 8;
+	int wButton = 128;
+	int hButton = 32;
+
+	buttonEnable_.SetBounds(xButton, yButton, wButton, hButton);
+	buttonReset_.SetBounds(xButton + (wButton + 16), yButton, wButton, hButton);
+	buttonExport_.SetBounds(xButton + (wButton + 16) * 2, yButton, wButton, hButton);
+
+	int yLine = yButton + hButton + 8;
+	int ySplitter = (int)((float)wHeight * wndSplitter_.GetRatioY());
+	int hSplitter = 6;
+
+	wndListViewLine_.SetBounds(wx, yLine, wWidth, ySplitter - yLine);
+	wndSplitter_.SetBounds(wx, ySplitter, wWidth, hSplitter);
+	wndListViewFunction_.SetBounds(wx, ySplitter + hSplitter, wWidth, wHeight - ySplitter - hSplitter);
+}
+void ScriptProfilerInfoPanel::PanelUpdate() {
+	if (!IsWindowVisible()) return;
+
+	uint64_t timeTotal = std::max(ScriptProfiler::GetTotalTime(), 1ui64);
+	double frequency = ScriptProfiler::GetTickFrequency();
+	double msPerTick = frequency > 0 ? 1000.0 / frequency : 0.0;
+
+	{
+		std::vector<ScriptProfiler::LineData> listLine;
+		ScriptProfiler::GetLineData(listLine);
+
+		int iRow = 0;
+		for (; iRow < listLine.size() && iRow < MAX_LINE_ROW; ++iRow) {
+			ScriptProfiler::LineData& data = listLine[iRow];
+			wndListViewLine_.SetText(iRow, COL_LINE_PERCENT,
+				StringUtility::Format(L"%.2f", data.time * 100.0 / timeTotal));
+			wndListViewLine_.SetText(iRow, COL_LINE_TIME, StringUtility::Format(L"%.3f", data.time * msPerTick));
+			wndListViewLine_.SetText(iRow, COL_LINE_COUNT, StringUtility::Format(L"%llu", data.count));
+			wndListViewLine_.SetText(iRow, COL_LINE_FUNCTION, data.function);
+			wndListViewLine_.SetText(iRow, COL_LINE_LINE, StringUtility::Format(L"%d", data.line));
+			wndListViewLine_.SetText(iRow, COL_LINE_FILE, PathProperty::GetFileName(data.path));
+		}
+		for (int i = wndListViewLine_.GetRowCount() - 1; i >= iRow; --i)
+			wndListViewLine_.DeleteRow(i);
+	}
+	{
+		std::vector<ScriptProfiler::FunctionData> listFunction;
+		ScriptProfiler::GetFunctionData(listFunction);
+
+		int iRow = 0;
+		for (; iRow < listFunction.size(); ++iRow) {
+			ScriptProfiler::FunctionData& data = listFunction[iRow];
+			wndListViewFunction_.SetText(iRow, COL_FUNC_PERCENT,
+				StringUtility::Format(L"%.2f", data.time * 100.0 / timeTotal));
+			wndListViewFunction_.SetText(iRow, COL_FUNC_TIME, StringUtility::Format(L"%.3f", data.time * msPerTick));
+			wndListViewFunction_.SetText(iRow, COL_FUNC_COUNT, StringUtility::Format(L"%llu", data.count));
+			wndListViewFunction_.SetText(iRow, COL_FUNC_NAME,
+				data.bBuiltin ? (L"[builtin] " + data.name) : data.name);
+		}
+		for (int i = wndListViewFunction_.GetRowCount() - 1; i >= iRow; --i)
+			wndListViewFunction_.DeleteRow(i);
+	}
+}
+void ScriptProfilerInfoPanel::_UpdateButtonText() {
+	buttonEnable_.SetText(ScriptProfiler::IsEnable() ? L"Stop Profiling" : L"Start Profiling");
+}
+void ScriptProfilerInfoPanel::_ExportFlamegraph() {
+	SYSTEMTIME date;
+	GetLocalTime(&date);
+
+	std::wstring path = PathProperty::GetModuleDirectory() + StringUtility::Format(
+		L"profile/flamegraph_%04d%02d%02d%02d%02d%02d.txt",
+		date.wYear, date.wMonth, date.wDay,
+		date.wHour, date.wMinute, date.wSecond);
+	if (ScriptProfiler::ExportFlamegraph(path))
+		Logger::WriteTop(L"ScriptProfiler: Exported flamegraph stacks (in microseconds) to " + path);
+	else
+		Logger::WriteTop(L"ScriptProfiler: Failed to export flamegraph stacks to " + path);
+}
+LRESULT ScriptProfilerInfoPanel::_WindowProcedure(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam) {
+	switch (uMsg) {
+	case WM_SIZE:
+	{
+		LocateParts();
+		break;
+	}
+	case WM_COMMAND:
+	{
+		int id = wParam & 0xffff;
+		if (id == buttonEnable_.GetWindowId()) {
+			ScriptProfiler::SetEnable(!ScriptProfiler::IsEnable());
+			_UpdateButtonText();
+			return FALSE;
+		}
+		else if (id == buttonReset_.GetWindowId()) {
+			ScriptProfiler::Clear();
+			wndListViewLine_.Clear();
+			wndListViewFunction_.Clear();
+			return FALSE;
+		}
+		else if (id == buttonExport_.GetWindowId()) {
+			_ExportFlamegraph();
+			return FALSE;
+		}
+	}
+	}
+	return _CallPreviousWindowProcedure(hWnd, uMsg, wParam, lParam);
+}
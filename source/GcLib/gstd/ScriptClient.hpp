@@ -25,7 +25,10 @@ namespace gstd {
 			std::wstring path_;
 		};
 	protected:
-		std::list<Entry> listEntry_;
+		//Sorted by line and non-overlapping, looked up with a binary search
+		std::vector<Entry> listEntry_;
+
+		size_t _GetEntryIndex(int line);
 	public:
 		ScriptFileLineMap();
 		virtual ~ScriptFileLineMap();
@@ -33,7 +36,7 @@ namespace gstd {
 		void AddEntry(const std::wstring& path, int lineAdd, int lineCount);
 		Entry* GetEntry(int line);
 		std::wstring& GetPath(int line);
-		std::list<Entry>& GetEntryList() { return listEntry_; }
+		std::vector<Entry>& GetEntryList() { return listEntry_; }
 
 		void Clear() { listEntry_.clear(); }
 	};
@@ -87,6 +90,126 @@ namespace gstd {
 		bool IsExists(const std::wstring& name);
 	};
 
+	//*******************************************************************
+	//ScriptIncludeCache
+	//Process-wide cache of include files, stored with the BOM stripped and
+	//	already converted to the encoding of the including script
+	//*******************************************************************
+	class ScriptIncludeCache {
+	public:
+		//Files on disk are checked by size and write time, so that a hit needs no read;
+		//	archive entries have no write time and are checked by a hash of their contents instead
+		struct Stamp {
+			uint64_t size;
+			int64_t time;
+			uint64_t hash;
+
+			bool operator==(const Stamp& other) const {
+				return size == other.size && time == other.time && hash == other.hash;
+			}
+			bool operator!=(const Stamp& other) const { return !(*this == other); }
+		};
+	protected:
+		struct Entry {
+			Stamp stamp;
+			std::vector<char> source;
+		};
+	protected:
+		static gstd::CriticalSection lock_;
+		static std::map<std::pair<std::wstring, Encoding::Type>, Entry> mapEntry_;
+
+		static size_t countHit_;
+		static size_t countMiss_;
+
+		static Encoding::Type _GetKeyEncoding(Encoding::Type encoding);
+	public:
+		static bool GetFileStamp(const std::wstring& path, Stamp* pStamp);
+		static Stamp GetDataStamp(const char* data, size_t size);
+
+		static bool Find(const std::wstring& path, Encoding::Type encoding, const Stamp& stamp, std::vector<char>& res);
+		static void Store(const std::wstring& path, Encoding::Type encoding, const Stamp& stamp, const std::vector<char>& source);
+
+		static size_t GetCacheCount();
+		static size_t GetHitCount() { return countHit_; }
+		static size_t GetMissCount() { return countMiss_; }
+	};
+
+	//*******************************************************************
+	//ScriptProfiler
+	//Process-wide profile of every script run while enabled, times are in timestamp counter ticks
+	//*******************************************************************
+	class ScriptProfiler {
+	public:
+		//Times are in timestamp counter ticks, GetTickFrequency converts them to seconds
+		struct LineData {
+			std::wstring path;
+			int line;
+			std::wstring function;
+			uint64_t count;
+			uint64_t time;
+		};
+		struct FunctionData {
+			std::wstring name;
+			bool bBuiltin;
+			uint64_t count;
+			uint64_t time;
+		};
+
+		//Brackets a run of a script machine
+		class Scope {
+			script_machine* machine_;
+			bool bActive_;
+		public:
+			Scope(shared_ptr<ScriptEngineData>& engine, script_machine* machine);
+			~Scope();
+		};
+	protected:
+		//Minimum interval between merges of a thread's data into the published data, in milliseconds
+		static constexpr uint64_t PUBLISH_PERIOD = 250;
+
+		//Each thread profiles into its own data without locking, and merges it into profiler_
+		//	under lock_ when its outermost run ends, at most once every PUBLISH_PERIOD
+		struct ThreadData {
+			script_profiler profiler;
+			std::map<script_engine*, shared_ptr<ScriptEngineData>> mapEngine;
+			size_t depth = 0;
+			uint64_t epoch = 0;
+			uint64_t timePublish = 0;
+		};
+		static thread_local ThreadData threadData_;
+
+		static gstd::CriticalSection lock_;
+		static std::atomic<bool> bEnable_;
+		static std::atomic<uint64_t> epoch_;	//Advanced by Clear, data collected before it is dropped
+		static script_profiler profiler_;
+
+		//Keeps the profiled engines alive, the collected data points into their blocks
+		static std::map<script_engine*, shared_ptr<ScriptEngineData>> mapEngine_;
+
+		//Timestamp counter and clock at the start of the calibration, see GetTickFrequency
+		static uint64_t tickCalibrate_;
+		static stdch::steady_clock::time_point timeCalibrate_;
+
+		static void _Publish(ThreadData& data);
+		static std::wstring _GetFunctionName(const script_block* block);
+		static void _GetOriginalLine(script_engine* engine, int line, std::wstring& path, int& lineOriginal);
+	public:
+		static void SetEnable(bool bEnable);
+		static bool IsEnable() { return bEnable_; }
+		static void Clear();
+
+		//Timestamp counter ticks per second, measured against the steady clock since profiling was first enabled
+		static double GetTickFrequency();
+
+		static uint64_t GetTotalTime();
+		//Both sorted by descending time
+		static void GetLineData(std::vector<LineData>& res);
+		static void GetFunctionData(std::vector<FunctionData>& res);
+
+		//Writes time-weighted stack samples in the collapsed format read by flamegraph tools
+		static bool ExportFlamegraph(const std::wstring& path);
+	};
+
 	//*******************************************************************
 	//ScriptClientBase
 	//*******************************************************************
@@ -134,6 +257,7 @@ namespace gstd {
 
 		virtual std::vector<char> _ParseScriptSource(std::vector<char>& source);
 		virtual bool _CreateEngine();
+		void _DumpBytecode();
 
 		std::wstring _ExtendPath(std::wstring path);
 	public:
@@ -385,17 +509,12 @@ namespace gstd {
 	}
 	template<typename T>
 	value ScriptClientBase::CreateFloatArrayValue(const T* ptrList, size_t count) {
-		type_data* type_float = script_type_manager::get_float_type();
 		type_data* type_arr = script_type_manager::get_float_array_type();
 		if (ptrList && count > 0) {
-			std::vector<value> res_arr;
-			res_arr.resize(count);
-			for (size_t iVal = 0U; iVal < count; ++iVal) {
-				res_arr[iVal] = value(type_float, (double)(ptrList[iVal]));
-			}
+			ref_unsync_ptr<std::vector<double>> res_arr = new std::vector<double>(ptrList, ptrList + count);
 
 			value res;
-			res.reset(type_arr, res_arr);
+			res.set(type_arr, res_arr);
 			return res;
 		}
 		return value(type_arr, std::wstring());
@@ -410,17 +529,12 @@ namespace gstd {
 	}
 	template<typename T>
 	value ScriptClientBase::CreateIntArrayValue(const T* ptrList, size_t count) {
-		type_data* type_int = script_type_manager::get_int_type();
 		type_data* type_arr = script_type_manager::get_int_array_type();
 		if (ptrList && count > 0) {
-			std::vector<value> res_arr;
-			res_arr.resize(count);
-			for (size_t iVal = 0U; iVal < count; ++iVal) {
-				res_arr[iVal] = value(type_int, (int64_t)(ptrList[iVal]));
-			}
+			ref_unsync_ptr<std::vector<int64_t>> res_arr = new std::vector<int64_t>(ptrList, ptrList + count);
 
 			value res;
-			res.reset(type_arr, res_arr);
+			res.set(type_arr, res_arr);
 			return res;
 		}
 		return value(type_arr, std::wstring());
@@ -454,6 +568,8 @@ namespace gstd {
 		void _ParseInclude();
 		void _ParseIfElse();
 
+		void _ReadIncludeFile(const std::wstring& path, int line, std::vector<char>& res);
+
 		void _ConvertToEncoding(Encoding::Type targetEncoding);
 	public:
 		ScriptLoader(ScriptClientBase* script, const std::wstring& path, 
@@ -585,4 +701,44 @@ namespace gstd {
 		virtual void Update();
 	};
 
+	//*******************************************************************
+	//ScriptProfilerInfoPanel
+	//*******************************************************************
+	class ScriptProfilerInfoPanel : public WindowLogger::Panel {
+	protected:
+		enum {
+			COL_LINE_PERCENT = 0,
+			COL_LINE_TIME,
+			COL_LINE_COUNT,
+			COL_LINE_FUNCTION,
+			COL_LINE_LINE,
+			COL_LINE_FILE,
+
+			COL_FUNC_PERCENT = 0,
+			COL_FUNC_TIME,
+			COL_FUNC_COUNT,
+			COL_FUNC_NAME,
+		};
+		enum {
+			MAX_LINE_ROW = 256,
+		};
+
+		WButton buttonEnable_;
+		WButton buttonReset_;
+		WButton buttonExport_;
+		WListView wndListViewLine_;
+		WListView wndListViewFunction_;
+		WSplitter wndSplitter_;
+
+		virtual bool _AddedLogger(HWND hTab);
+		virtual LRESULT _WindowProcedure(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
+
+		void _UpdateButtonText();
+		void _ExportFlamegraph();
+	public:
+		ScriptProfilerInfoPanel();
+
+		virtual void LocateParts();
+		virtual void PanelUpdate();
+	};
 }
@@ -61,6 +61,8 @@ namespace gstd {
 
 		//[XOR] vector a and b
 		static __forceinline __m128 XOR(const __m128& a, const __m128& b);
+		//Takes a[i] where mask[i] is all ones and b[i] where it is zero (SSE2, no blendv)
+		static __forceinline __m128 Select(const __m128& mask, const __m128& a, const __m128& b);
 
 		//[add] vector a and b
 		static __forceinline __m128 Add(const __m128& a, const __m128& b);
@@ -323,6 +325,20 @@ namespace gstd {
 #endif
 		return res;
 	}
+	__m128 Vectorize::Select(const __m128& mask, const __m128& a, const __m128& b) {
+		__m128 res;
+#ifndef __L_MATH_VECTORIZE
+		for (int i = 0; i < 4; ++i) {
+			uint32_t m = (uint32_t&)mask.m128_f32[i];
+			uint32_t s = ((uint32_t&)a.m128_f32[i] & m) | ((uint32_t&)b.m128_f32[i] & ~m);
+			res.m128_f32[i] = (float&)s;
+		}
+#else
+		//SSE
+		res = _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+#endif
+		return res;
+	}
 
 	//---------------------------------------------------------------------
 
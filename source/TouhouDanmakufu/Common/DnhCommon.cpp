@@ -291,7 +291,9 @@ std::vector<ref_count_ptr<ScriptInformation>> ScriptInformation::FindPlayerScrip
 			else {
 				std::wstring tPath = PathProperty::ReplaceYenToSlash(itr.path());
 
-				std::vector<ref_count_ptr<ScriptInformation>> listInfo = CreateScriptInformationList(tPath, true);
+				ScriptInformationIndex* index = ScriptInformationIndex::GetInstance();
+				std::vector<ref_count_ptr<ScriptInformation>> listInfo = index
+					? index->GetScriptInformationList(tPath) : CreateScriptInformationList(tPath, true);
 				for (size_t iInfo = 0; iInfo < listInfo.size(); iInfo++) {
 					ref_count_ptr<ScriptInformation> info = listInfo[iInfo];
 					if (info != nullptr && info->type_ == ScriptInformation::TYPE_PLAYER)
@@ -303,6 +305,221 @@ std::vector<ref_count_ptr<ScriptInformation>> ScriptInformation::FindPlayerScrip
 
 	return res;
 }
+
+//*******************************************************************
+//ScriptInformationIndex
+//*******************************************************************
+ScriptInformationIndex::ScriptInformationIndex() {
+	pathFile_ = GetIndexFilePath();
+	bModified_ = false;
+}
+ScriptInformationIndex::~ScriptInformationIndex() {
+}
+
+std::wstring ScriptInformationIndex::GetIndexFilePath() {
+	return PathProperty::GetModuleDirectory() + L"temp/script_index.dat";
+}
+
+bool ScriptInformationIndex::_GetFileStamp(const std::wstring& path, uint64_t* pSize, int64_t* pTime) {
+	std::error_code err;
+	uint64_t size = stdfs::file_size(path, err);
+	if (err) return false;
+	auto time = stdfs::last_write_time(path, err);
+	if (err) return false;
+
+	*pSize = size;
+	*pTime = time.time_since_epoch().count();
+	return true;
+}
+
+static void _IndexWriteString(ByteBuffer& buffer, const std::wstring& str) {
+	buffer.WriteValue<uint32_t>(str.size());
+	if (str.size() > 0)
+		buffer.Write((LPVOID)str.data(), str.size() * sizeof(wchar_t));
+}
+static std::wstring _IndexReadString(ByteBuffer& buffer) {
+	std::wstring res;
+	res.resize(buffer.ReadValue<uint32_t>());
+	if (res.size() > 0)
+		buffer.Read(&res[0], res.size() * sizeof(wchar_t));
+	return res;
+}
+void ScriptInformationIndex::_WriteInformation(ByteBuffer& buffer, ScriptInformation* info) {
+	buffer.WriteInteger(info->type_);
+	_IndexWriteString(buffer, info->pathArchive_);
+	_IndexWriteString(buffer, info->pathScript_);
+	_IndexWriteString(buffer, info->id_);
+	_IndexWriteString(buffer, info->title_);
+	_IndexWriteString(buffer, info->text_);
+	_IndexWriteString(buffer, info->pathImage_);
+	_IndexWriteString(buffer, info->pathSystem_);
+	_IndexWriteString(buffer, info->pathBackground_);
+	buffer.WriteValue<uint32_t>(info->listPlayer_.size());
+	for (const std::wstring& player : info->listPlayer_)
+		_IndexWriteString(buffer, player);
+	_IndexWriteString(buffer, info->replayName_);
+}
+ref_count_ptr<ScriptInformation> ScriptInformationIndex::_ReadInformation(ByteBuffer& buffer) {
+	ref_count_ptr<ScriptInformation> info = new ScriptInformation();
+	info->type_ = buffer.ReadInteger();
+	info->pathArchive_ = _IndexReadString(buffer);
+	info->pathScript_ = _IndexReadString(buffer);
+	info->id_ = _IndexReadString(buffer);
+	info->title_ = _IndexReadString(buffer);
+	info->text_ = _IndexReadString(buffer);
+	info->pathImage_ = _IndexReadString(buffer);
+	info->pathSystem_ = _IndexReadString(buffer);
+	info->pathBackground_ = _IndexReadString(buffer);
+	info->listPlayer_.resize(buffer.ReadValue<uint32_t>());
+	for (std::wstring& player : info->listPlayer_)
+		player = _IndexReadString(buffer);
+	info->replayName_ = _IndexReadString(buffer);
+	return info;
+}
+
+bool ScriptInformationIndex::Load() {
+	RecordBuffer record;
+	if (!record.ReadFromFile(pathFile_, GAME_VERSION_NUM, "DNHSIDX\0", 8U))
+		return false;
+
+	Lock lock(lock_);
+	mapEntry_.clear();
+
+	ByteBuffer buffer;
+	buffer.SetSize(record.GetRecordAsInteger("index_size"));
+	if (!record.GetRecord("index", buffer.GetPointer(), buffer.GetSize()))
+		return false;
+
+	uint32_t countEntry = buffer.ReadValue<uint32_t>();
+	for (uint32_t iEntry = 0; iEntry < countEntry; ++iEntry) {
+		std::wstring path = _IndexReadString(buffer);
+
+		Entry entry;
+		entry.size = buffer.ReadValue<uint64_t>();
+		entry.timeWrite = buffer.ReadInteger64();
+		entry.bVisited = false;
+		entry.listInfo.resize(buffer.ReadValue<uint32_t>());
+		for (auto& info : entry.listInfo)
+			info = _ReadInformation(buffer);
+
+		mapEntry_[path] = entry;
+	}
+	bModified_ = false;
+
+	return true;
+}
+bool ScriptInformationIndex::Save() {
+	Lock lock(lock_);
+
+	for (auto itr = mapEntry_.begin(); itr != mapEntry_.end();) {
+		std::error_code err;
+		if (!itr->second.bVisited && !stdfs::exists(itr->first, err)) {
+			itr = mapEntry_.erase(itr);
+			bModified_ = true;
+		}
+		else ++itr;
+	}
+	if (!bModified_) return true;
+
+	ByteBuffer buffer;
+	buffer.WriteValue<uint32_t>(mapEntry_.size());
+	for (auto& [path, entry] : mapEntry_) {
+		_IndexWriteString(buffer, path);
+		buffer.WriteValue<uint64_t>(entry.size);
+		buffer.WriteInteger64(entry.timeWrite);
+		buffer.WriteValue<uint32_t>(entry.listInfo.size());
+		for (auto& info : entry.listInfo)
+			_WriteInformation(buffer, info.get());
+	}
+
+	RecordBuffer record;
+	record.SetRecordAsInteger("index_size", buffer.GetSize());
+	record.SetRecord("index", buffer.GetPointer(), buffer.GetSize());
+
+	File::CreateFileDirectory(pathFile_);
+	if (!record.WriteToFile(pathFile_, GAME_VERSION_NUM, "DNHSIDX\0", 8U))
+		return false;
+
+	bModified_ = false;
+	return true;
+}
+
+bool ScriptInformationIndex::_Find(const std::wstring& path, uint64_t size, int64_t time,
+	std::vector<ref_count_ptr<ScriptInformation>>* pRes)
+{
+	Lock lock(lock_);
+
+	auto itr = mapEntry_.find(path);
+	if (itr == mapEntry_.end()) return false;
+
+	Entry& entry = itr->second;
+	if (entry.size != size || entry.timeWrite != time) return false;
+
+	entry.bVisited = true;
+	*pRes = entry.listInfo;
+	return true;
+}
+void ScriptInformationIndex::_Insert(const std::wstring& path, uint64_t size, int64_t time,
+	const std::vector<ref_count_ptr<ScriptInformation>>& listInfo)
+{
+	Lock lock(lock_);
+
+	Entry& entry = mapEntry_[path];
+	entry.size = size;
+	entry.timeWrite = time;
+	entry.bVisited = true;
+	entry.listInfo = listInfo;
+	bModified_ = true;
+}
+
+std::vector<ref_count_ptr<ScriptInformation>> ScriptInformationIndex::GetScriptInformationList(const std::wstring& path) {
+	std::vector<ref_count_ptr<ScriptInformation>> res;
+
+	uint64_t size = 0;
+	int64_t time = 0;
+	if (!_GetFileStamp(path, &size, &time))
+		return ScriptInformation::CreateScriptInformationList(path, true);
+	if (_Find(path, size, time, &res))
+		return res;
+
+	res = ScriptInformation::CreateScriptInformationList(path, true);
+	_Insert(path, size, time, res);
+	return res;
+}
+std::vector<std::vector<ref_count_ptr<ScriptInformation>>> ScriptInformationIndex::GetScriptInformationList(
+	const std::vector<std::wstring>& listPath)
+{
+	std::vector<std::vector<ref_count_ptr<ScriptInformation>>> res(listPath.size());
+
+	struct Miss {
+		size_t index;
+		uint64_t size;
+		int64_t time;
+		bool bStamp;
+	};
+	std::vector<Miss> listMiss;
+	for (size_t i = 0; i < listPath.size(); ++i) {
+		const std::wstring& path = listPath[i];
+
+		Miss miss = { i, 0, 0, false };
+		miss.bStamp = _GetFileStamp(path, &miss.size, &miss.time);
+		if (miss.bStamp && _Find(path, miss.size, miss.time, &res[i]))
+			continue;
+		listMiss.push_back(miss);
+	}
+
+	ParallelFor(listMiss.size(), [&](size_t iMiss) {
+		const Miss& miss = listMiss[iMiss];
+		res[miss.index] = ScriptInformation::CreateScriptInformationList(listPath[miss.index], true);
+	});
+
+	for (const Miss& miss : listMiss) {
+		if (miss.bStamp)
+			_Insert(listPath[miss.index], miss.size, miss.time, res[miss.index]);
+	}
+
+	return res;
+}
 #endif
 
 //*******************************************************************
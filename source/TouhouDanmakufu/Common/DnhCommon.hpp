@@ -80,6 +80,53 @@ struct ScriptInformation::PlayerListSort {
 		return res == CSTR_LESS_THAN;
 	}
 };
+
+//*******************************************************************
+//ScriptInformationIndex
+//	On-disk cache of script headers, keyed by path, file size and last write time.
+//	Archives are keyed as a whole, their entries cannot change without the archive changing.
+//*******************************************************************
+class ScriptInformationIndex : public Singleton<ScriptInformationIndex> {
+	friend Singleton<ScriptInformationIndex>;
+	struct Entry {
+		uint64_t size;
+		int64_t timeWrite;
+		bool bVisited;
+		std::vector<ref_count_ptr<ScriptInformation>> listInfo;
+	};
+private:
+	gstd::CriticalSection lock_;
+	std::wstring pathFile_;
+	std::unordered_map<std::wstring, Entry> mapEntry_;
+	bool bModified_;
+
+	ScriptInformationIndex();
+
+	static bool _GetFileStamp(const std::wstring& path, uint64_t* pSize, int64_t* pTime);
+	static void _WriteInformation(ByteBuffer& buffer, ScriptInformation* info);
+	static ref_count_ptr<ScriptInformation> _ReadInformation(ByteBuffer& buffer);
+
+	bool _Find(const std::wstring& path, uint64_t size, int64_t time, 
+		std::vector<ref_count_ptr<ScriptInformation>>* pRes);
+	void _Insert(const std::wstring& path, uint64_t size, int64_t time,
+		const std::vector<ref_count_ptr<ScriptInformation>>& listInfo);
+public:
+	~ScriptInformationIndex();
+
+	static std::wstring GetIndexFilePath();
+	//GetIndexFilePath by default
+	void SetFilePath(const std::wstring& path) { pathFile_ = path; }
+
+	bool Load();
+	//Also drops the entries of files that no longer exist, does nothing if the index is unchanged
+	bool Save();
+
+	//Same as ScriptInformation::CreateScriptInformationList(path, true)
+	std::vector<ref_count_ptr<ScriptInformation>> GetScriptInformationList(const std::wstring& path);
+	//Index misses are scanned in parallel, results are in the order of listPath
+	std::vector<std::vector<ref_count_ptr<ScriptInformation>>> GetScriptInformationList(
+		const std::vector<std::wstring>& listPath);
+};
 #endif
 
 //*******************************************************************
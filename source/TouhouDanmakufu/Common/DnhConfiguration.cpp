@@ -60,6 +60,9 @@ DnhConfiguration::DnhConfiguration() {
 
 	bEnableUnfocusedProcessing_ = false;
 
+	bScriptOptimize_ = true;
+	bScriptDumpBytecode_ = false;
+
 	LoadConfigFile();
 	_LoadDefinitionFile();
 }
@@ -93,6 +96,14 @@ bool DnhConfiguration::_LoadDefinitionFile() {
 		std::wstring str = prop.GetString(L"unfocused.processing", L"false");
 		bEnableUnfocusedProcessing_ = str == L"true" ? true : StringUtility::ToInteger(str);
 	}
+	{
+		std::wstring str = prop.GetString(L"script.optimize", L"true");
+		bScriptOptimize_ = str == L"true" ? true : StringUtility::ToInteger(str);
+	}
+	{
+		std::wstring str = prop.GetString(L"script.dump_bytecode", L"false");
+		bScriptDumpBytecode_ = str == L"true" ? true : StringUtility::ToInteger(str);
+	}
 
 	{
 		auto _AddWindowSize = [&](std::vector<POINT>& listSize, LONG width, LONG height) {
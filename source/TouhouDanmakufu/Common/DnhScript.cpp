@@ -31,3 +31,6 @@ static const std::vector<constant> dnhConstant = {
 DnhScript::DnhScript() {
 	_AddConstant(&dnhConstant);
 }
+void DnhScript::AppendScriptTables(std::vector<function>* listFunc, std::vector<constant>* listConst) {
+	listConst->insert(listConst->end(), dnhConstant.cbegin(), dnhConstant.cend());
+}
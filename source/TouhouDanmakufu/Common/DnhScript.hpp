@@ -10,4 +10,6 @@
 class DnhScript : public ManagedScript {
 public:
 	DnhScript();
+
+	static void AppendScriptTables(std::vector<gstd::function>* listFunc, std::vector<gstd::constant>* listConst);
 };
\ No newline at end of file
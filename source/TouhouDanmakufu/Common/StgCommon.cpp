@@ -3,6 +3,139 @@
 #include "StgCommon.hpp"
 #include "StgSystem.hpp"
 
+//****************************************************************************
+//StgSpatialGrid
+//****************************************************************************
+StgSpatialGrid::StgSpatialGrid() {
+	bValid_ = false;
+	build_ = 1;
+	countRegister_ = 0;
+
+	originX_ = 0;
+	originY_ = 0;
+	cellSize_ = CELL_SIZE_MIN;
+	countCellX_ = 0;
+	countCellY_ = 0;
+}
+
+void StgSpatialGrid::Register(StgMoveObject* obj) {
+	obj->spatialGrid_ = this;
+	obj->spatialOrder_ = ++countRegister_;
+	obj->spatialBuild_ = 0;
+	if (bValid_) _AddLoose(obj);
+}
+void StgSpatialGrid::Unregister(StgMoveObject* obj) {
+	if (obj->spatialGrid_ != this) return;
+	obj->spatialGrid_ = nullptr;
+	obj->spatialBuild_ = 0;
+	//The object may still be referenced by the cells or the loose list
+	Invalidate();
+}
+void StgSpatialGrid::Invalidate() {
+	if (!bValid_) return;
+	bValid_ = false;
+	if (++build_ == 0) ++build_;
+	listLoose_.clear();
+}
+
+void StgSpatialGrid::_Build(std::vector<StgMoveObject*>& listObj) {
+	listEntry_.clear();
+	listLoose_.clear();
+	countCellX_ = 0;
+	countCellY_ = 0;
+
+	double minX = DBL_MAX, minY = DBL_MAX;
+	double maxX = -DBL_MAX, maxY = -DBL_MAX;
+	size_t countIndexed = 0;
+	for (StgMoveObject* obj : listObj) {
+		if (!std::isfinite(obj->posX_) || !std::isfinite(obj->posY_)) continue;
+		minX = std::min(minX, obj->posX_);
+		minY = std::min(minY, obj->posY_);
+		maxX = std::max(maxX, obj->posX_);
+		maxY = std::max(maxY, obj->posY_);
+		++countIndexed;
+	}
+
+	if (countIndexed > 0) {
+		double extent = std::max(maxX - minX, maxY - minY);
+		cellSize_ = std::max(CELL_SIZE_MIN, extent / GRID_DIMENSION_MAX);
+		originX_ = minX;
+		originY_ = minY;
+		countCellX_ = std::min((int)((maxX - minX) / cellSize_) + 1, (int)GRID_DIMENSION_MAX);
+		countCellY_ = std::min((int)((maxY - minY) / cellSize_) + 1, (int)GRID_DIMENSION_MAX);
+
+		//Counting sort into cells, each cell keeps the registration order
+		listCellStart_.assign(countCellX_ * countCellY_ + 1, 0U);
+		std::vector<uint32_t> listCell(listObj.size());
+		for (size_t iObj = 0; iObj < listObj.size(); ++iObj) {
+			StgMoveObject* obj = listObj[iObj];
+			if (!std::isfinite(obj->posX_) || !std::isfinite(obj->posY_)) continue;
+			listCell[iObj] = _GetCellY(obj->posY_) * countCellX_ + _GetCellX(obj->posX_);
+			++listCellStart_[listCell[iObj] + 1];
+		}
+		for (size_t iCell = 1; iCell < listCellStart_.size(); ++iCell)
+			listCellStart_[iCell] += listCellStart_[iCell - 1];
+
+		std::vector<uint32_t> listCellWrite(listCellStart_.begin(), listCellStart_.end() - 1);
+		listEntry_.resize(countIndexed);
+		for (size_t iObj = 0; iObj < listObj.size(); ++iObj) {
+			StgMoveObject* obj = listObj[iObj];
+			if (!std::isfinite(obj->posX_) || !std::isfinite(obj->posY_)) continue;
+			listEntry_[listCellWrite[listCell[iObj]]++] = { obj, obj->posX_, obj->posY_ };
+			obj->spatialBuild_ = build_;
+		}
+	}
+	else listCellStart_.clear();
+
+	for (StgMoveObject* obj : listObj) {
+		if (obj->spatialBuild_ != build_) {
+			obj->spatialBuild_ = 0;
+			listLoose_.push_back(obj);
+		}
+	}
+	bValid_ = true;
+}
+void StgSpatialGrid::_MarkMoved(StgMoveObject* obj) {
+	obj->spatialBuild_ = 0;
+	_AddLoose(obj);
+}
+void StgSpatialGrid::_AddLoose(StgMoveObject* obj) {
+	listLoose_.push_back(obj);
+	//Past this point a rebuild is cheaper than testing the loose list in every query
+	if (listLoose_.size() > std::max<size_t>(LOOSE_LIMIT_MIN, listEntry_.size() / 4U))
+		Invalidate();
+}
+
+void StgSpatialGrid::QueryRect(double left, double top, double right, double bottom, std::vector<StgMoveObject*>& res) {
+	size_t countOld = res.size();
+
+	if (countCellX_ > 0 && left <= right && top <= bottom) {
+		int cellLeft = _GetCellX(left);
+		int cellRight = _GetCellX(right);
+		int cellTop = _GetCellY(top);
+		int cellBottom = _GetCellY(bottom);
+		for (int iy = cellTop; iy <= cellBottom; ++iy) {
+			for (int ix = cellLeft; ix <= cellRight; ++ix) {
+				size_t cell = iy * countCellX_ + ix;
+				for (uint32_t iEntry = listCellStart_[cell]; iEntry < listCellStart_[cell + 1]; ++iEntry) {
+					Entry& entry = listEntry_[iEntry];
+					if (entry.obj->spatialBuild_ != build_) continue;
+					if (entry.x >= left && entry.x <= right && entry.y >= top && entry.y <= bottom)
+						res.push_back(entry.obj);
+				}
+			}
+		}
+	}
+	for (StgMoveObject* obj : listLoose_) {
+		if (obj->posX_ >= left && obj->posX_ <= right && obj->posY_ >= top && obj->posY_ <= bottom)
+			res.push_back(obj);
+	}
+
+	std::sort(res.begin() + countOld, res.end(), [](StgMoveObject* a, StgMoveObject* b) {
+		return a->spatialOrder_ < b->spatialOrder_;
+	});
+}
+
 //****************************************************************************
 //StgMoveObject
 //****************************************************************************
@@ -27,6 +160,10 @@ StgMoveObject::StgMoveObject(StgStageController* stageController) : StgObjectBas
 	parent_ = nullptr;
 	bEnableMovement_ = true;
 	frameMove_ = 0;
+
+	spatialGrid_ = nullptr;
+	spatialBuild_ = 0;
+	spatialOrder_ = 0;
 }
 StgMoveObject::~StgMoveObject() {
 	pattern_ = nullptr;
@@ -41,6 +178,7 @@ StgMoveObject::~StgMoveObject() {
 void StgMoveObject::Copy(StgMoveObject* src) {
 	posX_ = src->posX_;
 	posY_ = src->posY_;
+	_NotifyMoved();
 
 	relativePosX_ = src->relativePosX_;
 	relativePosY_ = src->relativePosY_;
@@ -194,10 +332,12 @@ void StgMoveObject::SetRelativePositionXY(double posX, double posY) {
 		posX_ = posX;
 		posY_ = posY;
 	}
+	_NotifyMoved();
 }
 void StgMoveObject::SetPositionXY(double posX, double posY) {
 	posX_ = posX;
 	posY_ = posY;
+	_NotifyMoved();
 	if (auto parent = parent_.Lock()) {
 		double offX = posX - parent->posX_;
 		double offY = posY - parent->posY_;
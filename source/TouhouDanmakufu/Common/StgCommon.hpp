@@ -16,12 +16,71 @@ class StgPackageController;
 class StgStageInformation;
 class StgSystemInformation;
 class StgMovePattern;
+class StgMoveObject;
+
+//*******************************************************************
+//StgSpatialGrid
+//	Uniform grid over the positions of one manager's objects, built by the first query after
+//		every invalidation. Objects moved or registered after the build are kept in a loose list
+//		that every query tests too, so the results are the same as those of a linear scan.
+//*******************************************************************
+class StgSpatialGrid {
+	friend StgMoveObject;
+public:
+	enum : int {
+		GRID_DIMENSION_MAX = 128,
+		LOOSE_LIMIT_MIN = 256,
+	};
+	static constexpr double CELL_SIZE_MIN = 32.0;
+protected:
+	struct Entry {
+		StgMoveObject* obj;
+		double x;
+		double y;
+	};
+
+	bool bValid_;
+	uint32_t build_;
+	uint64_t countRegister_;
+
+	double originX_;
+	double originY_;
+	double cellSize_;
+	int countCellX_;
+	int countCellY_;
+	std::vector<uint32_t> listCellStart_;
+	std::vector<Entry> listEntry_;
+	std::vector<StgMoveObject*> listLoose_;
+
+	void _Build(std::vector<StgMoveObject*>& listObj);
+	void _MarkMoved(StgMoveObject* obj);
+	void _AddLoose(StgMoveObject* obj);
+
+	int _GetCellX(double x) { return (int)std::clamp((x - originX_) / cellSize_, 0.0, countCellX_ - 1.0); }
+	int _GetCellY(double y) { return (int)std::clamp((y - originY_) / cellSize_, 0.0, countCellY_ - 1.0); }
+public:
+	StgSpatialGrid();
+
+	void Register(StgMoveObject* obj);
+	void Unregister(StgMoveObject* obj);
+	void Invalidate();
+	bool IsValid() { return bValid_; }
+
+	//Builds the grid if it isn't valid, listObj has to be in registration order
+	template<class List> void Prepare(List& listObj);
+
+	//Appends the objects inside the box (edges included), in registration order
+	void QueryRect(double left, double top, double right, double bottom, std::vector<StgMoveObject*>& res);
+	//Appends up to count objects accepted by pred, nearest first and ties in registration order
+	template<class Pred> void QueryNearest(double x, double y, size_t count, Pred pred, std::vector<StgMoveObject*>& res);
+};
 
 //*******************************************************************
 //StgMoveObject
 //*******************************************************************
 class StgMoveObject : public StgObjectBase {
 	friend StgMovePattern;
+	friend StgSpatialGrid;
 protected:
 	double posX_;
 	double posY_;
@@ -49,6 +108,15 @@ protected:
 	uint32_t framePattern_;
 	std::map<uint32_t, std::list<ref_unsync_ptr<StgMovePattern>>> mapPattern_;
 
+	StgSpatialGrid* spatialGrid_;
+	uint32_t spatialBuild_;
+	uint64_t spatialOrder_;
+
+	void _NotifyMoved() {
+		if (spatialGrid_ && spatialBuild_ == spatialGrid_->build_)
+			spatialGrid_->_MarkMoved(this);
+	}
+
 	virtual void _Move();
 	void _AttachReservedPattern(ref_unsync_ptr<StgMovePattern> pattern);
 public:
@@ -77,6 +145,11 @@ public:
 
 	void SetRelativePositionXY(double posX, double posY);
 
+	//Rotates and scales a vector from the space of this object's children, as SetRelativePositionXY does
+	Math::DVec2 TransformChildVector(const Math::DVec2& vec) {
+		return { vec[0] * r2aMatX_[0] + vec[1] * r2aMatX_[1], vec[0] * r2aMatY_[0] + vec[1] * r2aMatY_[1] };
+	}
+
 	void SetParentRotationScale(double angle, double scale) {
 		Math::DVec2 sc;
 		Math::DoSinCos(Math::DegreeToRadian(angle), sc);
@@ -114,6 +187,75 @@ public:
 	int GetMoveFrame() { return frameMove_; }
 };
 
+template<class List> void StgSpatialGrid::Prepare(List& listObj) {
+	if (bValid_) return;
+
+	std::vector<StgMoveObject*> listMove;
+	listMove.reserve(listObj.size());
+	for (auto& obj : listObj) {
+		if (!obj->IsDeleted()) listMove.push_back(obj.get());
+	}
+	_Build(listMove);
+}
+template<class Pred> void StgSpatialGrid::QueryNearest(double x, double y, size_t count, Pred pred,
+	std::vector<StgMoveObject*>& res)
+{
+	if (count == 0 || !std::isfinite(x) || !std::isfinite(y)) return;
+
+	std::vector<std::pair<double, StgMoveObject*>> listFound;
+	auto _Less = [](const std::pair<double, StgMoveObject*>& a, const std::pair<double, StgMoveObject*>& b) {
+		if (a.first != b.first) return a.first < b.first;
+		return a.second->spatialOrder_ < b.second->spatialOrder_;
+	};
+
+	for (StgMoveObject* obj : listLoose_) {
+		if (pred(obj))
+			listFound.push_back({ Math::HypotSq(obj->posX_ - x, obj->posY_ - y), obj });
+	}
+
+	if (countCellX_ > 0) {
+		auto _ScanCell = [&](int ix, int iy) {
+			if (ix < 0 || ix >= countCellX_ || iy < 0 || iy >= countCellY_) return;
+			size_t cell = iy * countCellX_ + ix;
+			for (uint32_t iEntry = listCellStart_[cell]; iEntry < listCellStart_[cell + 1]; ++iEntry) {
+				Entry& entry = listEntry_[iEntry];
+				if (entry.obj->spatialBuild_ != build_ || !pred(entry.obj)) continue;
+				listFound.push_back({ Math::HypotSq(entry.x - x, entry.y - y), entry.obj });
+			}
+		};
+
+		//Scans rings of cells outwards, objects in ring k+1 are at least k cells away from the point
+		int cx = _GetCellX(x);
+		int cy = _GetCellY(y);
+		int ringMax = std::max(countCellX_, countCellY_);
+		for (int ring = 0; ring <= ringMax; ++ring) {
+			if (ring == 0) _ScanCell(cx, cy);
+			else {
+				for (int ix = cx - ring; ix <= cx + ring; ++ix) {
+					_ScanCell(ix, cy - ring);
+					_ScanCell(ix, cy + ring);
+				}
+				for (int iy = cy - ring + 1; iy < cy + ring; ++iy) {
+					_ScanCell(cx - ring, iy);
+					_ScanCell(cx + ring, iy);
+				}
+			}
+
+			if (listFound.size() >= count) {
+				auto itrNth = listFound.begin() + (count - 1);
+				std::nth_element(listFound.begin(), itrNth, listFound.end(), _Less);
+				double bound = ring * cellSize_;
+				if (itrNth->first < bound * bound) break;
+			}
+		}
+	}
+
+	size_t countRes = std::min(count, listFound.size());
+	std::partial_sort(listFound.begin(), listFound.begin() + countRes, listFound.end(), _Less);
+	for (size_t i = 0; i < countRes; ++i)
+		res.push_back(listFound[i].second);
+}
+
 //*******************************************************************
 //StgMoveParentObject
 //*******************************************************************
@@ -192,6 +192,10 @@ StgControlScript::StgControlScript(StgSystemController* systemController) {
 
 	SetScriptEngineCache(systemController->GetScriptEngineCache());
 }
+void StgControlScript::AppendScriptTables(std::vector<function>* listFunc, std::vector<constant>* listConst) {
+	listFunc->insert(listFunc->end(), stgControlFunction.cbegin(), stgControlFunction.cend());
+	listConst->insert(listConst->end(), stgControlConstant.cbegin(), stgControlConstant.cend());
+}
 
 //STG制御共通関数：共通データ
 gstd::value StgControlScript::Func_SaveCommonDataAreaA1(gstd::script_machine* machine, int argc, const gstd::value* argv) {
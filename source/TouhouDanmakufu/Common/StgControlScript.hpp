@@ -86,6 +86,8 @@ protected:
 public:
 	StgControlScript(StgSystemController* systemController);
 
+	static void AppendScriptTables(std::vector<gstd::function>* listFunc, std::vector<gstd::constant>* listConst);
+
 	//Area common data save/load
 	static gstd::value Func_SaveCommonDataAreaA1(gstd::script_machine* machine, int argc, const gstd::value* argv);
 	static gstd::value Func_LoadCommonDataAreaA1(gstd::script_machine* machine, int argc, const gstd::value* argv);
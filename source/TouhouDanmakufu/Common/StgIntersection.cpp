@@ -120,7 +120,8 @@ void StgIntersectionManager::Work() {
 	countCircleInstance_ = 0U;
 	countLineVertex_ = 0U;
 
-	listEnemyTargetPoint_ = listEnemyTargetPointNext_;
+	//Both buffers keep their capacity, no allocation once warmed up
+	listEnemyTargetPoint_.swap(listEnemyTargetPointNext_);
 	listEnemyTargetPointNext_.clear();
 
 	size_t totalCheck = 0;
@@ -130,6 +131,7 @@ void StgIntersectionManager::Work() {
 
 		size_t currentCheck = 0;
 		auto listCheck = space->CreateIntersectionCheckList(this, currentCheck);
+		_CheckIntersection(listCheck, currentCheck);
 
 		for (size_t iCheck = 0; iCheck < currentCheck; iCheck++) {
 			auto& cTargetPair = listCheck->at(iCheck);
@@ -138,7 +140,7 @@ void StgIntersectionManager::Work() {
 			StgIntersectionTarget* targetB = cTargetPair.second;
 			if (targetA == nullptr || targetB == nullptr) continue;
 
-			if (IsIntersected(targetA, targetB)) {
+			if (listCheckResult_[iCheck]) {
 				ref_unsync_weak_ptr<StgIntersectionObject>& ptrA = targetA->GetObject();
 				ref_unsync_weak_ptr<StgIntersectionObject>& ptrB = targetB->GetObject();
 				{
@@ -223,17 +225,7 @@ void StgIntersectionManager::AddTarget(ref_unsync_ptr<StgIntersectionTarget> tar
 			if (auto obj = target->GetObject()) {
 				listSpace_[SPACE_PLAYER_ENEMY]->RegistTargetB(target);
 				listSpace_[SPACE_PLAYERSHOT_ENEMY]->RegistTargetB(target);
-
-				if (auto circle = ref_unsync_ptr<StgIntersectionTarget_Circle>::Cast(target)) {
-					ref_unsync_weak_ptr<StgEnemyObject> objEnemy = ref_unsync_weak_ptr<StgEnemyObject>::Cast(obj);
-					if (objEnemy) {
-						POINT pos = { (int)circle->GetCircle().GetX(), (int)circle->GetCircle().GetY() };
-						StgIntersectionTargetPoint tp;
-						tp.SetObjectRef(objEnemy);
-						tp.SetPoint(pos);
-						listEnemyTargetPointNext_.push_back(tp);
-					}
-				}
+				_AddEnemyTargetPoint(target.get());
 			}
 
 			break;
@@ -256,19 +248,7 @@ void StgIntersectionManager::AddEnemyTargetToShot(ref_unsync_ptr<StgIntersection
 	case StgIntersectionTarget::TYPE_ENEMY:
 	{
 		listSpace_[SPACE_PLAYERSHOT_ENEMY]->RegistTargetB(target);
-
-		if (auto circle = ref_unsync_ptr<StgIntersectionTarget_Circle>::Cast(target)) {
-			if (ref_unsync_ptr<StgIntersectionObject> obj = target->GetObject().Lock()) {
-				if (ref_unsync_ptr<StgEnemyObject> objEnemy = ref_unsync_ptr<StgEnemyObject>::Cast(obj)) {
-					POINT pos = { (int)circle->GetCircle().GetX(), (int)circle->GetCircle().GetY() };
-					StgIntersectionTargetPoint tp;
-					tp.SetObjectRef(objEnemy);
-					tp.SetPoint(pos);
-					listEnemyTargetPointNext_.push_back(tp);
-				}
-			}
-		}
-
+		_AddEnemyTargetPoint(target.get());
 		break;
 	}
 	}
@@ -286,6 +266,66 @@ void StgIntersectionManager::AddEnemyTargetToPlayer(ref_unsync_ptr<StgIntersecti
 	}
 	}
 }
+void StgIntersectionManager::_AddEnemyTargetPoint(StgIntersectionTarget* target) {
+	auto circle = dynamic_cast<StgIntersectionTarget_Circle*>(target);
+	if (circle == nullptr) return;
+
+	auto objEnemy = dynamic_cast<StgEnemyObject*>(target->GetObject().get());
+	if (objEnemy == nullptr) return;
+
+	DxCircle& cir = circle->GetCircle();
+	listEnemyTargetPointNext_.push_back({ objEnemy->GetObjectID(), (LONG)cir.GetX(), (LONG)cir.GetY() });
+}
+//Tests the whole check list before any Intersect callback runs, the callbacks never alter the shapes.
+//	Circle pairs go through the batched tests, line-line pairs stay on the scalar path.
+void StgIntersectionManager::_CheckIntersection(std::vector<StgIntersectionSpace::TargetCheckListPair>* listCheck, size_t count) {
+	listCheckResult_.assign(count, 0);
+
+	batchCircleCircleA_.Clear();
+	batchCircleCircleB_.Clear();
+	listCircleCircleIndex_.clear();
+	batchCircleLineC_.Clear();
+	batchCircleLineL_.Clear();
+	listCircleLineIndex_.clear();
+
+	for (size_t iCheck = 0; iCheck < count; ++iCheck) {
+		StgIntersectionTarget* p1 = (*listCheck)[iCheck].first;
+		StgIntersectionTarget* p2 = (*listCheck)[iCheck].second;
+		if (p1 == nullptr || p2 == nullptr) continue;
+
+		//The shape is only ever set by the constructors of the matching subclasses
+		StgIntersectionTarget::Shape shape1 = p1->GetShape();
+		StgIntersectionTarget::Shape shape2 = p2->GetShape();
+		if (shape1 == StgIntersectionTarget::SHAPE_CIRCLE && shape2 == StgIntersectionTarget::SHAPE_CIRCLE) {
+			batchCircleCircleA_.Add(static_cast<StgIntersectionTarget_Circle*>(p1)->GetCircle());
+			batchCircleCircleB_.Add(static_cast<StgIntersectionTarget_Circle*>(p2)->GetCircle());
+			listCircleCircleIndex_.push_back(iCheck);
+		}
+		else if (shape1 == StgIntersectionTarget::SHAPE_LINE && shape2 == StgIntersectionTarget::SHAPE_LINE) {
+			listCheckResult_[iCheck] = IsIntersected(p1, p2);
+		}
+		else {
+			if (shape1 == StgIntersectionTarget::SHAPE_LINE)
+				std::swap(p1, p2);
+			batchCircleLineC_.Add(static_cast<StgIntersectionTarget_Circle*>(p1)->GetCircle());
+			batchCircleLineL_.Add(static_cast<StgIntersectionTarget_Line*>(p2)->GetLine());
+			listCircleLineIndex_.push_back(iCheck);
+		}
+	}
+
+	if (listCircleCircleIndex_.size() > 0) {
+		listBatchResult_.resize(listCircleCircleIndex_.size());
+		DxIntersect::Circle_Circle(&batchCircleCircleA_, &batchCircleCircleB_, listBatchResult_.data());
+		for (size_t i = 0; i < listCircleCircleIndex_.size(); ++i)
+			listCheckResult_[listCircleCircleIndex_[i]] = listBatchResult_[i];
+	}
+	if (listCircleLineIndex_.size() > 0) {
+		listBatchResult_.resize(listCircleLineIndex_.size());
+		DxIntersect::Circle_LineW(&batchCircleLineC_, &batchCircleLineL_, listBatchResult_.data());
+		for (size_t i = 0; i < listCircleLineIndex_.size(); ++i)
+			listCheckResult_[listCircleLineIndex_[i]] = listBatchResult_[i];
+	}
+}
 
 bool StgIntersectionManager::IsIntersected(StgIntersectionTarget* p1, StgIntersectionTarget* p2) {
 	if (p1 != nullptr && p2 != nullptr) {
@@ -95,7 +95,15 @@ public:
 	}
 };
 
-class StgIntersectionTargetPoint;
+//*******************************************************************
+//StgIntersectionTargetPoint
+//	Intersection circle of an enemy to player shots, as last registered
+//*******************************************************************
+struct StgIntersectionTargetPoint {
+	int idObject;
+	LONG x;
+	LONG y;
+};
 
 //*******************************************************************
 //StgIntersectionManager
@@ -109,6 +117,7 @@ private:
 	};
 	
 	std::vector<StgIntersectionSpace*> listSpace_;
+	//Swapped each frame, the front is read by scripts while the back is filled by the enemies
 	std::vector<StgIntersectionTargetPoint> listEnemyTargetPoint_;
 	std::vector<StgIntersectionTargetPoint> listEnemyTargetPointNext_;
 
@@ -123,6 +132,19 @@ private:
 	shared_ptr<Shader> shaderVisualizerLine_;
 
 	CriticalSection lock_;
+
+	//Narrowphase results of the current check list, and its pairs grouped by shape for the batched tests
+	std::vector<uint8_t> listCheckResult_;
+	std::vector<uint8_t> listBatchResult_;
+	DxCircleBatch batchCircleCircleA_;
+	DxCircleBatch batchCircleCircleB_;
+	std::vector<size_t> listCircleCircleIndex_;
+	DxCircleBatch batchCircleLineC_;
+	DxWidthLineBatch batchCircleLineL_;
+	std::vector<size_t> listCircleLineIndex_;
+
+	void _AddEnemyTargetPoint(StgIntersectionTarget* target);
+	void _CheckIntersection(std::vector<std::pair<StgIntersectionTarget*, StgIntersectionTarget*>>* listCheck, size_t count);
 public:
 	StgIntersectionManager();
 	virtual ~StgIntersectionManager();
@@ -138,7 +160,7 @@ public:
 	void AddTarget(ref_unsync_ptr<StgIntersectionTarget> target);
 	void AddEnemyTargetToShot(ref_unsync_ptr<StgIntersectionTarget> target);
 	void AddEnemyTargetToPlayer(ref_unsync_ptr<StgIntersectionTarget> target);
-	std::vector<StgIntersectionTargetPoint>* GetAllEnemyTargetPoint() { return &listEnemyTargetPoint_; }
+	const std::vector<StgIntersectionTargetPoint>& GetAllEnemyTargetPoint() { return listEnemyTargetPoint_; }
 
 	static bool IsIntersected(StgIntersectionTarget* target1, StgIntersectionTarget* target2);
 
@@ -247,20 +269,4 @@ public:
 inline void StgIntersectionTarget::ClearObjectIntersectedIdList() { 
 	if (!obj_.expired()) 
 		obj_->ClearIntersectedIdList();
-}
-
-//*******************************************************************
-//StgIntersectionTargetPoint
-//*******************************************************************
-class StgEnemyObject;
-class StgIntersectionTargetPoint {
-private:
-	POINT pos_;
-	ref_unsync_weak_ptr<StgEnemyObject> ptrObject_;
-public:
-	POINT& GetPoint() { return pos_; }
-	void SetPoint(POINT& pos) { pos_ = pos; }
-
-	ref_unsync_weak_ptr<StgEnemyObject> GetObjectRef() { return ptrObject_; }
-	void SetObjectRef(ref_unsync_weak_ptr<StgEnemyObject> id) { ptrObject_ = id; }
-};
\ No newline at end of file
+}
\ No newline at end of file
@@ -56,8 +56,13 @@ StgItemManager::StgItemManager(StgStageController* stageController) {
 	pLastTexture_ = nullptr;
 }
 StgItemManager::~StgItemManager() {
+	for (ref_unsync_ptr<StgItemObject>& obj : listObj_) {
+		if (obj) spatialGrid_.Unregister(obj.get());
+	}
 }
 void StgItemManager::Work() {
+	spatialGrid_.Invalidate();
+
 	ref_unsync_ptr<StgPlayerObject> objPlayer = stageController_->GetPlayerObject();
 	if (objPlayer == nullptr) return;
 
@@ -71,6 +76,7 @@ void StgItemManager::Work() {
 
 		if (obj->IsDeleted()) {
 			//obj->Clear();
+			spatialGrid_.Unregister(obj.get());
 			itr = listObj_.erase(itr);
 		}
 		else {
@@ -293,9 +299,16 @@ void StgItemManager::CancelCollectItems() {
 
 std::vector<int> StgItemManager::GetItemIdInCircle(int cx, int cy, int radius, int* itemType) {
 	int rr = radius * radius;
+	int r = std::abs(radius);
+
+	//Widened by 1 since the test truncates the offsets to integers
+	std::vector<StgMoveObject*> listFound;
+	spatialGrid_.Prepare(listObj_);
+	spatialGrid_.QueryRect(cx - r - 1.0, cy - r - 1.0, cx + r + 1.0, cy + r + 1.0, listFound);
 
 	std::vector<int> res;
-	for (ref_unsync_ptr<StgItemObject>& obj : listObj_) {
+	for (StgMoveObject* objMove : listFound) {
+		StgItemObject* obj = static_cast<StgItemObject*>(objMove);
 		if (obj->IsDeleted()) continue;
 		if (itemType != nullptr && (*itemType != obj->GetItemType())) continue;
 
@@ -313,71 +326,73 @@ StgItemDataList::StgItemDataList() {
 }
 StgItemDataList::~StgItemDataList() {
 }
-void StgItemDataList::_LoadVertexBuffers(std::map<std::wstring, VBContainerList>::iterator placement,
-	shared_ptr<Texture> texture, std::vector<StgItemData*>& listAddData)
+void StgItemDataList::_CreateVertices(shared_ptr<Texture> texture, std::vector<StgItemData*>& listAddData,
+	std::vector<VERTEX_TLX>& bufferVertex)
 {
-	DirectGraphics* graphics = DirectGraphics::GetBase();
-	IDirect3DDevice9* device = graphics->GetDevice();
-
 	float texW = texture->GetWidth();
 	float texH = texture->GetHeight();
 
-	size_t countFrame = 0;
-	for (StgItemData* iData : listAddData)
-		countFrame += iData->GetFrameCount();
+	size_t iVertex = 0;
+	for (StgItemData* data : listAddData) {
+		for (size_t iAnim = 0; iAnim < data->GetFrameCount(); ++iAnim) {
+			StgItemDataFrame* pFrame = &data->listFrame_[iAnim];
+
+			LONG* ptrSrc = reinterpret_cast<LONG*>(&pFrame->rcSrc_);
+			float* ptrDst = reinterpret_cast<float*>(&pFrame->rcDst_);
+
+			for (size_t iVert = 0; iVert < 4; ++iVert) {
+				VERTEX_TLX* pv = &bufferVertex[iVertex + iVert];
+
+				//((iVert & 1) << 1)
+				//   0 -> 0
+				//   1 -> 2
+				//   2 -> 0
+				//   3 -> 2
+				//(iVert | 1)
+				//   0 -> 1
+				//   1 -> 1
+				//   2 -> 3
+				//   3 -> 3
+
+				StgShotObject::_SetVertexUV(pv,
+					ptrSrc[(iVert & 1) << 1] / texW, ptrSrc[iVert | 1] / texH);
+				StgShotObject::_SetVertexPosition(pv, ptrDst[(iVert & 1) << 1], ptrDst[iVert | 1], 0);
+				StgShotObject::_SetVertexColorARGB(pv, 0xffffffff);
+			}
+			iVertex += 4;
+		}
+	}
+}
+void StgItemDataList::_LoadVertexBuffers(std::map<std::wstring, VBContainerList>::iterator placement,
+	shared_ptr<Texture> texture, std::vector<StgItemData*>& listAddData, const std::vector<VERTEX_TLX>& bufferVertex)
+{
+	size_t countFrame = bufferVertex.size() / 4;
 
-	size_t iBuffer = 0;
-	while (countFrame > 0) {
-		size_t thisCountFrame = std::min<size_t>(countFrame, StgShotVertexBufferContainer::MAX_DATA);
+	//Split the frames into buffers of at most MAX_DATA frames each
+	size_t iData = 0;
+	size_t iAnim = 0;
+	size_t iFrameTotal = 0;
+	while (iFrameTotal < countFrame) {
+		size_t thisCountFrame = std::min<size_t>(countFrame - iFrameTotal, StgShotVertexBufferContainer::MAX_DATA);
 
 		placement->second.push_back(unique_ptr<StgShotVertexBufferContainer>(
 			new StgShotVertexBufferContainer()));
 		StgShotVertexBufferContainer* pVertexBufferContainer = placement->second.back().get();
 		pVertexBufferContainer->SetTexture(texture);
 
-		std::vector<VERTEX_TLX> bufferVertex(4 * thisCountFrame);
-		size_t iVertex = 0;
-
-		VERTEX_TLX verts[4];
-		for (size_t iData = 0; iData < listAddData.size(); ++iData) {
-			StgItemData* data = listAddData[iData];
-			for (size_t iAnim = 0; iAnim < data->GetFrameCount(); ++iAnim) {
-				StgItemDataFrame* pFrame = &data->listFrame_[iAnim];
-				pFrame->listItemData_ = this;
-
-				LONG* ptrSrc = reinterpret_cast<LONG*>(&pFrame->rcSrc_);
-				float* ptrDst = reinterpret_cast<float*>(&pFrame->rcDst_);
-
-				for (size_t iVert = 0; iVert < 4; ++iVert) {
-					VERTEX_TLX* pv = &verts[iVert];
-
-					//((iVert & 1) << 1)
-					//   0 -> 0
-					//   1 -> 2
-					//   2 -> 0
-					//   3 -> 2
-					//(iVert | 1)
-					//   0 -> 1
-					//   1 -> 1
-					//   2 -> 3
-					//   3 -> 3
-
-					StgShotObject::_SetVertexUV(pv,
-						ptrSrc[(iVert & 1) << 1] / texW, ptrSrc[iVert | 1] / texH);
-					StgShotObject::_SetVertexPosition(pv, ptrDst[(iVert & 1) << 1], ptrDst[iVert | 1], 0);
-					StgShotObject::_SetVertexColorARGB(pv, 0xffffffff);
-				}
-
-				pFrame->pVertexBuffer_ = pVertexBufferContainer;
-				pFrame->vertexOffset_ = iVertex;
-
-				for (size_t j = 0; j < 4; ++j)
-					bufferVertex[iVertex + j] = verts[j];
-				iVertex += 4;
+		for (size_t iFrame = 0; iFrame < thisCountFrame; ++iFrame) {
+			while (iAnim >= listAddData[iData]->GetFrameCount()) {
+				++iData;
+				iAnim = 0;
 			}
+
+			StgItemDataFrame* pFrame = &listAddData[iData]->listFrame_[iAnim++];
+			pFrame->listItemData_ = this;
+			pFrame->pVertexBuffer_ = pVertexBufferContainer;
+			pFrame->vertexOffset_ = iFrame * 4;
 		}
 
-		HRESULT hr = pVertexBufferContainer->LoadData(bufferVertex, thisCountFrame);
+		HRESULT hr = pVertexBufferContainer->LoadData(bufferVertex.data() + iFrameTotal * 4, thisCountFrame);
 		if (FAILED(hr)) {
 			std::wstring err = StringUtility::Format(L"AddItemDataList::Failed to load shot data buffer: "
 				"\t\r\n%s: %s",
@@ -385,8 +400,102 @@ void StgItemDataList::_LoadVertexBuffers(std::map<std::wstring, VBContainerList>
 			throw gstd::wexception(err);
 		}
 
-		++iBuffer;
-		countFrame -= thisCountFrame;
+		iFrameTotal += thisCountFrame;
+	}
+}
+void StgItemDataList::_WriteBinary(ByteBuffer& buf, const std::wstring& pathImage, std::vector<int>& listAddID,
+	std::vector<StgItemData*>& listAddData)
+{
+	std::vector<BinaryItemRecord> listRecord;
+	std::vector<BinaryFrameRecord> listFrame;
+
+	auto _AddFrames = [&](StgItemData* data) {
+		for (StgItemDataFrame& iFrame : data->listFrame_) {
+			BinaryFrameRecord frame;
+			frame.frame = iFrame.frame_;
+			memcpy(frame.rect, &iFrame.rcSrc_, sizeof(frame.rect));
+			listFrame.push_back(frame);
+		}
+	};
+
+	//Out data follow their owners in listAddData, keep that order so the baked vertices line up
+	size_t iID = 0;
+	for (size_t i = 0; i < listAddData.size(); ++i) {
+		StgItemData* data = listAddData[i];
+
+		BinaryItemRecord record;
+		record.id = listAddID[iID++];
+		record.typeItem = data->typeItem_;
+		record.typeRender = data->typeRender_;
+		record.alpha = data->alpha_;
+		record.totalFrame = data->totalFrame_;
+		record.indexFrame = listFrame.size();
+		record.countFrame = data->listFrame_.size();
+		_AddFrames(data);
+
+		record.indexFrameOut = -1;
+		if (StgItemData* dataOut = data->dataOut_.get()) {
+			record.indexFrameOut = listFrame.size();
+			_AddFrames(dataOut);
+			++i;
+		}
+
+		listRecord.push_back(record);
+	}
+
+	StgDataBinaryCache::WriteString(buf, pathImage);
+	buf.WriteValue<uint32_t>(listRecord.size());
+	buf.WriteValue<uint32_t>(listFrame.size());
+	if (listRecord.size() > 0)
+		buf.Write(listRecord.data(), listRecord.size() * sizeof(BinaryItemRecord));
+	if (listFrame.size() > 0)
+		buf.Write(listFrame.data(), listFrame.size() * sizeof(BinaryFrameRecord));
+}
+void StgItemDataList::_ReadBinary(StgDataBinaryReader& reader, std::wstring& pathImage, std::map<int, unique_ptr<StgItemData>>& mapData) {
+	pathImage = StgDataBinaryCache::ReadString(reader);
+
+	uint32_t countRecord = reader.ReadValue<uint32_t>();
+	uint32_t countFrame = reader.ReadValue<uint32_t>();
+	reader.CheckSize((uint64_t)countRecord * sizeof(BinaryItemRecord) + (uint64_t)countFrame * sizeof(BinaryFrameRecord));
+
+	std::vector<BinaryItemRecord> listRecord(countRecord);
+	std::vector<BinaryFrameRecord> listFrame(countFrame);
+	if (listRecord.size() > 0)
+		reader.Read(listRecord.data(), listRecord.size() * sizeof(BinaryItemRecord));
+	if (listFrame.size() > 0)
+		reader.Read(listFrame.data(), listFrame.size() * sizeof(BinaryFrameRecord));
+
+	auto _LoadFrame = [&](StgItemDataFrame& dst, size_t index) {
+		BinaryFrameRecord& src = listFrame[index];
+		dst.frame_ = src.frame;
+		dst.rcSrc_ = DxRect<LONG>(src.rect[0], src.rect[1], src.rect[2], src.rect[3]);
+		dst.rcDst_ = StgItemDataFrame::LoadDestRect(&dst.rcSrc_);
+	};
+
+	for (BinaryItemRecord& record : listRecord) {
+		if ((uint64_t)record.indexFrame + record.countFrame > listFrame.size()
+			|| (record.indexFrameOut >= 0 && record.indexFrameOut >= listFrame.size()))
+			throw gstd::wexception("Corrupted compiled item data.");
+
+		StgItemData* data = new StgItemData(this);
+		mapData[record.id] = unique_ptr<StgItemData>(data);
+
+		data->typeItem_ = record.typeItem;
+		data->typeRender_ = (BlendMode)record.typeRender;
+		data->alpha_ = record.alpha;
+		data->totalFrame_ = record.totalFrame;
+
+		data->listFrame_.resize(record.countFrame);
+		for (size_t iFrame = 0; iFrame < record.countFrame; ++iFrame)
+			_LoadFrame(data->listFrame_[iFrame], record.indexFrame + iFrame);
+
+		if (record.indexFrameOut >= 0) {
+			StgItemData* out = new StgItemData(this);
+			out->listFrame_.resize(1);
+			_LoadFrame(out->listFrame_[0], record.indexFrameOut);
+			out->totalFrame_ = 1;
+			data->dataOut_.reset(out);
+		}
 	}
 }
 bool StgItemDataList::AddItemDataList(const std::wstring& path, bool bReload) {
@@ -401,32 +510,42 @@ bool StgItemDataList::AddItemDataList(const std::wstring& path, bool bReload) {
 
 	std::string source = reader->ReadAllString();
 
+	uint64_t keyBinary = StgDataBinaryCache::ComputeKey(BINARY_HEADER, source);
+	unique_ptr<StgDataBinaryReader> readerBinary = StgDataBinaryCache::Find(BINARY_HEADER, keyBinary);
+
 	bool res = false;
 	Scanner scanner(source);
 	try {
 		std::map<int, unique_ptr<StgItemData>> mapData;
 		std::wstring pathImage = L"";
 
-		while (scanner.HasNext()) {
-			Token& tok = scanner.Next();
-			if (tok.GetType() == Token::Type::TK_EOF)
-				break;
-			else if (tok.GetType() == Token::Type::TK_ID) {
-				std::wstring element = tok.GetElement();
-				if (element == L"ItemData") {
-					_ScanItem(mapData, scanner);
-				}
-				else if (element == L"item_image") {
-					scanner.CheckType(scanner.Next(), Token::Type::TK_EQUAL);
-					pathImage = scanner.Next().GetString();
-				}
+		if (readerBinary) {
+			_ReadBinary(*readerBinary, pathImage, mapData);
+		}
+		else {
+			while (scanner.HasNext()) {
+				Token& tok = scanner.Next();
+				if (tok.GetType() == Token::Type::TK_EOF)
+					break;
+				else if (tok.GetType() == Token::Type::TK_ID) {
+					std::wstring element = tok.GetElement();
+					if (element == L"ItemData") {
+						_ScanItem(mapData, scanner);
+					}
+					else if (element == L"item_image") {
+						scanner.CheckType(scanner.Next(), Token::Type::TK_EQUAL);
+						pathImage = scanner.Next().GetString();
+					}
 
-				if (scanner.HasNext())
-					tok = scanner.Next();
+					if (scanner.HasNext())
+						tok = scanner.Next();
+				}
 			}
 		}
 
 		if (pathImage.size() == 0) throw gstd::wexception("Item texture must be set.");
+		std::wstring pathImageSource = pathImage;
+
 		std::wstring dir = PathProperty::GetFileDirectory(path);
 		pathImage = StringUtility::Replace(pathImage, L"./", dir);
 		pathImage = PathProperty::GetUnique(pathImage);
@@ -445,6 +564,7 @@ bool StgItemDataList::AddItemDataList(const std::wstring& path, bool bReload) {
 			throw gstd::wexception("Failed to load the specified shot texture.");
 		}
 
+		std::vector<int> listAddID;
 		std::vector<StgItemData*> listAddData;
 
 		size_t countFrame = 0;
@@ -459,6 +579,7 @@ bool StgItemDataList::AddItemDataList(const std::wstring& path, bool bReload) {
 					iFrame.listItemData_ = this;
 				countFrame += data->GetFrameCount();
 
+				listAddID.push_back(id);
 				listAddData.push_back(data.get());
 				if (listData_.size() <= id)
 					listData_.resize(id + 1);
@@ -475,16 +596,33 @@ bool StgItemDataList::AddItemDataList(const std::wstring& path, bool bReload) {
 			}
 		}
 
+		std::vector<VERTEX_TLX> bufferVertex(countFrame * 4);
+		{
+			float texW = texture->GetWidth();
+			float texH = texture->GetHeight();
+
+			if (readerBinary == nullptr || !StgDataBinaryCache::ReadVertices(*readerBinary, bufferVertex, texW, texH))
+				_CreateVertices(texture, listAddData, bufferVertex);
+
+			if (readerBinary == nullptr) {
+				ByteBuffer bufCompiled;
+				_WriteBinary(bufCompiled, pathImageSource, listAddID, listAddData);
+				StgDataBinaryCache::WriteVertices(bufCompiled, bufferVertex, texW, texH);
+				StgDataBinaryCache::Store(BINARY_HEADER, keyBinary, bufCompiled);
+			}
+		}
+
 		if (itrVB != mapVertexBuffer_.end()) {
 			itrVB->second.clear();
-			_LoadVertexBuffers(itrVB, texture, listAddData);
+			_LoadVertexBuffers(itrVB, texture, listAddData, bufferVertex);
 		}
 		else {
 			itrVB = mapVertexBuffer_.insert({ path, VBContainerList() }).first;
-			_LoadVertexBuffers(itrVB, texture, listAddData);
+			_LoadVertexBuffers(itrVB, texture, listAddData, bufferVertex);
 		}
 
-		Logger::WriteTop(StringUtility::Format(L"Loaded item data: %s", pathReduce.c_str()));
+		Logger::WriteTop(StringUtility::Format(L"Loaded item data: %s%s", pathReduce.c_str(),
+			readerBinary ? L" (compiled)" : L""));
 		res = true;
 	}
 	catch (gstd::wexception& e) {
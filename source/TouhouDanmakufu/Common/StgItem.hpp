@@ -7,6 +7,7 @@
 //#include "StgShot.hpp"
 
 class StgShotVertexBufferContainer;
+class StgDataBinaryReader;
 
 class StgItemDataList;
 class StgItemData;
@@ -38,6 +39,7 @@ protected:
 	unique_ptr<StgItemDataList> listItemData_;
 
 	std::list<ref_unsync_ptr<StgItemObject>> listObj_;
+	StgSpatialGrid spatialGrid_;
 	std::vector<RenderQueue> listRenderQueue_;		//one for each render pri
 
 	std::list<DxCircle> listCircleToPlayer_;
@@ -65,6 +67,7 @@ public:
 
 	void AddItem(ref_unsync_ptr<StgItemObject> obj) {
 		listObj_.push_back(obj); 
+		spatialGrid_.Register(obj.get());
 	}
 	size_t GetItemCount() { return listObj_.size(); }
 
@@ -105,15 +108,38 @@ class StgItemDataList {
 public:
 	//Repurpose StgShotVertexBufferContainer for this, since it'd have been the same code anyway
 	using VBContainerList = std::list<unique_ptr<StgShotVertexBufferContainer>>;
+
+	static constexpr const char* BINARY_HEADER = "DNHITEMB";
 private:
+	struct BinaryItemRecord {
+		int32_t id;
+		int32_t typeItem;
+		int32_t typeRender;
+		int32_t alpha;
+		uint32_t totalFrame;
+		uint32_t indexFrame;
+		uint32_t countFrame;
+		int32_t indexFrameOut;		//-1 if the item has no out data
+	};
+	struct BinaryFrameRecord {
+		uint32_t frame;
+		LONG rect[4];
+	};
+protected:
 	std::map<std::wstring, VBContainerList> mapVertexBuffer_;	//<shot data file, vb list>
 	std::vector<unique_ptr<StgItemData>> listData_;
 
 	void _ScanItem(std::map<int, unique_ptr<StgItemData>>& mapData, Scanner& scanner);
 	static void _ScanAnimation(StgItemData* itemData, Scanner& scanner);
 
+	void _WriteBinary(gstd::ByteBuffer& buf, const std::wstring& pathImage, std::vector<int>& listAddID, 
+		std::vector<StgItemData*>& listAddData);
+	void _ReadBinary(StgDataBinaryReader& reader, std::wstring& pathImage, std::map<int, unique_ptr<StgItemData>>& mapData);
+
+	void _CreateVertices(shared_ptr<Texture> texture, std::vector<StgItemData*>& listAddData,
+		std::vector<VERTEX_TLX>& bufferVertex);
 	void _LoadVertexBuffers(std::map<std::wstring, VBContainerList>::iterator placement,
-		shared_ptr<Texture> texture, std::vector<StgItemData*>& listAddData);
+		shared_ptr<Texture> texture, std::vector<StgItemData*>& listAddData, const std::vector<VERTEX_TLX>& bufferVertex);
 public:
 	StgItemDataList();
 	virtual ~StgItemDataList();
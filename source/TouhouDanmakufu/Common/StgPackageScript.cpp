@@ -83,6 +83,10 @@ StgPackageScript::StgPackageScript(StgPackageController* packageController) : St
 	typeScript_ = TYPE_PACKAGE_MAIN;
 	packageController_ = packageController;
 }
+void StgPackageScript::AppendScriptTables(std::vector<function>* listFunc, std::vector<constant>* listConst) {
+	listFunc->insert(listFunc->end(), stgPackageFunction.cbegin(), stgPackageFunction.cend());
+	listConst->insert(listConst->end(), stgPackageConstant.cbegin(), stgPackageConstant.cend());
+}
 void StgPackageScript::_CheckNextStageExists() {
 	ref_count_ptr<StgPackageInformation> infoPackage = packageController_->GetPackageInformation();
 	ref_count_ptr<StgStageStartData> nextStageData = infoPackage->GetNextStageData();
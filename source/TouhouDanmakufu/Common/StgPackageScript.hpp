@@ -44,6 +44,8 @@ private:
 public:
 	StgPackageScript(StgPackageController* packageController);
 
+	static void AppendScriptTables(std::vector<gstd::function>* listFunc, std::vector<gstd::constant>* listConst);
+
 	//パッケージ共通関数：パッケージ操作
 	static gstd::value Func_ClosePackage(gstd::script_machine* machine, int argc, const gstd::value* argv);
 
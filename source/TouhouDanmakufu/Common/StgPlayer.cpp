@@ -111,7 +111,7 @@ void StgPlayerObject::Work() {
 				scriptManager->RequestEventAll(StgStagePlayerScript::EV_PLAYER_SHOOTDOWN);
 
 			if (infoPlayer_->life_ >= 0 || !enableStateEnd_) {
-				bVisible_ = false;
+				SetVisible(false);
 				state_ = STATE_DOWN;
 				frameState_ = frameStateDown_;
 			}
@@ -122,7 +122,7 @@ void StgPlayerObject::Work() {
 			//Also prevents STATE_END and STATE_DOWN
 			if (!enableShootdownEvent_) {
 				frameState_ = 0;
-				bVisible_ = true;
+				SetVisible(true);
 				_InitializeRebirth();
 				state_ = STATE_NORMAL;
 			}
@@ -131,14 +131,14 @@ void StgPlayerObject::Work() {
 	case STATE_DOWN:
 		frameState_--;
 		if (frameState_ <= 0) {
-			bVisible_ = true;
+			SetVisible(true);
 			_InitializeRebirth();
 			state_ = STATE_NORMAL;
 			scriptManager->RequestEventAll(StgStageScript::EV_PLAYER_REBIRTH);
 		}
 		break;
 	case STATE_END:
-		bVisible_ = false;
+		SetVisible(false);
 		break;
 	}
 
@@ -255,7 +255,7 @@ void StgPlayerObject::KillSelf(int hitObj) {
 }
 void StgPlayerObject::RestorePlayer() {
 	if (state_ == STATE_DOWN || state_ == STATE_END) {
-		bVisible_ = true;
+		SetVisible(true);
 		_InitializeRebirth();
 	}
 	state_ = STATE_NORMAL;
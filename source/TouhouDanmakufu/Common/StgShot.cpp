@@ -42,18 +42,24 @@ StgShotManager::StgShotManager(StgStageController* stageController) {
 }
 StgShotManager::~StgShotManager() {
 	for (ref_unsync_ptr<StgShotObject>& obj : listObj_) {
-		if (obj)
+		if (obj) {
+			spatialGrid_.Unregister(obj.get());
 			obj->ClearShotObject();
+		}
 	}
 }
 void StgShotManager::Work() {
+	spatialGrid_.Invalidate();
+
 	for (auto itr = listObj_.begin(); itr != listObj_.end(); ) {
 		ref_unsync_ptr<StgShotObject>& obj = *itr;
 		if (obj->IsDeleted()) {
+			spatialGrid_.Unregister(obj.get());
 			obj->ClearShotObject();
 			itr = listObj_.erase(itr);
 		}
 		else if (!obj->IsActive()) {
+			spatialGrid_.Unregister(obj.get());
 			itr = listObj_.erase(itr);
 		}
 		else ++itr;
@@ -162,6 +168,15 @@ void StgShotManager::RegistIntersectionTarget() {
 void StgShotManager::AddShot(ref_unsync_ptr<StgShotObject> obj) {
 	obj->SetOwnObjectReference();
 	listObj_.push_back(obj);
+	spatialGrid_.Register(obj.get());
+}
+
+std::vector<StgMoveObject*> StgShotManager::_QueryCircle(int cx, int cy, int r) {
+	//Widened by 1 since the tests truncate the shot positions to integers
+	std::vector<StgMoveObject*> res;
+	spatialGrid_.Prepare(listObj_);
+	spatialGrid_.QueryRect(cx - r - 1.0, cy - r - 1.0, cx + r + 1.0, cy + r + 1.0, res);
+	return res;
 }
 
 void StgShotManager::DeleteInCircle(int typeDelete, int typeTo, int typeOwner, int cx, int cy, int* radius) {
@@ -170,10 +185,10 @@ void StgShotManager::DeleteInCircle(int typeDelete, int typeTo, int typeOwner, i
 
 	DxRect<int> rcBox(cx - r, cy - r, cx + r, cy + r);
 
-	for (ref_unsync_ptr<StgShotObject>& obj : listObj_) {
-		if (obj->IsDeleted()) continue;
-		if ((typeOwner != StgShotObject::OWNER_NULL) && (obj->GetOwnerType() != typeOwner)) continue;
-		if (typeDelete == DEL_TYPE_SHOT && obj->IsSpellResist()) continue;
+	auto _DeleteShot = [&](StgShotObject* obj) {
+		if (obj->IsDeleted()) return;
+		if ((typeOwner != StgShotObject::OWNER_NULL) && (obj->GetOwnerType() != typeOwner)) return;
+		if (typeDelete == DEL_TYPE_SHOT && obj->IsSpellResist()) return;
 
 		int sx = obj->GetPositionX();
 		int sy = obj->GetPositionY();
@@ -186,6 +201,15 @@ void StgShotManager::DeleteInCircle(int typeDelete, int typeTo, int typeOwner, i
 			else if (typeTo == TO_TYPE_ITEM)
 				obj->ConvertToItem();
 		}
+	};
+
+	if (radius == nullptr) {
+		for (ref_unsync_ptr<StgShotObject>& obj : listObj_)
+			_DeleteShot(obj.get());
+	}
+	else {
+		for (StgMoveObject* obj : _QueryCircle(cx, cy, r))
+			_DeleteShot(static_cast<StgShotObject*>(obj));
 	}
 }
 
@@ -196,9 +220,9 @@ std::vector<int> StgShotManager::GetShotIdInCircle(int typeOwner, int cx, int cy
 	DxRect<int> rcBox(cx - r, cy - r, cx + r, cy + r);
 
 	std::vector<int> res;
-	for (ref_unsync_ptr<StgShotObject>& obj : listObj_) {
-		if (obj->IsDeleted()) continue;
-		if ((typeOwner != StgShotObject::OWNER_NULL) && (obj->GetOwnerType() != typeOwner)) continue;
+	auto _AddShot = [&](StgShotObject* obj) {
+		if (obj->IsDeleted()) return;
+		if ((typeOwner != StgShotObject::OWNER_NULL) && (obj->GetOwnerType() != typeOwner)) return;
 
 		int sx = obj->GetPositionX();
 		int sy = obj->GetPositionY();
@@ -206,10 +230,71 @@ std::vector<int> StgShotManager::GetShotIdInCircle(int typeOwner, int cx, int cy
 		if (radius == nullptr || (rcBox.IsPointIntersected(sx, sy) && Math::HypotSq<int64_t>(cx - sx, cy - sy) <= rr)) {
 			res.push_back(obj->GetObjectID());
 		}
+	};
+
+	if (radius == nullptr) {
+		for (ref_unsync_ptr<StgShotObject>& obj : listObj_)
+			_AddShot(obj.get());
+	}
+	else {
+		for (StgMoveObject* obj : _QueryCircle(cx, cy, r))
+			_AddShot(static_cast<StgShotObject*>(obj));
 	}
 
 	return res;
 }
+std::vector<int> StgShotManager::GetShotIdInRect(int typeOwner, double left, double top, double right, double bottom) {
+	std::vector<StgMoveObject*> listFound;
+	spatialGrid_.Prepare(listObj_);
+	spatialGrid_.QueryRect(left, top, right, bottom, listFound);
+
+	std::vector<int> res;
+	for (StgMoveObject* objMove : listFound) {
+		StgShotObject* obj = static_cast<StgShotObject*>(objMove);
+		if (obj->IsDeleted()) continue;
+		if ((typeOwner != StgShotObject::OWNER_NULL) && (obj->GetOwnerType() != typeOwner)) continue;
+		res.push_back(obj->GetObjectID());
+	}
+	return res;
+}
+std::vector<int> StgShotManager::GetShotIdNearest(int typeOwner, double x, double y, size_t count) {
+	std::vector<StgMoveObject*> listFound;
+	spatialGrid_.Prepare(listObj_);
+	spatialGrid_.QueryNearest(x, y, count, [&](StgMoveObject* objMove) {
+		StgShotObject* obj = static_cast<StgShotObject*>(objMove);
+		if (obj->IsDeleted()) return false;
+		return (typeOwner == StgShotObject::OWNER_NULL) || (obj->GetOwnerType() == typeOwner);
+	}, listFound);
+
+	std::vector<int> res;
+	for (StgMoveObject* obj : listFound)
+		res.push_back(static_cast<StgShotObject*>(obj)->GetObjectID());
+	return res;
+}
+//Appends [id, x, y, speedX, speedY] for each shot in the circle, extrapolated by frame frames.
+//	The speed is the displacement of the shot over the frame that follows.
+void StgShotManager::GetShotMotionInCircle(int typeOwner, double cx, double cy, double radius, uint32_t frame,
+	std::vector<double>& res)
+{
+	if (radius < 0) return;
+
+	std::vector<StgMoveObject*> listFound;
+	spatialGrid_.Prepare(listObj_);
+	spatialGrid_.QueryRect(cx - radius, cy - radius, cx + radius, cy + radius, listFound);
+
+	double rr = radius * radius;
+	StgMoveObject probe(stageController_);
+	for (StgMoveObject* objMove : listFound) {
+		StgShotObject* obj = static_cast<StgShotObject*>(objMove);
+		if (obj->IsDeleted()) continue;
+		if ((typeOwner != StgShotObject::OWNER_NULL) && (obj->GetOwnerType() != typeOwner)) continue;
+		if (Math::HypotSq(obj->GetPositionX() - cx, obj->GetPositionY() - cy) > rr) continue;
+
+		Math::DVec2 pos, speed;
+		obj->PredictMotion(&probe, frame, pos, speed);
+		res.insert(res.end(), { (double)obj->GetObjectID(), pos[0], pos[1], speed[0], speed[1] });
+	}
+}
 size_t StgShotManager::GetShotCount(int typeOwner) {
 	size_t res = 0;
 
@@ -256,80 +341,255 @@ bool StgShotManager::LoadEnemyShotData(const std::wstring& path, bool bReload) {
 	return listEnemyShotData_->AddShotDataList(path, bReload);
 }
 
+//****************************************************************************
+//StgDataBinaryReader
+//****************************************************************************
+DWORD StgDataBinaryReader::Read(LPVOID buf, DWORD size) {
+	if (size > GetRemaining())
+		throw gstd::wexception("Corrupted compiled data.");
+	if (size > 0) {
+		memcpy(buf, data_->GetPointer(offset_), size);
+		offset_ += size;
+	}
+	return size;
+}
+void StgDataBinaryReader::CheckSize(uint64_t size) {
+	if (size > GetRemaining())
+		throw gstd::wexception("Corrupted compiled data.");
+}
+
+//****************************************************************************
+//StgDataBinaryCache
+//****************************************************************************
+CriticalSection StgDataBinaryCache::lock_;
+StgDataBinaryCache::DataList StgDataBinaryCache::listData_;
+std::unordered_map<uint64_t, StgDataBinaryCache::DataList::iterator> StgDataBinaryCache::mapData_;
+std::set<uint64_t> StgDataBinaryCache::setWriting_;
+
+std::wstring StgDataBinaryCache::_GetPath(uint64_t key) {
+	return PathProperty::GetModuleDirectory() + StringUtility::Format(L"cache/stgdata/%016llx.dat", key);
+}
+void StgDataBinaryCache::_AddData(uint64_t key, shared_ptr<ByteBuffer> data) {
+	auto itrFind = mapData_.find(key);
+	if (itrFind != mapData_.end())
+		listData_.erase(itrFind->second);
+	listData_.push_back(std::make_pair(key, data));
+	mapData_[key] = std::prev(listData_.end());
+
+	while (listData_.size() > MEMORY_ENTRY_MAX) {
+		mapData_.erase(listData_.front().first);
+		listData_.pop_front();
+	}
+}
+shared_ptr<ByteBuffer> StgDataBinaryCache::_LoadFromDisk(const char* header, uint64_t key) {
+	File file(_GetPath(key));
+	if (!file.Open()) return nullptr;
+
+	size_t sizeFile = file.GetSize();
+	if (sizeFile < HEADER_SIZE + sizeof(uint32_t) + sizeof(uint64_t) + sizeof(uint32_t))
+		return nullptr;
+
+	char fHead[HEADER_SIZE];
+	file.Read(fHead, HEADER_SIZE);
+	if (memcmp(fHead, header, HEADER_SIZE) != 0)
+		return nullptr;
+	if (file.ReadValue<uint32_t>() != VERSION)
+		return nullptr;
+	if (file.ReadValue<uint64_t>() != key)
+		return nullptr;
+
+	uint32_t sizeData = file.ReadValue<uint32_t>();
+	if (file.GetFilePointer() + sizeData > sizeFile)
+		return nullptr;
+
+	shared_ptr<ByteBuffer> res(new ByteBuffer());
+	res->SetSize(sizeData);
+	file.Read(res->GetPointer(), sizeData);
+	return res;
+}
+bool StgDataBinaryCache::_SaveToDisk(const char* header, uint64_t key, ByteBuffer* data) {
+	std::wstring path = _GetPath(key);
+	std::wstring pathTemp = path + L".tmp";
+	File::CreateFileDirectory(path);
+
+	//Written under a temporary name first, so that a reader never sees a partial entry
+	{
+		File file(pathTemp);
+		if (!file.Open(File::AccessType::WRITEONLY))
+			return false;
+
+		file.Write((LPVOID)header, HEADER_SIZE);
+		file.WriteValue<uint32_t>(VERSION);
+		file.WriteValue<uint64_t>(key);
+		file.WriteValue<uint32_t>(data->GetSize());
+		file.Write(data->GetPointer(), data->GetSize());
+		file.Close();
+	}
+
+	std::error_code err;
+	stdfs::rename(pathTemp, path, err);
+	if (err) {
+		stdfs::remove(pathTemp, err);
+		return false;
+	}
+	return true;
+}
+uint64_t StgDataBinaryCache::ComputeKey(const char* header, const std::string& source) {
+	uint64_t hash = HashUtility::Fnv1a64(header, HEADER_SIZE);
+	return HashUtility::Fnv1a64(source, hash);
+}
+unique_ptr<StgDataBinaryReader> StgDataBinaryCache::Find(const char* header, uint64_t key) {
+	shared_ptr<ByteBuffer> data;
+	{
+		Lock lock(lock_);
+
+		auto itrFind = mapData_.find(key);
+		if (itrFind != mapData_.end()) {
+			data = itrFind->second->second;
+			_AddData(key, data);
+		}
+	}
+
+	//The file is read without the lock, another thread loading the same entry only costs a second read
+	if (data == nullptr) {
+		data = _LoadFromDisk(header, key);
+		if (data == nullptr) return nullptr;
+
+		Lock lock(lock_);
+		_AddData(key, data);
+	}
+	return unique_ptr<StgDataBinaryReader>(new StgDataBinaryReader(data));
+}
+void StgDataBinaryCache::Store(const char* header, uint64_t key, ByteBuffer& data) {
+	shared_ptr<ByteBuffer> copy(new ByteBuffer(data));
+	{
+		Lock lock(lock_);
+		_AddData(key, copy);
+
+		//Both threads would write the same bytes, only one gets to
+		if (!setWriting_.insert(key).second) return;
+	}
+
+	_SaveToDisk(header, key, copy.get());
+
+	Lock lock(lock_);
+	setWriting_.erase(key);
+}
+
+void StgDataBinaryCache::WriteString(ByteBuffer& buf, const std::wstring& str) {
+	buf.WriteValue<uint32_t>(str.size());
+	if (str.size() > 0)
+		buf.Write((LPVOID)str.data(), str.size() * sizeof(wchar_t));
+}
+std::wstring StgDataBinaryCache::ReadString(StgDataBinaryReader& reader) {
+	uint32_t count = reader.ReadValue<uint32_t>();
+	reader.CheckSize((uint64_t)count * sizeof(wchar_t));
+
+	std::wstring res;
+	res.resize(count);
+	if (count > 0)
+		reader.Read(&res[0], count * sizeof(wchar_t));
+	return res;
+}
+void StgDataBinaryCache::WriteVertices(ByteBuffer& buf, const std::vector<VERTEX_TLX>& list, float texW, float texH) {
+	buf.WriteValue<float>(texW);
+	buf.WriteValue<float>(texH);
+	buf.WriteValue<uint32_t>(list.size());
+	if (list.size() > 0)
+		buf.Write((LPVOID)list.data(), list.size() * sizeof(VERTEX_TLX));
+}
+bool StgDataBinaryCache::ReadVertices(StgDataBinaryReader& reader, std::vector<VERTEX_TLX>& list, float texW, float texH) {
+	float bTexW = reader.ReadValue<float>();
+	float bTexH = reader.ReadValue<float>();
+	uint32_t count = reader.ReadValue<uint32_t>();
+
+	//UVs were baked against the texture size at compile time
+	if (bTexW != texW || bTexH != texH || count != list.size())
+		return false;
+	if (count > 0)
+		reader.Read(list.data(), count * sizeof(VERTEX_TLX));
+	return true;
+}
+
 //****************************************************************************
 //StgShotDataList
 //****************************************************************************
 StgShotDataList::StgShotDataList() {
 	defaultDelayData_ = -1;
 	defaultDelayColor_ = 0xffffffff;	//Solid white
+
+	bScanFileDelayData_ = false;
+	bScanFileDelayColor_ = false;
 }
 StgShotDataList::~StgShotDataList() {
 }
-void StgShotDataList::_LoadVertexBuffers(std::map<std::wstring, VBContainerList>::iterator placement, 
-	shared_ptr<Texture> texture, std::vector<StgShotData*>& listAddData)
+void StgShotDataList::_CreateVertices(shared_ptr<Texture> texture, std::vector<StgShotData*>& listAddData,
+	std::vector<VERTEX_TLX>& bufferVertex)
 {
-	DirectGraphics* graphics = DirectGraphics::GetBase();
-	IDirect3DDevice9* device = graphics->GetDevice();
-
 	float texW = texture->GetWidth();
 	float texH = texture->GetHeight();
 
-	size_t countFrame = 0;
-	for (StgShotData* iData : listAddData)
-		countFrame += iData->GetFrameCount();
+	size_t iVertex = 0;
+	for (StgShotData* data : listAddData) {
+		for (size_t iAnim = 0; iAnim < data->GetFrameCount(); ++iAnim) {
+			StgShotDataFrame* pFrame = &data->listFrame_[iAnim];
+
+			LONG* ptrSrc = reinterpret_cast<LONG*>(&pFrame->rcSrc_);
+			float* ptrDst = reinterpret_cast<float*>(&pFrame->rcDst_);
+
+			for (size_t iVert = 0; iVert < 4; ++iVert) {
+				VERTEX_TLX* pv = &bufferVertex[iVertex + iVert];
+
+				//((iVert & 1) << 1)
+				//   0 -> 0
+				//   1 -> 2
+				//   2 -> 0
+				//   3 -> 2
+				//(iVert | 1)
+				//   0 -> 1
+				//   1 -> 1
+				//   2 -> 3
+				//   3 -> 3
+
+				StgShotObject::_SetVertexUV(pv,
+					ptrSrc[(iVert & 1) << 1] / texW, ptrSrc[iVert | 1] / texH);
+				StgShotObject::_SetVertexPosition(pv, ptrDst[(iVert & 1) << 1], ptrDst[iVert | 1], 0);
+				StgShotObject::_SetVertexColorARGB(pv, 0xffffffff);
+			}
+			iVertex += 4;
+		}
+	}
+}
+void StgShotDataList::_LoadVertexBuffers(std::map<std::wstring, VBContainerList>::iterator placement, 
+	shared_ptr<Texture> texture, std::vector<StgShotData*>& listAddData, const std::vector<VERTEX_TLX>& bufferVertex)
+{
+	size_t countFrame = bufferVertex.size() / 4;
 
-	size_t iBuffer = 0;
-	while (countFrame > 0) {
-		size_t thisCountFrame = std::min<size_t>(countFrame, StgShotVertexBufferContainer::MAX_DATA);
+	//Split the frames into buffers of at most MAX_DATA frames each
+	size_t iData = 0;
+	size_t iAnim = 0;
+	size_t iFrameTotal = 0;
+	while (iFrameTotal < countFrame) {
+		size_t thisCountFrame = std::min<size_t>(countFrame - iFrameTotal, StgShotVertexBufferContainer::MAX_DATA);
 
 		placement->second.push_back(unique_ptr<StgShotVertexBufferContainer>(
 			new StgShotVertexBufferContainer()));
 		StgShotVertexBufferContainer* pVertexBufferContainer = placement->second.back().get();
 		pVertexBufferContainer->SetTexture(texture);
 
-		std::vector<VERTEX_TLX> bufferVertex(4 * thisCountFrame);
-		size_t iVertex = 0;
-
-		VERTEX_TLX verts[4];
-		for (size_t iData = 0; iData < listAddData.size(); ++iData) {
-			StgShotData* data = listAddData[iData];
-			for (size_t iAnim = 0; iAnim < data->GetFrameCount(); ++iAnim) {
-				StgShotDataFrame* pFrame = &data->listFrame_[iAnim];
-				pFrame->listShotData_ = this;
-
-				LONG* ptrSrc = reinterpret_cast<LONG*>(&pFrame->rcSrc_);
-				float* ptrDst = reinterpret_cast<float*>(&pFrame->rcDst_);
-
-				for (size_t iVert = 0; iVert < 4; ++iVert) {
-					VERTEX_TLX* pv = &verts[iVert];
-
-					//((iVert & 1) << 1)
-					//   0 -> 0
-					//   1 -> 2
-					//   2 -> 0
-					//   3 -> 2
-					//(iVert | 1)
-					//   0 -> 1
-					//   1 -> 1
-					//   2 -> 3
-					//   3 -> 3
-
-					StgShotObject::_SetVertexUV(pv,
-						ptrSrc[(iVert & 1) << 1] / texW, ptrSrc[iVert | 1] / texH);
-					StgShotObject::_SetVertexPosition(pv, ptrDst[(iVert & 1) << 1], ptrDst[iVert | 1], 0);
-					StgShotObject::_SetVertexColorARGB(pv, 0xffffffff);
-				}
-
-				pFrame->pVertexBuffer_ = pVertexBufferContainer;
-				pFrame->vertexOffset_ = iVertex;
-
-				for (size_t j = 0; j < 4; ++j)
-					bufferVertex[iVertex + j] = verts[j];
-				iVertex += 4;
+		for (size_t iFrame = 0; iFrame < thisCountFrame; ++iFrame) {
+			while (iAnim >= listAddData[iData]->GetFrameCount()) {
+				++iData;
+				iAnim = 0;
 			}
+
+			StgShotDataFrame* pFrame = &listAddData[iData]->listFrame_[iAnim++];
+			pFrame->listShotData_ = this;
+			pFrame->pVertexBuffer_ = pVertexBufferContainer;
+			pFrame->vertexOffset_ = iFrame * 4;
 		}
 
-		HRESULT hr = pVertexBufferContainer->LoadData(bufferVertex, thisCountFrame);
+		HRESULT hr = pVertexBufferContainer->LoadData(bufferVertex.data() + iFrameTotal * 4, thisCountFrame);
 		if (FAILED(hr)) {
 			std::wstring err = StringUtility::Format(L"AddShotDataList::Failed to load shot data buffer: "
 				"\t\r\n%s: %s",
@@ -337,10 +597,170 @@ void StgShotDataList::_LoadVertexBuffers(std::map<std::wstring, VBContainerList>
 			throw gstd::wexception(err);
 		}
 
-		++iBuffer;
-		countFrame -= thisCountFrame;
+		iFrameTotal += thisCountFrame;
 	}
 }
+void StgShotDataList::_WriteBinary(ByteBuffer& buf, const std::wstring& pathImage, uint8_t fileFlags,
+	std::vector<int>& listAddID, std::vector<StgShotData*>& listAddData, std::map<int, uint8_t>& mapFlags)
+{
+	std::vector<BinaryShotRecord> listRecord(listAddData.size());
+	std::vector<BinaryFrameRecord> listFrame;
+	std::vector<BinaryCollisionRecord> listCol;
+
+	for (size_t i = 0; i < listAddData.size(); ++i) {
+		StgShotData* data = listAddData[i];
+		BinaryShotRecord& record = listRecord[i];
+
+		record.id = listAddID[i];
+		record.typeRender = data->typeRender_;
+		record.typeDelayRender = data->typeDelayRender_;
+		record.alpha = data->alpha_;
+		record.idDelay = data->idDefaultDelay_;
+		record.colorDelay = data->colorDelay_;
+		record.angularVelocityMin = data->angularVelocityMin_;
+		record.angularVelocityMax = data->angularVelocityMax_;
+		record.totalFrame = data->totalFrame_;
+		record.flags = mapFlags[record.id];
+		if (data->bFixedAngle_)
+			record.flags |= FLAG_FIXED_ANGLE;
+
+		record.indexFrame = listFrame.size();
+		record.countFrame = data->listFrame_.size();
+		for (StgShotDataFrame& iFrame : data->listFrame_) {
+			BinaryFrameRecord frame;
+			frame.frame = iFrame.frame_;
+			memcpy(frame.rect, &iFrame.rcSrc_, sizeof(frame.rect));
+			listFrame.push_back(frame);
+		}
+
+		record.indexCol = listCol.size();
+		record.countCol = data->listCol_.size();
+		for (DxCircle& iCol : data->listCol_)
+			listCol.push_back({ iCol.GetR(), iCol.GetX(), iCol.GetY() });
+	}
+
+	StgDataBinaryCache::WriteString(buf, pathImage);
+	buf.WriteValue<uint8_t>(fileFlags);
+	buf.WriteValue<int32_t>(defaultDelayData_);
+	buf.WriteValue<uint32_t>(defaultDelayColor_);
+
+	buf.WriteValue<uint32_t>(listRecord.size());
+	buf.WriteValue<uint32_t>(listFrame.size());
+	buf.WriteValue<uint32_t>(listCol.size());
+	if (listRecord.size() > 0)
+		buf.Write(listRecord.data(), listRecord.size() * sizeof(BinaryShotRecord));
+	if (listFrame.size() > 0)
+		buf.Write(listFrame.data(), listFrame.size() * sizeof(BinaryFrameRecord));
+	if (listCol.size() > 0)
+		buf.Write(listCol.data(), listCol.size() * sizeof(BinaryCollisionRecord));
+}
+void StgShotDataList::_ReadBinary(StgDataBinaryReader& reader, std::wstring& pathImage, std::map<int, unique_ptr<StgShotData>>& mapData) {
+	pathImage = StgDataBinaryCache::ReadString(reader);
+	uint8_t fileFlags = reader.ReadValue<uint8_t>();
+	int32_t fileDelayData = reader.ReadValue<int32_t>();
+	uint32_t fileDelayColor = reader.ReadValue<uint32_t>();
+
+	uint32_t countRecord = reader.ReadValue<uint32_t>();
+	uint32_t countFrame = reader.ReadValue<uint32_t>();
+	uint32_t countCol = reader.ReadValue<uint32_t>();
+	reader.CheckSize((uint64_t)countRecord * sizeof(BinaryShotRecord) + (uint64_t)countFrame * sizeof(BinaryFrameRecord)
+		+ (uint64_t)countCol * sizeof(BinaryCollisionRecord));
+
+	std::vector<BinaryShotRecord> listRecord(countRecord);
+	std::vector<BinaryFrameRecord> listFrame(countFrame);
+	std::vector<BinaryCollisionRecord> listCol(countCol);
+	if (listRecord.size() > 0)
+		reader.Read(listRecord.data(), listRecord.size() * sizeof(BinaryShotRecord));
+	if (listFrame.size() > 0)
+		reader.Read(listFrame.data(), listFrame.size() * sizeof(BinaryFrameRecord));
+	if (listCol.size() > 0)
+		reader.Read(listCol.data(), listCol.size() * sizeof(BinaryCollisionRecord));
+
+	for (BinaryShotRecord& record : listRecord) {
+		if ((uint64_t)record.indexFrame + record.countFrame > listFrame.size()
+			|| (uint64_t)record.indexCol + record.countCol > listCol.size())
+			throw gstd::wexception("Corrupted compiled shot data.");
+
+		StgShotData* data = new StgShotData(this);
+		mapData[record.id] = unique_ptr<StgShotData>(data);
+
+		data->typeRender_ = (BlendMode)record.typeRender;
+		data->typeDelayRender_ = (BlendMode)record.typeDelayRender;
+		data->alpha_ = record.alpha;
+		data->idDefaultDelay_ = (record.flags & FLAG_DELAY_ID_INHERIT) ? defaultDelayData_ : record.idDelay;
+		data->colorDelay_ = (record.flags & FLAG_DELAY_COLOR_INHERIT) ? defaultDelayColor_ : record.colorDelay;
+		data->angularVelocityMin_ = record.angularVelocityMin;
+		data->angularVelocityMax_ = record.angularVelocityMax;
+		data->bFixedAngle_ = (record.flags & FLAG_FIXED_ANGLE) != 0;
+		data->totalFrame_ = record.totalFrame;
+
+		data->listFrame_.resize(record.countFrame);
+		for (size_t iFrame = 0; iFrame < record.countFrame; ++iFrame) {
+			BinaryFrameRecord& src = listFrame[record.indexFrame + iFrame];
+			StgShotDataFrame& dst = data->listFrame_[iFrame];
+			dst.frame_ = src.frame;
+			dst.rcSrc_ = DxRect<LONG>(src.rect[0], src.rect[1], src.rect[2], src.rect[3]);
+			dst.rcDst_ = StgShotDataFrame::LoadDestRect(&dst.rcSrc_);
+		}
+
+		data->listCol_.resize(record.countCol);
+		for (size_t iCol = 0; iCol < record.countCol; ++iCol) {
+			BinaryCollisionRecord& src = listCol[record.indexCol + iCol];
+			data->listCol_[iCol] = DxCircle(src.x, src.y, src.r);
+		}
+	}
+
+	//File-level defaults only apply after every shot in the file took its value
+	if (fileFlags & FLAG_FILE_DELAY_ID)
+		defaultDelayData_ = fileDelayData;
+	if (fileFlags & FLAG_FILE_DELAY_COLOR)
+		defaultDelayColor_ = fileDelayColor;
+}
+void StgShotDataList::_ScanSource(Scanner& scanner, std::map<int, unique_ptr<StgShotData>>& mapData,
+	std::map<int, uint8_t>& mapFlags, std::wstring& pathImage, uint8_t& fileFlags)
+{
+	bScanFileDelayData_ = false;
+	bScanFileDelayColor_ = false;
+
+	while (scanner.HasNext()) {
+		Token& tok = scanner.Next();
+		if (tok.GetType() == Token::Type::TK_EOF)
+			break;
+		else if (tok.GetType() == Token::Type::TK_ID) {
+			std::wstring element = tok.GetElement();
+			if (element == L"ShotData") {
+				_ScanShot(mapData, mapFlags, scanner);
+			}
+			else if (element == L"shot_image") {
+				scanner.CheckType(scanner.Next(), Token::Type::TK_EQUAL);
+				pathImage = scanner.Next().GetString();
+			}
+			else if (element == L"delay_id") {
+				scanner.CheckType(scanner.Next(), Token::Type::TK_EQUAL);
+				defaultDelayData_ = scanner.Next().GetInteger();
+				bScanFileDelayData_ = true;
+			}
+			else if (element == L"delay_color") {
+				std::vector<std::wstring> list = scanner.GetArgumentList();
+
+				if (list.size() < 3)
+					throw wexception("Invalid argument list size (expected 3)");
+
+				defaultDelayColor_ = D3DCOLOR_ARGB(255,
+					StringUtility::ToInteger(list[0]),
+					StringUtility::ToInteger(list[1]),
+					StringUtility::ToInteger(list[2]));
+				bScanFileDelayColor_ = true;
+			}
+
+			if (scanner.HasNext())
+				tok = scanner.Next();
+		}
+	}
+
+	if (bScanFileDelayData_) fileFlags |= FLAG_FILE_DELAY_ID;
+	if (bScanFileDelayColor_) fileFlags |= FLAG_FILE_DELAY_COLOR;
+}
 bool StgShotDataList::AddShotDataList(const std::wstring& path, bool bReload) {
 	auto itrVB = mapVertexBuffer_.find(path);
 	if (!bReload && itrVB != mapVertexBuffer_.end()) return true;
@@ -353,47 +773,27 @@ bool StgShotDataList::AddShotDataList(const std::wstring& path, bool bReload) {
 
 	std::string source = reader->ReadAllString();
 
+	uint64_t keyBinary = StgDataBinaryCache::ComputeKey(BINARY_HEADER, source);
+	unique_ptr<StgDataBinaryReader> readerBinary = StgDataBinaryCache::Find(BINARY_HEADER, keyBinary);
+
 	bool res = false;
 	Scanner scanner(source);
 	try {
 		std::map<int, unique_ptr<StgShotData>> mapData;
+		std::map<int, uint8_t> mapFlags;
 		std::wstring pathImage;
+		uint8_t fileFlags = 0;
 
-		while (scanner.HasNext()) {
-			Token& tok = scanner.Next();
-			if (tok.GetType() == Token::Type::TK_EOF)
-				break;
-			else if (tok.GetType() == Token::Type::TK_ID) {
-				std::wstring element = tok.GetElement();
-				if (element == L"ShotData") {
-					_ScanShot(mapData, scanner);
-				}
-				else if (element == L"shot_image") {
-					scanner.CheckType(scanner.Next(), Token::Type::TK_EQUAL);
-					pathImage = scanner.Next().GetString();
-				}
-				else if (element == L"delay_id") {
-					scanner.CheckType(scanner.Next(), Token::Type::TK_EQUAL);
-					defaultDelayData_ = scanner.Next().GetInteger();
-				}
-				else if (element == L"delay_color") {
-					std::vector<std::wstring> list = scanner.GetArgumentList();
-
-					if (list.size() < 3)
-						throw wexception("Invalid argument list size (expected 3)");
-
-					defaultDelayColor_ = D3DCOLOR_ARGB(255,
-						StringUtility::ToInteger(list[0]),
-						StringUtility::ToInteger(list[1]),
-						StringUtility::ToInteger(list[2]));
-				}
-				
-				if (scanner.HasNext())
-					tok = scanner.Next();
-			}
+		if (readerBinary) {
+			_ReadBinary(*readerBinary, pathImage, mapData);
+		}
+		else {
+			_ScanSource(scanner, mapData, mapFlags, pathImage, fileFlags);
 		}
 
 		if (pathImage.size() == 0) throw gstd::wexception("Shot texture must be set.");
+		std::wstring pathImageSource = pathImage;
+
 		std::wstring dir = PathProperty::GetFileDirectory(path);
 		pathImage = StringUtility::Replace(pathImage, L"./", dir);
 		pathImage = PathProperty::GetUnique(pathImage);
@@ -412,6 +812,7 @@ bool StgShotDataList::AddShotDataList(const std::wstring& path, bool bReload) {
 			throw gstd::wexception("Failed to load the specified shot texture.");
 		}
 
+		std::vector<int> listAddID;
 		std::vector<StgShotData*> listAddData;
 
 		size_t countFrame = 0;
@@ -426,6 +827,7 @@ bool StgShotDataList::AddShotDataList(const std::wstring& path, bool bReload) {
 					iFrame.listShotData_ = this;
 				countFrame += data->GetFrameCount();
 
+				listAddID.push_back(id);
 				listAddData.push_back(data.get());
 				if (listData_.size() <= id)
 					listData_.resize(id + 1);
@@ -433,16 +835,33 @@ bool StgShotDataList::AddShotDataList(const std::wstring& path, bool bReload) {
 			}
 		}
 
+		std::vector<VERTEX_TLX> bufferVertex(countFrame * 4);
+		{
+			float texW = texture->GetWidth();
+			float texH = texture->GetHeight();
+
+			if (readerBinary == nullptr || !StgDataBinaryCache::ReadVertices(*readerBinary, bufferVertex, texW, texH))
+				_CreateVertices(texture, listAddData, bufferVertex);
+
+			if (readerBinary == nullptr) {
+				ByteBuffer bufCompiled;
+				_WriteBinary(bufCompiled, pathImageSource, fileFlags, listAddID, listAddData, mapFlags);
+				StgDataBinaryCache::WriteVertices(bufCompiled, bufferVertex, texW, texH);
+				StgDataBinaryCache::Store(BINARY_HEADER, keyBinary, bufCompiled);
+			}
+		}
+
 		if (itrVB != mapVertexBuffer_.end()) {
 			itrVB->second.clear();
-			_LoadVertexBuffers(itrVB, texture, listAddData);
+			_LoadVertexBuffers(itrVB, texture, listAddData, bufferVertex);
 		}
 		else {
 			itrVB = mapVertexBuffer_.insert({ path, VBContainerList() }).first;
-			_LoadVertexBuffers(itrVB, texture, listAddData);
+			_LoadVertexBuffers(itrVB, texture, listAddData, bufferVertex);
 		}
 
-		Logger::WriteTop(StringUtility::Format(L"Loaded shot data: %s", pathReduce.c_str()));
+		Logger::WriteTop(StringUtility::Format(L"Loaded shot data: %s%s", pathReduce.c_str(), 
+			readerBinary ? L" (compiled)" : L""));
 		res = true;
 	}
 	catch (gstd::wexception& e) {
@@ -460,7 +879,9 @@ bool StgShotDataList::AddShotDataList(const std::wstring& path, bool bReload) {
 
 	return res;
 }
-void StgShotDataList::_ScanShot(std::map<int, unique_ptr<StgShotData>>& mapData, Scanner& scanner) {
+void StgShotDataList::_ScanShot(std::map<int, unique_ptr<StgShotData>>& mapData, std::map<int, uint8_t>& mapFlags, 
+	Scanner& scanner) 
+{
 	Token& tok = scanner.Next();
 	if (tok.GetType() == Token::Type::TK_NEWLINE) tok = scanner.Next();
 	scanner.CheckType(tok, Token::Type::TK_OPENC);
@@ -468,6 +889,8 @@ void StgShotDataList::_ScanShot(std::map<int, unique_ptr<StgShotData>>& mapData,
 	struct Data {
 		StgShotData* shotData;
 		int id = -1;
+		bool bDelayID = false;
+		bool bDelayColor = false;
 	} data;
 	data.shotData = new StgShotData(this);
 	data.shotData->idDefaultDelay_ = defaultDelayData_;
@@ -498,6 +921,7 @@ void StgShotDataList::_ScanShot(std::map<int, unique_ptr<StgShotData>>& mapData,
 	auto funcSetDelayID = [](Data* i, Scanner& s) {
 		s.CheckType(s.Next(), Token::Type::TK_EQUAL);
 		i->shotData->idDefaultDelay_ = s.Next().GetInteger();
+		i->bDelayID = true;
 	};
 	auto funcSetDelayColor = [](Data* i, Scanner& s) {
 		std::vector<std::wstring> list = s.GetArgumentList();
@@ -509,6 +933,7 @@ void StgShotDataList::_ScanShot(std::map<int, unique_ptr<StgShotData>>& mapData,
 			StringUtility::ToInteger(list[0]),
 			StringUtility::ToInteger(list[1]),
 			StringUtility::ToInteger(list[2]));
+		i->bDelayColor = true;
 	};
 
 	static const std::unordered_map<std::wstring, BlendMode> mapBlendType = {
@@ -607,8 +1032,16 @@ void StgShotDataList::_ScanShot(std::map<int, unique_ptr<StgShotData>>& mapData,
 			data.shotData->listCol_.push_back(DxCircle(0, 0, r));
 		}
 
+		uint8_t flags = 0;
+		if (!data.bDelayID && !bScanFileDelayData_)
+			flags |= FLAG_DELAY_ID_INHERIT;
+		if (!data.bDelayColor && !bScanFileDelayColor_)
+			flags |= FLAG_DELAY_COLOR_INHERIT;
+		mapFlags[data.id] = flags;
+
 		mapData[data.id] = unique_ptr<StgShotData>(data.shotData);
 	}
+	else delete data.shotData;
 }
 void StgShotDataList::_ScanAnimation(StgShotData* shotData, Scanner& scanner) {
 	Token& tok = scanner.Next();
@@ -714,8 +1147,8 @@ StgShotVertexBufferContainer::~StgShotVertexBufferContainer() {
 	vbManager->ReleaseExtraVertexBuffer((size_t)pVertexBuffer_);
 }
 
-HRESULT StgShotVertexBufferContainer::LoadData(const std::vector<VERTEX_TLX>& data, size_t countFrame) {
-	pVertexBuffer_->Setup(data.size(), StgShotVertexBufferContainer::STRIDE, VERTEX_TLX::fvf);
+HRESULT StgShotVertexBufferContainer::LoadData(const VERTEX_TLX* data, size_t countFrame) {
+	pVertexBuffer_->Setup(countFrame * 4, StgShotVertexBufferContainer::STRIDE, VERTEX_TLX::fvf);
 
 	HRESULT hr = pVertexBuffer_->Create(0, D3DPOOL_MANAGED);
 	if (FAILED(hr)) {
@@ -723,7 +1156,9 @@ HRESULT StgShotVertexBufferContainer::LoadData(const std::vector<VERTEX_TLX>& da
 	}
 
 	BufferLockParameter lockParam = BufferLockParameter(D3DLOCK_DISCARD);
-	lockParam.SetSource(const_cast<std::vector<VERTEX_TLX>&>(data), pVertexBuffer_->GetSize(), sizeof(VERTEX_TLX));
+	lockParam.data = const_cast<VERTEX_TLX*>(data);
+	lockParam.dataCount = countFrame * 4;
+	lockParam.dataStride = sizeof(VERTEX_TLX);
 
 	hr = pVertexBuffer_->UpdateBuffer(&lockParam);
 	countData_ = countFrame;
@@ -777,8 +1212,11 @@ StgShotObject::StgShotObject(StgStageController* stageController) : StgMoveObjec
 	timerTransform_ = 0;
 	timerTransformNext_ = 0;
 
-	int priShotI = stageController_->GetStageInformation()->GetShotObjectPriority();
-	SetRenderPriorityI(priShotI);
+	//Shots made without a stage (the self tests) keep the default priority
+	if (stageController_) {
+		int priShotI = stageController_->GetStageInformation()->GetShotObjectPriority();
+		SetRenderPriorityI(priShotI);
+	}
 }
 StgShotObject::~StgShotObject() {
 }
@@ -850,6 +1288,42 @@ void StgShotObject::_Move() {
 	DxScriptRenderObject::SetX(posX_);
 	DxScriptRenderObject::SetY(posY_);
 }
+//Runs a copy of the current pattern, so reserved patterns and the motion of the parent are not accounted for
+void StgShotObject::PredictMotion(StgMoveObject* probe, uint32_t frame, Math::DVec2& pos, Math::DVec2& speed) {
+	pos = { posX_, posY_ };
+	speed = { 0, 0 };
+	if (!bEnableMovement_ || pattern_ == nullptr) return;
+
+	//The shot holds its position while delayed, see _Move
+	//	A parented shot doesn't, its parent moves it whether it is delayed or not
+	auto parent = parent_.Lock();
+	uint32_t frameHold = (parent == nullptr && delay_.time > 0 && !bEnableMotionDelay_) ? delay_.time : 0;
+
+	//Patterns move the relative position, the probe has no parent so it works in the same space
+	probe->SetPositionXY(relativePosX_, relativePosY_);
+	ref_unsync_ptr<StgMovePattern> pattern = nullptr;
+	pattern = pattern_->CreateCopy(probe);		//Takes ownership of raw ptr
+	pattern->CopyFrom(pattern_.get());
+
+	for (uint32_t i = frameHold; i < frame; ++i)
+		pattern->Move();
+	Math::DVec2 posRelative = { probe->GetPositionX(), probe->GetPositionY() };
+	Math::DVec2 speedRelative = { 0, 0 };
+	if (frame >= frameHold) {
+		pattern->Move();
+		speedRelative = { probe->GetPositionX() - posRelative[0], probe->GetPositionY() - posRelative[1] };
+	}
+
+	if (parent) {
+		Math::DVec2 offset = parent->TransformChildVector(posRelative);
+		pos = { parent->GetPositionX() + offset[0], parent->GetPositionY() + offset[1] };
+		speed = parent->TransformChildVector(speedRelative);
+	}
+	else {
+		pos = posRelative;
+		speed = speedRelative;
+	}
+}
 void StgShotObject::_DeleteInLife() {
 	if (IsDeleted() || life_ > 0) return;
 
@@ -2404,6 +2878,9 @@ StgCurveLaserObject::StgCurveLaserObject(StgStageController* stageController) :
 
 	bCap_ = false;
 	posOrigin_ = D3DXVECTOR2(0, 0);
+
+	indexNodeHead_ = 0;
+	countNode_ = 0;
 }
 
 void StgCurveLaserObject::Clone(DxScriptObjectBase* _src) {
@@ -2411,7 +2888,11 @@ void StgCurveLaserObject::Clone(DxScriptObjectBase* _src) {
 
 	auto src = (StgCurveLaserObject*)_src;
 
-	listPosition_ = src->listPosition_;
+	listNode_ = src->listNode_;
+	indexNodeHead_ = src->indexNodeHead_;
+	countNode_ = src->countNode_;
+	for (LaserNode& iNode : listNode_)
+		iNode.parent = this;
 	vertexData_ = src->vertexData_;
 	listRectIncrement_ = src->listRectIncrement_;
 
@@ -2450,10 +2931,10 @@ void StgCurveLaserObject::_Move() {
 	{
 		double angleZ = lastAngle_;
 
-		if (listPosition_.empty())
+		if (countNode_ == 0)
 			angleZ = GetDirectionAngle();
 		else {
-			LaserNode& node = listPosition_.front();
+			LaserNode& node = _GetNodeAt(0);
 			if (node.pos[0] != posX_ || node.pos[1] != posY_) {
 				angleZ = atan2(posY_ - node.pos[1], posX_ - node.pos[0]);
 			}
@@ -2484,28 +2965,69 @@ StgCurveLaserObject::LaserNode StgCurveLaserObject::CreateNode(const D3DXVECTOR2
 	node.color = col;
 	return node;
 }
-bool StgCurveLaserObject::GetNode(size_t indexNode, std::list<LaserNode>::iterator& res) {
-	//Search from whichever end is closer to the target node index
-	size_t listSizeMax = listPosition_.size();
-	if (indexNode >= listSizeMax) res = listPosition_.end();
-	if (indexNode < listSizeMax / 2U)
-		res = std::next(listPosition_.begin(), indexNode);
-	else
-		res = std::next(listPosition_.rbegin(), listSizeMax - indexNode).base();
-	return res != listPosition_.end();
+StgCurveLaserObject::LaserNode* StgCurveLaserObject::GetNode(size_t indexNode) {
+	if (indexNode >= countNode_) return nullptr;
+	return &_GetNodeAt(indexNode);
 }
 void StgCurveLaserObject::GetNodePointerList(std::vector<LaserNode*>* listRes) {
-	listRes->resize(listPosition_.size(), nullptr);
-	size_t i = 0;
-	for (LaserNode& iNode : listPosition_) {
-		(*listRes)[i++] = &iNode;
-	}
-}
-std::list<StgCurveLaserObject::LaserNode>::iterator StgCurveLaserObject::PushNode(const LaserNode& node) {
-	listPosition_.push_front(node);
-	while (listPosition_.size() > length_)
-		listPosition_.pop_back();
-	return listPosition_.begin();
+	listRes->resize(countNode_, nullptr);
+	for (size_t i = 0; i < countNode_; ++i)
+		(*listRes)[i] = &_GetNodeAt(i);
+}
+StgCurveLaserObject::LaserNode* StgCurveLaserObject::PushNode(const LaserNode& node) {
+	if (length_ <= 0) {
+		countNode_ = 0;
+		return nullptr;
+	}
+
+	size_t countMax = length_;
+	if (listNode_.size() < countMax)
+		_ReserveNode(countMax);
+
+	//Step the head back one slot; when the ring is full this overwrites the oldest node
+	size_t capacity = listNode_.size();
+	indexNodeHead_ = (indexNodeHead_ == 0 ? capacity : indexNodeHead_) - 1;
+	listNode_[indexNodeHead_] = node;
+	countNode_ = std::min(countNode_ + 1, countMax);
+
+	return &listNode_[indexNodeHead_];
+}
+StgCurveLaserObject::LaserNode* StgCurveLaserObject::GetNodeFromPointer(int64_t ptr) {
+	//Only compared as an address, the pointer may be into storage that was since freed
+	uintptr_t addr = (uintptr_t)ptr;
+	uintptr_t base = (uintptr_t)listNode_.data();
+	if (addr < base || addr >= base + listNode_.size() * sizeof(LaserNode)) return nullptr;
+	if ((addr - base) % sizeof(LaserNode) != 0) return nullptr;
+
+	size_t slot = (addr - base) / sizeof(LaserNode);
+	size_t index = slot >= indexNodeHead_ ? slot - indexNodeHead_ : slot + listNode_.size() - indexNodeHead_;
+	if (index >= countNode_) return nullptr;
+	return &listNode_[slot];
+}
+void StgCurveLaserObject::_ReserveNode(size_t capacity) {
+	if (capacity <= listNode_.size()) return;
+
+	std::vector<LaserNode> listNew(capacity);
+	for (size_t i = 0; i < countNode_; ++i)
+		listNew[i] = _GetNodeAt(i);
+
+	listNode_.swap(listNew);
+	indexNodeHead_ = 0;
+}
+void StgCurveLaserObject::_LinearizeNodePosition() {
+	listNodePos_.resize(countNode_);
+	if (countNode_ == 0) return;
+
+	//The ring holds at most two contiguous spans: [head, capacity) and [0, rest)
+	size_t countFirst = std::min(countNode_, listNode_.size() - indexNodeHead_);
+	const LaserNode* pFirst = listNode_.data() + indexNodeHead_;
+	const LaserNode* pSecond = listNode_.data();
+	D3DXVECTOR2* pDst = listNodePos_.data();
+	for (size_t i = 0; i < countFirst; ++i)
+		pDst[i] = pFirst[i].pos;
+	pDst += countFirst;
+	for (size_t i = 0, countSecond = countNode_ - countFirst; i < countSecond; ++i)
+		pDst[i] = pSecond[i].pos;
 }
 
 void StgCurveLaserObject::_DeleteInAutoClip() {
@@ -2519,14 +3041,12 @@ void StgCurveLaserObject::_DeleteInAutoClip() {
 		rcStgFrame->GetHeight() + rcClipBase->bottom);
 
 	//Checks if the node is within the bounding rect
-	auto PredicateNodeInRect = [&](LaserNode& node) {
-		return rcDeleteClip.IsPointIntersected((float*)&node.pos);
-	};
-	std::list<LaserNode>::iterator itrFind = std::find_if(listPosition_.begin(), listPosition_.end(),
-		PredicateNodeInRect);
+	bool bInRect = false;
+	for (size_t i = 0; i < countNode_ && !bInRect; ++i)
+		bInRect = rcDeleteClip.IsPointIntersected((float*)&_GetNodeAt(i).pos);
 
 	//Can't find any node within the bounding rect
-	if (itrFind == listPosition_.end()) {
+	if (!bInRect) {
 		auto objectManager = stageController_->GetMainObjectManager();
 		objectManager->DeleteObject(this);
 	}
@@ -2537,12 +3057,15 @@ bool StgCurveLaserObject::GetIntersectionTargetList_NoVector(StgShotData* shotDa
 
 	StgIntersectionManager* intersectionManager = stageController_->GetIntersectionManager();
 
-	size_t countPos = listPosition_.size();
+	size_t countPos = countNode_;
 	size_t countIntersection = countPos > 0U ? countPos - 1U : 0U;
 
 	if (countIntersection == 0)
 		return false;
 
+	//Segment i runs from linearized node i to node i + 1
+	_LinearizeNodePosition();
+
 	if (listIntersectionTarget_.size() < countIntersection)
 		listIntersectionTarget_.resize(countIntersection, CreateEmptyIntersection());
 	for (auto& i : listIntersectionTarget_) i.first = false;
@@ -2553,8 +3076,7 @@ bool StgCurveLaserObject::GetIntersectionTargetList_NoVector(StgShotData* shotDa
 	int posInvalidE = (int)(countPos * iLengthE);
 	float iWidth = widthIntersection_ * hitboxScale_.x;
 
-	std::list<LaserNode>::iterator itr = listPosition_.begin();
-	for (size_t iPos = 0; iPos < countIntersection; ++iPos, ++itr) {
+	for (size_t iPos = 0; iPos < countIntersection; ++iPos) {
 		IntersectionPairType* pPair = &listIntersectionTarget_[iPos];
 
 		if ((int)iPos < posInvalidS || (int)iPos > posInvalidE) {
@@ -2569,12 +3091,11 @@ bool StgCurveLaserObject::GetIntersectionTargetList_NoVector(StgShotData* shotDa
 		}
 		pPair->first = true;
 
-		std::list<LaserNode>::iterator itrNext = std::next(itr);
-		D3DXVECTOR2* nodeS = &itr->pos;
-		D3DXVECTOR2* nodeE = &itrNext->pos;
+		const D3DXVECTOR2& posA = listNodePos_[iPos];
+		const D3DXVECTOR2& posB = listNodePos_[iPos + 1];
 
 		DxWidthLine* pDstLine = &pTarget->GetLine();
-		*pDstLine = DxWidthLine(nodeS->x, nodeS->y, nodeE->x, nodeE->y, iWidth);
+		*pDstLine = DxWidthLine(posA.x, posA.y, posB.x, posB.y, iWidth);
 
 		pTarget->SetTargetType(typeOwner_ == OWNER_PLAYER ?
 			StgIntersectionTarget::TYPE_PLAYER_SHOT : StgIntersectionTarget::TYPE_ENEMY_SHOT);
@@ -2633,14 +3154,14 @@ void StgCurveLaserObject::Render(BlendMode targetBlend) {
 	}
 
 	//Render laser
-	if (listPosition_.size() > 1U) {
+	if (countNode_ > 1U) {
 		BlendMode objBlendType = GetBlendType();
 		objBlendType = objBlendType == MODE_BLEND_NONE ? MODE_BLEND_ADD_ARGB : objBlendType;
 
 		if (objBlendType == targetBlend) {
 			StgShotDataFrame* shotFrame = shotData->GetFrame(frameWork_);
 
-			size_t countPos = listPosition_.size();
+			size_t countPos = countNode_;
 			size_t countRect = countPos - 1U;
 			size_t halfPos = countRect / 2U;
 
@@ -2677,13 +3198,12 @@ void StgCurveLaserObject::Render(BlendMode targetBlend) {
 					size_t iPos = 0;
 					float remLen = rcMidPt;
 
-					auto tryCap = [&](auto itr) -> bool {
+					auto tryCap = [&](size_t iNode, size_t iNodeNext) -> bool {
 						if (i > halfPos) // Auto-fails if cap crosses the half-way point
 							return false;
 
-						auto itrNext = std::next(itr);
-						D3DXVECTOR2* pos = &itr->pos;
-						D3DXVECTOR2* posNext = &itrNext->pos;
+						D3DXVECTOR2* pos = &listNodePos_[iNode];
+						D3DXVECTOR2* posNext = &listNodePos_[iNodeNext];
 						// D3DXVECTOR2* off = &itr->vertOff[0];
 						// float wid = std::max(hypotf(off->x, off->y) * 2, 1.0f);
 						float incDist = hypotf(posNext->x - pos->x, posNext->y - pos->y) * incDistFactor;
@@ -2697,20 +3217,17 @@ void StgCurveLaserObject::Render(BlendMode targetBlend) {
 						return true;
 					};
 
-					auto itrHead = listPosition_.begin();
-					auto itrTail = listPosition_.rbegin();
-					auto itrHeadEnd = listPosition_.rend();
-					auto itrTailEnd = listPosition_.end();
+					_LinearizeNodePosition();
 
 					bCappable = true;
-					for (auto itr = itrHead; bCappable && remLen > 0 && itr != itrTailEnd; ++itr, ++i, ++iPos)
-						bCappable = tryCap(itr);
+					for (size_t iNode = 0; bCappable && remLen > 0 && iNode + 1 < countPos; ++iNode, ++i, ++iPos)
+						bCappable = tryCap(iNode, iNode + 1);
 
 					i = 0;
 					iPos = countPos - 2; // Ends straight up do not work otherwise?
 					remLen = rcMidPt;
-					for (auto itr = itrTail; bCappable && remLen > 0 && itr != itrHeadEnd; ++itr, ++i, --iPos)
-						bCappable = tryCap(itr);
+					for (size_t iNode = countPos - 1; bCappable && remLen > 0 && iNode > 0; --iNode, ++i, --iPos)
+						bCappable = tryCap(iNode, iNode - 1);
 				}
 				if (!bCappable) // If capping fails (or is disabled), just use the regular increment
 					std::fill(listRectIncrement_.begin(), listRectIncrement_.end(), rcInc);
@@ -2721,8 +3238,9 @@ void StgCurveLaserObject::Render(BlendMode targetBlend) {
 			float inv_halfPos = 1.0f / halfPos, inv_halfPosDec = 1.0f / (halfPos - 1);
 			float halfWidthRender = widthRender_ / 2.0f;
 
-			size_t iPos = 0U;
-			for (auto itr = listPosition_.begin(); itr != listPosition_.end(); ++itr, ++iPos) {
+			for (size_t iPos = 0U; iPos < countPos; ++iPos) {
+				const LaserNode* pNode = &_GetNodeAt(iPos);
+
 				float nodeAlpha = baseAlpha;
 				if (iPos > halfPos)
 					nodeAlpha = Math::Lerp::Linear(baseAlpha, tipAlpha, (iPos - halfPos + 1) * inv_halfPos);
@@ -2730,21 +3248,21 @@ void StgCurveLaserObject::Render(BlendMode targetBlend) {
 					nodeAlpha = Math::Lerp::Linear(tipAlpha, baseAlpha, iPos * inv_halfPosDec);
 				nodeAlpha = std::max(0.0f, nodeAlpha);
 
-				float renderWd = std::max(halfWidthRender * itr->widthMul, 1.0f) * scale_.x;
+				float renderWd = std::max(halfWidthRender * pNode->widthMul, 1.0f) * scale_.x;
 
 				D3DCOLOR thisColor = 0xffffffff;
 				{
 					byte alpha = ColorAccess::ClampColorRet(nodeAlpha * alphaRateShot);
 					thisColor = (thisColor & 0x00ffffff) | (alpha << 24);
 				}
-				if (itr->color != 0xffffffff) ColorAccess::MultiplyColor(thisColor, itr->color);
+				if (pNode->color != 0xffffffff) ColorAccess::MultiplyColor(thisColor, pNode->color);
 
 				for (size_t iVert = 0U; iVert < 2U; ++iVert) {
 					VERTEX_TLX* pv = &vertexData_[iPos * 2 + iVert];
 
 					_SetVertexUV(pv, ptrSrc[(iVert & 1) << 1] * texSizeInv.x, rectV);
-					_SetVertexPosition(pv, itr->pos.x + itr->vertOff[iVert].x * renderWd,
-						itr->pos.y + itr->vertOff[iVert].y * renderWd, position_.z);
+					_SetVertexPosition(pv, pNode->pos.x + pNode->vertOff[iVert].x * renderWd,
+						pNode->pos.y + pNode->vertOff[iVert].y * renderWd, position_.z);
 					_SetVertexColorARGB(pv, thisColor);
 				}
 
@@ -2866,13 +3384,12 @@ void StgCurveLaserObject::_SendDeleteEvent(TypeDelete type) {
 			++countToItem;
 		};
 
-		float lengthAcc = 0.0;
-		for (std::list<LaserNode>::iterator itr = listPosition_.begin(); itr != listPosition_.end(); itr++) {
-			std::list<LaserNode>::iterator itrNext = std::next(itr);
-			if (itrNext == listPosition_.end()) break;
+		_LinearizeNodePosition();
 
-			D3DXVECTOR2* pos = &itr->pos;
-			D3DXVECTOR2* posNext = &itrNext->pos;
+		float lengthAcc = 0.0;
+		for (size_t iNode = 0; iNode + 1 < countNode_; ++iNode) {
+			D3DXVECTOR2* pos = &listNodePos_[iNode];
+			D3DXVECTOR2* posNext = &listNodePos_[iNode + 1];
 			float nodeDist = hypotf(posNext->x - pos->x, posNext->y - pos->y);
 			lengthAcc += nodeDist;
 
@@ -5,6 +5,7 @@
 #include "StgCommon.hpp"
 #include "StgIntersection.hpp"
 
+class StgDataBinaryCache;
 class StgShotDataList;
 class StgShotData;
 struct StgShotDataFrame;
@@ -42,6 +43,9 @@ public:
 		SHOT_MAX = 10000,
 
 		BLEND_COUNT = 8,
+
+		//Limit of the frame argument of GetShotMotionInCircle, 10 seconds at 60 fps
+		MOTION_FRAME_MAX = 600,
 	};
 protected:
 	static std::array<BlendMode, BLEND_COUNT> blendTypeRenderOrder;
@@ -56,6 +60,7 @@ protected:
 	unique_ptr<StgShotDataList> listEnemyShotData_;
 
 	std::list<ref_unsync_ptr<StgShotObject>> listObj_;
+	StgSpatialGrid spatialGrid_;
 	std::vector<RenderQueue> listRenderQueuePlayer_;		//one for each render pri
 	std::vector<RenderQueue> listRenderQueueEnemy_;			//one for each render pri
 
@@ -68,6 +73,9 @@ protected:
 
 	ID3DXEffect* effectShot_;
 	D3DXMATRIX matProj_;
+
+	//Candidates for the integer circle tests of the script functions, in listObj_ order
+	std::vector<StgMoveObject*> _QueryCircle(int cx, int cy, int r);
 public:
 	IDirect3DTexture9* pLastTexture_;
 public:
@@ -101,6 +109,11 @@ public:
 
 	void DeleteInCircle(int typeDelete, int typeTo, int typeOwner, int cx, int cy, int* radius);
 	std::vector<int> GetShotIdInCircle(int typeOwner, int cx, int cy, int* radius);
+	std::vector<int> GetShotIdInRect(int typeOwner, double left, double top, double right, double bottom);
+	std::vector<int> GetShotIdNearest(int typeOwner, double x, double y, size_t count);
+	void GetShotMotionInCircle(int typeOwner, double cx, double cy, double radius, uint32_t frame,
+		std::vector<double>& res);
+	static uint32_t ClampMotionFrame(int frame) { return std::clamp<int>(frame, 0, MOTION_FRAME_MAX); }
 	size_t GetShotCount(int typeOwner);
 	size_t GetShotCountAll() { return listObj_.size(); }
 
@@ -108,12 +121,104 @@ public:
 	bool IsDeleteEventEnable(TypeDelete bit) { return listDeleteEventEnable_[(int)bit]; }
 };
 
+//*******************************************************************
+//StgDataBinaryReader
+//*******************************************************************
+//Reads compiled data in place, the buffer is shared with the cache and never written to
+//	Reading past the end throws, so a truncated or corrupted entry fails the load instead of reading garbage
+class StgDataBinaryReader : public gstd::Reader {
+	shared_ptr<gstd::ByteBuffer> data_;
+	size_t offset_;
+public:
+	StgDataBinaryReader(shared_ptr<gstd::ByteBuffer> data) : data_(data), offset_(0) {}
+
+	virtual DWORD Read(LPVOID buf, DWORD size);
+
+	size_t GetRemaining() { return data_->GetSize() - offset_; }
+	//Throws if fewer than size bytes are left, counts from the data are checked before anything is allocated for them
+	void CheckSize(uint64_t size);
+};
+
+//*******************************************************************
+//StgDataBinaryCache
+//*******************************************************************
+//Compiled forms of shot/item definition files, validated against the hash of their source text
+class StgDataBinaryCache {
+public:
+	enum : uint32_t {
+		VERSION = 1,
+		HEADER_SIZE = 8,
+
+		MEMORY_ENTRY_MAX = 32,
+	};
+protected:
+	static gstd::CriticalSection lock_;
+
+	//Loaded entries, least recently used first, kept under MEMORY_ENTRY_MAX by dropping from the front
+	using DataList = std::list<std::pair<uint64_t, shared_ptr<gstd::ByteBuffer>>>;
+	static DataList listData_;
+	static std::unordered_map<uint64_t, DataList::iterator> mapData_;
+	static std::set<uint64_t> setWriting_;
+
+	static std::wstring _GetPath(uint64_t key);
+	static void _AddData(uint64_t key, shared_ptr<gstd::ByteBuffer> data);
+	static shared_ptr<gstd::ByteBuffer> _LoadFromDisk(const char* header, uint64_t key);
+	static bool _SaveToDisk(const char* header, uint64_t key, gstd::ByteBuffer* data);
+public:
+	static uint64_t ComputeKey(const char* header, const std::string& source);
+
+	//Returns a reader at the start of the compiled data, or nullptr if none is cached
+	static unique_ptr<StgDataBinaryReader> Find(const char* header, uint64_t key);
+	static void Store(const char* header, uint64_t key, gstd::ByteBuffer& data);
+
+	static void WriteString(gstd::ByteBuffer& buf, const std::wstring& str);
+	static std::wstring ReadString(StgDataBinaryReader& reader);
+	static void WriteVertices(gstd::ByteBuffer& buf, const std::vector<VERTEX_TLX>& list, float texW, float texH);
+	static bool ReadVertices(StgDataBinaryReader& reader, std::vector<VERTEX_TLX>& list, float texW, float texH);
+};
+
 //*******************************************************************
 //StgShotDataList
 //*******************************************************************
 class StgShotDataList {
 public:
 	using VBContainerList = std::list<unique_ptr<StgShotVertexBufferContainer>>;
+
+	static constexpr const char* BINARY_HEADER = "DNHSHOTB";
+protected:
+	enum : uint8_t {
+		FLAG_DELAY_ID_INHERIT = 0x1,		//Takes the list's delay_id at load time
+		FLAG_DELAY_COLOR_INHERIT = 0x2,		//Takes the list's delay_color at load time
+		FLAG_FIXED_ANGLE = 0x4,
+
+		FLAG_FILE_DELAY_ID = 0x1,
+		FLAG_FILE_DELAY_COLOR = 0x2,
+	};
+	struct BinaryShotRecord {
+		int32_t id;
+		int32_t typeRender;
+		int32_t typeDelayRender;
+		int32_t alpha;
+		int32_t idDelay;
+		uint32_t colorDelay;
+		double angularVelocityMin;
+		double angularVelocityMax;
+		uint32_t totalFrame;
+		uint32_t indexFrame;
+		uint32_t countFrame;
+		uint32_t indexCol;
+		uint32_t countCol;
+		uint8_t flags;
+	};
+	struct BinaryFrameRecord {
+		uint32_t frame;
+		LONG rect[4];
+	};
+	struct BinaryCollisionRecord {
+		float r;
+		float x;
+		float y;
+	};
 protected:
 	std::map<std::wstring, VBContainerList> mapVertexBuffer_;	//<shot data file, vb list>
 	std::vector<unique_ptr<StgShotData>> listData_;
@@ -121,11 +226,23 @@ protected:
 	int defaultDelayData_;
 	D3DCOLOR defaultDelayColor_;
 
-	void _ScanShot(std::map<int, unique_ptr<StgShotData>>& mapData, Scanner& scanner);
+	bool bScanFileDelayData_;
+	bool bScanFileDelayColor_;
+
+	//Reads the text form, the file-level entries and every ShotData
+	void _ScanSource(Scanner& scanner, std::map<int, unique_ptr<StgShotData>>& mapData,
+		std::map<int, uint8_t>& mapFlags, std::wstring& pathImage, uint8_t& fileFlags);
+	void _ScanShot(std::map<int, unique_ptr<StgShotData>>& mapData, std::map<int, uint8_t>& mapFlags, Scanner& scanner);
 	static void _ScanAnimation(StgShotData* shotData, Scanner& scanner);
 
+	void _WriteBinary(gstd::ByteBuffer& buf, const std::wstring& pathImage, uint8_t fileFlags,
+		std::vector<int>& listAddID, std::vector<StgShotData*>& listAddData, std::map<int, uint8_t>& mapFlags);
+	void _ReadBinary(StgDataBinaryReader& reader, std::wstring& pathImage, std::map<int, unique_ptr<StgShotData>>& mapData);
+
+	void _CreateVertices(shared_ptr<Texture> texture, std::vector<StgShotData*>& listAddData, 
+		std::vector<VERTEX_TLX>& bufferVertex);
 	void _LoadVertexBuffers(std::map<std::wstring, VBContainerList>::iterator placement, 
-		shared_ptr<Texture> texture, std::vector<StgShotData*>& listAddData);
+		shared_ptr<Texture> texture, std::vector<StgShotData*>& listAddData, const std::vector<VERTEX_TLX>& bufferVertex);
 public:
 	StgShotDataList();
 	virtual ~StgShotDataList();
@@ -223,7 +340,7 @@ public:
 	StgShotVertexBufferContainer();
 	~StgShotVertexBufferContainer();
 
-	HRESULT LoadData(const std::vector<VERTEX_TLX>& data, size_t countFrame);
+	HRESULT LoadData(const VERTEX_TLX* data, size_t countFrame);
 
 	FixedVertexBuffer* GetBufferObject() { return pVertexBuffer_; }
 	IDirect3DVertexBuffer9* GetD3DBuffer() { return pVertexBuffer_ ? pVertexBuffer_->GetBuffer() : nullptr; }
@@ -441,6 +558,10 @@ public:
 	void SetEnableDelayMotion(bool b) { bEnableMotionDelay_ = b; }
 	void SetDelayAngularVelocity(float av) { delay_.angle.y = av; }
 
+	//Extrapolates the shot frame frames ahead, moving probe in its place.
+	//	A parented shot is moved relative to its parent, which is held at its current position and rotation.
+	void PredictMotion(StgMoveObject* probe, uint32_t frame, Math::DVec2& pos, Math::DVec2& speed);
+
 	double GetLife() { return life_; }
 	void SetLife(double life) { life_ = life; }
 	double GetDamage() { return damage_; }
@@ -671,7 +792,16 @@ public:
 		MAP_CAPPED
 	};
 protected:
-	std::list<LaserNode> listPosition_;
+	//Ring buffer of nodes, index 0 (head) is the newest node.
+	//A node pointer held by a script addresses a slot, not a node:
+	//	- Once the ring is full, the slot of the node at the end is reused by the next node pushed.
+	//	- When the laser length grows, the storage reallocates and every earlier pointer becomes invalid.
+	//	Pointers from scripts are resolved with GetNodeFromPointer, which rejects them once invalid.
+	std::vector<LaserNode> listNode_;
+	size_t indexNodeHead_;
+	size_t countNode_;
+
+	std::vector<D3DXVECTOR2> listNodePos_;
 	std::vector<VERTEX_TLX> vertexData_;
 	std::vector<float> listRectIncrement_;
 
@@ -683,6 +813,14 @@ protected:
 
 	D3DXVECTOR2 posOrigin_;
 
+	void _ReserveNode(size_t capacity);
+	LaserNode& _GetNodeAt(size_t index) {
+		size_t slot = indexNodeHead_ + index;
+		if (slot >= listNode_.size()) slot -= listNode_.size();
+		return listNode_[slot];
+	}
+	void _LinearizeNodePosition();
+
 	virtual void _DeleteInAutoClip();
 	virtual void _Move();
 	virtual void _SendDeleteEvent(TypeDelete type);
@@ -700,9 +838,12 @@ public:
 	void SetTipCapping(bool enable) { bCap_ = enable; }
 
 	LaserNode CreateNode(const D3DXVECTOR2& pos, const D3DXVECTOR2& rFac, float widthMul, D3DCOLOR col = 0xffffffff);
-	bool GetNode(size_t indexNode, std::list<LaserNode>::iterator& res);
+	size_t GetNodeCount() { return countNode_; }
+	LaserNode* GetNode(size_t indexNode);
 	void GetNodePointerList(std::vector<LaserNode*>* listRes);
-	std::list<LaserNode>::iterator PushNode(const LaserNode& node);
+	LaserNode* PushNode(const LaserNode& node);
+	//Returns nullptr unless ptr addresses a slot of this laser that holds a node
+	LaserNode* GetNodeFromPointer(int64_t ptr);
 };
 
 
@@ -302,6 +302,7 @@ static const std::vector<function> stgStageFunction = {
 	{ "GetAllEnemyID", StgStageScript::Func_GetAllEnemyID, 0 },
 	{ "GetIntersectionRegistedEnemyID", StgStageScript::Func_GetIntersectionRegistedEnemyID, 0 },
 	{ "GetAllEnemyIntersectionPosition", StgStageScript::Func_GetAllEnemyIntersectionPosition, 0 },
+	{ "GetAllEnemyIntersectionPositionPacked", StgStageScript::Func_GetAllEnemyIntersectionPositionPacked, 0 },
 	{ "GetEnemyIntersectionPosition", StgStageScript::Func_GetEnemyIntersectionPosition, 3 },
 	{ "GetEnemyIntersectionPositionByIdA1", StgStageScript::Func_GetEnemyIntersectionPositionByIdA1, 1 },
 	{ "GetEnemyIntersectionPositionByIdA2", StgStageScript::Func_GetEnemyIntersectionPositionByIdA2, 3 },
@@ -330,6 +331,9 @@ static const std::vector<function> stgStageFunction = {
 	{ "GetAllShotID", StgStageScript::Func_GetAllShotID, 1 },
 	{ "GetShotIdInCircleA1", StgStageScript::Func_GetShotIdInCircleA1, 3 },
 	{ "GetShotIdInCircleA2", StgStageScript::Func_GetShotIdInCircleA2, 4 },
+	{ "GetShotIdInRect", StgStageScript::Func_GetShotIdInRect, 5 },
+	{ "GetShotIdNearest", StgStageScript::Func_GetShotIdNearest, 4 },
+	{ "GetShotMotionInCircle", StgStageScript::Func_GetShotMotionInCircle, 5 },
 	{ "GetShotCount", StgStageScript::Func_GetShotCount, 1 },
 	{ "SetShotAutoDeleteClip", StgStageScript::Func_SetShotAutoDeleteClip, 4 },
 	{ "GetShotDataInfoA1", StgStageScript::Func_GetShotDataInfoA1, 3 },
@@ -790,6 +794,10 @@ StgStageScript::StgStageScript(StgStageController* stageController) : StgControl
 	SetObjectManager(scriptManager->GetObjectManager());
 }
 StgStageScript::~StgStageScript() {}
+void StgStageScript::AppendScriptTables(std::vector<function>* listFunc, std::vector<constant>* listConst) {
+	listFunc->insert(listFunc->end(), stgStageFunction.cbegin(), stgStageFunction.cend());
+	listConst->insert(listConst->end(), stgStageConstant.cbegin(), stgStageConstant.cend());
+}
 std::shared_ptr<StgStageScriptObjectManager> StgStageScript::GetStgObjectManager() {
 	StgStageScriptManager* scriptManager = (StgStageScriptManager*)scriptManager_;
 	return scriptManager->GetObjectManager();
@@ -1315,10 +1323,9 @@ gstd::value StgStageScript::Func_GetIntersectionRegistedEnemyID(gstd::script_mac
 	StgIntersectionManager* intersectionManager = stageController->GetIntersectionManager();
 
 	std::vector<int> listID;
-	std::vector<StgIntersectionTargetPoint>* listPoint = intersectionManager->GetAllEnemyTargetPoint();
-	for (auto itr = listPoint->begin(); itr != listPoint->end(); ++itr) {
-		if (auto ptrObj = itr->GetObjectRef())
-			listID.push_back(ptrObj->GetObjectID());
+	for (const StgIntersectionTargetPoint& point : intersectionManager->GetAllEnemyTargetPoint()) {
+		if (script->GetObjectPointerAs<StgEnemyObject>(point.idObject))
+			listID.push_back(point.idObject);
 	}
 
 	return script->CreateIntArrayValue(listID);
@@ -1329,19 +1336,33 @@ gstd::value StgStageScript::Func_GetAllEnemyIntersectionPosition(gstd::script_ma
 	StgIntersectionManager* interSectionManager = stageController->GetIntersectionManager();
 
 	std::vector<gstd::value> listV;
-	std::vector<StgIntersectionTargetPoint>* listPoint = interSectionManager->GetAllEnemyTargetPoint();
-	for (auto itr = listPoint->begin(); itr != listPoint->end(); ++itr) {
-		if (auto ptrObj = itr->GetObjectRef()) {
-			if (!ptrObj->GetEnableGetIntersectionPosition()) continue;
+	for (const StgIntersectionTargetPoint& point : interSectionManager->GetAllEnemyTargetPoint()) {
+		StgEnemyObject* ptrObj = script->GetObjectPointerAs<StgEnemyObject>(point.idObject);
+		if (ptrObj == nullptr || !ptrObj->GetEnableGetIntersectionPosition()) continue;
 
-			POINT& pos = itr->GetPoint();
-			LONG listPos[2] = { pos.x, pos.y };
-			gstd::value v = script->CreateFloatArrayValue(listPos, 2U);
-			listV.push_back(v);
-		}
+		LONG listPos[2] = { point.x, point.y };
+		gstd::value v = script->CreateFloatArrayValue(listPos, 2U);
+		listV.push_back(v);
 	}
 	return script->CreateValueArrayValue(listV);
 }
+gstd::value StgStageScript::Func_GetAllEnemyIntersectionPositionPacked(gstd::script_machine* machine, int argc, const gstd::value* argv) {
+	StgStageScript* script = (StgStageScript*)machine->data;
+	StgStageController* stageController = script->stageController_;
+	StgIntersectionManager* interSectionManager = stageController->GetIntersectionManager();
+
+	//Packed as [id, x, y] per intersection, in a single real array
+	const std::vector<StgIntersectionTargetPoint>& listPoint = interSectionManager->GetAllEnemyTargetPoint();
+	std::vector<double> listPos;
+	listPos.reserve(listPoint.size() * 3U);
+	for (const StgIntersectionTargetPoint& point : listPoint) {
+		StgEnemyObject* ptrObj = script->GetObjectPointerAs<StgEnemyObject>(point.idObject);
+		if (ptrObj == nullptr || !ptrObj->GetEnableGetIntersectionPosition()) continue;
+
+		listPos.insert(listPos.end(), { (double)point.idObject, (double)point.x, (double)point.y });
+	}
+	return script->CreateFloatArrayValue(listPos);
+}
 gstd::value StgStageScript::Func_GetEnemyIntersectionPosition(gstd::script_machine* machine, int argc, const gstd::value* argv) {
 	StgStageScript* script = (StgStageScript*)machine->data;
 	StgStageController* stageController = script->stageController_;
@@ -1354,18 +1375,15 @@ gstd::value StgStageScript::Func_GetEnemyIntersectionPosition(gstd::script_machi
 	std::map<int64_t, POINT> mapPos;
 	std::vector<gstd::value> listV;
 
-	std::vector<StgIntersectionTargetPoint>* listPoint = intersectionManager->GetAllEnemyTargetPoint();
-	for (auto itr = listPoint->begin(); itr != listPoint->end(); ++itr) {
-		if (auto ptrObj = itr->GetObjectRef()) {
-			if (!ptrObj->GetEnableGetIntersectionPosition()) continue;
+	for (const StgIntersectionTargetPoint& point : intersectionManager->GetAllEnemyTargetPoint()) {
+		StgEnemyObject* ptrObj = script->GetObjectPointerAs<StgEnemyObject>(point.idObject);
+		if (ptrObj == nullptr || !ptrObj->GetEnableGetIntersectionPosition()) continue;
 
-			POINT& pos = itr->GetPoint();
-			LONG dx = pos.x - cenX;
-			LONG dy = pos.y - cenY;
+		LONG dx = point.x - cenX;
+		LONG dy = point.y - cenY;
 
-			int64_t dist = dx * dx + dy * dy;
-			mapPos[dist] = pos;
-		}
+		int64_t dist = dx * dx + dy * dy;
+		mapPos[dist] = { point.x, point.y };
 	}
 
 	for (auto itr = mapPos.begin(); (itr != mapPos.end()) && (countRes > 0); ++itr) {
@@ -1396,19 +1414,14 @@ gstd::value StgStageScript::Func_GetEnemyIntersectionPositionByIdA1(gstd::script
 		StgStageController* stageController = script->stageController_;
 		StgIntersectionManager* interSectionManager = stageController->GetIntersectionManager();
 
-		std::vector<StgIntersectionTargetPoint>* listPoint = interSectionManager->GetAllEnemyTargetPoint();
-		for (auto itr = listPoint->begin(); itr != listPoint->end(); ++itr) {
-			if (auto ptrObj = itr->GetObjectRef()) {
-				if (!ptrObj->GetEnableGetIntersectionPosition()) continue;
-				if (ptrObj->GetObjectID() != id) continue;
+		for (const StgIntersectionTargetPoint& point : interSectionManager->GetAllEnemyTargetPoint()) {
+			if (point.idObject != id || !obj->GetEnableGetIntersectionPosition()) continue;
 
-				POINT& pos = itr->GetPoint();
-				LONG dx = pos.x - enemyX;
-				LONG dy = pos.y - enemyY;
+			LONG dx = point.x - enemyX;
+			LONG dy = point.y - enemyY;
 
-				int64_t dist = dx * dx + dy * dy;
-				mapPos[dist] = pos;
-			}
+			int64_t dist = dx * dx + dy * dy;
+			mapPos[dist] = { point.x, point.y };
 		}
 
 		for (auto itr = mapPos.begin(); itr != mapPos.end(); ++itr) {
@@ -1439,19 +1452,14 @@ gstd::value StgStageScript::Func_GetEnemyIntersectionPositionByIdA2(gstd::script
 		StgStageController* stageController = script->stageController_;
 		StgIntersectionManager* interSectionManager = stageController->GetIntersectionManager();
 
-		std::vector<StgIntersectionTargetPoint>* listPoint = interSectionManager->GetAllEnemyTargetPoint();
-		for (auto itr = listPoint->begin(); itr != listPoint->end(); ++itr) {
-			if (auto ptrObj = itr->GetObjectRef()) {
-				if (!ptrObj->GetEnableGetIntersectionPosition()) continue;
-				if (ptrObj->GetObjectID() != id) continue;
+		for (const StgIntersectionTargetPoint& point : interSectionManager->GetAllEnemyTargetPoint()) {
+			if (point.idObject != id || !obj->GetEnableGetIntersectionPosition()) continue;
 
-				POINT& pos = itr->GetPoint();
-				LONG dx = pos.x - tX;
-				LONG dy = pos.y - tY;
+			LONG dx = point.x - tX;
+			LONG dy = point.y - tY;
 
-				int64_t dist = dx * dx + dy * dy;
-				mapPos[dist] = pos;
-			}
+			int64_t dist = dx * dx + dy * dy;
+			mapPos[dist] = { point.x, point.y };
 		}
 
 		for (auto itr = mapPos.begin(); itr != mapPos.end(); ++itr) {
@@ -2112,6 +2120,72 @@ gstd::value StgStageScript::Func_GetShotIdInCircleA2(gstd::script_machine* machi
 	std::vector<int> listID = shotManager->GetShotIdInCircle(typeOwner, px, py, &radius);
 	return script->CreateIntArrayValue(listID);
 }
+gstd::value StgStageScript::Func_GetShotIdInRect(gstd::script_machine* machine, int argc, const gstd::value* argv) {
+	StgStageScript* script = (StgStageScript*)machine->data;
+	StgStageController* stageController = script->stageController_;
+
+	StgShotManager* shotManager = stageController->GetShotManager();
+	double left = argv[0].as_float();
+	double top = argv[1].as_float();
+	double right = argv[2].as_float();
+	double bottom = argv[3].as_float();
+	int target = argv[4].as_int();
+
+	int typeOwner = StgShotObject::OWNER_NULL;
+	switch (target) {
+	case TARGET_ALL:typeOwner = StgShotObject::OWNER_NULL; break;
+	case TARGET_PLAYER:typeOwner = StgShotObject::OWNER_PLAYER; break;
+	case TARGET_ENEMY:typeOwner = StgShotObject::OWNER_ENEMY; break;
+	}
+
+	std::vector<int> listID = shotManager->GetShotIdInRect(typeOwner, left, top, right, bottom);
+	return script->CreateIntArrayValue(listID);
+}
+gstd::value StgStageScript::Func_GetShotIdNearest(gstd::script_machine* machine, int argc, const gstd::value* argv) {
+	StgStageScript* script = (StgStageScript*)machine->data;
+	StgStageController* stageController = script->stageController_;
+
+	StgShotManager* shotManager = stageController->GetShotManager();
+	double px = argv[0].as_float();
+	double py = argv[1].as_float();
+	int count = argv[2].as_int();
+	int target = argv[3].as_int();
+
+	int typeOwner = StgShotObject::OWNER_NULL;
+	switch (target) {
+	case TARGET_ALL:typeOwner = StgShotObject::OWNER_NULL; break;
+	case TARGET_PLAYER:typeOwner = StgShotObject::OWNER_PLAYER; break;
+	case TARGET_ENEMY:typeOwner = StgShotObject::OWNER_ENEMY; break;
+	}
+
+	std::vector<int> listID;
+	if (count > 0)
+		listID = shotManager->GetShotIdNearest(typeOwner, px, py, count);
+	return script->CreateIntArrayValue(listID);
+}
+gstd::value StgStageScript::Func_GetShotMotionInCircle(gstd::script_machine* machine, int argc, const gstd::value* argv) {
+	StgStageScript* script = (StgStageScript*)machine->data;
+	StgStageController* stageController = script->stageController_;
+
+	StgShotManager* shotManager = stageController->GetShotManager();
+	double px = argv[0].as_float();
+	double py = argv[1].as_float();
+	double radius = argv[2].as_float();
+	int frame = argv[3].as_int();
+	int target = argv[4].as_int();
+
+	int typeOwner = StgShotObject::OWNER_NULL;
+	switch (target) {
+	case TARGET_ALL:typeOwner = StgShotObject::OWNER_NULL; break;
+	case TARGET_PLAYER:typeOwner = StgShotObject::OWNER_PLAYER; break;
+	case TARGET_ENEMY:typeOwner = StgShotObject::OWNER_ENEMY; break;
+	}
+
+	//Packed as [id, x, y, speedX, speedY] per shot
+	std::vector<double> listMotion;
+	shotManager->GetShotMotionInCircle(typeOwner, px, py, radius, StgShotManager::ClampMotionFrame(frame), listMotion);
+	return script->CreateFloatArrayValue(listMotion);
+}
 gstd::value StgStageScript::Func_GetShotCount(gstd::script_machine* machine, int argc, const gstd::value* argv) {
 	StgStageScript* script = (StgStageScript*)machine->data;
 	StgStageController* stageController = script->stageController_;
@@ -5060,11 +5134,8 @@ gstd::value StgStageScript::Func_ObjCrLaser_GetNodePointer(gstd::script_machine*
 	StgCurveLaserObject* obj = script->GetObjectPointerAs<StgCurveLaserObject>(id);
 	if (obj) {
 		int index = argv[1].as_int();
-		if (index >= 0) {
-			std::list<StgCurveLaserObject::LaserNode>::iterator itr;
-			bool bValidIndex = obj->GetNode(index, itr);
-			res = bValidIndex ? &*itr : nullptr;
-		}
+		if (index >= 0)
+			res = obj->GetNode(index);
 	}
 
 	return script->CreateIntValue((int64_t)res);
@@ -5089,8 +5160,8 @@ gstd::value StgStageScript::Func_ObjCrLaser_GetNodePosition(gstd::script_machine
 	int id = argv[0].as_int();
 	StgCurveLaserObject* obj = script->GetObjectPointerAs<StgCurveLaserObject>(id);
 	if (obj) {
-		StgCurveLaserObject::LaserNode* ptr = (StgCurveLaserObject::LaserNode*)argv[1].as_int();
-		if (ptr && ptr->parent == obj) {
+		StgCurveLaserObject::LaserNode* ptr = obj->GetNodeFromPointer(argv[1].as_int());
+		if (ptr) {
 			res[0] = ptr->pos.x;
 			res[1] = ptr->pos.y;
 		}
@@ -5104,8 +5175,8 @@ gstd::value StgStageScript::Func_ObjCrLaser_GetNodeAngle(gstd::script_machine* m
 	int id = argv[0].as_int();
 	StgCurveLaserObject* obj = script->GetObjectPointerAs<StgCurveLaserObject>(id);
 	if (obj) {
-		StgCurveLaserObject::LaserNode* ptr = (StgCurveLaserObject::LaserNode*)argv[1].as_int();
-		if (ptr && ptr->parent == obj) {
+		StgCurveLaserObject::LaserNode* ptr = obj->GetNodeFromPointer(argv[1].as_int());
+		if (ptr) {
 			D3DXVECTOR2& vec = ptr->vertOff[0];
 			angle = Math::RadianToDegree(atan2(vec.y, vec.x)) + 90.0;
 		}
@@ -5119,8 +5190,8 @@ gstd::value StgStageScript::Func_ObjCrLaser_GetNodeWidthScale(gstd::script_machi
 	int id = argv[0].as_int();
 	StgCurveLaserObject* obj = script->GetObjectPointerAs<StgCurveLaserObject>(id);
 	if (obj) {
-		StgCurveLaserObject::LaserNode* ptr = (StgCurveLaserObject::LaserNode*)argv[1].as_int();
-		if (ptr && ptr->parent == obj) {
+		StgCurveLaserObject::LaserNode* ptr = obj->GetNodeFromPointer(argv[1].as_int());
+		if (ptr) {
 			width = ptr->widthMul;
 		}
 	}
@@ -5133,8 +5204,8 @@ gstd::value StgStageScript::Func_ObjCrLaser_GetNodeColor(gstd::script_machine* m
 	int id = argv[0].as_int();
 	StgCurveLaserObject* obj = script->GetObjectPointerAs<StgCurveLaserObject>(id);
 	if (obj) {
-		StgCurveLaserObject::LaserNode* ptr = (StgCurveLaserObject::LaserNode*)argv[1].as_int();
-		if (ptr && ptr->parent == obj) {
+		StgCurveLaserObject::LaserNode* ptr = obj->GetNodeFromPointer(argv[1].as_int());
+		if (ptr) {
 			color = ptr->color;
 		}
 	}
@@ -5150,8 +5221,8 @@ gstd::value StgStageScript::Func_ObjCrLaser_GetNodeColorHex(gstd::script_machine
 	int id = argv[0].as_int();
 	StgCurveLaserObject* obj = script->GetObjectPointerAs<StgCurveLaserObject>(id);
 	if (obj) {
-		StgCurveLaserObject::LaserNode* ptr = (StgCurveLaserObject::LaserNode*)argv[1].as_int();
-		if (ptr && ptr->parent == obj) {
+		StgCurveLaserObject::LaserNode* ptr = obj->GetNodeFromPointer(argv[1].as_int());
+		if (ptr) {
 			color = ptr->color;
 		}
 	}
@@ -5163,8 +5234,8 @@ gstd::value StgStageScript::Func_ObjCrLaser_SetNode(gstd::script_machine* machin
 	int id = argv[0].as_int();
 	StgCurveLaserObject* obj = script->GetObjectPointerAs<StgCurveLaserObject>(id);
 	if (obj) {
-		StgCurveLaserObject::LaserNode* ptr = (StgCurveLaserObject::LaserNode*)argv[1].as_int();
-		if (ptr && ptr->parent == obj) {
+		StgCurveLaserObject::LaserNode* ptr = obj->GetNodeFromPointer(argv[1].as_int());
+		if (ptr) {
 			float x = argv[2].as_float();
 			float y = argv[3].as_float();
 			float angle = Math::DegreeToRadian(argv[4].as_float());
@@ -5185,8 +5256,8 @@ gstd::value StgStageScript::Func_ObjCrLaser_SetNodePosition(gstd::script_machine
 	int id = argv[0].as_int();
 	StgCurveLaserObject* obj = script->GetObjectPointerAs<StgCurveLaserObject>(id);
 	if (obj) {
-		StgCurveLaserObject::LaserNode* ptr = (StgCurveLaserObject::LaserNode*)argv[1].as_int();
-		if (ptr && ptr->parent == obj) {
+		StgCurveLaserObject::LaserNode* ptr = obj->GetNodeFromPointer(argv[1].as_int());
+		if (ptr) {
 			float x = argv[2].as_float();
 			float y = argv[3].as_float();
 			ptr->pos = D3DXVECTOR2(x, y);
@@ -5199,8 +5270,8 @@ gstd::value StgStageScript::Func_ObjCrLaser_SetNodeAngle(gstd::script_machine* m
 	int id = argv[0].as_int();
 	StgCurveLaserObject* obj = script->GetObjectPointerAs<StgCurveLaserObject>(id);
 	if (obj) {
-		StgCurveLaserObject::LaserNode* ptr = (StgCurveLaserObject::LaserNode*)argv[1].as_int();
-		if (ptr && ptr->parent == obj) {
+		StgCurveLaserObject::LaserNode* ptr = obj->GetNodeFromPointer(argv[1].as_int());
+		if (ptr) {
 			float angle = Math::DegreeToRadian(argv[2].as_float());
 			D3DXVECTOR2 rMove = D3DXVECTOR2(-sinf(angle), cosf(angle));
 
@@ -5215,8 +5286,8 @@ gstd::value StgStageScript::Func_ObjCrLaser_SetNodeWidthScale(gstd::script_machi
 	int id = argv[0].as_int();
 	StgCurveLaserObject* obj = script->GetObjectPointerAs<StgCurveLaserObject>(id);
 	if (obj) {
-		StgCurveLaserObject::LaserNode* ptr = (StgCurveLaserObject::LaserNode*)argv[1].as_int();
-		if (ptr && ptr->parent == obj) {
+		StgCurveLaserObject::LaserNode* ptr = obj->GetNodeFromPointer(argv[1].as_int());
+		if (ptr) {
 			float width = argv[2].as_float();
 			ptr->widthMul = width;
 		}
@@ -5228,8 +5299,8 @@ gstd::value StgStageScript::Func_ObjCrLaser_SetNodeColor(gstd::script_machine* m
 	int id = argv[0].as_int();
 	StgCurveLaserObject* obj = script->GetObjectPointerAs<StgCurveLaserObject>(id);
 	if (obj) {
-		StgCurveLaserObject::LaserNode* ptr = (StgCurveLaserObject::LaserNode*)argv[1].as_int();
-		if (ptr && ptr->parent == obj) {
+		StgCurveLaserObject::LaserNode* ptr = obj->GetNodeFromPointer(argv[1].as_int());
+		if (ptr) {
 			D3DCOLOR color = argv[2].as_int();
 			ptr->color = color;
 		}
@@ -5838,6 +5909,9 @@ StgStageSystemScript::StgStageSystemScript(StgStageController* stageController)
 	_AddConstant(&stgSystemConstant);
 }
 StgStageSystemScript::~StgStageSystemScript() {}
+void StgStageSystemScript::AppendScriptTables(std::vector<function>* listFunc, std::vector<constant>* listConst) {
+	listConst->insert(listConst->end(), stgSystemConstant.cbegin(), stgSystemConstant.cend());
+}
 
 //*******************************************************************
 //StgStageItemScript
@@ -5859,6 +5933,9 @@ StgStageItemScript::StgStageItemScript(StgStageController* stageController) : St
 	_AddConstant(&stgItemConstant);
 }
 StgStageItemScript::~StgStageItemScript() {}
+void StgStageItemScript::AppendScriptTables(std::vector<function>* listFunc, std::vector<constant>* listConst) {
+	listConst->insert(listConst->end(), stgItemConstant.cbegin(), stgItemConstant.cend());
+}
 
 //*******************************************************************
 //StgPlayerScript
@@ -5896,6 +5973,10 @@ StgStagePlayerScript::StgStagePlayerScript(StgStageController* stageController)
 	_AddConstant(&stgPlayerConstant);
 }
 StgStagePlayerScript::~StgStagePlayerScript() {}
+void StgStagePlayerScript::AppendScriptTables(std::vector<function>* listFunc, std::vector<constant>* listConst) {
+	listFunc->insert(listFunc->end(), stgPlayerFunction.cbegin(), stgPlayerFunction.cend());
+	listConst->insert(listConst->end(), stgPlayerConstant.cbegin(), stgPlayerConstant.cend());
+}
 
 //自機専用関数
 gstd::value StgStagePlayerScript::Func_CreatePlayerShotA1(gstd::script_machine* machine, int argc, const gstd::value* argv) {
@@ -167,6 +167,8 @@ public:
 	StgStageScript(StgStageController* stageController);
 	virtual ~StgStageScript();
 
+	static void AppendScriptTables(std::vector<gstd::function>* listFunc, std::vector<gstd::constant>* listConst);
+
 	StgStageController* GetStageController() { return stageController_; }
 	std::shared_ptr<StgStageScriptObjectManager> GetStgObjectManager();
 
@@ -251,6 +253,7 @@ public:
 	static gstd::value Func_GetAllEnemyID(gstd::script_machine* machine, int argc, const gstd::value* argv);
 	static gstd::value Func_GetIntersectionRegistedEnemyID(gstd::script_machine* machine, int argc, const gstd::value* argv);
 	static gstd::value Func_GetAllEnemyIntersectionPosition(gstd::script_machine* machine, int argc, const gstd::value* argv);
+	static gstd::value Func_GetAllEnemyIntersectionPositionPacked(gstd::script_machine* machine, int argc, const gstd::value* argv);
 	static gstd::value Func_GetEnemyIntersectionPosition(gstd::script_machine* machine, int argc, const gstd::value* argv);
 	static gstd::value Func_GetEnemyIntersectionPositionByIdA1(gstd::script_machine* machine, int argc, const gstd::value* argv);
 	static gstd::value Func_GetEnemyIntersectionPositionByIdA2(gstd::script_machine* machine, int argc, const gstd::value* argv);
@@ -278,6 +281,9 @@ public:
 	DNH_FUNCAPI_DECL_(Func_GetAllShotID);
 	static gstd::value Func_GetShotIdInCircleA1(gstd::script_machine* machine, int argc, const gstd::value* argv);
 	static gstd::value Func_GetShotIdInCircleA2(gstd::script_machine* machine, int argc, const gstd::value* argv);
+	static gstd::value Func_GetShotIdInRect(gstd::script_machine* machine, int argc, const gstd::value* argv);
+	static gstd::value Func_GetShotIdNearest(gstd::script_machine* machine, int argc, const gstd::value* argv);
+	static gstd::value Func_GetShotMotionInCircle(gstd::script_machine* machine, int argc, const gstd::value* argv);
 	static gstd::value Func_GetShotCount(gstd::script_machine* machine, int argc, const gstd::value* argv);
 	static gstd::value Func_SetShotAutoDeleteClip(gstd::script_machine* machine, int argc, const gstd::value* argv);
 	static gstd::value Func_GetShotDataInfoA1(gstd::script_machine* machine, int argc, const gstd::value* argv);
@@ -537,6 +543,8 @@ public:
 	StgStageSystemScript(StgStageController* stageController);
 	virtual ~StgStageSystemScript();
 
+	static void AppendScriptTables(std::vector<gstd::function>* listFunc, std::vector<gstd::constant>* listConst);
+
 	//システム専用関数：システム操作
 
 };
@@ -555,6 +563,8 @@ public:
 	StgStageItemScript(StgStageController* stageController);
 	virtual ~StgStageItemScript();
 
+	static void AppendScriptTables(std::vector<gstd::function>* listFunc, std::vector<gstd::constant>* listConst);
+
 	//システム専用関数：アイテム操作
 
 };
@@ -574,6 +584,8 @@ public:
 	StgStagePlayerScript(StgStageController* stageController);
 	virtual ~StgStagePlayerScript();
 
+	static void AppendScriptTables(std::vector<gstd::function>* listFunc, std::vector<gstd::constant>* listConst);
+
 	//自機専用関数
 	static gstd::value Func_CreatePlayerShotA1(gstd::script_machine* machine, int argc, const gstd::value* argv);
 	static gstd::value Func_CallSpell(gstd::script_machine* machine, int argc, const gstd::value* argv);
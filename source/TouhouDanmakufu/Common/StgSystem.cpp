@@ -421,20 +421,19 @@ void StgSystemController::RenderScriptObject(int priMin, int priMax) {
 					stageController_->GetShotManager()->Render(iPri);
 				}
 				if (pRenderListStage != nullptr && iPri < pRenderListStage->size()) {
-					for (auto itr = renderList.begin(); itr != renderList.end(); ++itr) {
-						if (DxScriptRenderObject* obj = dynamic_cast<DxScriptRenderObject*>(itr->get())) {
+					for (DxScriptObjectBase* objBase : renderList) {
+						if (DxScriptRenderObject* obj = dynamic_cast<DxScriptRenderObject*>(objBase)) {
 							if (!bClearZBufferFor2DCoordinate)
 								bClearZBufferFor2DCoordinate = CheckMeshAndClearZBuffer(obj);
-							obj->Render();
+							objManagerStage->RenderObjectBatched(obj);
 						}
 					}
+					objManagerStage->FlushRenderBatch();
 					//renderList.clear();
 				}
 
 				if (effect) effect->EndPass();
 			}
-			renderList.Clear();
-
 			if (effect) effect->End();
 
 			//Intersection visualizer
@@ -463,20 +462,19 @@ void StgSystemController::RenderScriptObject(int priMin, int priMax) {
 				if (effect) effect->BeginPass(iPass);
 
 				if (pRenderListPackage != nullptr && iPri < pRenderListPackage->size()) {
-					for (auto itr = renderList.begin(); itr != renderList.end(); ++itr) {
-						if (DxScriptRenderObject* obj = dynamic_cast<DxScriptRenderObject*>(itr->get())) {
+					for (DxScriptObjectBase* objBase : renderList) {
+						if (DxScriptRenderObject* obj = dynamic_cast<DxScriptRenderObject*>(objBase)) {
 							if (!bClearZBufferFor2DCoordinate)
 								bClearZBufferFor2DCoordinate = CheckMeshAndClearZBuffer(obj);
-							obj->Render();
+							objManagerPackage->RenderObjectBatched(obj);
 						}
 					}
+					objManagerPackage->FlushRenderBatch();
 					//renderList.clear();
 				}
 
 				if (effect) effect->EndPass();
 			}
-			renderList.Clear();
-
 			if (effect) effect->End();
 		}
 
@@ -504,13 +502,6 @@ void StgSystemController::RenderScriptObject(int priMin, int priMax) {
 	camera2D->SetAngleZ(focusAngleZ);
 
 	camera3D->PopMatrixState();		//Just in case
-
-	//--------------------------------
-
-	if (objManagerStage)
-		objManagerStage->ClearRenderObject();
-	if (objManagerPackage)
-		objManagerPackage->ClearRenderObject();
 }
 bool StgSystemController::CheckMeshAndClearZBuffer(DxScriptRenderObject* obj) {
 	if (obj == nullptr) return false;
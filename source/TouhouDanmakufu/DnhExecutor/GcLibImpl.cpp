@@ -24,6 +24,9 @@ bool EApplication::_Initialize() {
 	EFileManager* fileManager = EFileManager::CreateInstance();
 	fileManager->Initialize();
 
+	ScriptInformationIndex* scriptIndex = ScriptInformationIndex::CreateInstance();
+	scriptIndex->Load();
+
 	EFpsController* fpsController = EFpsController::CreateInstance();
 	fpsController->SetFastModeRate((size_t)config->fastModeSpeed_ * 60U);
 	
@@ -43,6 +46,9 @@ bool EApplication::_Initialize() {
 	if (!config->bMouseVisible_)
 		WindowUtility::SetMouseVisible(false);
 
+	gstd::script_engine::option_optimize = config->bScriptOptimize_;
+	gstd::script_engine::option_keep_unoptimized = config->bScriptDumpBytecode_;
+
 	EDirectGraphics* graphics = EDirectGraphics::CreateInstance();
 	graphics->Initialize(appName);
 	ptrGraphics = graphics;
@@ -102,6 +108,9 @@ bool EApplication::_Initialize() {
 
 		shared_ptr<ScriptInfoPanel> panelScript(new ScriptInfoPanel());
 		logger->EAddPanel(panelScript, L"Script", 250);
+
+		shared_ptr<gstd::ScriptProfilerInfoPanel> panelProfiler(new gstd::ScriptProfilerInfoPanel());
+		logger->EAddPanel(panelProfiler, L"Profiler", 1000);
 	}
 
 	logger->LoadState();
@@ -182,6 +191,15 @@ bool EApplication::_Loop() {
 
 				logger->SetInfo(2, L"Font cache",
 					StringUtility::Format(L"%d", EDxTextRenderer::GetInstance()->GetCacheCount()));
+
+				{
+					size_t countHit = ScriptIncludeCache::GetHitCount();
+					size_t countTotal = countHit + ScriptIncludeCache::GetMissCount();
+					logger->SetInfo(3, L"Include cache",
+						StringUtility::Format(L"Files: %u, Hits: %u/%u (%.1f%%)",
+							ScriptIncludeCache::GetCacheCount(), countHit, countTotal,
+							countTotal > 0 ? countHit * 100.0 / countTotal : 0.0));
+				}
 			}
 
 			if (count % 120 == 0) {
@@ -372,6 +390,11 @@ bool EApplication::_Finalize() {
 
 	SystemController::DeleteInstance();
 	ETaskManager::DeleteInstance();
+
+	if (ScriptInformationIndex* scriptIndex = ScriptInformationIndex::GetInstance())
+		scriptIndex->Save();
+	ScriptInformationIndex::DeleteInstance();
+
 	EFileManager::GetInstance()->EndLoadThread();
 	EDirectInput::DeleteInstance();
 	EDirectSoundManager::DeleteInstance();
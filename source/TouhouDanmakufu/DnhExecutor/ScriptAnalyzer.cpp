@@ -0,0 +1,165 @@
+#include "source/GcLib/pch.h"
+
+#include "ScriptAnalyzer.hpp"
+
+#include "../Common/DnhConfiguration.hpp"
+#include "../Common/StgStageScript.hpp"
+#include "../Common/StgPackageScript.hpp"
+
+//*******************************************************************
+//ScriptAnalyzer
+//*******************************************************************
+ScriptAnalyzer::ScriptAnalyzer(Type type) {
+	//Same tables, in the same order, as the constructors of the real script classes
+	DxScript::AppendScriptTables(&func_, &const_);
+	{
+		DnhConfiguration* config = DnhConfiguration::GetInstance();
+		const std::vector<constant> screenConstant = {
+			constant("SCREEN_WIDTH", (int64_t)config->screenWidth_),
+			constant("SCREEN_HEIGHT", (int64_t)config->screenHeight_),
+		};
+		_AddConstant(&screenConstant);
+	}
+	ManagedScript::AppendScriptTables(&func_, &const_);
+	DnhScript::AppendScriptTables(&func_, &const_);
+	StgControlScript::AppendScriptTables(&func_, &const_);
+
+	if (type == Type::Package) {
+		StgPackageScript::AppendScriptTables(&func_, &const_);
+		definedMacro_[L"SCRIPT_PACKAGE"] = L"";
+	}
+	else {
+		StgStageScript::AppendScriptTables(&func_, &const_);
+		definedMacro_[L"SCRIPT_STAGE"] = L"";
+
+		switch (type) {
+		case Type::Player:
+			StgStagePlayerScript::AppendScriptTables(&func_, &const_);
+			break;
+		case Type::Item:
+			StgStageItemScript::AppendScriptTables(&func_, &const_);
+			break;
+		case Type::System:
+			StgStageSystemScript::AppendScriptTables(&func_, &const_);
+			break;
+		}
+	}
+}
+ScriptAnalyzer::~ScriptAnalyzer() {}
+
+std::string ScriptAnalyzer::Analyze(const std::wstring& path) {
+	SetSourceFromFile(path);
+	Compile();
+
+	script_engine* engine = engine_->GetEngine().get();
+
+	std::string res = "//Analysis\n";
+	res += engine->analyze();
+	if (engine->listing_unoptimized.size() > 0) {
+		res += "\n//Disassembly (unoptimized)\n";
+		res += engine->listing_unoptimized;
+	}
+	res += "\n//Disassembly\n";
+	res += engine->disassemble();
+	return res;
+}
+
+bool ScriptAnalyzer::IsRequested() {
+	int argc = 0;
+	LPWSTR* argv = CommandLineToArgvW(GetCommandLineW(), &argc);
+	if (argv == nullptr) return false;
+
+	bool res = false;
+	for (int i = 1; i < argc; ++i) {
+		if (wcscmp(argv[i], L"-analyze") == 0) {
+			res = true;
+			break;
+		}
+	}
+	LocalFree(argv);
+	return res;
+}
+
+/* Usage:
+ *		th_dnh.exe -analyze <path> [-type stage|player|item|system|package] [-out <path>] [-noopt]
+ * The report is written to the -out path, or to temp/bytecode/<file>.analysis.txt,
+ *		and also to the console th_dnh was started from.
+ * Returns 0 on success, 1 on a compilation error, 2 on invalid arguments.
+ */
+int ScriptAnalyzer::RunFromCommandLine() {
+	HANDLE hOutput = nullptr;
+	if (AttachConsole(ATTACH_PARENT_PROCESS))
+		hOutput = GetStdHandle(STD_OUTPUT_HANDLE);
+	auto _Print = [&](const std::string& text) {
+		if (hOutput == nullptr || hOutput == INVALID_HANDLE_VALUE) return;
+		DWORD written = 0;
+		WriteFile(hOutput, text.data(), text.size(), &written, nullptr);
+	};
+
+	std::wstring pathScript;
+	std::wstring pathOutput;
+	Type type = Type::Stage;
+	bool bOptimize = DnhConfiguration::GetInstance()->bScriptOptimize_;
+	{
+		int argc = 0;
+		LPWSTR* argv = CommandLineToArgvW(GetCommandLineW(), &argc);
+		for (int i = 1; i < argc; ++i) {
+			std::wstring arg = argv[i];
+			bool bHasNext = i + 1 < argc;
+			if (arg == L"-analyze" && bHasNext)
+				pathScript = argv[++i];
+			else if (arg == L"-out" && bHasNext)
+				pathOutput = argv[++i];
+			else if (arg == L"-noopt")
+				bOptimize = false;
+			else if (arg == L"-type" && bHasNext) {
+				std::wstring strType = argv[++i];
+				if (strType == L"player") type = Type::Player;
+				else if (strType == L"item") type = Type::Item;
+				else if (strType == L"system") type = Type::System;
+				else if (strType == L"package") type = Type::Package;
+				else type = Type::Stage;
+			}
+		}
+		LocalFree(argv);
+	}
+	if (pathScript.size() == 0) {
+		_Print("Usage: th_dnh.exe -analyze <path> [-type stage|player|item|system|package] [-out <path>] [-noopt]\n");
+		return 2;
+	}
+
+	pathScript = PathProperty::GetUnique(pathScript);
+	if (pathOutput.size() == 0) {
+		pathOutput = PathProperty::GetModuleDirectory() + L"temp/bytecode/"
+			+ PathProperty::GetFileName(pathScript) + L".analysis.txt";
+	}
+
+	EFileManager* fileManager = EFileManager::CreateInstance();
+	fileManager->Initialize();
+
+	script_engine::option_optimize = bOptimize;
+	script_engine::option_keep_unoptimized = bOptimize;
+
+	int res = 0;
+	try {
+		ScriptAnalyzer analyzer(type);
+		std::string report = analyzer.Analyze(pathScript);
+
+		File file(pathOutput);
+		File::CreateFileDirectory(pathOutput);
+		if (file.Open(File::WRITEONLY))
+			file.Write(report.data(), report.size());
+
+		_Print(report);
+		_Print("Report written to " + StringUtility::ConvertWideToMulti(pathOutput) + "\n");
+	}
+	catch (gstd::wexception& e) {
+		_Print(StringUtility::ConvertWideToMulti(e.what()) + "\n");
+		res = 1;
+	}
+
+	fileManager->EndLoadThread();
+	EFileManager::DeleteInstance();
+
+	return res;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "../../GcLib/pch.h"
+
+#include "GcLibImpl.hpp"
+
+//*******************************************************************
+//ScriptAnalyzer
+//	Compiles a script against the function tables of a script type without running it,
+//	then reports its bytecode. Used by "th_dnh.exe -analyze <path>", no window is created.
+//*******************************************************************
+class ScriptAnalyzer : public ScriptClientBase {
+public:
+	enum class Type {
+		Stage,
+		Player,
+		Item,
+		System,
+		Package,
+	};
+public:
+	ScriptAnalyzer(Type type);
+	virtual ~ScriptAnalyzer();
+
+	//Throws gstd::wexception on compilation failure
+	std::string Analyze(const std::wstring& path);
+
+	static bool IsRequested();
+	static int RunFromCommandLine();
+};
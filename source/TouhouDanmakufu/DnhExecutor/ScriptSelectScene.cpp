@@ -479,23 +479,22 @@ ScriptSelectFileModel::~ScriptSelectFileModel() {
 void ScriptSelectFileModel::_Run() {
 	timeLastUpdate_ = SystemUtility::GetCpuTime2() - 1000;
 
-	_SearchScript(dir_);
+	std::vector<std::wstring> listPath;
+	_SearchScript(dir_, listPath);
+	_CreateMenuItem(listPath);
+
+	if (ScriptInformationIndex* index = ScriptInformationIndex::GetInstance())
+		index->Save();
 
 	bCreated_ = true;
 }
-void ScriptSelectFileModel::_SearchScript(const std::wstring& dir) {
+//Directory items are listed as they are found, the scripts only after the search. ScriptSelectScene::Sort
+//	puts directories ahead of scripts anyway, so the menu ends up in the same order as when they were interleaved
+void ScriptSelectFileModel::_SearchScript(const std::wstring& dir, std::vector<std::wstring>& listPath) {
 	if (stdfs::exists(dir) && stdfs::is_directory(dir)) {
 		for (auto itr : stdfs::directory_iterator(dir)) {
 			if (GetStatus() != RUN) return;
 
-			uint64_t time = SystemUtility::GetCpuTime2();
-			if ((time - timeLastUpdate_) > 100) {
-				//100ms delay between updates
-				timeLastUpdate_ = time;
-				scene_->AddMenuItem(listItem_);
-				listItem_.clear();
-			}
-
 			if (itr.is_directory()) {
 				std::wstring tDir = PathProperty::ReplaceYenToSlash(itr.path());
 				tDir = PathProperty::AppendSlash(tDir);
@@ -506,28 +505,57 @@ void ScriptSelectFileModel::_SearchScript(const std::wstring& dir) {
 					listItem_.push_back(item);
 				}
 				else {
-					_SearchScript(tDir);
+					_SearchScript(tDir, listPath);
 				}
 			}
 			else {
 				std::wstring tPath = PathProperty::ReplaceYenToSlash(itr.path());
-				_CreateMenuItem(tPath);
+				listPath.push_back(tPath);
 			}
 		}
 	}
-
-	scene_->AddMenuItem(listItem_);
-	listItem_.clear();
 }
-void ScriptSelectFileModel::_CreateMenuItem(const std::wstring& path) {
-	std::vector<ref_count_ptr<ScriptInformation>> listInfo = ScriptInformation::CreateScriptInformationList(path, true);
-	for (ref_count_ptr<ScriptInformation> info : listInfo) {
-		if (!_IsValidScriptInformation(info)) continue;
+void ScriptSelectFileModel::_CreateMenuItem(const std::vector<std::wstring>& listPath) {
+	ScriptInformationIndex* index = ScriptInformationIndex::GetInstance();
 
-		int typeItem = _ConvertTypeInfoToItem(info->type_);
-		listItem_.push_back(new ScriptSelectSceneMenuItem(typeItem, info->pathScript_, info));
+	//Indexed files resolve immediately, the rest are scanned in parallel a chunk at a time
+	constexpr size_t CHUNK_SIZE = 256U;
+	for (size_t iChunk = 0; iChunk < listPath.size(); iChunk += CHUNK_SIZE) {
+		if (GetStatus() != RUN) return;
+
+		std::vector<std::wstring> listChunk(listPath.begin() + iChunk,
+			listPath.begin() + std::min(iChunk + CHUNK_SIZE, listPath.size()));
+
+		std::vector<std::vector<ref_count_ptr<ScriptInformation>>> listChunkInfo;
+		if (index)
+			listChunkInfo = index->GetScriptInformationList(listChunk);
+		else {
+			for (const std::wstring& path : listChunk)
+				listChunkInfo.push_back(ScriptInformation::CreateScriptInformationList(path, true));
+		}
+
+		for (auto& listInfo : listChunkInfo) {
+			for (ref_count_ptr<ScriptInformation> info : listInfo) {
+				if (!_IsValidScriptInformation(info)) continue;
+
+				int typeItem = _ConvertTypeInfoToItem(info->type_);
+				listItem_.push_back(new ScriptSelectSceneMenuItem(typeItem, info->pathScript_, info));
+			}
+		}
+
+		_UpdateMenuItem(false);
 	}
 
+	_UpdateMenuItem(true);
+}
+void ScriptSelectFileModel::_UpdateMenuItem(bool bForce) {
+	uint64_t time = SystemUtility::GetCpuTime2();
+	if (bForce || (time - timeLastUpdate_) > 100) {
+		//100ms delay between updates
+		timeLastUpdate_ = time;
+		scene_->AddMenuItem(listItem_);
+		listItem_.clear();
+	}
 }
 bool ScriptSelectFileModel::_IsValidScriptInformation(ref_count_ptr<ScriptInformation> info) {
 	int typeScript = info->type_;
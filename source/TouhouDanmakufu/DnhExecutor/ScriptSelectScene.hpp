@@ -133,8 +133,10 @@ protected:
 	std::list<ref_count_ptr<ScriptSelectSceneMenuItem>> listItem_;
 	
 	virtual void _Run();
-	virtual void _SearchScript(const std::wstring& dir);
-	void _CreateMenuItem(const std::wstring& path);
+	//Collects the files to scan into listPath, directory items are created immediately
+	virtual void _SearchScript(const std::wstring& dir, std::vector<std::wstring>& listPath);
+	void _CreateMenuItem(const std::vector<std::wstring>& listPath);
+	void _UpdateMenuItem(bool bForce);
 	bool _IsValidScriptInformation(ref_count_ptr<ScriptInformation> info);
 	int _ConvertTypeInfoToItem(int typeInfo);
 public:
@@ -0,0 +1,172 @@
+#include "source/GcLib/pch.h"
+
+#include "SelfTest.hpp"
+
+//*******************************************************************
+//SelfTest
+//*******************************************************************
+SelfTest::SelfTest() {
+	countCheck_ = 0;
+	countCheckFailed_ = 0;
+
+	_AddScriptCases();
+	_AddDirectXCases();
+	_AddStgCases();
+}
+
+void SelfTest::Check(bool bPass, const std::string& what) {
+	++countCheck_;
+	if (bPass) return;
+	++countCheckFailed_;
+	Print("    FAILED: " + what + "\n");
+}
+void SelfTest::Print(const std::string& text) {
+	report_ += text;
+}
+
+double SelfTest::Measure(const std::string& name, size_t count, std::function<void()> func) {
+	if (count == 0) return 0;
+
+	func();		//Warm-up, not timed
+
+	auto timeStart = SystemUtility::GetCpuTime();
+	for (size_t i = 0; i < count; ++i)
+		func();
+	auto timeEnd = SystemUtility::GetCpuTime();
+
+	double micros = stdch::duration<double, std::micro>(timeEnd - timeStart).count() / count;
+	Print(StringUtility::Format("    %-48s %12.3f us/run (%u runs)\n", name.c_str(), micros, (uint32_t)count));
+	return micros;
+}
+
+size_t SelfTest::Run(const std::string& filter, bool bBenchmark) {
+	size_t countRun = 0;
+	size_t countFailed = 0;
+	for (Case& iCase : listCase_) {
+		if (iCase.kind == Kind::Benchmark && !bBenchmark) continue;
+		if (filter.size() > 0 && iCase.name.find(filter) == std::string::npos) continue;
+
+		Print(StringUtility::Format("[%s] %s\n",
+			iCase.kind == Kind::Benchmark ? "bench" : "test", iCase.name.c_str()));
+
+		size_t failedPrev = countCheckFailed_;
+		try {
+			iCase.func(this);
+		}
+		catch (gstd::wexception& e) {
+			++countCheckFailed_;
+			Print("    EXCEPTION: " + StringUtility::ConvertWideToMulti(e.GetErrorMessage()) + "\n");
+		}
+		catch (std::exception& e) {
+			++countCheckFailed_;
+			Print(std::string("    EXCEPTION: ") + e.what() + "\n");
+		}
+
+		++countRun;
+		if (countCheckFailed_ > failedPrev)
+			++countFailed;
+	}
+
+	Print(StringUtility::Format("\n%u case(s) run, %u failed, %u/%u check(s) passed\n",
+		(uint32_t)countRun, (uint32_t)countFailed,
+		(uint32_t)(countCheck_ - countCheckFailed_), (uint32_t)countCheck_));
+	return countFailed;
+}
+
+bool SelfTest::IsRequested() {
+	int argc = 0;
+	LPWSTR* argv = CommandLineToArgvW(GetCommandLineW(), &argc);
+	if (argv == nullptr) return false;
+
+	bool res = false;
+	for (int i = 1; i < argc; ++i) {
+		if (wcscmp(argv[i], L"-selftest") == 0) {
+			res = true;
+			break;
+		}
+	}
+	LocalFree(argv);
+	return res;
+}
+
+/* Usage:
+ *		th_dnh.exe -selftest [-filter <text>] [-benchmark] [-out <path>]
+ * Runs every test case whose name contains the filter text; -benchmark also runs the timing drivers.
+ * The report is written to the -out path, or to temp/selftest/report.txt,
+ *		and also to the console th_dnh was started from.
+ * Returns 0 if every case passed, 1 otherwise.
+ */
+int SelfTest::RunFromCommandLine() {
+	HANDLE hOutput = nullptr;
+	if (AttachConsole(ATTACH_PARENT_PROCESS))
+		hOutput = GetStdHandle(STD_OUTPUT_HANDLE);
+	auto _Print = [&](const std::string& text) {
+		if (hOutput == nullptr || hOutput == INVALID_HANDLE_VALUE) return;
+		DWORD written = 0;
+		WriteFile(hOutput, text.data(), text.size(), &written, nullptr);
+	};
+
+	std::string filter;
+	std::wstring pathOutput;
+	bool bBenchmark = false;
+	{
+		int argc = 0;
+		LPWSTR* argv = CommandLineToArgvW(GetCommandLineW(), &argc);
+		for (int i = 1; i < argc; ++i) {
+			std::wstring arg = argv[i];
+			bool bHasNext = i + 1 < argc;
+			if (arg == L"-filter" && bHasNext)
+				filter = StringUtility::ConvertWideToMulti(argv[++i]);
+			else if (arg == L"-out" && bHasNext)
+				pathOutput = argv[++i];
+			else if (arg == L"-benchmark")
+				bBenchmark = true;
+		}
+		LocalFree(argv);
+	}
+	if (pathOutput.size() == 0)
+		pathOutput = PathProperty::GetModuleDirectory() + L"temp/selftest/report.txt";
+
+	EFileManager* fileManager = EFileManager::CreateInstance();
+	fileManager->Initialize();
+
+	size_t countFailed = 0;
+	{
+		SelfTest test;
+		countFailed = test.Run(filter, bBenchmark);
+
+		std::string report = test.GetReport();
+
+		File file(pathOutput);
+		File::CreateFileDirectory(pathOutput);
+		if (file.Open(File::WRITEONLY))
+			file.Write(report.data(), report.size());
+
+		_Print(report);
+		_Print("Report written to " + StringUtility::ConvertWideToMulti(pathOutput) + "\n");
+	}
+
+	fileManager->EndLoadThread();
+	EFileManager::DeleteInstance();
+
+	return countFailed > 0 ? 1 : 0;
+}
+
+//*******************************************************************
+//SelfTestScript
+//*******************************************************************
+SelfTestScript::SelfTestScript() {
+	_AddFunction("SelfTestOutput", SelfTestScript::Func_SelfTestOutput, 1);
+}
+void SelfTestScript::Execute(const std::string& source) {
+	SetSource(source);
+	Compile();
+	Run();
+}
+
+gstd::value SelfTestScript::Func_SelfTestOutput(gstd::script_machine* machine, int argc, const gstd::value* argv) {
+	SelfTestScript* script = (SelfTestScript*)machine->data;
+	script->output_ += type_data::string_representation(argv[0].get_type()) + " "
+		+ StringUtility::ConvertWideToMulti(argv[0].as_string()) + "\n";
+	return gstd::value();
+}
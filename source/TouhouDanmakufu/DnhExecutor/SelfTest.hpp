@@ -0,0 +1,75 @@
+#pragma once
+
+#include "../../GcLib/pch.h"
+
+#include "GcLibImpl.hpp"
+
+//*******************************************************************
+//SelfTest
+//	Runs the engine's regression tests and timing drivers without creating a window.
+//	Used by "th_dnh.exe -selftest", cases are registered per area in the SelfTest*.cpp files.
+//*******************************************************************
+class SelfTest {
+public:
+	enum class Kind {
+		Test,
+		Benchmark,
+	};
+	using CaseFunc = std::function<void(SelfTest*)>;
+
+	struct Case {
+		std::string name;
+		Kind kind;
+		CaseFunc func;
+	};
+private:
+	std::vector<Case> listCase_;
+
+	std::string report_;
+	size_t countCheck_;
+	size_t countCheckFailed_;
+
+	void _AddCase(const std::string& name, Kind kind, CaseFunc func) {
+		listCase_.push_back({ name, kind, func });
+	}
+
+	//SelfTestScript.cpp
+	void _AddScriptCases();
+	//SelfTestDirectX.cpp
+	void _AddDirectXCases();
+	//SelfTestStg.cpp
+	void _AddStgCases();
+public:
+	SelfTest();
+
+	//Records a failed check, the case keeps running
+	void Check(bool bPass, const std::string& what);
+	void Print(const std::string& text);
+
+	//Runs func count times and reports the average time of one run
+	double Measure(const std::string& name, size_t count, std::function<void()> func);
+
+	//Returns the number of failed cases
+	size_t Run(const std::string& filter, bool bBenchmark);
+	const std::string& GetReport() { return report_; }
+
+	static bool IsRequested();
+	static int RunFromCommandLine();
+};
+
+//*******************************************************************
+//SelfTestScript
+//	A bare ScriptClientBase with only the common function tables; the built-in assert() reports failures.
+//	SelfTestOutput(v) appends "<type> <value>" to the output, for comparing runs against each other.
+//*******************************************************************
+class SelfTestScript : public ScriptClientBase {
+	std::string output_;
+public:
+	SelfTestScript();
+
+	//Throws gstd::wexception on a compilation error, a runtime error or a failed assert
+	void Execute(const std::string& source);
+	const std::string& GetOutput() { return output_; }
+
+	static gstd::value Func_SelfTestOutput(gstd::script_machine* machine, int argc, const gstd::value* argv);
+};
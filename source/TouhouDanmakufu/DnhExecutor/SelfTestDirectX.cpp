@@ -0,0 +1,533 @@
+#include "source/GcLib/pch.h"
+
+#include "SelfTest.hpp"
+
+//*******************************************************************
+//SelfTest: directx utilities
+//*******************************************************************
+//Random shape pairs for the batched intersection tests
+//	Every 7th line has zero width and every 11th has zero length, the scalar tests divide by the length
+struct SelfTestIntersectData {
+	DxCircleBatch circle1;
+	DxCircleBatch circle2;
+	DxCircleBatch circle3;
+	DxWidthLineBatch line;
+
+	SelfTestIntersectData(size_t count, uint32_t seed) {
+		RandProvider rand(seed);
+		auto _Rand = [&](float min, float max) { return (float)rand.GetReal(min, max); };
+		for (size_t i = 0; i < count; ++i) {
+			circle1.Add(DxCircle(_Rand(0, 100), _Rand(0, 100), _Rand(0, 20)));
+			circle2.Add(DxCircle(_Rand(0, 100), _Rand(0, 100), _Rand(0, 20)));
+			circle3.Add(DxCircle(_Rand(0, 100), _Rand(0, 100), _Rand(0, 20)));
+
+			float width = (i % 7 == 0) ? 0.0f : _Rand(0, 64);
+			float x1 = _Rand(0, 100);
+			float y1 = _Rand(0, 100);
+			if (i % 11 == 0)
+				line.Add(DxWidthLine(x1, y1, x1, y1, width));
+			else
+				line.Add(DxWidthLine(x1, y1, _Rand(0, 100), _Rand(0, 100), width));
+		}
+	}
+	DxCircle GetCircle(const DxCircleBatch& batch, size_t i) {
+		return DxCircle(batch.x[i], batch.y[i], batch.r[i]);
+	}
+	DxWidthLine GetLine(size_t i) {
+		return DxWidthLine(line.x1[i], line.y1[i], line.x2[i], line.y2[i], line.w[i]);
+	}
+};
+
+//Random TLX vertices and the transforms RenderObjectTLX uses: scale, rotation and translation,
+//	plus a perspective projection so that the homogeneous divide is covered
+struct SelfTestVertexData {
+	std::vector<VERTEX_TLX> listVertex;
+	std::vector<D3DXMATRIX> listMatrix;
+
+	SelfTestVertexData(size_t count, uint32_t seed) {
+		RandProvider rand(seed);
+		auto _Rand = [&](float min, float max) { return (float)rand.GetReal(min, max); };
+
+		listVertex.resize(count);
+		for (VERTEX_TLX& vert : listVertex) {
+			vert.position = D3DXVECTOR4(_Rand(-640, 640), _Rand(-480, 480), _Rand(-1, 1), _Rand(0.5f, 2));
+			vert.diffuse_color = (D3DCOLOR)rand.GetInt();
+			vert.texcoord = D3DXVECTOR2(_Rand(0, 1), _Rand(0, 1));
+		}
+
+		for (size_t i = 0; i < 8; ++i) {
+			D3DXMATRIX matScale, matRotate, matTranslate;
+			D3DXMatrixScaling(&matScale, _Rand(-4, 4), _Rand(-4, 4), _Rand(0.5f, 2));
+			D3DXMatrixRotationYawPitchRoll(&matRotate, _Rand(-GM_PI, GM_PI), _Rand(-GM_PI, GM_PI), _Rand(-GM_PI, GM_PI));
+			D3DXMatrixTranslation(&matTranslate, _Rand(-640, 640), _Rand(-480, 480), _Rand(-10, 10));
+			listMatrix.push_back(matScale * matRotate * matTranslate);
+		}
+		{
+			D3DXMATRIX matView, matProj;
+			D3DXVECTOR3 eye(0, 0, -2000), at(0, 0, 0), up(0, 1, 0);
+			D3DXMatrixLookAtLH(&matView, &eye, &at, &up);
+			D3DXMatrixPerspectiveFovLH(&matProj, D3DXToRadian(45), 640.0f / 480.0f, 10, 4000);
+			listMatrix.push_back(matView * matProj);
+		}
+	}
+};
+
+//A script object that joins the render buckets but draws nothing, for timing the object manager on its own
+class SelfTestScriptObject : public DxScriptObjectBase {
+public:
+	virtual bool HasNormalRendering() { return true; }
+};
+
+//A reference device without rendering, enough for D3DX to decode into system memory textures
+//	Created on the desktop window, so the self test still doesn't need one of its own
+struct SelfTestNullDevice {
+	IDirect3D9* direct3D = nullptr;
+	IDirect3DDevice9* device = nullptr;
+
+	SelfTestNullDevice() {
+		direct3D = Direct3DCreate9(D3D_SDK_VERSION);
+		if (direct3D == nullptr) return;
+
+		D3DPRESENT_PARAMETERS param;
+		ZeroMemory(&param, sizeof(D3DPRESENT_PARAMETERS));
+		param.BackBufferWidth = 1;
+		param.BackBufferHeight = 1;
+		param.BackBufferFormat = D3DFMT_UNKNOWN;
+		param.SwapEffect = D3DSWAPEFFECT_DISCARD;
+		param.Windowed = TRUE;
+		direct3D->CreateDevice(D3DADAPTER_DEFAULT, D3DDEVTYPE_NULLREF, ::GetDesktopWindow(),
+			D3DCREATE_SOFTWARE_VERTEXPROCESSING, &param, &device);
+	}
+	~SelfTestNullDevice() {
+		ptr_release(device);
+		ptr_release(direct3D);
+	}
+};
+
+void SelfTest::_AddDirectXCases() {
+	//The batched tests must give exactly the scalar results, including the tail that doesn't fill a vector
+	_AddCase("directx/intersect_batch_equivalence", Kind::Test, [](SelfTest* test) {
+		constexpr size_t COUNT = 100003;
+		SelfTestIntersectData data(COUNT, 0x5e1f7e57);
+
+		std::vector<uint8_t> listCircle(COUNT);
+		std::vector<uint8_t> listLine(COUNT);
+		DxIntersect::Circle_Circle(&data.circle1, &data.circle2, listCircle.data());
+		DxIntersect::Circle_LineW(&data.circle3, &data.line, listLine.data());
+
+		size_t countMismatchCircle = 0;
+		size_t countMismatchLine = 0;
+		size_t countHit = 0;
+		for (size_t i = 0; i < COUNT; ++i) {
+			DxCircle c1 = data.GetCircle(data.circle1, i);
+			DxCircle c2 = data.GetCircle(data.circle2, i);
+			DxCircle c3 = data.GetCircle(data.circle3, i);
+			DxWidthLine l = data.GetLine(i);
+
+			if (listCircle[i] != (uint8_t)DxIntersect::Circle_Circle(&c1, &c2))
+				++countMismatchCircle;
+			if (listLine[i] != (uint8_t)DxIntersect::Circle_LineW(&c3, &l))
+				++countMismatchLine;
+			countHit += listCircle[i] + listLine[i];
+		}
+		test->Check(countMismatchCircle == 0, StringUtility::Format("Circle_Circle: %u of %u pairs differ",
+			(uint32_t)countMismatchCircle, (uint32_t)COUNT));
+		test->Check(countMismatchLine == 0, StringUtility::Format("Circle_LineW: %u of %u pairs differ",
+			(uint32_t)countMismatchLine, (uint32_t)COUNT));
+		//Both outcomes have to be covered for the comparison to mean anything
+		test->Check(countHit > 0 && countHit < COUNT * 2, "random pairs are all hits or all misses");
+	});
+
+	_AddCase("directx/intersect_batch", Kind::Benchmark, [](SelfTest* test) {
+		constexpr size_t COUNT = 4096;
+		SelfTestIntersectData data(COUNT, 0x5e1f7e57);
+		std::vector<uint8_t> listRes(COUNT);
+
+		test->Measure("Circle_Circle x4096, scalar", 200, [&]() {
+			for (size_t i = 0; i < COUNT; ++i) {
+				DxCircle c1 = data.GetCircle(data.circle1, i);
+				DxCircle c2 = data.GetCircle(data.circle2, i);
+				listRes[i] = DxIntersect::Circle_Circle(&c1, &c2);
+			}
+		});
+		test->Measure("Circle_Circle x4096, batched", 200, [&]() {
+			DxIntersect::Circle_Circle(&data.circle1, &data.circle2, listRes.data());
+		});
+		test->Measure("Circle_LineW x4096, scalar", 200, [&]() {
+			for (size_t i = 0; i < COUNT; ++i) {
+				DxCircle c = data.GetCircle(data.circle3, i);
+				DxWidthLine l = data.GetLine(i);
+				listRes[i] = DxIntersect::Circle_LineW(&c, &l);
+			}
+		});
+		test->Measure("Circle_LineW x4096, batched", 200, [&]() {
+			DxIntersect::Circle_LineW(&data.circle3, &data.line, listRes.data());
+		});
+	});
+
+	//TransformVertexPositions must match D3DXVec3TransformCoord and leave w and the other vertex fields alone
+	_AddCase("directx/transform_vertex_positions", Kind::Test, [](SelfTest* test) {
+		constexpr size_t COUNT = 1027;
+		SelfTestVertexData data(COUNT, 0x7e47e4);
+		const size_t stride = sizeof(VERTEX_TLX);
+
+		for (size_t iMatrix = 0; iMatrix < data.listMatrix.size(); ++iMatrix) {
+			const D3DXMATRIX& mat = data.listMatrix[iMatrix];
+
+			std::vector<VERTEX_TLX> listSeparate = data.listVertex;
+			std::vector<VERTEX_TLX> listInPlace = data.listVertex;
+			DxMath::TransformVertexPositions((byte*)listSeparate.data(), (const byte*)data.listVertex.data(),
+				stride, COUNT, mat);
+			DxMath::TransformVertexPositions((byte*)listInPlace.data(), (const byte*)listInPlace.data(),
+				stride, COUNT, mat);
+
+			size_t countMismatch = 0;
+			size_t countChanged = 0;
+			float errorMax = 0;
+			for (size_t i = 0; i < COUNT; ++i) {
+				const VERTEX_TLX& src = data.listVertex[i];
+				D3DXVECTOR3 pos(src.position.x, src.position.y, src.position.z);
+				D3DXVECTOR3 expect;
+				D3DXVec3TransformCoord(&expect, &pos, &mat);
+
+				//D3DX may order the operations differently, so the error is taken relative to the size
+				//	of the terms that were summed, then carried through the divide by w
+				auto _TermSize = [&](size_t col) {
+					return fabsf(pos.x * mat.m[0][col]) + fabsf(pos.y * mat.m[1][col])
+						+ fabsf(pos.z * mat.m[2][col]) + fabsf(mat.m[3][col]);
+				};
+				float w = pos.x * mat.m[0][3] + pos.y * mat.m[1][3] + pos.z * mat.m[2][3] + mat.m[3][3];
+				float termW = _TermSize(3);
+
+				for (const VERTEX_TLX* res : { &listSeparate[i], &listInPlace[i] }) {
+					const float* pRes = (const float*)&res->position;
+					const float* pExpect = (const float*)&expect;
+					for (size_t j = 0; j < 3; ++j) {
+						float bound = (_TermSize(j) + fabsf(pExpect[j]) * termW) / fabsf(w);
+						float error = fabsf(pRes[j] - pExpect[j]) / std::max(bound, 1e-6f);
+						errorMax = std::max(errorMax, error);
+						if (!(error <= 1e-5f)) ++countMismatch;
+					}
+					if (res->position.w != src.position.w || res->diffuse_color != src.diffuse_color
+						|| res->texcoord != src.texcoord)
+						++countChanged;
+				}
+			}
+			test->Check(countMismatch == 0, StringUtility::Format("matrix %u: %u coordinates differ from D3DX, max error %g",
+				(uint32_t)iMatrix, (uint32_t)countMismatch, errorMax));
+			test->Check(countChanged == 0, StringUtility::Format("matrix %u: %u vertices had w, color or texcoord changed",
+				(uint32_t)iMatrix, (uint32_t)countChanged));
+		}
+	});
+
+	//A non-batchable object between batchable ones must flush what was merged before it is drawn by itself,
+	//	the same protocol as DxScriptObjectManager::RenderObjectBatched
+	_AddCase("directx/render_batch_order", Kind::Test, [](SelfTest* test) {
+		auto _Create = [](D3DPRIMITIVETYPE type, size_t count, float x) {
+			auto obj = std::make_shared<RenderObjectTLX>();
+			obj->SetPrimitiveType(type);
+			obj->SetVertexCount(count);
+			for (size_t i = 0; i < count; ++i)
+				obj->SetVertexPosition(i, x + i, (float)(i & 1));
+			return obj;
+		};
+		shared_ptr<RenderObjectTLX> listObject[] = {
+			_Create(D3DPT_TRIANGLELIST, 3, 100),
+			_Create(D3DPT_TRIANGLEFAN, 4, 200),
+			_Create(D3DPT_LINELIST, 2, 300),
+			_Create(D3DPT_TRIANGLESTRIP, 4, 400),
+		};
+
+		RenderBatchRecordSink2D sink;
+		RenderBatcher2D batcher(&sink);
+		RenderBatchKey2D key;
+		D3DXMATRIX matIdentity;
+		D3DXMatrixIdentity(&matIdentity);
+
+		std::vector<size_t> listDrawnBefore;
+		for (auto& obj : listObject) {
+			if (batcher.Add(key, obj.get(), matIdentity)) continue;
+			batcher.Flush();
+			//Stands in for obj->Render(), records how many batches were drawn before it
+			listDrawnBefore.push_back(sink.GetDrawList().size());
+		}
+		batcher.Flush();
+
+		const std::vector<RenderBatchRecordSink2D::Draw>& listDraw = sink.GetDrawList();
+		test->Check(listDrawnBefore.size() == 1, "the line list was batched");
+		test->Check(listDrawnBefore.size() == 1 && listDrawnBefore[0] == 1,
+			"the batch before the line list wasn't drawn before it");
+		test->Check(listDraw.size() == 2, StringUtility::Format("%u batches drawn, expected 2", (uint32_t)listDraw.size()));
+		test->Check(batcher.GetObjectCount() == 3 && batcher.GetDrawCount() == 2, "object or draw count is wrong");
+		if (listDraw.size() != 2) return;
+
+		//First batch: the list and the fan, second: the strip alone
+		auto _CheckDraw = [&](const RenderBatchRecordSink2D::Draw& draw, std::vector<float> listX,
+			const std::vector<uint16_t>& listIndex, const char* name)
+		{
+			bool bVertex = draw.vertex.size() == listX.size();
+			for (size_t i = 0; bVertex && i < listX.size(); ++i)
+				bVertex = draw.vertex[i].position.x == listX[i];
+			test->Check(bVertex, StringUtility::Format("%s: wrong vertices", name));
+			test->Check(draw.index == listIndex, StringUtility::Format("%s: wrong indices", name));
+		};
+		_CheckDraw(listDraw[0], { 100, 101, 102, 200, 201, 202, 203 },
+			{ 0, 1, 2, 3, 4, 5, 3, 5, 6 }, "batch before the line list");
+		_CheckDraw(listDraw[1], { 400, 401, 402, 403 },
+			{ 0, 1, 2, 2, 1, 3 }, "batch after the line list");
+
+		//A vertex shader object is drawn by itself whatever its primitive type, the shader does the transform
+		{
+			auto objShader = _Create(D3DPT_TRIANGLELIST, 3, 500);
+			objShader->SetVertexShaderRendering(true);
+
+			size_t countDrawPrev = sink.GetDrawList().size();
+			test->Check(batcher.Add(key, listObject[0].get(), matIdentity), "the triangle list wasn't batched");
+			test->Check(!batcher.Add(key, objShader.get(), matIdentity), "a vertex shader object was batched");
+			batcher.Flush();
+			test->Check(sink.GetDrawList().size() == countDrawPrev + 1 && sink.GetDrawList().back().vertex.size() == 3,
+				"a vertex shader object was merged into the batch");
+		}
+
+		//The script functions only set the script object's modes, they must reach the render object
+		//	before it is checked, as SetRenderState does for the unbatched path
+		{
+			ref_unsync_ptr<DxScriptPrimitiveObject2D> objScript = new DxScriptPrimitiveObject2D();
+			RenderObjectTLX* objRender = objScript->GetRenderObject();
+			objRender->SetPrimitiveType(D3DPT_TRIANGLELIST);
+			objRender->SetVertexCount(3);
+			objScript->SetVertexShaderRendering(true);
+			objScript->SetLoadWorldMatrix(false);
+
+			test->Check(!objScript->RenderBatched(&batcher), "a script object in vertex shader mode was batched");
+			test->Check(objRender->IsVertexShaderRendering(), "vertex shader mode didn't reach the render object");
+			test->Check(objRender->IsDisableMatrixTransformation(),
+				"the default transform matrix toggle didn't reach the render object");
+		}
+	});
+
+	_AddCase("directx/transform_vertex_positions", Kind::Benchmark, [](SelfTest* test) {
+		constexpr size_t COUNT = 4096;
+		SelfTestVertexData data(COUNT, 0x7e47e4);
+		const D3DXMATRIX& mat = data.listMatrix[0];
+		std::vector<VERTEX_TLX> listDest = data.listVertex;
+
+		test->Measure("D3DXVec3TransformCoord x4096", 200, [&]() {
+			for (size_t i = 0; i < COUNT; ++i) {
+				const D3DXVECTOR4& src = data.listVertex[i].position;
+				D3DXVECTOR3 pos(src.x, src.y, src.z);
+				D3DXVec3TransformCoord((D3DXVECTOR3*)&listDest[i].position, &pos, &mat);
+			}
+		});
+		test->Measure("TransformVertexPositions x4096", 200, [&]() {
+			DxMath::TransformVertexPositions((byte*)listDest.data(), (const byte*)data.listVertex.data(),
+				sizeof(VERTEX_TLX), COUNT, mat);
+		});
+	});
+
+	//Buckets only change when an object is created, deleted, hidden or reprioritized,
+	//	a frame with none of those should cost no more than walking the buckets
+	_AddCase("directx/render_bucket", Kind::Benchmark, [](SelfTest* test) {
+		constexpr size_t COUNT = 20000;
+		DxScriptObjectManager manager;
+		std::vector<ref_unsync_ptr<DxScriptObjectBase>> listObject;
+		for (size_t i = 0; i < COUNT; ++i) {
+			ref_unsync_ptr<DxScriptObjectBase> obj = new SelfTestScriptObject();
+			manager.AddObject(obj);
+			obj->SetRenderPriorityI(i % manager.GetRenderBucketCapacity());
+			listObject.push_back(obj);
+		}
+
+		auto _WalkBuckets = [&]() {
+			size_t count = 0;
+			for (auto& renderList : *manager.GetRenderObjectListPointer()) {
+				for (DxScriptObjectBase* obj : renderList)
+					++count;
+			}
+			return count;
+		};
+		test->Check(_WalkBuckets() == COUNT, "not every object is in a bucket");
+
+		size_t countWalked = 0;
+		test->Measure("prepare and walk buckets, 20000 objects", 200, [&]() {
+			manager.PrepareRenderObject();
+			countWalked += _WalkBuckets();
+		});
+		test->Check(countWalked == COUNT * 201, "objects were skipped while walking");
+		test->Measure("reprioritize 2000 of 20000 objects", 200, [&]() {
+			for (size_t i = 0; i < COUNT; i += 10) {
+				DxScriptObjectBase* obj = listObject[i].get();
+				obj->SetRenderPriorityI((obj->GetRenderPriorityI() + 1) % manager.GetRenderBucketCapacity());
+			}
+			manager.PrepareRenderObject();
+		});
+		test->Measure("hide and show 2000 of 20000 objects", 200, [&]() {
+			for (size_t i = 0; i < COUNT; i += 10)
+				listObject[i]->SetVisible(false);
+			manager.PrepareRenderObject();
+			for (size_t i = 0; i < COUNT; i += 10)
+				listObject[i]->SetVisible(true);
+			manager.PrepareRenderObject();
+		});
+		test->Check(_WalkBuckets() == COUNT, "objects were lost from the buckets");
+
+		//A scene transition: everything is created, drawn for a frame, then deleted at once
+		DxScriptObjectManager managerTransition;
+		test->Measure("create, draw and delete 20000 objects", 20, [&]() {
+			for (size_t i = 0; i < COUNT; ++i) {
+				ref_unsync_ptr<DxScriptObjectBase> obj = new SelfTestScriptObject();
+				managerTransition.AddObject(obj);
+				obj->SetRenderPriorityI(i % managerTransition.GetRenderBucketCapacity());
+			}
+			managerTransition.WorkObject();
+			managerTransition.PrepareRenderObject();
+			for (int id : managerTransition.GetValidObjectIdentifier())
+				managerTransition.DeleteObject(id);
+			managerTransition.CleanupObject();
+			managerTransition.WorkObject();
+			managerTransition.PrepareRenderObject();
+		});
+	});
+
+	//Closing a script only walks the objects it owns, the objects of other scripts shouldn't change the cost
+	_AddCase("directx/delete_by_script", Kind::Benchmark, [](SelfTest* test) {
+		constexpr int64_t COUNT_SCRIPT = 64;
+		constexpr size_t COUNT_OWNED = 312;
+		constexpr int64_t ID_SCRIPT_OTHER = COUNT_SCRIPT + 1;
+
+		for (size_t countOther : { 0, 80000 }) {
+			for (bool bDelete : { true, false }) {
+				DxScriptObjectManager manager;
+				for (size_t i = 0; i < COUNT_OWNED * COUNT_SCRIPT + countOther; ++i) {
+					ref_unsync_ptr<DxScriptObjectBase> obj = new SelfTestScriptObject();
+					obj->SetScriptID(i < COUNT_OWNED * COUNT_SCRIPT ? (int64_t)(i % COUNT_SCRIPT) : ID_SCRIPT_OTHER);
+					manager.AddObject(obj);
+				}
+
+				//One script per run, the warm-up run takes the first one
+				int64_t idScript = 0;
+				test->Measure(StringUtility::Format("%s %u of %u objects",
+					bDelete ? "DeleteObjectByScriptID" : "OrphanObjectByScriptID", (uint32_t)COUNT_OWNED,
+					(uint32_t)(COUNT_OWNED * COUNT_SCRIPT + countOther)), COUNT_SCRIPT - 1, [&]() {
+					if (bDelete) manager.DeleteObjectByScriptID(idScript);
+					else manager.OrphanObjectByScriptID(idScript);
+					++idScript;
+				});
+				manager.CleanupObject();
+
+				size_t countLeft = 0;
+				for (int64_t iScript = 0; iScript < COUNT_SCRIPT; ++iScript)
+					countLeft += manager.GetObjectByScriptID(iScript).size();
+				test->Check(countLeft == 0, StringUtility::Format("%u objects are still owned", (uint32_t)countLeft));
+				test->Check(manager.GetObjectByScriptID(ID_SCRIPT_OTHER).size() == countOther,
+					"objects of another script were touched");
+			}
+		}
+	});
+
+	//Bulk conversion, then loading the same images back from memory and from the disk cache
+	_AddCase("directx/texture_decode_cache", Kind::Benchmark, [](SelfTest* test) {
+		constexpr size_t COUNT_IMAGE = 16;
+		constexpr UINT SIZE_IMAGE = 512;
+
+		SelfTestNullDevice nullDevice;
+		IDirect3DDevice9* device = nullDevice.device;
+		if (device == nullptr) {
+			test->Print("    skipped, no reference device\n");
+			return;
+		}
+
+		//Noisy PNGs, so that decoding has real work to do
+		std::wstring dir = PathProperty::GetModuleDirectory() + L"temp/selftest/texture/";
+		std::vector<std::wstring> listPath;
+		std::vector<uint64_t> listKey;
+		RandProvider rand(0x7e8c4c);
+		for (size_t iImage = 0; iImage < COUNT_IMAGE; ++iImage) {
+			IDirect3DTexture9* texture = nullptr;
+			HRESULT hr = D3DXCreateTexture(device, SIZE_IMAGE, SIZE_IMAGE, 1, 0, 
+				D3DFMT_A8R8G8B8, D3DPOOL_SYSTEMMEM, &texture);
+			if (FAILED(hr))
+				throw gstd::wexception("D3DXCreateTexture failure.");
+
+			D3DLOCKED_RECT rect;
+			texture->LockRect(0, &rect, nullptr, 0);
+			for (UINT y = 0; y < SIZE_IMAGE; ++y) {
+				D3DCOLOR* line = (D3DCOLOR*)((byte*)rect.pBits + y * rect.Pitch);
+				for (UINT x = 0; x < SIZE_IMAGE; ++x)
+					line[x] = D3DCOLOR_ARGB(255, x / 2, y / 2, 0) ^ (rand.GetInt() & 0x1f1f1f);
+			}
+			texture->UnlockRect(0);
+
+			ID3DXBuffer* buffer = nullptr;
+			hr = D3DXSaveTextureToFileInMemory(&buffer, D3DXIFF_PNG, texture, nullptr);
+			ptr_release(texture);
+			if (FAILED(hr))
+				throw gstd::wexception("D3DXSaveTextureToFileInMemory failure.");
+
+			std::string source((const char*)buffer->GetBufferPointer(), buffer->GetBufferSize());
+			ptr_release(buffer);
+
+			std::wstring path = dir + StringUtility::Format(L"image%02u.png", (uint32_t)iImage);
+			File file(path);
+			File::CreateFileDirectory(path);
+			if (!file.Open(File::WRITEONLY))
+				throw gstd::wexception(L"cannot write " + path);
+			file.Write((void*)source.data(), source.size());
+			file.Close();
+
+			listPath.push_back(path);
+			listKey.push_back(TextureDecodeCache::ComputeKey(source, true, false));
+		}
+
+		TextureDecodeCache cache;
+		cache.SetDirectory(dir + L"cache/");
+		std::error_code err;
+		stdfs::remove_all(cache.GetDirectory(), err);
+
+		cache.SetDiskCacheEnable(false);
+		test->Measure("ConvertFiles x16 512x512, uncached", 8, [&]() {
+			cache.Clear();
+			cache.ConvertFiles(device, listPath, true, false);
+		});
+
+		size_t countHit = cache.GetHitCount();
+		test->Measure("Find x16, memory", 1000, [&]() {
+			for (uint64_t key : listKey)
+				cache.Find(key);
+		});
+		test->Check(cache.GetHitCount() - countHit == COUNT_IMAGE * 1001, "memory lookups missed");
+
+		cache.SetDiskCacheEnable(true);
+		cache.Clear();
+		size_t countConvert = cache.ConvertFiles(device, listPath, true, false);
+		test->Check(countConvert == COUNT_IMAGE, StringUtility::Format("%u of %u files converted", 
+			(uint32_t)countConvert, (uint32_t)COUNT_IMAGE));
+		test->Check(cache.ConvertFiles(device, listPath, true, false) == 0, "cached files were converted again");
+		test->Check(cache.GetDiskSize() > 0, "nothing was written to the disk cache");
+
+		std::vector<std::string> listData;
+		for (uint64_t key : listKey)
+			listData.push_back(cache.Find(key)->data);
+
+		size_t countMiss = cache.GetMissCount();
+		test->Measure("Find x16, disk", 8, [&]() {
+			cache.Clear();
+			for (uint64_t key : listKey)
+				cache.Find(key);
+		});
+		test->Check(cache.GetMissCount() == countMiss, "disk lookups missed");
+
+		for (size_t i = 0; i < COUNT_IMAGE; ++i) {
+			shared_ptr<TextureDecodeCache::Entry> entry = cache.Find(listKey[i]);
+			test->Check(entry != nullptr && entry->data == listData[i], 
+				StringUtility::Format("image %u differs after a reload from disk", (uint32_t)i));
+			test->Check(entry != nullptr && entry->infoImage.Width == SIZE_IMAGE 
+				&& entry->infoImage.ImageFileFormat == D3DXIFF_PNG, 
+				StringUtility::Format("image %u has the wrong source info", (uint32_t)i));
+		}
+		test->Print(StringUtility::Format("    %u hits, %u misses, %llu bytes on disk\n",
+			(uint32_t)cache.GetHitCount(), (uint32_t)cache.GetMissCount(), cache.GetDiskSize()));
+
+		stdfs::remove_all(dir, err);
+	});
+}
@@ -0,0 +1,910 @@
+#include "source/GcLib/pch.h"
+
+#include "SelfTest.hpp"
+
+//*******************************************************************
+//SelfTest: script engine
+//*******************************************************************
+struct SelfTestScriptSource {
+	const char* name;
+	const char* source;
+};
+
+//Each source runs top to bottom, a failed assert() fails the case
+static const SelfTestScriptSource listScriptCase[] = {
+	{ "script/concat_assign", R"dnh(
+		//[] ~= packed
+		int[] a = [];
+		int[] p = [1, 2, 3];
+		a ~= p;
+		assert(length(a) == 3, "[] ~= packed: length");
+		assert(a[0] == 1 && a[2] == 3, "[] ~= packed: contents");
+		assert(length(p) == 3, "[] ~= packed: right side unchanged");
+
+		//packed ~= unpacked
+		int[] b = [1, 2];
+		int[] u = [3, 4];
+		u[0] = 3;		//Writing through an element reference unpacks the array
+		b ~= u;
+		assert(length(b) == 4, "packed ~= unpacked: length");
+		assert(b[1] == 2 && b[2] == 3 && b[3] == 4, "packed ~= unpacked: contents");
+
+		//string ~= string
+		string s = "abc";
+		string t = s;
+		s ~= "def";
+		assert(s == "abcdef", "string ~= string");
+		assert(t == "abc", "string ~= string: copy unchanged");
+
+		//Through an element reference
+		int[][] n = [[1], [2]];
+		n[0] ~= [5, 6];
+		assert(length(n[0]) == 3 && n[0][2] == 6, "arr[i] ~= packed");
+		assert(length(n[1]) == 1, "arr[i] ~= packed: sibling unchanged");
+	)dnh" },
+	{ "script/element_assign_detach", R"dnh(
+		int[] a = [1, 2, 3];
+		int[] b = [];
+		function<int> CopyA() {
+			b = a;
+			return 9;
+		}
+		a[0] = CopyA();
+		assert(a[0] == 9, "a[i] = f(): write lands");
+		assert(b[0] == 1, "a[i] = f(): copy taken in f unchanged");
+
+		a = [1, 2, 3];
+		a[1] += CopyA();
+		assert(a[1] == 11, "a[i] += f(): write lands");
+		assert(b[1] == 2, "a[i] += f(): copy taken in f unchanged");
+
+		int[][] m = [[1, 2], [3, 4]];
+		int[][] mc = [];
+		function<int> CopyM() {
+			mc = m;
+			return 7;
+		}
+		m[1][0] = CopyM();
+		assert(m[1][0] == 7, "m[i][j] = f(): write lands");
+		assert(mc[1][0] == 3, "m[i][j] = f(): copy taken in f unchanged");
+	)dnh" },
+	{ "script/foreach_ref", R"dnh(
+		int[] arr = [1, 2, 3];
+		int sum = 0;
+		for each (int i in ref arr) {
+			if (i == 1) arr[2] = 10;
+			sum += i;
+		}
+		assert(sum == 13, "for each ref: sees writes to the array");
+
+		arr = [1, 2, 3];
+		sum = 0;
+		for each (int i in arr) {
+			if (i == 1) arr[2] = 10;
+			sum += i;
+		}
+		assert(sum == 6, "for each: iterates a snapshot");
+		assert(arr[2] == 10, "for each: write lands");
+
+		function<int> LocalRef() {
+			int[] loc = [1, 2, 3];
+			int s = 0;
+			for each (int i in ref loc) {
+				if (i == 1) loc[1] = 20;
+				s += i;
+			}
+			return s;
+		}
+		assert(LocalRef() == 24, "for each ref: local variable");
+
+		sum = 0;
+		for each (int i in ref [4, 5]) { sum += i; }
+		assert(sum == 9, "for each ref: temporary array");
+
+		int[] grow = [1, 2, 3, 4];
+		int[] seen = [];
+		for each (int i in ref grow) {
+			if (i % 2 == 0)
+				grow ~= [5];
+			seen ~= [i];
+		}
+		assert(length(seen) == 6 && seen[5] == 5, "for each ref: sees appended elements");
+		grow = [1, 2, 3, 4];
+		seen = [];
+		for each (int i in grow) {
+			if (i % 2 == 0)
+				grow ~= [5];
+			seen ~= [i];
+		}
+		assert(length(seen) == 4 && length(grow) == 6, "for each: appended elements not iterated");
+	)dnh" },
+	{ "script/call_arguments", R"dnh(
+		function<int> Sub3(int a, int b, int c) {
+			return a * 100 + b * 10 + c;
+		}
+		assert(Sub3(1, 2, 3) == 123, "function: argument order");
+
+		function<int> Locals(int a, int b) {
+			int x = a - b;
+			int y = b - a;
+			return x * 10 + y;
+		}
+		assert(Locals(5, 2) == 27, "function: locals after arguments");
+		assert(Locals(2, 5) == -27, "function: second call, fresh locals");
+
+		function<int> Fact(int n) {
+			if (n <= 1) return 1;
+			return n * Fact(n - 1);
+		}
+		assert(Fact(6) == 720, "function: recursion");
+
+		int[] got = [];
+		task TArgs(int a, string s, int[] arr) {
+			got = [a, length(s), length(arr)];
+		}
+		TArgs(4, "hello", [1, 2]);
+		yield;
+		assert(length(got) == 3 && got[0] == 4 && got[1] == 5 && got[2] == 2, "task: arguments");
+	)dnh" },
+	{ "script/constant_globals", R"dnh(
+		int c = 7;
+		string s = "ab";
+		float f = 1;		//Not propagated, the cast changes the literal
+		assert(c * 2 == 14, "int global");
+		assert(s ~ "c" == "abc", "string global");
+		assert(f / 2 == 0.5, "float global from an int literal");
+
+		int late;
+		int[] seen = [];
+		loop (2) {
+			if (length(seen) > 0)
+				seen ~= [late];
+			else
+				seen ~= [0];
+			late = 3;
+		}
+		assert(seen[1] == 3, "global written once inside a loop");
+	)dnh" },
+	{ "script/string_semantics", R"dnh(
+		string s = "hello";
+		assert(length(s) == 5, "length");
+		assert(s[1] == 'e', "index reads a char");
+		assert(s[1..3] == "el", "slice");
+		assert(s ~ "!" == "hello!", "concatenation");
+		assert("abc" < "abd" && "ab" < "abc", "comparison");
+		assert(s == ['h', 'e', 'l', 'l', 'o'], "equal to a char array");
+
+		string t = s;
+		t[0] = 'j';
+		assert(t == "jello", "element write lands");
+		assert(s == "hello", "element write: copy unchanged");
+
+		string r = "";
+		for each (char c in s) {
+			r = [c] ~ r;
+		}
+		assert(r == "olleh", "for each: chars in order");
+		assert(s == "hello", "for each: string unchanged");
+	)dnh" },
+	{ "script/char_array_packed", R"dnh(
+		//Reads must not change how a char array behaves, whether or not they unpack it
+		char[] c = ['a', 'b', 'c'];
+		assert(c == "abc", "char[] equals a string");
+		char first = c[0];
+		int count = 0;
+		for each (char x in c) {
+			count++;
+		}
+		assert(first == 'a' && count == 3, "reads");
+		assert(c == "abc" && c ~ "d" == "abcd", "still a string after reads");
+
+		string s = c;
+		c[1] = 'x';		//Writing through an element reference unpacks the array
+		assert(c == "axc", "element write lands");
+		assert(s == "abc", "element write: copy unchanged");
+		c ~= ['d'];
+		assert(c == "axcd" && length(c) == 4, "append after unpacking");
+		assert(c ~ "e" == "axcde" && c[1..3] == "xc", "still a string after unpacking");
+	)dnh" },
+};
+
+//Each source reads a global before its only assignment, the read must fail as uninitialized
+//	instead of seeing the literal propagated by the optimizer
+static const char* listScriptUninitializedCase[] = {
+	R"dnh(
+		int k;
+		int r = k;
+		k = 3;
+	)dnh",
+	R"dnh(
+		int k;
+		function<int> GetK() { return k; }
+		int r = GetK();
+		k = 3;
+	)dnh",
+	R"dnh(
+		int k;
+		loop (2) {
+			int r = k;
+			k = 3;
+		}
+	)dnh",
+};
+
+//Operations covered by the scalar fast paths, for every pair of operand types
+//	$L and $R are replaced by the operand types, $N by the function name
+static const char* SOURCE_FAST_PATH_OPS = R"dnh(
+	function<void> Ops$N($L a, $R b) {
+		SelfTestOutput(a + b);
+		SelfTestOutput(a - b);
+		SelfTestOutput(a * b);
+		SelfTestOutput(a / b);
+		SelfTestOutput(a == b);
+		SelfTestOutput(a != b);
+		SelfTestOutput(a < b);
+		SelfTestOutput(a <= b);
+		SelfTestOutput(a > b);
+		SelfTestOutput(a >= b);
+
+		$L v = a;
+		v++;
+		SelfTestOutput(v);
+		v--;
+		v--;
+		SelfTestOutput(v);
+		v = a;
+		v += b;
+		SelfTestOutput(v);
+		v = a;
+		v -= b;
+		SelfTestOutput(v);
+		v = a;
+		v *= b;
+		SelfTestOutput(v);
+		v = a;
+		v /= b;
+		SelfTestOutput(v);
+	}
+)dnh";
+static const char* SOURCE_FAST_PATH_MAIN = R"dnh(
+	int[] listInt = [-7, -1, 0, 1, 3, 1099511627776, 9223372036854775807];
+	float[] listFloat = [-2.5, -0.0, 0.0, 0.5, 3.0, 1e30];
+	for each (int a in listInt) {
+		for each (int b in listInt) { OpsII(a, b); }
+		for each (float b in listFloat) { OpsIF(a, b); }
+	}
+	for each (float a in listFloat) {
+		for each (int b in listInt) { OpsFI(a, b); }
+		for each (float b in listFloat) { OpsFF(a, b); }
+	}
+)dnh";
+
+//$N tasks that each wake once every 60 frames, staggered so that a frame wakes about $N / 60 of them
+//	$WAIT is either a wait() or the equivalent yield loop, one @MainLoop call is one frame
+static const char* SOURCE_WAIT_SCHEDULING = R"dnh(
+	int countWake = 0;
+	task Sleeper(int phase) {
+		loop (phase) { yield; }
+		loop {
+			$WAIT
+			countWake++;
+		}
+	}
+	ascent (int i in 0..$N) {
+		Sleeper(i % 60);
+	}
+	@MainLoop {
+		yield;
+	}
+)dnh";
+
+//Tasks with mixed wait lengths report every wake as frame * 1000 + id, $WAIT is a wait() or the equivalent yield loop
+//	The waits cross the near and far wheel boundaries and the overflow list, and @Spawn is called between frames
+//	to start 100 tasks in a row, which runs out of thread labels and relabels them while the others sleep
+static const char* SOURCE_WAKE_ORDER = R"dnh(
+	int frame = 0;
+	task Sleeper(int id, int countWait, int countRepeat) {
+		loop (id % 16) { yield; }
+		loop (countRepeat) {
+			$WAIT
+			SelfTestOutput(frame * 1000 + id);
+		}
+	}
+	task Spawner() {
+		ascent (int i in 0..100) {
+			Sleeper(100 + i, 1 + i % 9, 4);
+		}
+	}
+	int[] listWait = [1, 2, 3, 7, 255, 256, 257, 300, 511, 512, 4097, 65535, 65536, 65836];
+	int[] listRepeat = [3000, 1500, 1000, 400, 12, 12, 12, 10, 6, 6, 2, 1, 1, 1];
+	ascent (int i in 0..length(listWait)) {
+		Sleeper(i, listWait[i], listRepeat[i]);
+	}
+	@Spawn {
+		Spawner();
+	}
+	@MainLoop {
+		frame++;
+		yield;
+	}
+)dnh";
+
+//The same counting loop on a local, a global, and a local of the enclosing function
+//	Only the first two are resolved at compile time, the last one still walks the parent chain
+static const char* SOURCE_VARIABLE_ACCESS = R"dnh(
+	int g = 0;
+	function<int> LocalAccess() {
+		int a = 0;
+		loop (10000) {
+			a = a + 1;
+		}
+		return a;
+	}
+	function<int> GlobalAccess() {
+		g = 0;
+		loop (10000) {
+			g = g + 1;
+		}
+		return g;
+	}
+	function<int> EnclosingAccess() {
+		int a = 0;
+		function<void> Inner() {
+			loop (10000) {
+				a = a + 1;
+			}
+		}
+		Inner();
+		return a;
+	}
+	@Local {
+		assert(LocalAccess() == 10000, "local");
+	}
+	@Global {
+		assert(GlobalAccess() == 10000, "global");
+	}
+	@Enclosing {
+		assert(EnclosingAccess() == 10000, "enclosing");
+	}
+)dnh";
+
+//Copy-on-write: every event does 100 assignments, copies are only expected where a shared array is written to
+static const char* SOURCE_ARRAY_COPY = R"dnh(
+	int[] table = [];
+	ascent (int i in 0..1000) {
+		table ~= [i];
+	}
+	int[][] grid = [];
+	ascent (int i in 0..32) {
+		grid ~= [table[0..32]];
+	}
+	@CopyOnly {
+		loop (100) {
+			int[] b = table;
+		}
+	}
+	@CopyThenWrite {
+		loop (100) {
+			int[] b = table;
+			b[0] = 1;
+		}
+	}
+	@NestedWrite {
+		loop (100) {
+			grid[5][7] = 1;
+		}
+	}
+	@CopyThenNestedWrite {
+		loop (100) {
+			int[][] c = grid;
+			c[5][7] = 1;
+		}
+	}
+	@PassArgument {
+		function<int> Sum3(int[] arr) {
+			return arr[0] + arr[1] + arr[2];
+		}
+		loop (100) {
+			Sum3(table);
+		}
+	}
+)dnh";
+
+//Small script functions called 10000 times per event, with scalar and array arguments
+//	Arguments are moved into the callee's variables, passing an array must not copy it
+static const char* SOURCE_CALL_OVERHEAD = R"dnh(
+	int[] table = [];
+	ascent (int i in 0..100) {
+		table ~= [i];
+	}
+	function<int> One() {
+		return 1;
+	}
+	function<int> Add3(int a, int b, int c) {
+		return a + b - c;
+	}
+	function<int> Second(int[] arr) {
+		return arr[1];
+	}
+	function<int> MulSecond(int[] a, int[] b) {
+		return a[1] * b[1];
+	}
+	function<int> Fib(int n) {
+		if (n < 2) return n;
+		return Fib(n - 1) + Fib(n - 2);
+	}
+	@NoArgs {
+		int sum = 0;
+		loop (10000) { sum += One(); }
+		assert(sum == 10000, "no arguments");
+	}
+	@IntArgs {
+		int sum = 0;
+		loop (10000) { sum += Add3(1, 2, 2); }
+		assert(sum == 10000, "int arguments");
+	}
+	@ArrayArg {
+		int sum = 0;
+		loop (10000) { sum += Second(table); }
+		assert(sum == 10000, "array argument");
+	}
+	@TwoArrayArgs {
+		int sum = 0;
+		loop (10000) { sum += MulSecond(table, table); }
+		assert(sum == 10000, "two array arguments");
+	}
+	@Recursive {
+		assert(Fib(20) == 6765, "recursion");
+	}
+)dnh";
+
+//Include files for the line map test, every line that survives expansion is tagged with its file and line
+//	Covers an include at the start, the middle and the end of an entry, nested includes,
+//	a repeated include that is removed, and splitting an entry that doesn't start at line 1 of its file
+static const SelfTestScriptSource listLineMapFile[] = {
+	{ "main.dnh",
+		"//@main.dnh:1\n"
+		"#include \"./a.dnh\"\n"
+		"int m = 0; //@main.dnh:3\n"
+		"#include \"./c.dnh\"\n"
+		"//@main.dnh:5\n"
+		"#include \"./e.dnh\"\n"
+		"//@main.dnh:7\n"
+	},
+	{ "a.dnh",
+		"//@a.dnh:1\n"
+		"//@a.dnh:2\n"
+		"#include \"./b.dnh\"\n"
+		"//@a.dnh:4\n"
+		"#include \"./d.dnh\""
+	},
+	{ "b.dnh",
+		"#include \"./c.dnh\"\n"
+		"//@b.dnh:2\n"
+	},
+	{ "c.dnh",
+		"//@c.dnh:1\n"
+		"//@c.dnh:2"
+	},
+	{ "d.dnh",
+		"//@d.dnh:1\n"
+		"//@d.dnh:2"
+	},
+	{ "e.dnh",
+		"//@e.dnh:1"
+	},
+};
+
+//Files for the profiler test, the counts of Work's lines must be reported against work.dnh
+static const SelfTestScriptSource listProfileFile[] = {
+	{ "main.dnh",
+		"#include \"./work.dnh\"\n"
+		"int total = 0;\n"
+		"@Run {\n"
+		"	loop (7) {\n"
+		"		total += Work();\n"
+		"	}\n"
+		"}\n"
+		"@Nop {\n"
+		"}\n"
+	},
+	{ "work.dnh",
+		"function<int> Work() {\n"
+		"	int s = 0;\n"
+		"	loop (50) {\n"
+		"		s += 2;\n"
+		"	}\n"
+		"	return s;\n"
+		"}\n"
+	},
+};
+
+void SelfTest::_AddScriptCases() {
+	for (const SelfTestScriptSource& iCase : listScriptCase) {
+		std::string source = iCase.source;
+		_AddCase(iCase.name, Kind::Test, [source](SelfTest* test) {
+			SelfTestScript script;
+			script.Execute(source);
+		});
+	}
+
+	//Runs the same operations with the scalar fast paths on and off, the outputs must match
+	_AddCase("script/fast_path_differential", Kind::Test, [](SelfTest* test) {
+		std::string source;
+		for (const char* types : { "II", "IF", "FI", "FF" }) {
+			std::string ops = SOURCE_FAST_PATH_OPS;
+			ops = StringUtility::ReplaceAll(ops, "$N", types);
+			ops = StringUtility::ReplaceAll(ops, "$L", types[0] == 'I' ? "int" : "float");
+			ops = StringUtility::ReplaceAll(ops, "$R", types[1] == 'I' ? "int" : "float");
+			source += ops;
+		}
+		source += SOURCE_FAST_PATH_MAIN;
+
+		std::string listOutput[2];
+		for (size_t iRun = 0; iRun < 2; ++iRun) {
+			bool bFastPrev = script_engine::option_fast_path;
+			script_engine::option_fast_path = iRun == 0;
+			try {
+				SelfTestScript script;
+				script.Execute(source);
+				listOutput[iRun] = script.GetOutput();
+			}
+			catch (...) {
+				script_engine::option_fast_path = bFastPrev;
+				throw;
+			}
+			script_engine::option_fast_path = bFastPrev;
+		}
+
+		std::vector<std::string> listFast = StringUtility::Split(listOutput[0], "\n");
+		std::vector<std::string> listGeneric = StringUtility::Split(listOutput[1], "\n");
+		test->Check(listFast.size() > 0, "no output");
+		test->Check(listFast.size() == listGeneric.size(), StringUtility::Format("output count: fast=%u, generic=%u",
+			(uint32_t)listFast.size(), (uint32_t)listGeneric.size()));
+		size_t countMismatch = 0;
+		for (size_t i = 0; i < std::min(listFast.size(), listGeneric.size()); ++i) {
+			if (listFast[i] == listGeneric[i]) continue;
+			//Report the first few, one mismatch usually repeats for every operand pair
+			if (++countMismatch <= 8)
+				test->Check(false, StringUtility::Format("output %u: fast=\"%s\", generic=\"%s\"",
+					(uint32_t)i, listFast[i].c_str(), listGeneric[i].c_str()));
+		}
+		test->Check(countMismatch == 0, StringUtility::Format("%u mismatched output(s)", (uint32_t)countMismatch));
+	});
+
+	_AddCase("script/include_line_map", Kind::Test, [](SelfTest* test) {
+		std::wstring dir = PathProperty::GetModuleDirectory() + L"temp/selftest/include/";
+		for (const SelfTestScriptSource& iFile : listLineMapFile) {
+			std::wstring path = dir + StringUtility::ConvertMultiToWide(iFile.name);
+			std::string text = iFile.source;
+
+			File file(path);
+			File::CreateFileDirectory(path);
+			if (!file.Open(File::WRITEONLY))
+				throw gstd::wexception(L"cannot write " + path);
+			file.Write((void*)text.data(), text.size());
+		}
+
+		//The second compile reads the includes from ScriptIncludeCache
+		for (size_t iRun = 0; iRun < 2; ++iRun) {
+			SelfTestScript script;
+			script.SetSourceFromFile(dir + L"main.dnh");
+			script.Compile();
+
+			std::vector<char>& source = script.GetEngine()->GetSource();
+			std::wstring text((wchar_t*)source.data(), source.size() / sizeof(wchar_t));
+			if (text.size() > 0 && text[0] == 0xfeff)
+				text.erase(0, 1);
+			text.erase(std::find(text.begin(), text.end(), L'\0'), text.end());
+
+			ScriptFileLineMap* mapLine = script.GetEngine()->GetScriptFileLineMap();
+			std::vector<std::wstring> listLine = StringUtility::Split(text, L"\n");
+
+			size_t countTag = 0;
+			for (size_t iLine = 0; iLine < listLine.size(); ++iLine) {
+				size_t posTag = listLine[iLine].find(L"//@");
+				if (posTag == std::wstring::npos) continue;
+				++countTag;
+
+				std::wstring tag = StringUtility::Trim(listLine[iLine].substr(posTag + 3));
+				int line = iLine + 1;
+
+				std::wstring found = L"(none)";
+				if (ScriptFileLineMap::Entry* entry = mapLine->GetEntry(line)) {
+					found = PathProperty::GetFileName(entry->path_)
+						+ StringUtility::Format(L":%d", entry->lineEndOriginal_ - (entry->lineEnd_ - line));
+				}
+				test->Check(found == tag, StringUtility::Format("run %u, line %d: expected %s, got %s",
+					(uint32_t)iRun, line, StringUtility::ConvertWideToMulti(tag).c_str(),
+					StringUtility::ConvertWideToMulti(found).c_str()));
+			}
+			test->Check(countTag == 13, StringUtility::Format("run %u: %u tagged lines, expected 13",
+				(uint32_t)iRun, (uint32_t)countTag));
+		}
+	});
+
+	_AddCase("script/profiler_line_map", Kind::Test, [](SelfTest* test) {
+		std::wstring dir = PathProperty::GetModuleDirectory() + L"temp/selftest/profile/";
+		for (const SelfTestScriptSource& iFile : listProfileFile) {
+			std::wstring path = dir + StringUtility::ConvertMultiToWide(iFile.name);
+			std::string text = iFile.source;
+
+			File file(path);
+			File::CreateFileDirectory(path);
+			if (!file.Open(File::WRITEONLY))
+				throw gstd::wexception(L"cannot write " + path);
+			file.Write((void*)text.data(), text.size());
+		}
+
+		SelfTestScript script;
+		script.SetSourceFromFile(dir + L"main.dnh");
+		script.Compile();
+		script.Run();
+
+		ScriptProfiler::Clear();
+		ScriptProfiler::SetEnable(true);
+		for (size_t i = 0; i < 10; ++i)
+			script.Run("Run");
+		ScriptProfiler::SetEnable(false);
+		//A run with profiling stopped hands the thread's data over to the shared profile
+		script.Run("Nop");
+
+		std::vector<ScriptProfiler::LineData> listLine;
+		ScriptProfiler::GetLineData(listLine);
+		ScriptProfiler::Clear();
+
+		//Work may be inlined into @Run, so the counts are summed over functions
+		std::map<std::wstring, uint64_t> mapCount;
+		for (ScriptProfiler::LineData& data : listLine)
+			mapCount[PathProperty::GetFileName(data.path) + StringUtility::Format(L":%d", data.line)] += data.count;
+
+		struct {
+			const wchar_t* position;
+			uint64_t count;
+		} listExpect[] = {
+			{ L"work.dnh:2", 10 * 7 },			//Function entry
+			{ L"work.dnh:4", 10 * 7 * 50 },		//Loop body
+			{ L"main.dnh:5", 10 * 7 },			//The call, after the include
+		};
+		for (auto& iExpect : listExpect) {
+			uint64_t count = mapCount[iExpect.position];
+			test->Check(count == iExpect.count, StringUtility::Format("%s: count %llu, expected %llu",
+				StringUtility::ConvertWideToMulti(iExpect.position).c_str(), count, iExpect.count));
+		}
+	});
+
+	//Entries must survive a save and load, be dropped when the file's size or time changes,
+	//	and be pruned by a save once the file is gone. Headers are only rescanned on a miss,
+	//	which is what the titles show: a file edited behind the index's back keeps its old title
+	_AddCase("script/information_index", Kind::Test, [](SelfTest* test) {
+		if (ScriptInformationIndex::GetInstance()) {
+			test->Check(false, "the script index already exists");
+			return;
+		}
+
+		std::wstring dir = PathProperty::GetModuleDirectory() + L"temp/selftest/index/";
+		std::wstring pathIndex = dir + L"script_index.dat";
+		std::wstring pathA = dir + L"a.dnh";
+		std::wstring pathB = dir + L"b.dnh";
+
+		auto _WriteScript = [](const std::wstring& path, const std::string& title) {
+			std::string text = "#TouhouDanmakufu[Single]\n#Title[\"" + title + "\"]\n";
+			File file(path);
+			File::CreateFileDirectory(path);
+			if (!file.Open(File::WRITEONLY))
+				throw gstd::wexception(L"cannot write " + path);
+			file.Write((void*)text.data(), text.size());
+		};
+		auto _CreateIndex = [&]() {
+			ScriptInformationIndex* index = ScriptInformationIndex::CreateInstance();
+			index->SetFilePath(pathIndex);
+			return index;
+		};
+		auto _GetTitle = [](ScriptInformationIndex* index, const std::wstring& path) {
+			std::vector<ref_count_ptr<ScriptInformation>> listInfo = index->GetScriptInformationList(path);
+			return listInfo.size() == 1 ? StringUtility::ConvertWideToMulti(listInfo[0]->title_) : std::string("(none)");
+		};
+		auto _CheckTitle = [&](ScriptInformationIndex* index, const std::wstring& path, const std::string& expect,
+			const char* step)
+		{
+			std::string title = _GetTitle(index, path);
+			test->Check(title == expect, StringUtility::Format("%s: %s has title %s, expected %s", step,
+				StringUtility::ConvertWideToMulti(PathProperty::GetFileName(path)).c_str(), title.c_str(), expect.c_str()));
+		};
+
+		std::error_code err;
+		stdfs::remove(pathIndex, err);
+		_WriteScript(pathA, "A1");
+		_WriteScript(pathB, "B1");
+
+		ScriptInformationIndex* index = _CreateIndex();
+		_CheckTitle(index, pathA, "A1", "scan");
+		_CheckTitle(index, pathB, "B1", "scan");
+		test->Check(index->Save(), "first save");
+		ScriptInformationIndex::DeleteInstance();
+
+		//Same size and time, the loaded entry wins over the new header
+		stdfs::file_time_type timeA = stdfs::last_write_time(pathA);
+		_WriteScript(pathA, "A2");
+		stdfs::last_write_time(pathA, timeA);
+
+		index = _CreateIndex();
+		test->Check(index->Load(), "load");
+		_CheckTitle(index, pathA, "A1", "loaded entry");
+
+		//A changed time or size drops the entry
+		stdfs::last_write_time(pathA, timeA + std::chrono::hours(1));
+		_CheckTitle(index, pathA, "A2", "time changed");
+		_WriteScript(pathB, "B22");
+		_CheckTitle(index, pathB, "B22", "size changed");
+		test->Check(index->Save(), "second save");
+		ScriptInformationIndex::DeleteInstance();
+
+		//b.dnh disappears, a save that didn't look it up prunes it
+		stdfs::file_time_type timeB = stdfs::last_write_time(pathB);
+		stdfs::remove(pathB, err);
+
+		index = _CreateIndex();
+		test->Check(index->Load(), "load before pruning");
+		_CheckTitle(index, pathA, "A2", "reloaded entry");
+		test->Check(index->Save(), "pruning save");
+		ScriptInformationIndex::DeleteInstance();
+
+		//Recreated with the stamp of the pruned entry, a stale entry would still say B22
+		_WriteScript(pathB, "B33");
+		stdfs::last_write_time(pathB, timeB);
+
+		index = _CreateIndex();
+		test->Check(index->Load(), "load after pruning");
+		_CheckTitle(index, pathB, "B33", "pruned entry");
+		ScriptInformationIndex::DeleteInstance();
+	});
+
+	_AddCase("script/constant_read_before_write", Kind::Test, [](SelfTest* test) {
+		for (const char* source : listScriptUninitializedCase) {
+			bool bError = false;
+			try {
+				SelfTestScript script;
+				script.Execute(source);
+			}
+			catch (gstd::wexception&) {
+				bError = true;
+			}
+			test->Check(bError, std::string("no error for:") + source);
+		}
+	});
+
+	//The timer wheel must wake tasks in the same order as counting down with yields, the scheduling it replaced
+	_AddCase("script/wake_order", Kind::Test, [](SelfTest* test) {
+		constexpr size_t COUNT_FRAME = 66000;
+		//Every Sleeper repeat, plus 4 for each of the 100 tasks of every @Spawn
+		constexpr size_t COUNT_WAKE = 5963 + 17 * 400;
+
+		std::string listOutput[2];
+		for (size_t iRun = 0; iRun < 2; ++iRun) {
+			std::string source = SOURCE_WAKE_ORDER;
+			source = StringUtility::ReplaceAll(source, "$WAIT", iRun == 0 ? "wait(countWait);" : "loop (countWait) { yield; }");
+
+			SelfTestScript script;
+			script.Execute(source);
+			for (size_t iFrame = 0; iFrame < COUNT_FRAME; ++iFrame) {
+				if (iFrame % 4000 == 1500)
+					script.Run("Spawn");
+				script.Run("MainLoop");
+			}
+			test->Check(script.GetThreadCount() == 1, StringUtility::Format("%u threads left",
+				(uint32_t)script.GetThreadCount()));
+			listOutput[iRun] = script.GetOutput();
+		}
+
+		size_t countWake = std::count(listOutput[1].begin(), listOutput[1].end(), '\n');
+		test->Check(countWake == COUNT_WAKE, StringUtility::Format("%u of %u wakes with yields",
+			(uint32_t)countWake, (uint32_t)COUNT_WAKE));
+		if (listOutput[0] != listOutput[1]) {
+			//Report the first wake that differs
+			std::vector<std::string> listWheel = StringUtility::Split(listOutput[0], "\n");
+			std::vector<std::string> listYield = StringUtility::Split(listOutput[1], "\n");
+			size_t i = 0;
+			while (i < listWheel.size() && i < listYield.size() && listWheel[i] == listYield[i]) ++i;
+			test->Check(false, StringUtility::Format("wake %u: wait=\"%s\", yield=\"%s\"", (uint32_t)i,
+				i < listWheel.size() ? listWheel[i].c_str() : "", i < listYield.size() ? listYield[i].c_str() : ""));
+		}
+	});
+
+	//Sleeping tasks are kept out of the runnable list, so a frame should only pay for the ones that wake
+	_AddCase("script/wait_scheduling", Kind::Benchmark, [](SelfTest* test) {
+		for (size_t countTask : { 100, 1000, 10000 }) {
+			for (const char* wait : { "wait(60);", "loop (60) { yield; }" }) {
+				std::string source = SOURCE_WAIT_SCHEDULING;
+				source = StringUtility::ReplaceAll(source, "$N", std::to_string(countTask));
+				source = StringUtility::ReplaceAll(source, "$WAIT", wait);
+
+				SelfTestScript script;
+				script.Execute(source);
+				test->Check(script.GetThreadCount() == countTask + 1, StringUtility::Format("%u tasks: %u threads",
+					(uint32_t)countTask, (uint32_t)script.GetThreadCount()));
+
+				test->Measure(StringUtility::Format("%u tasks, %s", (uint32_t)countTask, wait), 600, [&]() {
+					script.Run("MainLoop");
+				});
+			}
+		}
+	});
+
+	//Writing to a copy detaches only the arrays on the written path, the outer array and the one row for a nested write
+	_AddCase("script/array_copy", Kind::Benchmark, [](SelfTest* test) {
+		struct {
+			const char* event;
+			size_t countCopy;
+		} listEvent[] = {
+			{ "CopyOnly", 0 },
+			{ "CopyThenWrite", 100 },
+			{ "NestedWrite", 0 },
+			{ "CopyThenNestedWrite", 200 },
+			{ "PassArgument", 0 },
+		};
+
+		SelfTestScript script;
+		script.Execute(SOURCE_ARRAY_COPY);
+		for (auto& iEvent : listEvent) {
+			constexpr size_t COUNT_RUN = 200;
+			size_t countPrev = gstd::value::count_array_copy;
+			test->Measure(iEvent.event, COUNT_RUN, [&]() {
+				script.Run(iEvent.event);
+			});
+			//Measure adds a warm-up run
+			size_t countCopy = (gstd::value::count_array_copy - countPrev) / (COUNT_RUN + 1);
+			test->Print(StringUtility::Format("        %u array copies/run\n", (uint32_t)countCopy));
+			test->Check(countCopy == iEvent.countCopy, StringUtility::Format("%s: %u array copies, expected %u",
+				iEvent.event, (uint32_t)countCopy, (uint32_t)iEvent.countCopy));
+		}
+	});
+
+	_AddCase("script/call_overhead", Kind::Benchmark, [](SelfTest* test) {
+		SelfTestScript script;
+		script.Execute(SOURCE_CALL_OVERHEAD);
+
+		size_t countPrev = gstd::value::count_array_copy;
+		test->Measure("NoArgs, 10000 calls", 200, [&]() { script.Run("NoArgs"); });
+		test->Measure("IntArgs, 10000 calls", 200, [&]() { script.Run("IntArgs"); });
+		test->Measure("ArrayArg, 10000 calls", 200, [&]() { script.Run("ArrayArg"); });
+		test->Measure("TwoArrayArgs, 10000 calls", 200, [&]() { script.Run("TwoArrayArgs"); });
+		test->Measure("Recursive, Fib(20)", 200, [&]() { script.Run("Recursive"); });
+		test->Check(gstd::value::count_array_copy == countPrev, "an array argument was copied");
+	});
+
+	//The cost of recording every instruction, on a plain loop and on call-heavy code
+	_AddCase("script/profiler_overhead", Kind::Benchmark, [](SelfTest* test) {
+		SelfTestScript scriptLoop;
+		scriptLoop.Execute(SOURCE_VARIABLE_ACCESS);
+		SelfTestScript scriptCall;
+		scriptCall.Execute(SOURCE_CALL_OVERHEAD);
+
+		for (bool bEnable : { false, true }) {
+			const char* state = bEnable ? "on" : "off";
+			ScriptProfiler::Clear();
+			ScriptProfiler::SetEnable(bEnable);
+			test->Measure(StringUtility::Format("Local, 10000 increments, profiler %s", state), 200, [&]() {
+				scriptLoop.Run("Local");
+			});
+			test->Measure(StringUtility::Format("IntArgs, 10000 calls, profiler %s", state), 200, [&]() {
+				scriptCall.Run("IntArgs");
+			});
+			test->Measure(StringUtility::Format("Recursive, Fib(20), profiler %s", state), 50, [&]() {
+				scriptCall.Run("Recursive");
+			});
+		}
+		ScriptProfiler::SetEnable(false);
+		ScriptProfiler::Clear();
+	});
+
+	_AddCase("script/variable_access", Kind::Benchmark, [](SelfTest* test) {
+		SelfTestScript script;
+		script.Execute(SOURCE_VARIABLE_ACCESS);
+		for (const char* event : { "Local", "Global", "Enclosing" }) {
+			test->Measure(StringUtility::Format("%s, 10000 increments", event), 200, [&]() {
+				script.Run(event);
+			});
+		}
+	});
+}
@@ -0,0 +1,523 @@
+#include "source/GcLib/pch.h"
+
+#include "SelfTest.hpp"
+
+#include "../Common/StgCommon.hpp"
+#include "../Common/StgShot.hpp"
+#include "../Common/StgItem.hpp"
+
+//*******************************************************************
+//SelfTest: stg
+//*******************************************************************
+class SelfTestMoveObject : public StgMoveObject {
+public:
+	SelfTestMoveObject() : StgMoveObject(nullptr) {}
+
+	bool IsDeleted() { return false; }
+
+	void Step() { _Move(); }
+};
+
+//Moves as StgNormalShotObject::Work does, without the parts that need a stage
+class SelfTestShotObject : public StgNormalShotObject {
+public:
+	SelfTestShotObject() : StgNormalShotObject(nullptr) {}
+
+	void Step() {
+		_Move();
+		if (delay_.time > 0)
+			--(delay_.time);
+	}
+};
+
+//Random positions over and around the STG frame, registered with one grid in creation order
+//	The linear scans are what the grid queries replaced, their results are the reference
+struct SelfTestGridData {
+	std::vector<unique_ptr<SelfTestMoveObject>> listObj;
+	StgSpatialGrid grid;
+	RandProvider rand;
+
+	SelfTestGridData(size_t count, uint32_t seed) {
+		rand.Initialize(seed);
+		for (size_t i = 0; i < count; ++i)
+			Add();
+	}
+
+	double GetRandomX() { return rand.GetReal(-64, 448); }
+	double GetRandomY() { return rand.GetReal(-64, 512); }
+	void Add() {
+		listObj.push_back(std::make_unique<SelfTestMoveObject>());
+		SelfTestMoveObject* obj = listObj.back().get();
+		obj->SetPositionXY(GetRandomX(), GetRandomY());
+		grid.Register(obj);
+	}
+
+	void QueryRectLinear(double left, double top, double right, double bottom, std::vector<StgMoveObject*>& res) {
+		for (auto& obj : listObj) {
+			double x = obj->GetPositionX();
+			double y = obj->GetPositionY();
+			if (x >= left && x <= right && y >= top && y <= bottom)
+				res.push_back(obj.get());
+		}
+	}
+	void QueryNearestLinear(double x, double y, size_t count, std::vector<StgMoveObject*>& res) {
+		std::vector<std::pair<double, size_t>> listFound;
+		for (size_t i = 0; i < listObj.size(); ++i)
+			listFound.push_back({ Math::HypotSq(listObj[i]->GetPositionX() - x, listObj[i]->GetPositionY() - y), i });
+
+		size_t countRes = std::min(count, listFound.size());
+		std::partial_sort(listFound.begin(), listFound.begin() + countRes, listFound.end());
+		for (size_t i = 0; i < countRes; ++i)
+			res.push_back(listObj[listFound[i].second].get());
+	}
+};
+
+//Both load paths of AddShotDataList, without the texture and vertex buffer steps that need a device
+class SelfTestShotDataList : public StgShotDataList {
+public:
+	using DataMap = std::map<int, unique_ptr<StgShotData>>;
+
+	void Scan(const std::string& source, DataMap& mapData, std::map<int, uint8_t>& mapFlags,
+		std::wstring& pathImage, uint8_t& fileFlags)
+	{
+		Scanner scanner(source);
+		_ScanSource(scanner, mapData, mapFlags, pathImage, fileFlags);
+	}
+	void Compile(const std::string& source, DataMap& mapData, ByteBuffer& buf) {
+		std::map<int, uint8_t> mapFlags;
+		std::wstring pathImage;
+		uint8_t fileFlags = 0;
+		Scan(source, mapData, mapFlags, pathImage, fileFlags);
+
+		std::vector<int> listAddID;
+		std::vector<StgShotData*> listAddData;
+		for (auto& [id, data] : mapData) {
+			listAddID.push_back(id);
+			listAddData.push_back(data.get());
+		}
+		_WriteBinary(buf, pathImage, fileFlags, listAddID, listAddData, mapFlags);
+	}
+	void Read(shared_ptr<ByteBuffer> buf, std::wstring& pathImage, DataMap& mapData) {
+		StgDataBinaryReader reader(buf);
+		_ReadBinary(reader, pathImage, mapData);
+	}
+};
+
+//A shot definition file with count entries covering every field, every fourth one animated
+//	The file's delay_id comes last, so the entries without their own take the list's running default
+static std::string SelfTestShotDataSource(size_t count) {
+	std::string res = "#UserShotData\n"
+		"shot_image = \"./shot.png\"\n"
+		"delay_color = (255, 128, 64)\n";
+	for (size_t i = 0; i < count; ++i) {
+		int x = (i % 16) * 32;
+		int y = (i / 16 % 16) * 32;
+		res += StringUtility::Format("ShotData {\n\tid = %u\n", (uint32_t)(i + 1));
+		if (i % 4 == 3) {
+			res += "\tAnimationData {\n";
+			for (int iFrame = 0; iFrame < 4; ++iFrame)
+				res += StringUtility::Format("\t\tanimation_data = (4, %d, %d, %d, %d)\n", x, y, x + 32, y + 32);
+			res += "\t}\n";
+		}
+		else res += StringUtility::Format("\trect = (%d, %d, %d, %d)\n", x, y, x + 32, y + 32);
+		if (i % 3 == 0) res += "\trender = ADD_ARGB\n\tdelay_color = (64, 255, 128)\n\talpha = 192\n";
+		if (i % 5 == 0) res += "\tcollision = (6, 1, -1)\n\tcollision = 3\n";
+		if (i % 6 == 0) res += "\tdelay_id = 7\n\tdelay_render = MULTIPLY\n";
+		if (i % 7 == 0) res += "\tangular_velocity = rand(-3, 3)\n";
+		if (i % 8 == 0) res += "\tfixed_angle = true\n";
+		res += "}\n";
+	}
+	res += "delay_id = 1\n";
+	return res;
+}
+
+//The same for AddItemDataList, out data go right after their owners as they do there
+class SelfTestItemDataList : public StgItemDataList {
+public:
+	using DataMap = std::map<int, unique_ptr<StgItemData>>;
+
+	void Compile(const std::string& source, DataMap& mapData, ByteBuffer& buf) {
+		Scanner scanner(source);
+		while (scanner.HasNext()) {
+			Token& tok = scanner.Next();
+			if (tok.GetType() == Token::Type::TK_EOF)
+				break;
+			else if (tok.GetType() == Token::Type::TK_ID && tok.GetElement() == L"ItemData")
+				_ScanItem(mapData, scanner);
+		}
+
+		std::vector<int> listAddID;
+		std::vector<StgItemData*> listAddData;
+		for (auto& [id, data] : mapData) {
+			listAddID.push_back(id);
+			listAddData.push_back(data.get());
+			if (StgItemData* dataOut = data->GetOutData())
+				listAddData.push_back(dataOut);
+		}
+		_WriteBinary(buf, L"./item.png", listAddID, listAddData);
+	}
+	void Read(shared_ptr<ByteBuffer> buf, std::wstring& pathImage, DataMap& mapData) {
+		StgDataBinaryReader reader(buf);
+		_ReadBinary(reader, pathImage, mapData);
+	}
+};
+
+//An item definition file with count entries, every third one with out data and every fourth one animated
+static std::string SelfTestItemDataSource(size_t count) {
+	std::string res;
+	for (size_t i = 0; i < count; ++i) {
+		int x = (i % 16) * 16;
+		int y = (i / 16 % 16) * 16;
+		res += StringUtility::Format("ItemData {\n\tid = %u\n", (uint32_t)(i + 1));
+		if (i % 4 == 3) {
+			res += "\tAnimationData {\n";
+			for (int iFrame = 0; iFrame < 3; ++iFrame)
+				res += StringUtility::Format("\t\tanimation_data = (%d, %d, %d, %d, %d)\n", 2 + iFrame, x, y + iFrame, x + 16, y + 16);
+			res += "\t}\n";
+		}
+		else res += StringUtility::Format("\trect = (%d, %d, %d, %d)\n", x, y, x + 16, y + 16);
+		if (i % 3 == 0) res += StringUtility::Format("\tout = (%d, %d, %d, %d)\n", x, y + 256, x + 16, y + 272);
+		if (i % 5 == 0) res += "\ttype = 3\n\trender = ADD_ARGB\n\talpha = 128\n";
+		res += "}\n";
+	}
+	return res;
+}
+
+void SelfTest::_AddStgCases() {
+	//Grid queries must return what a linear scan returns, in the same order,
+	//	including for objects moved or registered after the grid was built
+	_AddCase("stg/spatial_grid_equivalence", Kind::Test, [](SelfTest* test) {
+		SelfTestGridData data(5000, 0x9e1d);
+		auto _AcceptAll = [](StgMoveObject*) { return true; };
+
+		for (size_t iPass = 0; iPass < 3; ++iPass) {
+			data.grid.Invalidate();
+			data.grid.Prepare(data.listObj);
+			if (iPass >= 1) {
+				for (size_t i = 0; i < data.listObj.size(); i += 37)
+					data.listObj[i]->SetPositionXY(data.GetRandomX(), data.GetRandomY());
+			}
+			if (iPass >= 2) {
+				for (size_t i = 0; i < 100; ++i)
+					data.Add();
+			}
+
+			size_t countMismatchRect = 0;
+			size_t countMismatchNearest = 0;
+			for (size_t iQuery = 0; iQuery < 200; ++iQuery) {
+				double x = data.GetRandomX();
+				double y = data.GetRandomY();
+				double size = data.rand.GetReal(0, 128);
+
+				std::vector<StgMoveObject*> listGrid, listLinear;
+				data.grid.QueryRect(x - size, y - size, x + size, y + size, listGrid);
+				data.QueryRectLinear(x - size, y - size, x + size, y + size, listLinear);
+				if (listGrid != listLinear) ++countMismatchRect;
+
+				size_t count = 1 + iQuery % 16;
+				listGrid.clear();
+				listLinear.clear();
+				data.grid.QueryNearest(x, y, count, _AcceptAll, listGrid);
+				data.QueryNearestLinear(x, y, count, listLinear);
+				if (listGrid != listLinear) ++countMismatchNearest;
+			}
+			test->Check(countMismatchRect == 0, StringUtility::Format("pass %u: %u rect queries differ",
+				(uint32_t)iPass, (uint32_t)countMismatchRect));
+			test->Check(countMismatchNearest == 0, StringUtility::Format("pass %u: %u nearest queries differ",
+				(uint32_t)iPass, (uint32_t)countMismatchNearest));
+		}
+	});
+
+	//One frame's worth of area queries, the grid is rebuilt every frame as the managers do
+	_AddCase("stg/spatial_grid", Kind::Benchmark, [](SelfTest* test) {
+		constexpr size_t COUNT_QUERY = 100;
+		auto _AcceptAll = [](StgMoveObject*) { return true; };
+
+		for (size_t countObj : { 1000, 10000, 50000 }) {
+			SelfTestGridData data(countObj, 0x9e1d);
+			std::vector<std::pair<double, double>> listPoint;
+			for (size_t i = 0; i < COUNT_QUERY; ++i)
+				listPoint.push_back({ data.GetRandomX(), data.GetRandomY() });
+
+			std::vector<StgMoveObject*> listRes;
+			test->Measure(StringUtility::Format("%u x 64px box of %u objects, linear",
+				(uint32_t)COUNT_QUERY, (uint32_t)countObj), 20, [&]() {
+				for (auto& [x, y] : listPoint) {
+					listRes.clear();
+					data.QueryRectLinear(x - 32, y - 32, x + 32, y + 32, listRes);
+				}
+			});
+			test->Measure(StringUtility::Format("%u x 64px box of %u objects, grid",
+				(uint32_t)COUNT_QUERY, (uint32_t)countObj), 20, [&]() {
+				data.grid.Invalidate();
+				data.grid.Prepare(data.listObj);
+				for (auto& [x, y] : listPoint) {
+					listRes.clear();
+					data.grid.QueryRect(x - 32, y - 32, x + 32, y + 32, listRes);
+				}
+			});
+			test->Measure(StringUtility::Format("%u x nearest 4 of %u objects, linear",
+				(uint32_t)COUNT_QUERY, (uint32_t)countObj), 20, [&]() {
+				for (auto& [x, y] : listPoint) {
+					listRes.clear();
+					data.QueryNearestLinear(x, y, 4, listRes);
+				}
+			});
+			test->Measure(StringUtility::Format("%u x nearest 4 of %u objects, grid",
+				(uint32_t)COUNT_QUERY, (uint32_t)countObj), 20, [&]() {
+				data.grid.Invalidate();
+				data.grid.Prepare(data.listObj);
+				for (auto& [x, y] : listPoint) {
+					listRes.clear();
+					data.grid.QueryNearest(x, y, 4, _AcceptAll, listRes);
+				}
+			});
+		}
+	});
+
+	//The compiled form must load into the same shot data as the text it was compiled from
+	_AddCase("stg/shot_data_binary", Kind::Test, [](SelfTest* test) {
+		constexpr size_t COUNT = 300;
+		std::string source = SelfTestShotDataSource(COUNT);
+
+		//Separate lists, so that both loads start from the same running defaults
+		SelfTestShotDataList listText, listBinary;
+		SelfTestShotDataList::DataMap mapText, mapBinary;
+		shared_ptr<ByteBuffer> buf(new ByteBuffer());
+		listText.Compile(source, mapText, *buf);
+		std::wstring pathImage;
+		listBinary.Read(buf, pathImage, mapBinary);
+
+		test->Check(pathImage == L"./shot.png", "image path");
+		test->Check(mapText.size() == COUNT, StringUtility::Format("%u entries scanned, expected %u",
+			(uint32_t)mapText.size(), (uint32_t)COUNT));
+		test->Check(mapBinary.size() == mapText.size(), StringUtility::Format("%u entries read, expected %u",
+			(uint32_t)mapBinary.size(), (uint32_t)mapText.size()));
+
+		auto _IsSame = [](StgShotData* a, StgShotData* b) {
+			if (a->GetRenderType() != b->GetRenderType() || a->GetDelayRenderType() != b->GetDelayRenderType()
+				|| a->GetAlpha() != b->GetAlpha() || a->GetDefaultDelayID() != b->GetDefaultDelayID()
+				|| a->GetDelayColor() != b->GetDelayColor() || a->IsFixedAngle() != b->IsFixedAngle()
+				|| a->GetAngularVelocityMin() != b->GetAngularVelocityMin()
+				|| a->GetAngularVelocityMax() != b->GetAngularVelocityMax())
+				return false;
+
+			if (a->GetFrameCount() != b->GetFrameCount()) return false;
+			for (size_t iFrame = 0; iFrame < a->GetFrameCount() * 4; ++iFrame) {
+				DxRect<LONG>* rectA = a->GetFrame(iFrame)->GetSourceRect();
+				DxRect<LONG>* rectB = b->GetFrame(iFrame)->GetSourceRect();
+				if (rectA->left != rectB->left || rectA->top != rectB->top
+					|| rectA->right != rectB->right || rectA->bottom != rectB->bottom)
+					return false;
+			}
+
+			const std::vector<DxCircle>& listColA = a->GetIntersectionCircleList();
+			const std::vector<DxCircle>& listColB = b->GetIntersectionCircleList();
+			if (listColA.size() != listColB.size()) return false;
+			for (size_t iCol = 0; iCol < listColA.size(); ++iCol) {
+				if (listColA[iCol].GetR() != listColB[iCol].GetR() || listColA[iCol].GetX() != listColB[iCol].GetX()
+					|| listColA[iCol].GetY() != listColB[iCol].GetY())
+					return false;
+			}
+			return true;
+		};
+		size_t countMismatch = 0;
+		for (auto& [id, data] : mapText) {
+			auto itrBinary = mapBinary.find(id);
+			if (itrBinary == mapBinary.end() || !_IsSame(data.get(), itrBinary->second.get())) {
+				if (++countMismatch <= 8)
+					test->Check(false, StringUtility::Format("id %d differs", id));
+			}
+		}
+		test->Check(countMismatch == 0, StringUtility::Format("%u mismatched entries", (uint32_t)countMismatch));
+	});
+
+	//Item entries with out data write their out frame after their own, the read must pair them up again
+	//	Counts read from a damaged file must fail the load before anything is allocated for them
+	_AddCase("stg/item_data_binary", Kind::Test, [](SelfTest* test) {
+		constexpr size_t COUNT = 100;
+		std::string source = SelfTestItemDataSource(COUNT);
+
+		SelfTestItemDataList listText, listBinary;
+		SelfTestItemDataList::DataMap mapText, mapBinary;
+		shared_ptr<ByteBuffer> buf(new ByteBuffer());
+		listText.Compile(source, mapText, *buf);
+		std::wstring pathImage;
+		listBinary.Read(buf, pathImage, mapBinary);
+
+		test->Check(pathImage == L"./item.png", "image path");
+		test->Check(mapText.size() == COUNT, StringUtility::Format("%u entries scanned, expected %u",
+			(uint32_t)mapText.size(), (uint32_t)COUNT));
+		test->Check(mapBinary.size() == mapText.size(), StringUtility::Format("%u entries read, expected %u",
+			(uint32_t)mapBinary.size(), (uint32_t)mapText.size()));
+
+		//GetFrame takes a time, the animated entries cycle within the first 16 frames
+		auto _IsSameFrames = [](StgItemData* a, StgItemData* b) {
+			if (a->GetFrameCount() != b->GetFrameCount()) return false;
+			for (size_t iFrame = 0; iFrame < 16; ++iFrame) {
+				DxRect<LONG>* rectA = a->GetFrame(iFrame)->GetSourceRect();
+				DxRect<LONG>* rectB = b->GetFrame(iFrame)->GetSourceRect();
+				if (rectA->left != rectB->left || rectA->top != rectB->top
+					|| rectA->right != rectB->right || rectA->bottom != rectB->bottom)
+					return false;
+			}
+			return true;
+		};
+		auto _IsSame = [&](StgItemData* a, StgItemData* b) {
+			if (a->GetItemType() != b->GetItemType() || a->GetRenderType() != b->GetRenderType()
+				|| a->GetAlpha() != b->GetAlpha() || !_IsSameFrames(a, b))
+				return false;
+
+			StgItemData* outA = a->GetOutData();
+			StgItemData* outB = b->GetOutData();
+			if ((outA == nullptr) != (outB == nullptr)) return false;
+			return outA == nullptr || _IsSameFrames(outA, outB);
+		};
+		size_t countMismatch = 0;
+		size_t countOut = 0;
+		for (auto& [id, data] : mapText) {
+			if (data->GetOutData()) ++countOut;
+
+			auto itrBinary = mapBinary.find(id);
+			if (itrBinary == mapBinary.end() || !_IsSame(data.get(), itrBinary->second.get())) {
+				if (++countMismatch <= 8)
+					test->Check(false, StringUtility::Format("id %d differs", id));
+			}
+		}
+		test->Check(countOut == (COUNT + 2) / 3, StringUtility::Format("%u entries with out data", (uint32_t)countOut));
+		test->Check(countMismatch == 0, StringUtility::Format("%u mismatched entries", (uint32_t)countMismatch));
+
+		auto _IsRejected = [&](shared_ptr<ByteBuffer> bufBad) {
+			try {
+				SelfTestItemDataList list;
+				SelfTestItemDataList::DataMap mapData;
+				list.Read(bufBad, pathImage, mapData);
+			}
+			catch (gstd::wexception&) {
+				return true;
+			}
+			return false;
+		};
+		size_t offsetCount = sizeof(uint32_t) + pathImage.size() * sizeof(wchar_t);
+		{
+			shared_ptr<ByteBuffer> bufBad(new ByteBuffer(*buf));
+			*(uint32_t*)bufBad->GetPointer(offsetCount) = 0xffffffff;
+			test->Check(_IsRejected(bufBad), "record count past the end of the data");
+		}
+		{
+			shared_ptr<ByteBuffer> bufBad(new ByteBuffer(*buf));
+			*(uint32_t*)bufBad->GetPointer(0) = 0x7fffffff;
+			test->Check(_IsRejected(bufBad), "string length past the end of the data");
+		}
+		{
+			shared_ptr<ByteBuffer> bufBad(new ByteBuffer(*buf));
+			bufBad->SetSize(buf->GetSize() - 1);
+			test->Check(_IsRejected(bufBad), "truncated data");
+		}
+	});
+
+	//PredictMotion must land where the shot is after being stepped that many frames, with the speed
+	//	of the frame after. The parent is held still, which is what PredictMotion assumes of it
+	_AddCase("stg/shot_motion_prediction", Kind::Test, [](SelfTest* test) {
+		constexpr uint32_t DELAY = 20;
+		const uint32_t FRAME_CLAMPED = StgShotManager::ClampMotionFrame(100000);
+
+		test->Check(StgShotManager::ClampMotionFrame(-30) == 0, "negative frame clamped to 0");
+		test->Check(FRAME_CLAMPED == StgShotManager::MOTION_FRAME_MAX, StringUtility::Format(
+			"large frame clamped to %u, expected %u", FRAME_CLAMPED, (uint32_t)StgShotManager::MOTION_FRAME_MAX));
+
+		struct Setup {
+			const char* name;
+			bool bParent;
+			uint32_t delay;
+			bool bMotionDelay;
+		};
+		const Setup listSetup[] = {
+			{ "free", false, 0, false },
+			{ "delayed", false, DELAY, false },
+			{ "delayed, motion during delay", false, DELAY, true },
+			{ "parented", true, 0, false },
+			{ "parented, delayed", true, DELAY, false },
+		};
+		const uint32_t listFrame[] = { 0, 1, 7, DELAY - 1, DELAY, DELAY + 1, 150, FRAME_CLAMPED };
+
+		for (const Setup& setup : listSetup) {
+			ref_unsync_ptr<StgMoveObject> parent = new SelfTestMoveObject();
+			parent->SetPositionXY(192, 224);
+			parent->SetParentRotationScale(30, 1.5);
+
+			ref_unsync_ptr<SelfTestShotObject> shot = new SelfTestShotObject();
+			if (setup.bParent) {
+				shot->SetParent(parent);
+				shot->SetRelativePositionXY(-12, 8);
+			}
+			else shot->SetPositionXY(100, 50);
+			shot->SetSpeed(1.5);
+			shot->SetDirectionAngle(Math::DegreeToRadian(20));
+			StgMovePattern_Angle* pattern = (StgMovePattern_Angle*)shot->GetPattern().get();
+			pattern->SetAcceleration(0.02);
+			pattern->SetMaxSpeed(4);
+			pattern->SetAngularVelocity(Math::DegreeToRadian(0.4));
+			shot->SetDelay(setup.delay);
+			shot->SetEnableDelayMotion(setup.bMotionDelay);
+
+			std::vector<std::pair<Math::DVec2, Math::DVec2>> listPredict;
+			StgMoveObject probe(nullptr);
+			for (uint32_t frame : listFrame) {
+				Math::DVec2 pos, speed;
+				shot->PredictMotion(&probe, frame, pos, speed);
+				listPredict.push_back({ pos, speed });
+			}
+
+			//Positions after each frame up to the last one predicted, and the frame after it for the speed
+			std::vector<Math::DVec2> listPos = { { shot->GetPositionX(), shot->GetPositionY() } };
+			for (uint32_t frame = 0; frame <= FRAME_CLAMPED; ++frame) {
+				static_cast<SelfTestMoveObject*>(parent.get())->Step();
+				shot->Step();
+				listPos.push_back({ shot->GetPositionX(), shot->GetPositionY() });
+			}
+
+			for (size_t i = 0; i < std::size(listFrame); ++i) {
+				Math::DVec2& pos = listPos[listFrame[i]];
+				Math::DVec2 speed = { listPos[listFrame[i] + 1][0] - pos[0], listPos[listFrame[i] + 1][1] - pos[1] };
+
+				auto& [posPredict, speedPredict] = listPredict[i];
+				double errPos = std::max(std::abs(pos[0] - posPredict[0]), std::abs(pos[1] - posPredict[1]));
+				double errSpeed = std::max(std::abs(speed[0] - speedPredict[0]), std::abs(speed[1] - speedPredict[1]));
+				test->Check(errPos < 1e-6 && errSpeed < 1e-6, StringUtility::Format(
+					"%s, frame %u: stepped (%.4f, %.4f) speed (%.4f, %.4f), predicted (%.4f, %.4f) speed (%.4f, %.4f)",
+					setup.name, listFrame[i], pos[0], pos[1], speed[0], speed[1],
+					posPredict[0], posPredict[1], speedPredict[0], speedPredict[1]));
+			}
+		}
+	});
+
+	//Texture and vertex buffer creation are the same on both paths and are left out
+	_AddCase("stg/shot_data_load", Kind::Benchmark, [](SelfTest* test) {
+		for (size_t count : { 500, 4000 }) {
+			std::string source = SelfTestShotDataSource(count);
+
+			SelfTestShotDataList list;
+			shared_ptr<ByteBuffer> buf(new ByteBuffer());
+			{
+				SelfTestShotDataList::DataMap mapData;
+				list.Compile(source, mapData, *buf);
+			}
+			test->Print(StringUtility::Format("    %u entries: text %u bytes, compiled %u bytes\n",
+				(uint32_t)count, (uint32_t)source.size(), (uint32_t)buf->GetSize()));
+
+			test->Measure(StringUtility::Format("%u entries, scan text", (uint32_t)count), 20, [&]() {
+				SelfTestShotDataList::DataMap mapData;
+				std::map<int, uint8_t> mapFlags;
+				std::wstring pathImage;
+				uint8_t fileFlags = 0;
+				list.Scan(source, mapData, mapFlags, pathImage, fileFlags);
+			});
+			test->Measure(StringUtility::Format("%u entries, read compiled", (uint32_t)count), 20, [&]() {
+				SelfTestShotDataList::DataMap mapData;
+				std::wstring pathImage;
+				list.Read(buf, pathImage, mapData);
+			});
+		}
+	});
+}
@@ -1,12 +1,15 @@
 #include "source/GcLib/pch.h"
 
 #include "GcLibImpl.hpp"
+#include "ScriptAnalyzer.hpp"
+#include "SelfTest.hpp"
 
 //*******************************************************************
 //WinMain
 //*******************************************************************
 int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPWSTR lpCmdLine, int nCmdShow) {
 	HWND handleWindow = nullptr;
+	int res = 0;
 
 	try {
 		gstd::SystemUtility::TestCpuSupportSIMD();
@@ -16,6 +19,18 @@ int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPWSTR lpCmd
 		logger->Initialize(config->bLogFile_, config->bLogWindow_);
 		EPathProperty::CreateInstance();
 
+		if (ScriptAnalyzer::IsRequested() || SelfTest::IsRequested()) {
+			if (ScriptAnalyzer::IsRequested())
+				res = ScriptAnalyzer::RunFromCommandLine();
+			else
+				res = SelfTest::RunFromCommandLine();
+
+			EPathProperty::DeleteInstance();
+			ELogger::DeleteInstance();
+			DnhConfiguration::DeleteInstance();
+			return res;
+		}
+
 		EApplication* app = EApplication::CreateInstance();
 
 		app->Initialize();
@@ -49,5 +64,5 @@ int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPWSTR lpCmd
 
 	gstd::DebugUtility::DumpMemoryLeaksOnExit();
 
-	return 0;
+	return res;
 }